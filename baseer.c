@@ -9,6 +9,7 @@
 /* Baseer 0.1.0a */
 
 #include "baseer.h"
+#include <sys/mman.h>
 
 
 /* =================== Baseer open =================== */
@@ -22,7 +23,7 @@ baseer_target_t *baseer_open(char *file_path, baseer_mode_t mode)
 
     struct stat info;
     RETURN_NULL_IF(stat(file_path, &info) != 0)
-    RETURN_NULL_IF((info.st_size == 0) || (info.st_size > BASEER_MAX_FILE_SIZE))
+    RETURN_NULL_IF(info.st_size == 0)
 
     handler = fopen(file_path, "rb");
     RETURN_NULL_IF(handler == NULL)
@@ -39,8 +40,24 @@ baseer_target_t *baseer_open(char *file_path, baseer_mode_t mode)
     target->fp = (mode == BASEER_MODE_STREAM || mode == BASEER_MODE_BOTH) ? handler : NULL;
 
     target->size = info.st_size;
+    target->block = NULL;
+    target->mapped = false;
 
-    if (mode == BASEER_MODE_MEMORY || mode == BASEER_MODE_BOTH){
+    if ((mode == BASEER_MODE_MEMORY || mode == BASEER_MODE_BOTH) && target->size > BASEER_MAX_FILE_SIZE){
+        // too large to copy: map it, pages are read in on demand
+        void *map = mmap(NULL, target->size, PROT_READ, MAP_PRIVATE, fileno(handler), 0);
+        if (map == MAP_FAILED){
+            free(target);
+            fclose(handler);
+            return NULL;
+        }
+        target->block = map;
+        target->mapped = true;
+        if (mode == BASEER_MODE_MEMORY){
+            fclose(handler);
+            target->fp = NULL;
+        }
+    } else if (mode == BASEER_MODE_MEMORY || mode == BASEER_MODE_BOTH){
         target->block = malloc(target->size);
         if (target->block == NULL){
             free(target);
@@ -68,6 +85,11 @@ void baseer_close(baseer_target_t *target)
 {
     if(!target) return;
 
+    if (target->mapped){
+        munmap(target->block, target->size);
+        target->block = NULL;
+    }
+
     switch (target->mode){
         case BASEER_MODE_MEMORY:
             if (target->block){
@@ -105,7 +127,7 @@ void baseer_print(baseer_target_t *target)
         return;
 
     char *ptr = (char *)target->block;
-    printf("block-size: %u\n", target->size);
+    printf("block-size: %zu\n", target->size);
     printf("block-address: %p\n", target->block);
     printf("\n\n");
 
@@ -126,3 +148,19 @@ bool baseer_execute(baseer_target_t *target, baseer_callback_t callback, void *a
 
     return true;
 }
+
+/* =================== Sub-commands =================== */
+char **baseer_sub_args(inputs *input, int from, int *sub_argc, inputs *sub)
+{
+    int argc = *input->argc;
+    char **args = malloc((argc + 2) * sizeof(*args));
+    if (!args) return NULL;
+    *sub_argc = 0;
+    args[(*sub_argc)++] = input->args[0];
+    args[(*sub_argc)++] = input->args[1];
+    for (int i = from; i < argc; i++) args[(*sub_argc)++] = input->args[i];
+    *sub = *input;
+    sub->argc = sub_argc;
+    sub->args = args;
+    return args;
+}
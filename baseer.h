@@ -18,6 +18,7 @@
 #include <string.h>
 #include <ctype.h>
 #include <stdlib.h>
+#include <unistd.h>
 #include "linenoise.h"
 #include "modules/b_hashmap/b_hashmap.h"
 
@@ -33,7 +34,7 @@
     TOSTRING(BASEER_VERSION_MINOR) "." \
     TOSTRING(BASEER_VERSION_MICRO)
 
-#define BASEER_MAX_FILE_SIZE 1024 * 1024 * 4 /**< Max file size for memory mode */
+#define BASEER_MAX_FILE_SIZE 1024 * 1024 * 4 /**< Larger files are mapped instead of read into memory */
 #define RETURN_NULL_IF(con) \
     if ((con))              \
     {                       \
@@ -88,6 +89,23 @@ static inline int get_block_length(void)
     return DEFAULT_BLOCK_LENGTH;
 }
 
+#define BASEER_MAX_THREADS 64
+
+/**
+ * @brief Number of worker threads for parallel tools.
+ *
+ * Uses the BASEER_THREADS environment variable when set, otherwise the
+ * number of online CPUs, capped to BASEER_MAX_THREADS.
+ */
+static inline int get_thread_count(void)
+{
+    char *env = getenv("BASEER_THREADS");
+    long val = (env != NULL) ? atol(env) : sysconf(_SC_NPROCESSORS_ONLN);
+    if (val < 1) val = 1;
+    if (val > BASEER_MAX_THREADS) val = BASEER_MAX_THREADS;
+    return (int)val;
+}
+
 
 
 /**
@@ -99,8 +117,55 @@ typedef struct {
     int input_argc;
     char* input_args[MAX_INPUT_ARGS];
     hashmap_t *map;
+    const char *member;     /**< Archive member being analyzed, NULL for the file itself */
 } inputs;
 
+/**
+ * @brief Get the value that follows an option flag (e.g. `--function main`).
+ *
+ * Only the tool flags are searched, anything after `--args` belongs to the
+ * debugged program and is ignored.
+ *
+ * @param input Pointer to the command-line inputs
+ * @param opt Option name to look for
+ * @return Pointer to the option value, or NULL if the option is absent
+ */
+static inline const char *baseer_get_opt(inputs *input, const char *opt)
+{
+    for (int i = 2; i + 1 < *input->argc; i++) {
+        if (strcmp("--args", input->args[i]) == 0) break;
+        if (strcmp(opt, input->args[i]) == 0) return input->args[i + 1];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Check whether a flag without a value (e.g. `--source`) was given.
+ *
+ * @param input Pointer to the command-line inputs
+ * @param flag Flag to look for
+ * @return true if the flag is among the tool flags
+ */
+static inline bool baseer_has_flag(inputs *input, const char *flag)
+{
+    for (int i = 2; i < *input->argc; i++) {
+        if (strcmp("--args", input->args[i]) == 0) break;
+        if (strcmp(flag, input->args[i]) == 0) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Build the command line `<prog> <file> <args[from]...>` to run flags on a member.
+ *
+ * @param input    Pointer to the command-line inputs
+ * @param from     Index of the first flag to keep
+ * @param sub_argc Receives the argument count (sub->argc points to it)
+ * @param sub      Receives the inputs for the member
+ * @return The argument array to free(), NULL on allocation failure
+ */
+char **baseer_sub_args(inputs *input, int from, int *sub_argc, inputs *sub);
+
 /**
  * @brief Enum representing file access modes
  */
@@ -116,8 +181,9 @@ typedef enum {
 typedef struct baseer_target_t {
     FILE* fp;           /**< File pointer */
     baseer_mode_t mode; /**< File access mode */
-    unsigned int size;  /**< File size in bytes */
+    size_t size;        /**< File size in bytes */
     void *block;        /**< Memory block or FILE* cast */
+    bool mapped;        /**< block is a read-only mapping of the file */
 } baseer_target_t;
 
 /**
@@ -131,6 +197,10 @@ typedef bool (*baseer_callback_t)(baseer_target_t *, void *arg);
 
 /**
  * @brief Open a file in specified mode (memory, streaming, or both)
+ *
+ * In memory mode, files larger than BASEER_MAX_FILE_SIZE are mapped
+ * read-only instead of being copied, so multi-GB images only occupy the
+ * page cache.
  * 
  * @param file_path Path to the file
  * @param mode Access mode (MEMORY, STREAM, BOTH)
@@ -0,0 +1,128 @@
+/**
+ * @file bench_udis86.c
+ * @brief Compare ud_disassemble (Intel syntax) with ud_decode_only.
+ *
+ * Decodes the same code buffer with both entry points and prints the
+ * instructions per second of each. The buffer is the `.text` section of the
+ * given ELF file, or the whole file when it has no `.text`.
+ *
+ * Usage: bench_udis86 <file> [iterations] [32|64]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <elf.h>
+#include "udis86.h"
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Return a pointer to `.text` of an ELF64/ELF32 image, or the whole image.
+ */
+static const unsigned char *find_code(const unsigned char *data, size_t size, size_t *code_size)
+{
+    *code_size = size;
+    if (size < EI_NIDENT || memcmp(data, ELFMAG, SELFMAG) != 0) return data;
+
+    if (data[EI_CLASS] == ELFCLASS64 && size >= sizeof(Elf64_Ehdr)) {
+        const Elf64_Ehdr *elf = (const Elf64_Ehdr*)data;
+        if (elf->e_shoff + (size_t)elf->e_shnum * sizeof(Elf64_Shdr) > size || elf->e_shstrndx >= elf->e_shnum) return data;
+        const Elf64_Shdr *shdrs = (const Elf64_Shdr*)(data + elf->e_shoff);
+        const char *names = (const char*)data + shdrs[elf->e_shstrndx].sh_offset;
+        for (int i = 0; i < elf->e_shnum; i++) {
+            if (strcmp(names + shdrs[i].sh_name, ".text") == 0 && shdrs[i].sh_offset + shdrs[i].sh_size <= size) {
+                *code_size = shdrs[i].sh_size;
+                return data + shdrs[i].sh_offset;
+            }
+        }
+    } else if (data[EI_CLASS] == ELFCLASS32 && size >= sizeof(Elf32_Ehdr)) {
+        const Elf32_Ehdr *elf = (const Elf32_Ehdr*)data;
+        if (elf->e_shoff + (size_t)elf->e_shnum * sizeof(Elf32_Shdr) > size || elf->e_shstrndx >= elf->e_shnum) return data;
+        const Elf32_Shdr *shdrs = (const Elf32_Shdr*)(data + elf->e_shoff);
+        const char *names = (const char*)data + shdrs[elf->e_shstrndx].sh_offset;
+        for (int i = 0; i < elf->e_shnum; i++) {
+            if (strcmp(names + shdrs[i].sh_name, ".text") == 0 && shdrs[i].sh_offset + shdrs[i].sh_size <= size) {
+                *code_size = shdrs[i].sh_size;
+                return data + shdrs[i].sh_offset;
+            }
+        }
+    }
+    return data;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <file> [iterations] [32|64]\n", argv[0]);
+        return 1;
+    }
+    int iterations = (argc > 2) ? atoi(argv[2]) : 200;
+    int mode = (argc > 3) ? atoi(argv[3]) : 64;
+    if (iterations <= 0) iterations = 1;
+
+    FILE *fp = fopen(argv[1], "rb");
+    if (!fp) {
+        perror("fopen");
+        return 1;
+    }
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    unsigned char *data = malloc(size > 0 ? size : 1);
+    if (!data || fread(data, 1, size, fp) != (size_t)size) {
+        fprintf(stderr, "[!] Failed to read %s\n", argv[1]);
+        fclose(fp);
+        free(data);
+        return 1;
+    }
+    fclose(fp);
+
+    size_t code_size;
+    const unsigned char *code = find_code(data, size, &code_size);
+    ud_t u;
+    unsigned long long full_count = 0, fast_count = 0, checksum = 0;
+
+    // full disassembly with text output
+    double t0 = now_sec();
+    for (int it = 0; it < iterations; it++) {
+        ud_init(&u);
+        ud_set_mode(&u, mode);
+        ud_set_syntax(&u, UD_SYN_INTEL);
+        ud_set_input_buffer(&u, code, code_size);
+        while (ud_disassemble(&u)) {
+            checksum += ud_insn_asm(&u)[0];
+            full_count++;
+        }
+    }
+    double full_time = now_sec() - t0;
+
+    // decode-only
+    struct ud_insn_info info;
+    t0 = now_sec();
+    for (int it = 0; it < iterations; it++) {
+        ud_init(&u);
+        ud_set_mode(&u, mode);
+        ud_set_input_buffer(&u, code, code_size);
+        while (ud_decode_only(&u, &info)) {
+            checksum += info.mnemonic + info.target;
+            fast_count++;
+        }
+    }
+    double fast_time = now_sec() - t0;
+
+    printf("code bytes      : %zu x %d iterations\n", code_size, iterations);
+    printf("ud_disassemble  : %llu insns in %.3fs (%.2f M insn/s)\n",
+           full_count, full_time, full_count / full_time / 1e6);
+    printf("ud_decode_only  : %llu insns in %.3fs (%.2f M insn/s)\n",
+           fast_count, fast_time, fast_count / fast_time / 1e6);
+    printf("speedup         : %.2fx (checksum %llu)\n", full_time / fast_time, checksum);
+
+    free(data);
+    return 0;
+}
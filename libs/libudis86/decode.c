@@ -1261,6 +1261,50 @@ ud_decode(struct ud *u)
   return u->inp_ctr;
 }
 
+
+/* =============================================================================
+ * ud_decode_only
+ *    Decodes one instruction without running the syntax translator or
+ *    building the hex string. Fills in the length, mnemonic and, for
+ *    relative branches, the resolved target. Returns the number of bytes
+ *    decoded, zero at the end of input.
+ * =============================================================================
+ */
+unsigned int
+ud_decode_only(struct ud *u, struct ud_insn_info *info)
+{
+  unsigned int len;
+  const struct ud_operand *op;
+
+  if (u->inp_end) {
+    return 0;
+  }
+  len = ud_decode(u);
+  if (info == NULL) {
+    return len;
+  }
+
+  info->offset = u->insn_offset;
+  info->len = len;
+  info->mnemonic = u->mnemonic;
+  info->has_target = 0;
+  info->target = 0;
+
+  op = &u->operand[0];
+  if (op->type == UD_OP_JIMM) {
+    /* same arithmetic as ud_syn_rel_target(), pc already points past insn */
+    const uint64_t trunc_mask = 0xffffffffffffffffull >> (64 - u->opr_mode);
+    switch (op->size) {
+    case 8 : info->target = (u->pc + op->lval.sbyte)  & trunc_mask; break;
+    case 16: info->target = (u->pc + op->lval.sword)  & trunc_mask; break;
+    case 32: info->target = (u->pc + op->lval.sdword) & trunc_mask; break;
+    default: return len;
+    }
+    info->has_target = 1;
+  }
+  return len;
+}
+
 /*
 vim: set ts=2 sw=2 expandtab
 */
@@ -70,6 +70,8 @@ extern LIBUDIS86_DLLEXTERN unsigned int ud_decode(struct ud*);
 
 extern LIBUDIS86_DLLEXTERN unsigned int ud_disassemble(struct ud*);
 
+extern LIBUDIS86_DLLEXTERN unsigned int ud_decode_only(struct ud*, struct ud_insn_info*);
+
 extern LIBUDIS86_DLLEXTERN void ud_translate_intel(struct ud*);
 
 extern LIBUDIS86_DLLEXTERN void ud_translate_att(struct ud*);
@@ -235,6 +235,19 @@ struct ud
   struct ud_lookup_table_list_entry *le;
 };
 
+/* -----------------------------------------------------------------------------
+ * struct ud_insn_info - Result of a decode-only pass (no syntax translation).
+ * -----------------------------------------------------------------------------
+ */
+struct ud_insn_info
+{
+  uint64_t              offset;     /* program counter of the instruction */
+  unsigned int          len;        /* length in bytes */
+  enum ud_mnemonic_code mnemonic;
+  uint64_t              target;     /* branch target, valid if has_target */
+  uint8_t               has_target; /* 1 for relative jmp/jcc/call/loop */
+};
+
 /* -----------------------------------------------------------------------------
  * Type-definitions
  * -----------------------------------------------------------------------------
@@ -244,6 +257,7 @@ typedef enum ud_mnemonic_code ud_mnemonic_code_t;
 
 typedef struct ud             ud_t;
 typedef struct ud_operand     ud_operand_t;
+typedef struct ud_insn_info   ud_insn_info_t;
 
 #define UD_SYN_INTEL          ud_translate_intel
 #define UD_SYN_ATT            ud_translate_att
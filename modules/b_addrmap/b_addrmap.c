@@ -0,0 +1,167 @@
+/**
+ * @file b_addrmap.c
+ * @brief Sorted interval index for virtual address <-> file offset lookups.
+ *
+ * Intervals are appended while the headers are walked, then sorted once by
+ * b_addrmap_finalize(). Every entry also records the highest end address
+ * seen so far (`reach`), which keeps lookups correct when intervals overlap
+ * (e.g. TLS sections) while still costing O(log n) in the common case.
+ */
+#include "b_addrmap.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Append an interval, growing the array geometrically.
+ */
+static void intervals_push(b_intervals *set, const b_interval *item)
+{
+    if (set->count == set->cap) {
+        size_t cap = set->cap ? set->cap * 2 : 16;
+        b_interval *items = realloc(set->items, cap * sizeof(b_interval));
+        if (!items) return;
+        set->items = items;
+        set->cap = cap;
+    }
+    set->items[set->count++] = *item;
+}
+
+static int cmp_by_addr(const void *a, const void *b)
+{
+    const b_interval *x = a, *y = b;
+    if (x->addr != y->addr) return (x->addr < y->addr) ? -1 : 1;
+    return (x->size < y->size) ? -1 : (x->size > y->size);
+}
+
+static int cmp_by_off(const void *a, const void *b)
+{
+    const b_interval *x = a, *y = b;
+    if (x->off != y->off) return (x->off < y->off) ? -1 : 1;
+    return (x->filesz < y->filesz) ? -1 : (x->filesz > y->filesz);
+}
+
+static inline uint64_t key_start(const b_interval *it, bool by_off) { return by_off ? it->off : it->addr; }
+static inline uint64_t key_end(const b_interval *it, bool by_off)   { return by_off ? it->off + it->filesz : it->addr + it->size; }
+
+/**
+ * @brief Sort an interval array and compute the running `reach` values.
+ */
+static void intervals_sort(b_intervals *set, bool by_off)
+{
+    if (set->count == 0) return;
+    qsort(set->items, set->count, sizeof(b_interval), by_off ? cmp_by_off : cmp_by_addr);
+
+    uint64_t reach = 0;
+    for (size_t i = 0; i < set->count; i++) {
+        uint64_t end = key_end(&set->items[i], by_off);
+        if (end > reach) reach = end;
+        set->items[i].reach = reach;
+    }
+}
+
+/**
+ * @brief Find the interval containing `key`.
+ *
+ * Binary search for the last interval starting at or before `key`, then
+ * step back only while an earlier interval can still reach past `key`.
+ *
+ * @return Pointer to the containing interval, or NULL.
+ */
+static const b_interval *intervals_find(const b_intervals *set, uint64_t key, bool by_off)
+{
+    size_t lo = 0, hi = set->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (key_start(&set->items[mid], by_off) <= key) lo = mid + 1;
+        else hi = mid;
+    }
+
+    for (size_t i = lo; i > 0; i--) {
+        const b_interval *it = &set->items[i - 1];
+        if (it->reach <= key) break;
+        if (key < key_end(it, by_off)) return it;
+    }
+    return NULL;
+}
+
+/* ========================= Build ========================= */
+b_addrmap *b_addrmap_create(void)
+{
+    return calloc(1, sizeof(b_addrmap));
+}
+
+void b_addrmap_add_segment(b_addrmap *map, uint64_t addr, uint64_t memsz, uint64_t off, uint64_t filesz, int id)
+{
+    if (!map || (memsz == 0 && filesz == 0)) return;
+    b_interval it = {addr, (memsz > filesz) ? memsz : filesz, off, filesz, 0, id};
+    intervals_push(&map->segs, &it);
+    if (filesz > 0) intervals_push(&map->segs_off, &it);
+}
+
+void b_addrmap_add_section(b_addrmap *map, uint64_t addr, uint64_t size, uint64_t off, uint64_t filesz, int id, bool alloc)
+{
+    if (!map || size == 0) return;
+    b_interval it = {addr, size, off, filesz, 0, id};
+    // only sections loaded in memory have a meaningful address
+    if (alloc) intervals_push(&map->secs, &it);
+    if (filesz > 0) intervals_push(&map->secs_off, &it);
+}
+
+void b_addrmap_finalize(b_addrmap *map)
+{
+    if (!map) return;
+    intervals_sort(&map->segs, false);
+    intervals_sort(&map->segs_off, true);
+    intervals_sort(&map->secs, false);
+    intervals_sort(&map->secs_off, true);
+}
+
+/* ========================= Lookups ========================= */
+bool b_addrmap_va_to_off(const b_addrmap *map, uint64_t va, uint64_t *off, uint64_t *avail)
+{
+    if (!map) return false;
+    // files without a segment table (e.g. some firmware images) fall back to sections
+    const b_intervals *set = map->segs.count ? &map->segs : &map->secs;
+    const b_interval *it = intervals_find(set, va, false);
+    if (!it || va - it->addr >= it->filesz) return false;
+
+    if (off)   *off   = it->off + (va - it->addr);
+    if (avail) *avail = it->filesz - (va - it->addr);
+    return true;
+}
+
+bool b_addrmap_off_to_va(const b_addrmap *map, uint64_t off, uint64_t *va)
+{
+    if (!map) return false;
+    const b_intervals *set = map->segs.count ? &map->segs_off : &map->secs_off;
+    const b_interval *it = intervals_find(set, off, true);
+    if (!it) return false;
+
+    if (va) *va = it->addr + (off - it->off);
+    return true;
+}
+
+int b_addrmap_va_to_section(const b_addrmap *map, uint64_t va)
+{
+    if (!map) return -1;
+    const b_interval *it = intervals_find(&map->secs, va, false);
+    return it ? it->id : -1;
+}
+
+int b_addrmap_off_to_section(const b_addrmap *map, uint64_t off)
+{
+    if (!map) return -1;
+    const b_interval *it = intervals_find(&map->secs_off, off, true);
+    return it ? it->id : -1;
+}
+
+/* ========================= Free ========================= */
+void b_addrmap_free(b_addrmap *map)
+{
+    if (!map) return;
+    free(map->segs.items);
+    free(map->segs_off.items);
+    free(map->secs.items);
+    free(map->secs_off.items);
+    free(map);
+}
@@ -0,0 +1,62 @@
+/**
+ * @file b_addrmap.h
+ * @brief Virtual address <-> file offset translation layer.
+ *
+ * An address map is built once from the loadable segments and the sections
+ * of a binary. Both are kept as sorted interval arrays, so every lookup is a
+ * binary search instead of a walk over the header tables.
+ *
+ * The map itself knows nothing about a file format: ELF, PE, Mach-O or core
+ * files feed it with their own segments and sections.
+ */
+#ifndef B_ADDRMAP_H
+#define B_ADDRMAP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief One mapped interval (a segment or a section).
+ */
+typedef struct {
+    uint64_t addr;    /**< Start virtual address */
+    uint64_t size;    /**< Size in memory */
+    uint64_t off;     /**< File offset of the first byte */
+    uint64_t filesz;  /**< Bytes backed by the file (0 for NOBITS/bss) */
+    uint64_t reach;   /**< Highest end seen up to this entry (for overlaps) */
+    int id;           /**< Index in the format's own header table */
+} b_interval;
+
+/**
+ * @brief Sorted interval array.
+ */
+typedef struct {
+    b_interval *items;
+    size_t count;
+    size_t cap;
+} b_intervals;
+
+/**
+ * @brief Address map of a binary.
+ */
+typedef struct {
+    b_intervals segs;      /**< Loadable segments sorted by virtual address */
+    b_intervals segs_off;  /**< Loadable segments sorted by file offset */
+    b_intervals secs;      /**< Allocated sections sorted by virtual address */
+    b_intervals secs_off;  /**< All sections with file contents sorted by file offset */
+} b_addrmap;
+
+b_addrmap *b_addrmap_create(void);
+void b_addrmap_add_segment(b_addrmap *map, uint64_t addr, uint64_t memsz, uint64_t off, uint64_t filesz, int id);
+void b_addrmap_add_section(b_addrmap *map, uint64_t addr, uint64_t size, uint64_t off, uint64_t filesz, int id, bool alloc);
+void b_addrmap_finalize(b_addrmap *map);
+
+bool b_addrmap_va_to_off(const b_addrmap *map, uint64_t va, uint64_t *off, uint64_t *avail);
+bool b_addrmap_off_to_va(const b_addrmap *map, uint64_t off, uint64_t *va);
+int  b_addrmap_va_to_section(const b_addrmap *map, uint64_t va);
+int  b_addrmap_off_to_section(const b_addrmap *map, uint64_t off);
+
+void b_addrmap_free(b_addrmap *map);
+
+#endif
@@ -0,0 +1,549 @@
+/**
+ * @file b_carve.c
+ * @brief Sweep an image for embedded ELF, tar, zip, PNG and PDF files.
+ */
+#define _GNU_SOURCE
+#include "b_carve.h"
+#include "../binhead/bx_binhead.h"
+#include <elf.h>
+#include <pthread.h>
+#include <time.h>
+
+// ========================= BEGIN HELPERS ==================================
+/**
+ * @brief Parse a tar numeric field (octal, or base-256 when the high bit is set).
+ */
+static uint64_t tar_number(const unsigned char *p, size_t len)
+{
+    uint64_t v = 0;
+    if (p[0] & 0x80) {
+        for (size_t i = 1; i < len; i++) v = v << 8 | p[i];
+        return v;
+    }
+    size_t i = 0;
+    while (i < len && p[i] == ' ') i++;
+    for (; i < len && p[i] >= '0' && p[i] <= '7'; i++) v = v * 8 + (p[i] - '0');
+    return v;
+}
+// ========================= END HELPERS ==================================
+
+// ========================= BEGIN FORMATS ==================================
+static bool elf_check(const unsigned char *p, size_t avail)
+{
+    if (avail < sizeof(Elf32_Ehdr)) return false;
+    if (p[EI_CLASS] != ELFCLASS32 && p[EI_CLASS] != ELFCLASS64) return false;
+    if (p[EI_DATA] != ELFDATA2LSB && p[EI_DATA] != ELFDATA2MSB) return false;
+    if (p[EI_VERSION] != EV_CURRENT) return false;
+
+    bool be = p[EI_DATA] == ELFDATA2MSB;
+    bool is64 = p[EI_CLASS] == ELFCLASS64;
+    if (is64 && avail < sizeof(Elf64_Ehdr)) return false;
+    uint16_t type = rd16_endian(p + 16, be);
+    uint16_t ehsize = rd16_endian(p + (is64 ? 52 : 40), be);
+    if (type < ET_REL || type > ET_CORE) return false;
+    return ehsize == (is64 ? sizeof(Elf64_Ehdr) : sizeof(Elf32_Ehdr));
+}
+
+static const char *elf_machine_name(uint16_t machine)
+{
+    switch (machine) {
+    case EM_386:     return "x86";
+    case EM_X86_64:  return "x86-64";
+    case EM_ARM:     return "ARM";
+    case EM_AARCH64: return "AArch64";
+    case EM_MIPS:    return "MIPS";
+    case EM_PPC:     return "PowerPC";
+    case EM_PPC64:   return "PowerPC64";
+    case EM_RISCV:   return "RISC-V";
+    default:         return NULL;
+    }
+}
+
+/**
+ * @brief The end of an ELF file is the end of its section header table or
+ * of its last segment, whichever comes later.
+ */
+static uint64_t elf_measure(bparser *slice, char *info, size_t info_len)
+{
+    const unsigned char *p = slice->block;
+    size_t avail = slice->size;
+    bool be = p[EI_DATA] == ELFDATA2MSB;
+    bool is64 = p[EI_CLASS] == ELFCLASS64;
+
+    uint16_t type = rd16_endian(p + 16, be);
+    uint16_t machine = rd16_endian(p + 18, be);
+    uint64_t phoff = is64 ? rd64_endian(p + 32, be) : rd32_endian(p + 28, be);
+    uint64_t shoff = is64 ? rd64_endian(p + 40, be) : rd32_endian(p + 32, be);
+    uint16_t phentsize = rd16_endian(p + (is64 ? 54 : 42), be);
+    uint16_t phnum = rd16_endian(p + (is64 ? 56 : 44), be);
+    uint16_t shentsize = rd16_endian(p + (is64 ? 58 : 46), be);
+    uint16_t shnum = rd16_endian(p + (is64 ? 60 : 48), be);
+
+    uint64_t end = is64 ? sizeof(Elf64_Ehdr) : sizeof(Elf32_Ehdr);
+    if (shoff && shoff + (uint64_t)shnum * shentsize > end)
+        end = shoff + (uint64_t)shnum * shentsize;
+    if (phoff && phentsize >= (is64 ? sizeof(Elf64_Phdr) : sizeof(Elf32_Phdr)) &&
+        phoff + (uint64_t)phnum * phentsize <= avail) {
+        for (uint16_t i = 0; i < phnum; i++) {
+            const unsigned char *ph = p + phoff + (uint64_t)i * phentsize;
+            uint64_t off = is64 ? rd64_endian(ph + 8, be) : rd32_endian(ph + 4, be);
+            uint64_t filesz = is64 ? rd64_endian(ph + 32, be) : rd32_endian(ph + 16, be);
+            if (off + filesz > end) end = off + filesz;
+        }
+    }
+
+    static const char *types[] = {"NONE", "REL", "EXEC", "DYN", "CORE"};
+    const char *mname = elf_machine_name(machine);
+    char mbuf[24];
+    if (!mname) {
+        snprintf(mbuf, sizeof(mbuf), "machine %u", machine);
+        mname = mbuf;
+    }
+    snprintf(info, info_len, "ELF%d %s %s %s%s", is64 ? 64 : 32, be ? "MSB" : "LSB", mname,
+             types[type], end > avail ? " (truncated)" : "");
+    return end > avail ? avail : end;
+}
+
+static bool tar_header_valid(const unsigned char *p)
+{
+    uint64_t stored = tar_number(p + 148, 8);
+    uint64_t sum = 0;
+    for (int i = 0; i < 512; i++)
+        sum += (i >= 148 && i < 156) ? ' ' : p[i];
+    return sum == stored;
+}
+
+static bool tar_check(const unsigned char *p, size_t avail)
+{
+    return avail >= 512 && tar_header_valid(p);
+}
+
+/**
+ * @brief Walk the member headers up to the end-of-archive blocks.
+ */
+static uint64_t tar_measure(bparser *slice, char *info, size_t info_len)
+{
+    const unsigned char *p = slice->block;
+    size_t avail = slice->size;
+    uint64_t pos = 0, members = 0;
+
+    while (pos + 512 <= avail) {
+        const unsigned char *hdr = p + pos;
+        if (hdr[0] == '\0') {
+            // end-of-archive: two zero blocks
+            pos += 1024;
+            break;
+        }
+        if (!tar_header_valid(hdr)) break;
+        uint64_t size = tar_number(hdr + 124, 12);
+        pos += 512 + ((size + 511) & ~(uint64_t)511);
+        members++;
+    }
+    snprintf(info, info_len, "tar, %llu members%s", (unsigned long long)members,
+             pos > avail ? " (truncated)" : "");
+    return pos > avail ? avail : pos;
+}
+
+static bool zip_check(const unsigned char *p, size_t avail)
+{
+    if (avail < 30) return false;
+    uint16_t version = rd16le(p + 4);
+    uint16_t method = rd16le(p + 8);
+    uint16_t name_len = rd16le(p + 26);
+    if ((version & 0xff) > 63 || method > 99) return false;
+    return name_len > 0 && name_len <= 1024 && 30 + (size_t)name_len <= avail;
+}
+
+/**
+ * @brief Skip the data of a member written with a data descriptor.
+ *
+ * The sizes in such a local header may be zero, so the data ends at the
+ * first `PK\7\8` descriptor whose compressed size is its distance from the
+ * start of the data (32-bit or zip64 sizes).
+ *
+ * @return Offset after the descriptor, 0 if there is none.
+ */
+static uint64_t zip_skip_descriptor(const unsigned char *p, size_t avail, uint64_t data)
+{
+    for (uint64_t at = data; at < avail; at++) {
+        const unsigned char *d = memmem(p + at, avail - at, "PK\x07\x08", 4);
+        if (!d) return 0;
+        at = d - p;
+        uint64_t csize = at - data;
+        if (at + 16 <= avail && rd32le(d + 8) == csize) return at + 16;
+        if (at + 24 <= avail && rd64le(d + 8) == csize) return at + 24;
+    }
+    return 0;
+}
+
+/**
+ * @brief Compressed size of a local header, from its zip64 extra field if needed.
+ */
+static uint64_t zip_local_csize(const unsigned char *h, const unsigned char *extra, uint16_t extra_len)
+{
+    uint64_t csize = rd32le(h + 18);
+    if (csize != 0xffffffff) return csize;
+    for (const unsigned char *x = extra; x + 4 <= extra + extra_len; x += 4 + rd16le(x + 2)) {
+        // a local zip64 field holds both sizes, the uncompressed one first
+        if (rd16le(x) == 0x0001 && rd16le(x + 2) >= 16 && x + 20 <= extra + extra_len)
+            return rd64le(x + 12);
+    }
+    return csize;
+}
+
+/**
+ * @brief A zip ends with the end-of-central-directory record that follows
+ * its central directory.
+ *
+ * A stored member may itself be a zip, so the first `PK\5\6` in the data
+ * proves nothing: the local headers are walked to the central directory,
+ * then its entries and the zip64 records, and the end record is only
+ * searched for in the CARVE_ZIP_TAIL bytes after them.
+ */
+static uint64_t zip_measure(bparser *slice, char *info, size_t info_len)
+{
+    const unsigned char *p = slice->block;
+    size_t avail = slice->size;
+    uint16_t name_len = rd16le(p + 26);
+    int shown = name_len > 40 ? 40 : name_len;
+    uint64_t pos = 0, entries = 0;
+
+    while (pos + 30 <= avail && memcmp(p + pos, "PK\x03\x04", 4) == 0) {
+        const unsigned char *h = p + pos;
+        uint16_t extra_len = rd16le(h + 28);
+        uint64_t data = pos + 30 + rd16le(h + 26) + extra_len;
+        if (data > avail) break;
+        if (rd16le(h + 6) & 8) {
+            pos = zip_skip_descriptor(p, avail, data);
+            if (!pos) break;
+        } else {
+            uint64_t csize = zip_local_csize(h, p + data - extra_len, extra_len);
+            if (csize > avail - data) break;
+            pos = data + csize;
+        }
+    }
+    while (pos + 46 <= avail && memcmp(p + pos, "PK\x01\x02", 4) == 0) {
+        pos += 46 + (uint64_t)rd16le(p + pos + 28) + rd16le(p + pos + 30) + rd16le(p + pos + 32);
+        entries++;
+    }
+    if (pos + 12 <= avail && memcmp(p + pos, "PK\x06\x06", 4) == 0 && rd64le(p + pos + 4) <= avail - pos - 12)
+        pos += 12 + rd64le(p + pos + 4);
+    if (pos + 20 <= avail && memcmp(p + pos, "PK\x06\x07", 4) == 0)
+        pos += 20;
+
+    const unsigned char *eocd = NULL;
+    if (entries && pos < avail)
+        eocd = memmem(p + pos, avail - pos < CARVE_ZIP_TAIL ? avail - pos : CARVE_ZIP_TAIL, "PK\x05\x06", 4);
+    if (!eocd || (size_t)(eocd - p) + 22 > avail) {
+        snprintf(info, info_len, "zip, first: %.*s (no end of central directory)", shown, p + 30);
+        return avail;
+    }
+    uint64_t end = (eocd - p) + 22 + rd16le(eocd + 20);
+    snprintf(info, info_len, "zip, %llu entries, first: %.*s", (unsigned long long)entries, shown, p + 30);
+    return end > avail ? avail : end;
+}
+
+static bool png_check(const unsigned char *p, size_t avail)
+{
+    if (avail < 33) return false;
+    if (rd32be(p + 8) != 13 || memcmp(p + 12, "IHDR", 4) != 0) return false;
+    uint32_t width = rd32be(p + 16), height = rd32be(p + 20);
+    uint8_t depth = p[24], color = p[25];
+    if (width == 0 || height == 0 || width > 0x7fffffff || height > 0x7fffffff) return false;
+    if (depth != 1 && depth != 2 && depth != 4 && depth != 8 && depth != 16) return false;
+    return color == 0 || color == 2 || color == 3 || color == 4 || color == 6;
+}
+
+/**
+ * @brief Walk the chunks up to IEND.
+ */
+static uint64_t png_measure(bparser *slice, char *info, size_t info_len)
+{
+    const unsigned char *p = slice->block;
+    size_t avail = slice->size;
+    uint64_t pos = 8;
+    bool complete = false;
+
+    while (pos + 12 <= avail) {
+        uint32_t len = rd32be(p + pos);
+        bool iend = memcmp(p + pos + 4, "IEND", 4) == 0;
+        pos += 12 + (uint64_t)len;
+        if (iend) {
+            complete = true;
+            break;
+        }
+    }
+    snprintf(info, info_len, "PNG, %ux%u, depth %u, color type %u%s", rd32be(p + 16),
+             rd32be(p + 20), p[24], p[25], complete && pos <= avail ? "" : " (truncated)");
+    return pos > avail ? avail : pos;
+}
+
+static bool pdf_check(const unsigned char *p, size_t avail)
+{
+    return avail >= 8 && isdigit(p[5]) && p[6] == '.' && isdigit(p[7]);
+}
+
+/**
+ * @brief End of a `%%EOF` marker, with its line break.
+ */
+static uint64_t pdf_eof_end(const unsigned char *p, size_t avail, const unsigned char *eof)
+{
+    uint64_t end = (eof - p) + 5;
+    while (end < avail && (p[end] == '\r' || p[end] == '\n')) end++;
+    return end;
+}
+
+/**
+ * @brief A PDF ends after the `%%EOF` of its last revision.
+ *
+ * Incremental updates append objects, a new xref section and another
+ * `startxref ... %%EOF` trailer per revision, so a later `%%EOF` still
+ * belongs to the file when its `startxref` sits just before it and no new
+ * `%PDF-` header starts in between.
+ */
+static uint64_t pdf_measure(bparser *slice, char *info, size_t info_len)
+{
+    const unsigned char *p = slice->block;
+    size_t avail = slice->size;
+    const unsigned char *eof = memmem(p, avail, "%%EOF", 5);
+    if (!eof) {
+        snprintf(info, info_len, "PDF, version %c.%c (truncated)", p[5], p[7]);
+        return avail;
+    }
+
+    uint64_t end = pdf_eof_end(p, avail, eof);
+    unsigned revisions = 1;
+    while ((eof = memmem(p + end, avail - end, "%%EOF", 5)) != NULL) {
+        size_t gap = eof - (p + end);
+        size_t tail = gap > CARVE_PDF_TRAILER ? CARVE_PDF_TRAILER : gap;
+        if (!memmem(eof - tail, tail, "startxref", 9) || memmem(p + end, gap, "%PDF-", 5)) break;
+        end = pdf_eof_end(p, avail, eof);
+        revisions++;
+    }
+    if (revisions > 1)
+        snprintf(info, info_len, "PDF, version %c.%c, %u revisions", p[5], p[7], revisions);
+    else
+        snprintf(info, info_len, "PDF, version %c.%c", p[5], p[7]);
+    return end;
+}
+
+static const carve_sig_t carve_sigs[] = {
+    {"ELF", "\x7f" "ELF",              4, 0,   elf_check, elf_measure},
+    {"TAR", "ustar",                   5, 257, tar_check, tar_measure},
+    {"ZIP", "PK\x03\x04",              4, 0,   zip_check, zip_measure},
+    {"PNG", "\x89PNG\r\n\x1a\n",       8, 0,   png_check, png_measure},
+    {"PDF", "%PDF-",                   5, 0,   pdf_check, pdf_measure},
+};
+#define CARVE_SIG_COUNT (sizeof(carve_sigs) / sizeof(carve_sigs[0]))
+// ========================= END FORMATS ==================================
+
+// ========================= BEGIN SWEEP ==================================
+typedef struct {
+    const unsigned char *data;
+    size_t size;
+    size_t chunk_count;
+    size_t next_chunk;   /**< Next chunk to pick up (atomic) */
+    size_t hits;         /**< Hits kept so far (atomic) */
+    bool overflow;
+} carve_job_t;
+
+typedef struct {
+    carve_job_t *job;
+    carve_hit_t *items;
+    size_t count;
+    size_t cap;
+} carve_worker_t;
+
+static void worker_push(carve_worker_t *w, uint64_t off, uint32_t sig)
+{
+    if (__atomic_fetch_add(&w->job->hits, 1, __ATOMIC_RELAXED) >= CARVE_MAX_HITS) {
+        w->job->overflow = true;
+        return;
+    }
+    if (w->count == w->cap) {
+        size_t cap = w->cap ? w->cap * 2 : 64;
+        carve_hit_t *items = realloc(w->items, cap * sizeof(*items));
+        if (!items) return;
+        w->items = items;
+        w->cap = cap;
+    }
+    w->items[w->count++] = (carve_hit_t){off, sig};
+}
+
+/**
+ * @brief Find the validated signatures whose magic starts in a chunk.
+ */
+static void *carve_worker(void *arg)
+{
+    carve_worker_t *w = arg;
+    carve_job_t *job = w->job;
+    const unsigned char *data = job->data;
+
+    for (;;) {
+        size_t c = __atomic_fetch_add(&job->next_chunk, 1, __ATOMIC_RELAXED);
+        if (c >= job->chunk_count) break;
+
+        size_t start = c * CARVE_CHUNK_SIZE;
+        size_t stop = start + CARVE_CHUNK_SIZE;
+        if (stop > job->size) stop = job->size;
+
+        // one pass per signature; the chunk stays in cache between passes
+        for (uint32_t s = 0; s < CARVE_SIG_COUNT; s++) {
+            const carve_sig_t *sig = &carve_sigs[s];
+            const unsigned char *q = data + start, *end = data + stop;
+            while (q < end && (q = memchr(q, (unsigned char)sig->magic[0], end - q)) != NULL) {
+                size_t pos = q - data;
+                q++;
+                if (pos < sig->magic_pos || pos + sig->magic_len > job->size) continue;
+                if (memcmp(data + pos + 1, sig->magic + 1, sig->magic_len - 1) != 0) continue;
+                size_t off = pos - sig->magic_pos;
+                if (sig->check(data + off, job->size - off))
+                    worker_push(w, off, s);
+            }
+        }
+    }
+    return NULL;
+}
+
+static int cmp_hit(const void *a, const void *b)
+{
+    const carve_hit_t *x = a, *y = b;
+    if (x->off != y->off) return x->off < y->off ? -1 : 1;
+    return (x->sig > y->sig) - (x->sig < y->sig);
+}
+// ========================= END SWEEP ==================================
+
+// ========================= BEGIN CARVE ==================================
+#define CARVE_MAX_DEPTH 16
+
+/**
+ * @brief Run the flags that follow `--carve` on every carved payload.
+ *
+ * Each payload is a zero-copy slice of the image dispatched through
+ * bx_binhead, as if it had been opened on its own.
+ *
+ * @return false if no flag follows `--carve`.
+ */
+static bool carve_analyze(bparser *parser, inputs *input, const carve_hit_t *items, const uint64_t *sizes, size_t count)
+{
+    int argc = *input->argc, at = 2;
+    while (at < argc && strcmp("--carve", input->args[at]) != 0) at++;
+    if (at + 1 >= argc) return false;
+
+    // <prog> <file> <flags after --carve...>
+    int sub_argc;
+    inputs sub;
+    char **args = baseer_sub_args(input, at + 1, &sub_argc, &sub);
+    if (!args) return false;
+
+    char name[32];
+    sub.member = name;
+    for (size_t i = 0; i < count; i++) {
+        bparser *slice = bparser_slice(parser, items[i].off, sizes[i]);
+        if (!slice) continue;
+        snprintf(name, sizeof(name), "0x%llx", (unsigned long long)items[i].off);
+        printf(COLOR_BLUE "\n=== %s at 0x%llx (0x%llx bytes) ===\n" COLOR_RESET, carve_sigs[items[i].sig].name,
+               (unsigned long long)items[i].off, (unsigned long long)sizes[i]);
+        bx_binhead_dispatch(slice, &sub);
+        free(slice);
+    }
+    free(args);
+    return true;
+}
+
+/**
+ * @brief Sweep an image for embedded files and list them.
+ *
+ * Flags after `--carve` (e.g. `--carve -m`) are applied to every carved
+ * payload.
+ *
+ * @param parser Pointer to a bparser structure containing the image.
+ * @param arg    Pointer to the command-line inputs.
+ * @return true on success, false if the image is not in memory.
+ */
+bool b_carve(bparser *parser, void *arg)
+{
+    if (!parser || !parser->block) return false;
+
+    carve_job_t job = {
+        .data = parser->block, .size = parser->size,
+        .chunk_count = (parser->size + CARVE_CHUNK_SIZE - 1) / CARVE_CHUNK_SIZE,
+    };
+
+    int threads = get_thread_count();
+    if ((size_t)threads > job.chunk_count) threads = job.chunk_count ? (int)job.chunk_count : 1;
+    carve_worker_t workers[BASEER_MAX_THREADS] = {0};
+    pthread_t tids[BASEER_MAX_THREADS];
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int t = 0; t < threads; t++) {
+        workers[t].job = &job;
+        if (t > 0 && pthread_create(&tids[t], NULL, carve_worker, &workers[t]) != 0) {
+            threads = t;
+            break;
+        }
+    }
+    carve_worker(&workers[0]);
+    for (int t = 1; t < threads; t++)
+        pthread_join(tids[t], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double seconds = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+    size_t total = 0;
+    for (int t = 0; t < threads; t++) total += workers[t].count;
+    carve_hit_t *hits = malloc((total ? total : 1) * sizeof(*hits));
+    size_t n = 0;
+    for (int t = 0; t < threads; t++) {
+        if (hits && workers[t].count) memcpy(hits + n, workers[t].items, workers[t].count * sizeof(*hits));
+        n += workers[t].count;
+        free(workers[t].items);
+    }
+    if (!hits) n = 0;
+    qsort(hits, n, sizeof(*hits), cmp_hit);
+
+    printf(COLOR_BLUE "\n=== Carved Files ===\n" COLOR_RESET);
+    uint64_t *sizes = malloc((n ? n : 1) * sizeof(*sizes));
+    if (!sizes) n = 0;
+    struct { uint64_t end; uint32_t sig; } stack[CARVE_MAX_DEPTH];
+    int depth = 0;
+    size_t carved = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t off = hits[i].off;
+        while (depth > 0 && stack[depth - 1].end <= off) depth--;
+
+        bool inner = false;
+        for (int d = 0; d < depth; d++)
+            if (stack[d].sig == hits[i].sig) inner = true;
+        if (inner) continue;
+
+        const carve_sig_t *sig = &carve_sigs[hits[i].sig];
+        bparser *slice = bparser_slice(parser, off, parser->size - off);
+        if (!slice) continue;
+        char info[CARVE_INFO_LEN];
+        uint64_t size = sig->measure(slice, info, sizeof(info));
+        free(slice);
+
+        printf("%*s" COLOR_YELLOW "|----0x%08llx:  " COLOR_RESET COLOR_CYAN "%-4s" COLOR_RESET
+               " size 0x%-10llx %s\n", depth * 4, "", (unsigned long long)off, sig->name,
+               (unsigned long long)size, info);
+        // compact the accepted payloads at the front of hits
+        hits[carved] = hits[i];
+        sizes[carved++] = size;
+        if (depth < CARVE_MAX_DEPTH) {
+            stack[depth].end = off + size;
+            stack[depth].sig = hits[i].sig;
+            depth++;
+        }
+    }
+
+    if (job.overflow)
+        fprintf(stderr, COLOR_RED "[!] More than %d signature hits, the rest were dropped\n" COLOR_RESET, CARVE_MAX_HITS);
+    printf(COLOR_GREEN "\nSwept " COLOR_RESET "%zu bytes in %.3f s (%.2f GB/s, %d threads), %zu files carved\n",
+           parser->size, seconds, seconds > 0 ? parser->size / seconds / 1e9 : 0.0, threads, carved);
+
+    carve_analyze(parser, arg, hits, sizes, carved);
+    free(sizes);
+    free(hits);
+    return true;
+}
+// ========================= END CARVE ==================================
@@ -0,0 +1,73 @@
+/**
+ * @file b_carve.h
+ * @brief Embedded file carving (`--carve`).
+ *
+ * The whole image is swept for the signature of every registered format
+ * (ELF, tar, zip, PNG, PDF), not only at the fixed offsets checked by
+ * bx_binhead. Every signature is located with memchr() on its first magic
+ * byte, the rest of the magic is compared, and the candidate is validated
+ * with the header sanity check of its format.
+ *
+ * The image is split into chunks swept in parallel; workers only keep the
+ * validated hits, so memory does not grow with the image (large images are
+ * mapped by baseer_open()). The hits are then sorted, measured and
+ * described by their format handler on a sub-range parser. Hits inside an
+ * already carved payload of the same format (tar headers, zip local
+ * headers) belong to it and are not reported again.
+ *
+ * Flags given after `--carve` are run on every payload through
+ * bx_binhead_dispatch() on a bparser_slice() of the image.
+ */
+#ifndef B_CARVE_H
+#define B_CARVE_H
+#include "../bparser/bparser.h"
+#include "../../baseer.h"
+#include <stdint.h>
+
+#define CARVE_CHUNK_SIZE (4 * 1024 * 1024)
+#define CARVE_MAX_HITS   (1 << 20)   /**< Validated hits kept before giving up */
+#define CARVE_INFO_LEN   96
+#define CARVE_PDF_TRAILER 1024   /**< Bytes before a later `%%EOF` searched for its `startxref` */
+#define CARVE_ZIP_TAIL   (64 * 1024 + 22)   /**< Bytes after a central directory searched for its end record */
+
+/**
+ * @brief Header sanity check of a format.
+ *
+ * @param p     Start of the candidate payload.
+ * @param avail Bytes available from p to the end of the image.
+ * @return true if the header is plausible.
+ */
+typedef bool (*carve_check_t)(const unsigned char *p, size_t avail);
+
+/**
+ * @brief Measure a validated payload and describe it.
+ *
+ * @param slice Parser over the payload, from its start to the end of the image.
+ * @param info  Receives a one-line description.
+ * @return Size of the payload (at most slice->size).
+ */
+typedef uint64_t (*carve_measure_t)(bparser *slice, char *info, size_t info_len);
+
+/**
+ * @brief A registered signature.
+ */
+typedef struct {
+    const char *name;
+    const char *magic;
+    size_t magic_len;
+    size_t magic_pos;        /**< Offset of the magic in the payload */
+    carve_check_t check;
+    carve_measure_t measure;
+} carve_sig_t;
+
+/**
+ * @brief One validated hit.
+ */
+typedef struct {
+    uint64_t off;            /**< Start of the payload */
+    uint32_t sig;            /**< Index in the signature table */
+} carve_hit_t;
+
+bool b_carve(bparser *parser, void *arg);
+
+#endif
@@ -0,0 +1,160 @@
+/**
+ * @file b_crc32.c
+ * @brief Slice-by-8 and carry-less multiply CRC-32 kernels.
+ */
+#include "b_crc32.h"
+#include <stdlib.h>
+#include <string.h>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#define CRC32_POLY 0xedb88320u   /**< Reflected 0x04c11db7 */
+
+// ========================= BEGIN SLICE-BY-8 ==================================
+static uint32_t crc_tables[8][256];
+
+__attribute__((constructor))
+static void crc32_init_tables(void)
+{
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) c = (c >> 1) ^ (CRC32_POLY & (0u - (c & 1)));
+        crc_tables[0][i] = c;
+    }
+    // table k advances a byte through k more zero bytes
+    for (uint32_t i = 0; i < 256; i++)
+        for (int t = 1; t < 8; t++)
+            crc_tables[t][i] = (crc_tables[t - 1][i] >> 8) ^ crc_tables[0][crc_tables[t - 1][i] & 0xff];
+}
+
+/**
+ * @brief Slice-by-8 on the inverted CRC state.
+ */
+static uint32_t crc32_slice8(uint32_t c, const unsigned char *p, size_t len)
+{
+    for (; len && ((uintptr_t)p & 7); len--)
+        c = (c >> 8) ^ crc_tables[0][(c ^ *p++) & 0xff];
+    for (; len >= 8; len -= 8, p += 8) {
+        uint32_t lo, hi;
+        memcpy(&lo, p, 4);
+        memcpy(&hi, p + 4, 4);
+        lo ^= c;   // little-endian: the CRC covers the first four bytes
+        c = crc_tables[7][lo & 0xff] ^ crc_tables[6][(lo >> 8) & 0xff] ^
+            crc_tables[5][(lo >> 16) & 0xff] ^ crc_tables[4][lo >> 24] ^
+            crc_tables[3][hi & 0xff] ^ crc_tables[2][(hi >> 8) & 0xff] ^
+            crc_tables[1][(hi >> 16) & 0xff] ^ crc_tables[0][hi >> 24];
+    }
+    while (len--)
+        c = (c >> 8) ^ crc_tables[0][(c ^ *p++) & 0xff];
+    return c;
+}
+
+uint32_t b_crc32_table(uint32_t crc, const void *data, size_t len)
+{
+    return ~crc32_slice8(~crc, data, len);
+}
+// ========================= END SLICE-BY-8 ==================================
+
+// ========================= BEGIN PCLMUL ==================================
+#if defined(__x86_64__)
+/**
+ * @brief Fold a multiple of 16 bytes (at least 64) with PCLMULQDQ.
+ *
+ * Constants are x^(k) mod P for the fold distances (512+64, 512, 128+64,
+ * 128, 64 bits) and the Barrett pair (P', mu), all bit-reflected.
+ */
+__attribute__((target("pclmul,sse4.1")))
+static uint32_t crc32_pclmul(uint32_t c, const unsigned char *p, size_t len)
+{
+    const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+    const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124);
+    const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+
+    __m128i x1 = _mm_loadu_si128((const __m128i*)(p + 0x00));
+    __m128i x2 = _mm_loadu_si128((const __m128i*)(p + 0x10));
+    __m128i x3 = _mm_loadu_si128((const __m128i*)(p + 0x20));
+    __m128i x4 = _mm_loadu_si128((const __m128i*)(p + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)c));
+    p += 64;
+    len -= 64;
+
+    // four independent lanes hide the multiply latency
+    while (len >= 64) {
+        __m128i x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+        __m128i x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+        __m128i x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+        __m128i x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i*)(p + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i*)(p + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i*)(p + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i*)(p + 0x30)));
+        p += 64;
+        len -= 64;
+    }
+
+    // fold the lanes into one, then the remaining 16-byte blocks
+    __m128i lanes[3] = {x2, x3, x4};
+    for (int i = 0; i < 3; i++) {
+        __m128i x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, lanes[i]), x5);
+    }
+    for (; len >= 16; p += 16, len -= 16) {
+        __m128i x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i*)p)), x5);
+    }
+
+    // 128 -> 64 bits
+    __m128i x2r = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2r);
+    x2r = _mm_srli_si128(x1, 4);
+    x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k5k0, 0x00);
+    x1 = _mm_xor_si128(x1, x2r);
+
+    // Barrett reduction to 32 bits
+    x2r = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), poly, 0x10);
+    x2r = _mm_clmulepi64_si128(_mm_and_si128(x2r, mask32), poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2r);
+    return (uint32_t)_mm_extract_epi32(x1, 1);
+}
+
+static bool have_pclmul(void)
+{
+    static int cached = -1;
+    if (cached < 0)
+        cached = __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1") && !getenv("BASEER_NO_PCLMUL");
+    return cached;
+}
+#endif
+// ========================= END PCLMUL ==================================
+
+uint32_t b_crc32(uint32_t crc, const void *data, size_t len)
+{
+    const unsigned char *p = data;
+    uint32_t c = ~crc;
+#if defined(__x86_64__)
+    if (len >= 64 && have_pclmul()) {
+        size_t bulk = len & ~(size_t)15;
+        c = crc32_pclmul(c, p, bulk);
+        p += bulk;
+        len -= bulk;
+    }
+#endif
+    return ~crc32_slice8(c, p, len);
+}
+
+const char *b_crc32_kernel(void)
+{
+#if defined(__x86_64__)
+    if (have_pclmul()) return "pclmul";
+#endif
+    return "slice-by-8";
+}
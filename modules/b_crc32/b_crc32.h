@@ -0,0 +1,35 @@
+/**
+ * @file b_crc32.h
+ * @brief CRC-32 (IEEE 802.3, as used by PNG, zip and gzip).
+ *
+ * Two kernels compute the same value:
+ * - slice-by-8: eight 256-entry tables, eight input bytes per step;
+ * - PCLMULQDQ folding (x86-64): four 128-bit lanes folded with carry-less
+ *   multiplies, then a Barrett reduction. It is used for buffers of 64
+ *   bytes or more when the CPU supports it, unless `BASEER_NO_PCLMUL` is set.
+ */
+#ifndef B_CRC32_H
+#define B_CRC32_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Update a CRC-32 with len bytes (start with crc = 0).
+ *
+ * Compatible with zlib's crc32(): b_crc32(b_crc32(0, a, n), b, m) is the
+ * CRC of a followed by b.
+ */
+uint32_t b_crc32(uint32_t crc, const void *data, size_t len);
+
+/**
+ * @brief Same as b_crc32(), always with the slice-by-8 kernel.
+ */
+uint32_t b_crc32_table(uint32_t crc, const void *data, size_t len);
+
+/**
+ * @brief Name of the kernel b_crc32() uses for large buffers.
+ */
+const char *b_crc32_kernel(void);
+
+#endif
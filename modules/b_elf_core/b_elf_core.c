@@ -0,0 +1,577 @@
+/**
+ * @file b_elf_core.c
+ * @brief Core dump notes, process memory and symbolization.
+ */
+#include "b_elf_core.h"
+#include <elf.h>
+#include <signal.h>
+
+#define CORE_MAX_NOTES (64u * 1024 * 1024)
+
+/**
+ * @brief Register layout of NT_PRSTATUS for one machine.
+ */
+typedef struct {
+    uint16_t machine;
+    const char *const *names;
+    int nregs;
+    int pc, sp, fp;             /**< Indexes in names */
+} core_arch_t;
+
+static const char *const regs_x86_64[] = {
+    "r15", "r14", "r13", "r12", "rbp", "rbx", "r11", "r10", "r9", "r8", "rax", "rcx", "rdx", "rsi",
+    "rdi", "orig_rax", "rip", "cs", "eflags", "rsp", "ss", "fs_base", "gs_base", "ds", "es", "fs", "gs"};
+static const char *const regs_i386[] = {
+    "ebx", "ecx", "edx", "esi", "edi", "ebp", "eax", "ds", "es", "fs", "gs", "orig_eax", "eip", "cs",
+    "eflags", "esp", "ss"};
+static const char *const regs_aarch64[] = {
+    "x0", "x1", "x2", "x3", "x4", "x5", "x6", "x7", "x8", "x9", "x10", "x11", "x12", "x13", "x14", "x15", "x16",
+    "x17", "x18", "x19", "x20", "x21", "x22", "x23", "x24", "x25", "x26", "x27", "x28", "x29", "x30", "sp", "pc",
+    "pstate"};
+static const char *const regs_arm[] = {
+    "r0", "r1", "r2", "r3", "r4", "r5", "r6", "r7", "r8", "r9", "r10", "fp", "ip", "sp", "lr", "pc", "cpsr",
+    "orig_r0"};
+
+static const core_arch_t core_archs[] = {
+    {EM_X86_64, regs_x86_64, 27, 16, 19, 4},
+    {EM_386, regs_i386, 17, 12, 15, 5},
+    {EM_AARCH64, regs_aarch64, 34, 32, 31, 29},
+    {EM_ARM, regs_arm, 18, 15, 13, 11},
+};
+
+static const core_arch_t *core_arch(uint16_t machine)
+{
+    for (size_t i = 0; i < sizeof(core_archs) / sizeof(core_archs[0]); i++)
+        if (core_archs[i].machine == machine) return &core_archs[i];
+    return NULL;
+}
+
+/**
+ * @brief Read a native word (4 or 8 bytes) of the core.
+ */
+static uint64_t word(const core_file_t *core, const unsigned char *p)
+{
+    return core->cls == ELFCLASS64 ? rd64le(p) : rd32le(p);
+}
+
+static bool grow(void **items, size_t count, size_t *cap, size_t elem)
+{
+    if (count < *cap) return true;
+    size_t n = *cap ? *cap * 2 : 8;
+    void *tmp = realloc(*items, n * elem);
+    if (!tmp) return false;
+    *items = tmp, *cap = n;
+    return true;
+}
+
+// ========================= BEGIN NOTES ==================================
+static void note_prstatus(core_file_t *core, const unsigned char *desc, uint32_t size, size_t *cap)
+{
+    // 64-bit: 8-byte sigpend/sighold and timevals, registers at 112; 32-bit: at 72
+    size_t w = core->cls == ELFCLASS64 ? 8 : 4;
+    size_t pid_off = core->cls == ELFCLASS64 ? 32 : 24, reg_off = core->cls == ELFCLASS64 ? 112 : 72;
+    if (size < pid_off + 8 || !grow((void **)&core->threads, core->nthreads, cap, sizeof(core_thread_t))) return;
+
+    core_thread_t *t = &core->threads[core->nthreads++];
+    memset(t, 0, sizeof(*t));
+    t->signo = desc[12] | desc[13] << 8;          // pr_cursig
+    t->pid = rd32le(desc + pid_off);
+    t->ppid = rd32le(desc + pid_off + 4);
+    const core_arch_t *arch = core_arch(core->machine);
+    if (!arch) return;
+    for (int i = 0; i < arch->nregs && reg_off + (i + 1) * w <= size; i++) {
+        t->regs[i] = word(core, desc + reg_off + i * w);
+        t->nregs = i + 1;
+    }
+}
+
+static void note_prpsinfo(core_file_t *core, const unsigned char *desc, uint32_t size)
+{
+    size_t fname = core->cls == ELFCLASS64 ? 40 : 28;
+    if (size < fname + 16 + 80) return;
+    memcpy(core->fname, desc + fname, 16);
+    memcpy(core->psargs, desc + fname + 16, 80);
+    core->fname[16] = core->psargs[80] = '\0';
+}
+
+static void note_siginfo(core_file_t *core, const unsigned char *desc, uint32_t size)
+{
+    size_t addr = core->cls == ELFCLASS64 ? 16 : 12;
+    if (size < addr + (core->cls == ELFCLASS64 ? 8 : 4)) return;
+    core->fault_signo = (int)rd32le(desc);
+    core->fault_addr = word(core, desc + addr);
+    core->has_fault = core->fault_signo == SIGSEGV || core->fault_signo == SIGBUS || core->fault_signo == SIGILL ||
+                      core->fault_signo == SIGFPE || core->fault_signo == SIGTRAP;
+}
+
+static void note_auxv(core_file_t *core, const unsigned char *desc, uint32_t size)
+{
+    size_t w = core->cls == ELFCLASS64 ? 8 : 4, n = size / (2 * w);
+    free(core->auxv);
+    core->auxv = calloc(n ? n : 1, sizeof(*core->auxv));
+    core->nauxv = 0;
+    if (!core->auxv) return;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t type = word(core, desc + 2 * w * i);
+        if (type == AT_NULL) break;
+        core->auxv[core->nauxv++] = (core_auxv_t){type, word(core, desc + 2 * w * i + w)};
+    }
+}
+
+static int cmp_mapping(const void *a, const void *b)
+{
+    const core_mapping_t *x = a, *y = b;
+    return (x->start > y->start) - (x->start < y->start);
+}
+
+/**
+ * @brief NT_FILE: count and page size, count (start, end, page offset)
+ * triples, then count NUL-terminated paths.
+ */
+static void note_file(core_file_t *core, const unsigned char *desc, uint32_t size)
+{
+    size_t w = core->cls == ELFCLASS64 ? 8 : 4;
+    if (size < 2 * w) return;
+    uint64_t count = word(core, desc), page = word(core, desc + w);
+    if (count > (size - 2 * w) / (3 * w)) return;
+    free(core->files);
+    core->files = calloc(count ? count : 1, sizeof(*core->files));
+    core->nfiles = 0;
+    if (!core->files) return;
+
+    const unsigned char *entry = desc + 2 * w;
+    const char *path = (const char *)entry + count * 3 * w, *end = (const char *)desc + size;
+    for (uint64_t i = 0; i < count && path < end; i++, entry += 3 * w) {
+        const char *nul = memchr(path, '\0', end - path);
+        if (!nul) break;
+        core->files[core->nfiles++] = (core_mapping_t){word(core, entry), word(core, entry + w),
+                                                       word(core, entry + 2 * w) * page, path};
+        path = nul + 1;
+    }
+    qsort(core->files, core->nfiles, sizeof(*core->files), cmp_mapping);
+}
+
+/**
+ * @brief Walk the notes of one PT_NOTE segment (4-byte aligned in cores).
+ */
+static void parse_notes(core_file_t *core, const unsigned char *p, uint64_t size, size_t *cap)
+{
+    const unsigned char *end = p + size;
+    while (end - p >= 12) {
+        uint32_t namesz = rd32le(p), descsz = rd32le(p + 4), type = rd32le(p + 8);
+        uint64_t name_len = ((uint64_t)namesz + 3) & ~3ull, desc_len = ((uint64_t)descsz + 3) & ~3ull;
+        if (name_len > (uint64_t)(end - p - 12) || descsz > (uint64_t)(end - p - 12) - name_len) break;
+        const char *name = (const char *)p + 12;
+        const unsigned char *desc = p + 12 + name_len;
+        // the core notes are owned by "CORE" (NT_FILE too), extended register sets by "LINUX"
+        if (namesz == 5 && memcmp(name, "CORE", 5) == 0) {
+            switch (type) {
+            case NT_PRSTATUS: note_prstatus(core, desc, descsz, cap); break;
+            case NT_PRPSINFO: note_prpsinfo(core, desc, descsz); break;
+            case NT_SIGINFO:  note_siginfo(core, desc, descsz); break;
+            case NT_AUXV:     note_auxv(core, desc, descsz); break;
+            case NT_FILE:     note_file(core, desc, descsz); break;
+            default: break;
+            }
+        }
+        if (desc_len > (uint64_t)(end - desc)) break;
+        p = desc + desc_len;
+    }
+}
+// ========================= END NOTES ==================================
+
+// ========================= BEGIN MEMORY ==================================
+static const core_mapping_t *find_mapping(const core_file_t *core, uint64_t va)
+{
+    size_t lo = 0, hi = core->nfiles;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (core->files[mid].start <= va) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo == 0 || va >= core->files[lo - 1].end) return NULL;
+    return &core->files[lo - 1];
+}
+
+static uint64_t auxv_value(const core_file_t *core, uint64_t type, bool *found)
+{
+    for (size_t i = 0; i < core->nauxv; i++)
+        if (core->auxv[i].type == type) {
+            if (found) *found = true;
+            return core->auxv[i].value;
+        }
+    if (found) *found = false;
+    return 0;
+}
+
+size_t core_read(const core_file_t *core, uint64_t va, void *buf, size_t len)
+{
+    size_t done = 0;
+    while (done < len) {
+        uint64_t off, avail, cur = va + done;
+        size_t want = len - done;
+        if (b_addrmap_va_to_off(core->map, cur, &off, &avail)) {
+            if (want > avail) want = (size_t)avail;
+            size_t n = bparser_read(core->parser, (char *)buf + done, off, want);
+            done += n;
+            if (n < want) break;
+            continue;
+        }
+        // not dumped (file pages the kernel skipped): the executable still has them
+        const core_mapping_t *m = find_mapping(core, cur);
+        if (!m || !core->exe.parser || strcmp(m->path, core->exe.mapped) != 0) break;
+        uint64_t foff = m->file_off + (cur - m->start);
+        if (foff >= core->exe.parser->size) break;
+        if (want > m->end - cur) want = (size_t)(m->end - cur);
+        if (want > core->exe.parser->size - foff) want = (size_t)(core->exe.parser->size - foff);
+        size_t n = bparser_read(core->exe.parser, (char *)buf + done, foff, want);
+        done += n;
+        if (n < want) break;
+    }
+    return done;
+}
+
+static int cmp_region_va(const void *a, const void *b)
+{
+    const elf_region_t *x = a, *y = b;
+    return (x->vaddr > y->vaddr) - (x->vaddr < y->vaddr);
+}
+
+/**
+ * @brief Open the executable and load its function symbols. The load bias
+ * is AT_ENTRY minus the link-time entry point.
+ */
+static void load_exe(core_file_t *core, const char *path)
+{
+    core_exe_t *exe = &core->exe;
+    bool have_entry;
+    uint64_t entry = auxv_value(core, AT_ENTRY, &have_entry);
+    const core_mapping_t *m = have_entry ? find_mapping(core, entry) : NULL;
+    if (!path && !m) return;
+    if (!path) path = m->path;
+    exe->target = baseer_open((char *)path, BASEER_MODE_MEMORY);
+    if (!exe->target || exe->target->size < sizeof(Elf64_Ehdr) || memcmp(exe->target->block, ELFMAG, SELFMAG) != 0 ||
+        !(exe->parser = bparser_load(exe->target))) {
+        fprintf(stderr, COLOR_YELLOW "[!] Cannot load the executable %s, use --exe <path>\n" COLOR_RESET, path);
+        baseer_close(exe->target);
+        exe->target = NULL;
+        return;
+    }
+    exe->path = path;
+    exe->mapped = m ? m->path : path;
+    const unsigned char *data = exe->parser->block;
+    uint64_t e_entry = data[EI_CLASS] == ELFCLASS64 ? rd64le(data + 24) : rd32le(data + 24);
+    exe->bias = have_entry ? entry - e_entry : 0;
+    exe->map = elf_build_addrmap(exe->parser);
+    exe->funcs = elf_functions(exe->parser, exe->map, &exe->nfuncs);
+    if (exe->funcs) qsort(exe->funcs, exe->nfuncs, sizeof(*exe->funcs), cmp_region_va);
+}
+
+const char *core_symbolize(const core_file_t *core, uint64_t va, char *buf, size_t size)
+{
+    const core_exe_t *exe = &core->exe;
+    if (exe->nfuncs) {
+        uint64_t rel = va - exe->bias;
+        size_t lo = 0, hi = exe->nfuncs;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (exe->funcs[mid].vaddr <= rel) lo = mid + 1;
+            else hi = mid;
+        }
+        if (lo && rel - exe->funcs[lo - 1].vaddr < exe->funcs[lo - 1].size) {
+            const elf_region_t *f = &exe->funcs[lo - 1];
+            snprintf(buf, size, "%s+0x%llx", f->name, (unsigned long long)(rel - f->vaddr));
+            return buf;
+        }
+    }
+    const core_mapping_t *m = find_mapping(core, va);
+    if (!m) return NULL;
+    const char *base = strrchr(m->path, '/');
+    snprintf(buf, size, "%s+0x%llx", base ? base + 1 : m->path, (unsigned long long)(m->file_off + va - m->start));
+    return buf;
+}
+// ========================= END MEMORY ==================================
+
+core_file_t *core_open(bparser *parser, const char *exe_path)
+{
+    unsigned char ident[EI_NIDENT];
+    if (bparser_read(parser, ident, 0, sizeof(ident)) != sizeof(ident) || memcmp(ident, ELFMAG, SELFMAG) != 0)
+        return NULL;
+    if (ident[EI_DATA] != ELFDATA2LSB) {
+        fprintf(stderr, COLOR_RED "[!] Big-endian cores are not supported\n" COLOR_RESET);
+        return NULL;
+    }
+
+    uint64_t phoff;
+    uint32_t phnum;
+    uint16_t type, machine, phentsize;
+    if (ident[EI_CLASS] == ELFCLASS64) {
+        Elf64_Ehdr eh;
+        if (bparser_read(parser, &eh, 0, sizeof(eh)) != sizeof(eh)) return NULL;
+        type = eh.e_type, machine = eh.e_machine, phoff = eh.e_phoff, phnum = eh.e_phnum, phentsize = eh.e_phentsize;
+        if (phnum == PN_XNUM && eh.e_shoff) {
+            // more than 0xfffe segments: the real count is in section 0
+            Elf64_Shdr sh0;
+            if (bparser_read(parser, &sh0, eh.e_shoff, sizeof(sh0)) == sizeof(sh0)) phnum = sh0.sh_info;
+        }
+    } else if (ident[EI_CLASS] == ELFCLASS32) {
+        Elf32_Ehdr eh;
+        if (bparser_read(parser, &eh, 0, sizeof(eh)) != sizeof(eh)) return NULL;
+        type = eh.e_type, machine = eh.e_machine, phoff = eh.e_phoff, phnum = eh.e_phnum, phentsize = eh.e_phentsize;
+        if (phnum == PN_XNUM && eh.e_shoff) {
+            Elf32_Shdr sh0;
+            if (bparser_read(parser, &sh0, eh.e_shoff, sizeof(sh0)) == sizeof(sh0)) phnum = sh0.sh_info;
+        }
+    } else {
+        return NULL;
+    }
+    size_t phsize = ident[EI_CLASS] == ELFCLASS64 ? sizeof(Elf64_Phdr) : sizeof(Elf32_Phdr);
+    if (type != ET_CORE || phentsize != phsize || phoff > parser->size ||
+        (uint64_t)phnum * phsize > parser->size - phoff)
+        return NULL;
+
+    core_file_t *core = calloc(1, sizeof(*core));
+    unsigned char *phdrs = malloc(phnum ? (size_t)phnum * phsize : 1);
+    if (!core || !phdrs || bparser_read(parser, phdrs, phoff, (size_t)phnum * phsize) != (size_t)phnum * phsize ||
+        !(core->map = b_addrmap_create())) {
+        free(phdrs);
+        if (core) b_addrmap_free(core->map);
+        free(core);
+        return NULL;
+    }
+    core->parser = parser;
+    core->cls = ident[EI_CLASS];
+    core->machine = machine;
+
+    // notes are copied (they are small), memory stays in the file
+    uint64_t notes_size = 0;
+    size_t cap = 0;
+    for (uint32_t pass = 0; pass < 2; pass++) {
+        uint64_t pos = 0;
+        for (uint32_t i = 0; i < phnum; i++) {
+            uint32_t p_type;
+            uint64_t off, vaddr, filesz, memsz;
+            if (core->cls == ELFCLASS64) {
+                Elf64_Phdr ph;
+                memcpy(&ph, phdrs + i * phsize, sizeof(ph));
+                p_type = ph.p_type, off = ph.p_offset, vaddr = ph.p_vaddr, filesz = ph.p_filesz, memsz = ph.p_memsz;
+            } else {
+                Elf32_Phdr ph;
+                memcpy(&ph, phdrs + i * phsize, sizeof(ph));
+                p_type = ph.p_type, off = ph.p_offset, vaddr = ph.p_vaddr, filesz = ph.p_filesz, memsz = ph.p_memsz;
+            }
+            if (off > parser->size || filesz > parser->size - off) filesz = off > parser->size ? 0 : parser->size - off;
+            if (pass == 0 && p_type == PT_LOAD) {
+                b_addrmap_add_segment(core->map, vaddr, memsz, off, filesz, (int)i);
+                core->nloads++;
+            } else if (pass == 0 && p_type == PT_NOTE) {
+                notes_size += filesz;
+            } else if (pass == 1 && p_type == PT_NOTE && filesz && core->notes) {
+                unsigned char *p = core->notes + pos;
+                size_t n = bparser_read(parser, p, off, (size_t)filesz);
+                parse_notes(core, p, n, &cap);
+                pos += filesz;
+            }
+        }
+        if (pass == 0) {
+            if (notes_size > CORE_MAX_NOTES) {
+                fprintf(stderr, COLOR_RED "[!] Notes too large: " COLOR_RESET "%llu bytes\n",
+                        (unsigned long long)notes_size);
+                notes_size = 0;
+            }
+            core->notes = malloc(notes_size ? notes_size : 1);
+        }
+    }
+    free(phdrs);
+    b_addrmap_finalize(core->map);
+    load_exe(core, exe_path);
+    return core;
+}
+
+void core_close(core_file_t *core)
+{
+    if (!core) return;
+    b_addrmap_free(core->map);
+    free(core->threads);
+    free(core->files);
+    free(core->auxv);
+    free(core->notes);
+    free(core->exe.funcs);
+    b_addrmap_free(core->exe.map);
+    free(core->exe.parser);
+    baseer_close(core->exe.target);
+    free(core);
+}
+
+// ========================= BEGIN COMMANDS ==================================
+static const char *auxv_name(uint64_t type)
+{
+    switch (type) {
+    case AT_PHDR:          return "AT_PHDR";
+    case AT_PHENT:         return "AT_PHENT";
+    case AT_PHNUM:         return "AT_PHNUM";
+    case AT_PAGESZ:        return "AT_PAGESZ";
+    case AT_BASE:          return "AT_BASE";
+    case AT_FLAGS:         return "AT_FLAGS";
+    case AT_ENTRY:         return "AT_ENTRY";
+    case AT_UID:           return "AT_UID";
+    case AT_EUID:          return "AT_EUID";
+    case AT_GID:           return "AT_GID";
+    case AT_EGID:          return "AT_EGID";
+    case AT_PLATFORM:      return "AT_PLATFORM";
+    case AT_HWCAP:         return "AT_HWCAP";
+    case AT_CLKTCK:        return "AT_CLKTCK";
+    case AT_SECURE:        return "AT_SECURE";
+    case AT_BASE_PLATFORM: return "AT_BASE_PLATFORM";
+    case AT_RANDOM:        return "AT_RANDOM";
+    case AT_HWCAP2:        return "AT_HWCAP2";
+    case AT_EXECFN:        return "AT_EXECFN";
+    case AT_SYSINFO:       return "AT_SYSINFO";
+    case AT_SYSINFO_EHDR:  return "AT_SYSINFO_EHDR";
+    case 51:               return "AT_MINSIGSTKSZ";
+    default:               return NULL;
+    }
+}
+
+/**
+ * @brief Print a NUL-terminated string of process memory (AT_EXECFN...).
+ */
+static void print_core_string(const core_file_t *core, uint64_t va)
+{
+    char s[256];
+    size_t n = core_read(core, va, s, sizeof(s) - 1);
+    s[n] = '\0';
+    if (n) printf(" \"%s\"", s);
+}
+
+static void print_thread(const core_file_t *core, const core_thread_t *t, size_t index)
+{
+    const core_arch_t *arch = core_arch(core->machine);
+    char sym[256];
+    int width = core->cls == ELFCLASS64 ? 16 : 8;
+    printf(COLOR_BLUE "\n=== Thread %zu (pid %u) ===\n" COLOR_RESET, index + 1, t->pid);
+    if (t->signo) printf(COLOR_GREEN "|--signal    :" COLOR_RESET " %d (%s)\n", t->signo, strsignal(t->signo));
+    if (!arch || t->nregs < arch->nregs) {
+        printf(COLOR_YELLOW "|--registers : not decoded for this machine\n" COLOR_RESET);
+        return;
+    }
+
+    uint64_t pc = t->regs[arch->pc], sp = t->regs[arch->sp], fp = t->regs[arch->fp];
+    const char *where = core_symbolize(core, pc, sym, sizeof(sym));
+    printf(COLOR_GREEN "|--%-10s:" COLOR_RESET " 0x%0*llx%s%s\n", arch->names[arch->pc], width, (unsigned long long)pc,
+           where ? " " : "", where ? where : "");
+    for (int i = 0; i < arch->nregs; i++) {
+        printf("%s" COLOR_CYAN "%-9s" COLOR_RESET "0x%0*llx", i % 3 ? "  " : "|  ", arch->names[i], width,
+               (unsigned long long)t->regs[i]);
+        if (i % 3 == 2 || i == arch->nregs - 1) printf("\n");
+    }
+
+    unsigned char code[CORE_CODE_BYTES];
+    size_t n = core_read(core, pc, code, sizeof(code));
+    if (n && (core->machine == EM_X86_64 || core->machine == EM_386)) {
+        printf(COLOR_GREEN "|--code at %s:\n" COLOR_RESET, arch->names[arch->pc]);
+        print_disasm(code, n, pc, core->cls);
+    } else if (!n) {
+        printf(COLOR_YELLOW "|--code at %s: not in the core\n" COLOR_RESET, arch->names[arch->pc]);
+    }
+
+    size_t w = core->cls == ELFCLASS64 ? 8 : 4;
+    unsigned char stack[CORE_STACK_WORDS * 8];
+    n = core_read(core, sp, stack, CORE_STACK_WORDS * w) / w;
+    printf(COLOR_GREEN "|--stack at %s (%zu words):\n" COLOR_RESET, arch->names[arch->sp], n);
+    for (size_t i = 0; i < n; i++) {
+        uint64_t addr = sp + i * w, value = word(core, stack + i * w);
+        where = core_symbolize(core, value, sym, sizeof(sym));
+        printf("|    0x%0*llx: 0x%0*llx%s" COLOR_YELLOW "%s" COLOR_RESET "%s\n", width, (unsigned long long)addr,
+               width, (unsigned long long)value, where ? " " : "", where ? where : "", addr == fp ? " <- frame" : "");
+    }
+}
+
+static void core_report(const core_file_t *core)
+{
+    char sym[256];
+    printf(COLOR_BLUE "\n=== Core Dump ===\n" COLOR_RESET);
+    if (*core->fname)
+        printf(COLOR_GREEN "|--command   :" COLOR_RESET " %s (%s)\n", core->fname, core->psargs);
+    printf(COLOR_GREEN "|--machine   :" COLOR_RESET " %s, %d-bit\n", elf_machine_to_str(core->machine),
+           core->cls == ELFCLASS64 ? 64 : 32);
+    printf(COLOR_GREEN "|--threads   :" COLOR_RESET " %zu\n", core->nthreads);
+    printf(COLOR_GREEN "|--segments  :" COLOR_RESET " %zu PT_LOAD\n", core->nloads);
+    if (core->has_fault) {
+        const char *where = core_symbolize(core, core->fault_addr, sym, sizeof(sym));
+        printf(COLOR_RED "|--fault     :" COLOR_RESET " %s at 0x%llx%s%s\n", strsignal(core->fault_signo),
+               (unsigned long long)core->fault_addr, where ? " " : "", where ? where : "");
+    }
+    if (core->exe.parser)
+        printf(COLOR_GREEN "|--executable:" COLOR_RESET " %s (bias 0x%llx, %zu functions)\n", core->exe.path,
+               (unsigned long long)core->exe.bias, core->exe.nfuncs);
+
+    for (size_t i = 0; i < core->nthreads; i++) print_thread(core, &core->threads[i], i);
+
+    printf(COLOR_BLUE "\n=== Mapped Files (%zu) ===\n" COLOR_RESET, core->nfiles);
+    for (size_t i = 0; i < core->nfiles; i++) {
+        const core_mapping_t *m = &core->files[i];
+        printf(COLOR_GREEN "|--" COLOR_RESET "0x%012llx-0x%012llx  off 0x%08llx  %s\n", (unsigned long long)m->start,
+               (unsigned long long)m->end, (unsigned long long)m->file_off, m->path);
+    }
+
+    printf(COLOR_BLUE "\n=== Auxiliary Vector (%zu) ===\n" COLOR_RESET, core->nauxv);
+    for (size_t i = 0; i < core->nauxv; i++) {
+        const core_auxv_t *a = &core->auxv[i];
+        const char *name = auxv_name(a->type);
+        if (name) printf(COLOR_GREEN "|--%-16s" COLOR_RESET " 0x%llx", name, (unsigned long long)a->value);
+        else printf(COLOR_GREEN "|--%-16llu" COLOR_RESET " 0x%llx", (unsigned long long)a->type,
+                    (unsigned long long)a->value);
+        if (a->type == AT_EXECFN || a->type == AT_PLATFORM || a->type == AT_BASE_PLATFORM)
+            print_core_string(core, a->value);
+        printf("\n");
+    }
+}
+
+/**
+ * @brief Open the core for one of the commands, with the `--exe` option.
+ */
+static core_file_t *open_for(bparser *parser, void *arg)
+{
+    core_file_t *core = core_open(parser, baseer_get_opt(arg, "--exe"));
+    if (!core) fprintf(stderr, COLOR_RED "[!] Not an ELF core file\n" COLOR_RESET);
+    return core;
+}
+
+bool b_elf_core(bparser *parser, void *arg)
+{
+    core_file_t *core = open_for(parser, arg);
+    if (!core) return false;
+    core_report(core);
+    core_close(core);
+    return true;
+}
+
+bool b_elf_core_read(bparser *parser, void *arg)
+{
+    const char *range = baseer_get_opt(arg, "--read");
+    uint64_t start, end;
+    if (!range || !parse_vaddr_range(range, &start, &end)) {
+        fprintf(stderr, COLOR_RED "[!] Invalid range (use <vaddr>:<vaddr|+len>): " COLOR_RESET "%s\n",
+                range ? range : "");
+        return false;
+    }
+    if (end - start > CORE_MAX_READ) end = start + CORE_MAX_READ;
+    core_file_t *core = open_for(parser, arg);
+    if (!core) return false;
+
+    unsigned char *buf = malloc(end - start);
+    size_t n = buf ? core_read(core, start, buf, end - start) : 0;
+    char sym[256];
+    const char *where = core_symbolize(core, start, sym, sizeof(sym));
+    printf(COLOR_BLUE "\n=== Memory 0x%llx-0x%llx ===\n" COLOR_RESET, (unsigned long long)start,
+           (unsigned long long)end);
+    if (where) printf(COLOR_GREEN "|--at        :" COLOR_RESET " %s\n", where);
+    if (n) print_body_bytes(buf, n, start, 0, core->cls);
+    if (n < end - start)
+        fprintf(stderr, COLOR_YELLOW "[!] Not in the core from 0x%llx\n" COLOR_RESET, (unsigned long long)(start + n));
+    free(buf);
+    core_close(core);
+    return true;
+}
+// ========================= END COMMANDS ==================================
@@ -0,0 +1,127 @@
+/**
+ * @file b_elf_core.h
+ * @brief ELF core dumps (ET_CORE): threads, mapped files and memory.
+ *
+ * Only the program headers and the PT_NOTE segments are parsed. The memory
+ * of the process is the set of PT_LOAD segments, put in an address map so
+ * a virtual address is read with one binary search; large cores are mapped
+ * by baseer_open(), so only the pages actually read are touched.
+ *
+ * Notes decoded:
+ * - NT_PRSTATUS: one per thread, signal, pid and registers (x86-64, i386,
+ *   AArch64 and ARM register layouts).
+ * - NT_PRPSINFO: command name and arguments.
+ * - NT_SIGINFO:  faulting address.
+ * - NT_AUXV:     auxiliary vector (AT_ENTRY locates the executable).
+ * - NT_FILE:     file-backed mappings.
+ *
+ * Addresses are symbolized against the executable (from `--exe`, or its
+ * NT_FILE path), relocated by the AT_ENTRY bias, and as file+offset in any
+ * other mapping. Memory the kernel did not dump (read-only file pages) is
+ * read from the executable instead.
+ *
+ * Options (read from the command line):
+ * - `--core`                          Process, threads with registers and stack, mappings, auxv.
+ * - `--read <vaddr>:<vaddr|+len>`     Hex dump of process memory.
+ * - `--exe <path>`                    Executable to symbolize against.
+ */
+#ifndef B_ELF_CORE_H
+#define B_ELF_CORE_H
+#include "../bparser/bparser.h"
+#include "../../baseer.h"
+#include "../b_addrmap/b_addrmap.h"
+#include "../bx_elf_utils/bx_elf_utils.h"
+#include <stdint.h>
+
+#define CORE_MAX_REGS     34    /**< AArch64: x0-x30, sp, pc, pstate */
+#define CORE_STACK_WORDS  32    /**< Stack words printed per thread */
+#define CORE_CODE_BYTES   32    /**< Bytes disassembled at the program counter */
+#define CORE_MAX_READ     (16u * 1024 * 1024)
+
+/**
+ * @brief One thread (one NT_PRSTATUS note).
+ */
+typedef struct {
+    uint32_t pid, ppid;
+    int signo;                  /**< Signal that stopped the thread (pr_cursig) */
+    uint64_t regs[CORE_MAX_REGS];
+    int nregs;
+} core_thread_t;
+
+/**
+ * @brief One NT_FILE entry.
+ */
+typedef struct {
+    uint64_t start, end;
+    uint64_t file_off;          /**< Offset in the mapped file */
+    const char *path;           /**< Points into the note */
+} core_mapping_t;
+
+typedef struct {
+    uint64_t type, value;
+} core_auxv_t;
+
+/**
+ * @brief Symbols of the executable, used to name addresses.
+ */
+typedef struct {
+    baseer_target_t *target;
+    bparser *parser;
+    b_addrmap *map;
+    elf_region_t *funcs;        /**< Sorted by virtual address */
+    size_t nfuncs;
+    uint64_t bias;              /**< Load address - link address */
+    const char *path;
+    const char *mapped;         /**< NT_FILE path of the executable */
+} core_exe_t;
+
+/**
+ * @brief A parsed core file.
+ */
+typedef struct {
+    bparser *parser;
+    unsigned char cls;          /**< ELFCLASS32 or ELFCLASS64 */
+    uint16_t machine;
+    b_addrmap *map;             /**< PT_LOAD segments */
+    size_t nloads;
+    core_thread_t *threads;
+    size_t nthreads;
+    core_mapping_t *files;
+    size_t nfiles;
+    core_auxv_t *auxv;
+    size_t nauxv;
+    char fname[17];             /**< NT_PRPSINFO */
+    char psargs[81];
+    bool has_fault;
+    int fault_signo;
+    uint64_t fault_addr;        /**< NT_SIGINFO si_addr */
+    unsigned char *notes;       /**< Copy of the note segments */
+    core_exe_t exe;
+} core_file_t;
+
+/**
+ * @brief Parse the program headers and notes of a core file.
+ *
+ * @param exe_path Executable to symbolize against, NULL to use the NT_FILE path.
+ * @return The core (free with core_close()), NULL if it is not an ELF core.
+ */
+core_file_t *core_open(bparser *parser, const char *exe_path);
+void core_close(core_file_t *core);
+
+/**
+ * @brief Read process memory at a virtual address.
+ *
+ * @return Bytes read, less than len where the memory is not in the core
+ *         (nor in the executable).
+ */
+size_t core_read(const core_file_t *core, uint64_t va, void *buf, size_t len);
+
+/**
+ * @brief Name an address ("main+0x12", "libc.so.6+0x29d90"), NULL if unknown.
+ */
+const char *core_symbolize(const core_file_t *core, uint64_t va, char *buf, size_t size);
+
+bool b_elf_core(bparser *parser, void *arg);
+bool b_elf_core_read(bparser *parser, void *arg);
+
+#endif
@@ -0,0 +1,809 @@
+/**
+ * @file b_elf_dwarf.c
+ * @brief DWARF line tables, decoded per compile unit and searched by address.
+ */
+#include "b_elf_dwarf.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ===== BEGIN DWARF CONSTANTS =====
+#define DW_AT_stmt_list             0x10
+
+#define DW_UT_compile               0x01
+#define DW_UT_partial               0x03
+#define DW_UT_skeleton              0x04
+#define DW_UT_split_compile         0x05
+
+#define DW_FORM_addr                0x01
+#define DW_FORM_block2              0x03
+#define DW_FORM_block4              0x04
+#define DW_FORM_data2               0x05
+#define DW_FORM_data4               0x06
+#define DW_FORM_data8               0x07
+#define DW_FORM_string              0x08
+#define DW_FORM_block               0x09
+#define DW_FORM_block1              0x0a
+#define DW_FORM_data1               0x0b
+#define DW_FORM_flag                0x0c
+#define DW_FORM_sdata               0x0d
+#define DW_FORM_strp                0x0e
+#define DW_FORM_udata               0x0f
+#define DW_FORM_ref_addr            0x10
+#define DW_FORM_ref1                0x11
+#define DW_FORM_ref2                0x12
+#define DW_FORM_ref4                0x13
+#define DW_FORM_ref8                0x14
+#define DW_FORM_ref_udata           0x15
+#define DW_FORM_indirect            0x16
+#define DW_FORM_sec_offset          0x17
+#define DW_FORM_exprloc             0x18
+#define DW_FORM_flag_present        0x19
+#define DW_FORM_strx                0x1a
+#define DW_FORM_addrx               0x1b
+#define DW_FORM_ref_sup4            0x1c
+#define DW_FORM_strp_sup            0x1d
+#define DW_FORM_data16              0x1e
+#define DW_FORM_line_strp           0x1f
+#define DW_FORM_ref_sig8            0x20
+#define DW_FORM_implicit_const      0x21
+#define DW_FORM_loclistx            0x22
+#define DW_FORM_rnglistx            0x23
+#define DW_FORM_ref_sup8            0x24
+#define DW_FORM_strx1               0x25
+#define DW_FORM_strx2               0x26
+#define DW_FORM_strx3               0x27
+#define DW_FORM_strx4               0x28
+#define DW_FORM_addrx1              0x29
+#define DW_FORM_addrx2              0x2a
+#define DW_FORM_addrx3              0x2b
+#define DW_FORM_addrx4              0x2c
+#define DW_FORM_GNU_addr_index      0x1f01
+#define DW_FORM_GNU_str_index       0x1f02
+#define DW_FORM_GNU_ref_alt         0x1f20
+#define DW_FORM_GNU_strp_alt        0x1f21
+
+#define DW_LNCT_path                0x1
+#define DW_LNCT_directory_index     0x2
+
+#define DW_LNS_copy                 0x01
+#define DW_LNS_advance_pc           0x02
+#define DW_LNS_advance_line         0x03
+#define DW_LNS_set_file             0x04
+#define DW_LNS_const_add_pc         0x08
+#define DW_LNS_fixed_advance_pc     0x09
+
+#define DW_LNE_end_sequence         0x01
+#define DW_LNE_set_address          0x02
+#define DW_LNE_define_file          0x03
+
+#define DWARF_NO_FILE               UINT32_MAX
+// ===== END DWARF CONSTANTS =====
+
+// ===== BEGIN READER =====
+/**
+ * @brief Bounds-checked reader. Reading past the end sets `bad` and
+ * returns zeros, so a decoder checks once after a group of reads.
+ */
+typedef struct {
+    const unsigned char *p, *end;
+    bool bad;
+} dwarf_cursor_t;
+
+static dwarf_cursor_t dwarf_cursor(const unsigned char *p, uint64_t size)
+{
+    return (dwarf_cursor_t){p, p + size, false};
+}
+
+static uint64_t rd_uint(dwarf_cursor_t *c, int n)
+{
+    uint64_t v = 0;
+    if (c->bad || c->end - c->p < n) {
+        c->bad = true;
+        c->p = c->end;
+        return 0;
+    }
+    for (int i = 0; i < n && i < 8; i++) v |= (uint64_t)c->p[i] << (8 * i);
+    c->p += n;
+    return v;
+}
+
+static uint64_t rd_uleb(dwarf_cursor_t *c)
+{
+    uint64_t v = 0;
+    unsigned shift = 0;
+    while (c->p < c->end) {
+        unsigned char b = *c->p++;
+        if (shift < 64) v |= (uint64_t)(b & 0x7f) << shift;
+        shift += 7;
+        if (!(b & 0x80)) return v;
+    }
+    c->bad = true;
+    return 0;
+}
+
+static int64_t rd_sleb(dwarf_cursor_t *c)
+{
+    uint64_t v = 0;
+    unsigned shift = 0;
+    while (c->p < c->end) {
+        unsigned char b = *c->p++;
+        if (shift < 64) v |= (uint64_t)(b & 0x7f) << shift;
+        shift += 7;
+        if (!(b & 0x80)) {
+            if (shift < 64 && (b & 0x40)) v |= ~0ull << shift;
+            return (int64_t)v;
+        }
+    }
+    c->bad = true;
+    return 0;
+}
+
+static const char *rd_str(dwarf_cursor_t *c)
+{
+    const unsigned char *nul = c->bad ? NULL : memchr(c->p, 0, c->end - c->p);
+    if (!nul) {
+        c->bad = true;
+        c->p = c->end;
+        return NULL;
+    }
+    const char *s = (const char*)c->p;
+    c->p = nul + 1;
+    return s;
+}
+
+static void rd_skip(dwarf_cursor_t *c, uint64_t n)
+{
+    if (c->bad || n > (uint64_t)(c->end - c->p)) {
+        c->bad = true;
+        c->p = c->end;
+        return;
+    }
+    c->p += n;
+}
+
+/**
+ * @brief Read a unit length and return a reader bounded to the unit. The
+ * outer reader moves past the unit.
+ *
+ * @param off_size Output offset size: 4 (32-bit DWARF) or 8 (64-bit DWARF).
+ */
+static dwarf_cursor_t rd_unit(dwarf_cursor_t *c, int *off_size)
+{
+    uint64_t len = rd_uint(c, 4);
+    *off_size = 4;
+    if (len == 0xffffffff) {
+        len = rd_uint(c, 8);
+        *off_size = 8;
+    }
+    dwarf_cursor_t u = {c->p, c->p, c->bad};
+    if (c->bad || len > (uint64_t)(c->end - c->p)) {
+        c->bad = u.bad = true;
+        return u;
+    }
+    u.end = c->p + len;
+    c->p += len;
+    return u;
+}
+
+/**
+ * @brief Read (or skip) one attribute value.
+ *
+ * @param value Output value of constant, offset and index forms; 0 for
+ *              strings and blocks.
+ * @return false for an unknown form or a truncated value.
+ */
+static bool rd_form(dwarf_cursor_t *c, uint64_t form, int off_size, int addr_size, int version, uint64_t *value)
+{
+    uint64_t v = 0;
+    switch (form) {
+    case DW_FORM_addr:          v = rd_uint(c, addr_size); break;
+    case DW_FORM_data1: case DW_FORM_ref1: case DW_FORM_flag:
+    case DW_FORM_strx1: case DW_FORM_addrx1:
+                                v = rd_uint(c, 1); break;
+    case DW_FORM_data2: case DW_FORM_ref2:
+    case DW_FORM_strx2: case DW_FORM_addrx2:
+                                v = rd_uint(c, 2); break;
+    case DW_FORM_strx3: case DW_FORM_addrx3:
+                                v = rd_uint(c, 3); break;
+    case DW_FORM_data4: case DW_FORM_ref4: case DW_FORM_ref_sup4:
+    case DW_FORM_strx4: case DW_FORM_addrx4:
+                                v = rd_uint(c, 4); break;
+    case DW_FORM_data8: case DW_FORM_ref8: case DW_FORM_ref_sig8: case DW_FORM_ref_sup8:
+                                v = rd_uint(c, 8); break;
+    case DW_FORM_data16:        rd_skip(c, 16); break;
+    case DW_FORM_strp: case DW_FORM_sec_offset: case DW_FORM_line_strp: case DW_FORM_strp_sup:
+    case DW_FORM_GNU_ref_alt: case DW_FORM_GNU_strp_alt:
+                                v = rd_uint(c, off_size); break;
+    case DW_FORM_ref_addr:      v = rd_uint(c, version <= 2 ? addr_size : off_size); break;
+    case DW_FORM_udata: case DW_FORM_ref_udata: case DW_FORM_strx: case DW_FORM_addrx:
+    case DW_FORM_loclistx: case DW_FORM_rnglistx:
+    case DW_FORM_GNU_addr_index: case DW_FORM_GNU_str_index:
+                                v = rd_uleb(c); break;
+    case DW_FORM_sdata:         v = (uint64_t)rd_sleb(c); break;
+    case DW_FORM_string:        rd_str(c); break;
+    case DW_FORM_block1:        rd_skip(c, rd_uint(c, 1)); break;
+    case DW_FORM_block2:        rd_skip(c, rd_uint(c, 2)); break;
+    case DW_FORM_block4:        rd_skip(c, rd_uint(c, 4)); break;
+    case DW_FORM_block: case DW_FORM_exprloc:
+                                rd_skip(c, rd_uleb(c)); break;
+    case DW_FORM_flag_present: case DW_FORM_implicit_const:
+                                break;
+    case DW_FORM_indirect:
+        form = rd_uleb(c);
+        if (form == DW_FORM_indirect) return false;
+        return rd_form(c, form, off_size, addr_size, version, value);
+    default:
+        return false;
+    }
+    *value = v;
+    return !c->bad;
+}
+
+/**
+ * @brief NUL-terminated string at an offset of a string section, NULL if
+ * there is none.
+ */
+static const char *section_str(const dwarf_section_t *s, uint64_t off)
+{
+    if (!s->data || off >= s->size || !memchr(s->data + off, 0, s->size - off)) return NULL;
+    return (const char*)s->data + off;
+}
+// ===== END READER =====
+
+// ===== BEGIN SECTIONS =====
+/**
+ * @brief Size of the absolute relocations found in debug sections, 0 for
+ * the others.
+ */
+static int reloc_size(uint16_t machine, uint32_t type)
+{
+    if (machine == EM_X86_64 && type == R_X86_64_64) return 8;
+    if (machine == EM_X86_64 && (type == R_X86_64_32 || type == R_X86_64_32S)) return 4;
+    if (machine == EM_386 && type == R_386_32) return 4;
+    return 0;
+}
+
+/**
+ * @brief Apply the REL/RELA sections targeting a debug section of a
+ * relocatable object to a copy of it.
+ *
+ * The symbols are section symbols, so a value is the symbol value plus the
+ * addend (read from the section for REL).
+ */
+static void relocate_section(dwarf_lines_t *d, dwarf_section_t *s)
+{
+    bparser *parser = d->views->parser;
+    const unsigned char *data = (const unsigned char*)parser->block;
+    bool is64 = data[EI_CLASS] == ELFCLASS64;
+    uint16_t type = is64 ? ((Elf64_Ehdr*)data)->e_type : ((Elf32_Ehdr*)data)->e_type;
+    uint16_t machine = is64 ? ((Elf64_Ehdr*)data)->e_machine : ((Elf32_Ehdr*)data)->e_machine;
+    if (type != ET_REL || !s->size) return;
+
+    for (uint32_t i = 1; i < d->views->shnum; i++) {
+        Elf64_Shdr rel = elf_section_header(d->views, i);
+        if ((rel.sh_type != SHT_RELA && rel.sh_type != SHT_REL) || rel.sh_info != s->index || rel.sh_link >= d->views->shnum)
+            continue;
+        Elf64_Shdr symtab = elf_section_header(d->views, rel.sh_link);
+        if (rel.sh_offset > parser->size || rel.sh_size > parser->size - rel.sh_offset ||
+            symtab.sh_offset > parser->size || symtab.sh_size > parser->size - symtab.sh_offset)
+            continue;
+        if (!s->copy) {
+            if (!(s->copy = malloc(s->size))) return;
+            memcpy(s->copy, s->data, s->size);
+        }
+
+        bool rela = rel.sh_type == SHT_RELA;
+        size_t entsize = is64 ? (rela ? sizeof(Elf64_Rela) : sizeof(Elf64_Rel)) : (rela ? sizeof(Elf32_Rela) : sizeof(Elf32_Rel));
+        size_t symsize = is64 ? sizeof(Elf64_Sym) : sizeof(Elf32_Sym);
+        for (uint64_t off = 0; off + entsize <= rel.sh_size; off += entsize) {
+            const unsigned char *r = data + rel.sh_offset + off;
+            uint64_t r_offset, sym, value = 0;
+            int64_t addend = 0;
+            uint32_t r_type;
+            if (is64) {
+                Elf64_Rela e = {0};
+                memcpy(&e, r, entsize);
+                r_offset = e.r_offset, sym = ELF64_R_SYM(e.r_info), r_type = ELF64_R_TYPE(e.r_info), addend = e.r_addend;
+            } else {
+                Elf32_Rela e = {0};
+                memcpy(&e, r, entsize);
+                r_offset = e.r_offset, sym = ELF32_R_SYM(e.r_info), r_type = ELF32_R_TYPE(e.r_info), addend = e.r_addend;
+            }
+
+            int size = reloc_size(machine, r_type);
+            if (!size || r_offset > s->size || (uint64_t)size > s->size - r_offset) continue;
+            if (!rela) {
+                dwarf_cursor_t c = dwarf_cursor(s->copy + r_offset, size);
+                addend = (int64_t)rd_uint(&c, size);
+            }
+            if ((sym + 1) * symsize <= symtab.sh_size) {
+                const unsigned char *p = data + symtab.sh_offset + sym * symsize;
+                value = is64 ? ((const Elf64_Sym*)p)->st_value : ((const Elf32_Sym*)p)->st_value;
+            }
+            value += addend;
+            for (int b = 0; b < size; b++) s->copy[r_offset + b] = (unsigned char)(value >> (8 * b));
+        }
+    }
+    if (s->copy) s->data = s->copy;
+}
+
+/**
+ * @brief Get (and pin) a debug section, `name` or its `.zdebug` form.
+ */
+static bool debug_section(dwarf_lines_t *d, const char *name, dwarf_section_t *out)
+{
+    char zname[64];
+    uint32_t index = elf_section_find(d->views, name);
+    if (index == SHN_UNDEF) {
+        snprintf(zname, sizeof(zname), ".z%s", name + 1);
+        index = elf_section_find(d->views, zname);
+    }
+    if (index == SHN_UNDEF) return false;
+    out->data = elf_section_get(d->views, index, &out->size);
+    out->index = index;
+    if (out->data) relocate_section(d, out);
+    return out->data != NULL;
+}
+
+static int cmp_arange(const void *a, const void *b)
+{
+    const dwarf_arange_t *x = a, *y = b;
+    return (x->lo > y->lo) - (x->lo < y->lo);
+}
+
+/**
+ * @brief Read every `.debug_aranges` set into one table sorted by address.
+ */
+static void read_aranges(dwarf_lines_t *d)
+{
+    size_t cap = 0;
+    dwarf_cursor_t c = dwarf_cursor(d->aranges.data, d->aranges.size);
+
+    while (d->aranges.data && c.p < c.end && !c.bad) {
+        const unsigned char *set = c.p;
+        int off_size;
+        dwarf_cursor_t u = rd_unit(&c, &off_size);
+        unsigned version = rd_uint(&u, 2);
+        uint64_t info_off = rd_uint(&u, off_size);
+        unsigned addr_size = rd_uint(&u, 1);
+        unsigned seg_size = rd_uint(&u, 1);
+        if (u.bad || version != 2 || (addr_size != 4 && addr_size != 8) || seg_size != 0) continue;
+
+        // the tuples are aligned on their size from the start of the set
+        size_t tuple = 2 * addr_size;
+        rd_skip(&u, (tuple - (size_t)(u.p - set) % tuple) % tuple);
+        while (!u.bad) {
+            uint64_t lo = rd_uint(&u, addr_size), len = rd_uint(&u, addr_size);
+            if (u.bad || (lo == 0 && len == 0)) break;
+            if (len == 0) continue;
+            if (d->nranges == cap) {
+                cap = cap ? cap * 2 : 64;
+                dwarf_arange_t *grown = realloc(d->ranges, cap * sizeof(*grown));
+                if (!grown) return;
+                d->ranges = grown;
+            }
+            d->ranges[d->nranges++] = (dwarf_arange_t){lo, (lo + len < lo) ? UINT64_MAX : lo + len, info_off, 0};
+        }
+    }
+
+    if (d->nranges) qsort(d->ranges, d->nranges, sizeof(*d->ranges), cmp_arange);
+    uint64_t max_hi = 0;
+    for (size_t i = 0; i < d->nranges; i++) {
+        if (d->ranges[i].hi > max_hi) max_hi = d->ranges[i].hi;
+        d->ranges[i].max_hi = max_hi;
+    }
+}
+
+dwarf_lines_t *dwarf_lines_open(bparser *parser)
+{
+    if (((unsigned char*)parser->block)[EI_DATA] != ELFDATA2LSB) return NULL;
+    elf_sections_t *views = elf_sections_open(parser, 0);
+    if (!views) return NULL;
+
+    dwarf_lines_t *d = calloc(1, sizeof(*d));
+    if (!d) {
+        elf_sections_close(views);
+        return NULL;
+    }
+    d->views = views;
+    if (!debug_section(d, ".debug_line", &d->line)) {
+        dwarf_lines_close(d);
+        return NULL;
+    }
+    debug_section(d, ".debug_info", &d->info);
+    debug_section(d, ".debug_abbrev", &d->abbrev);
+    debug_section(d, ".debug_aranges", &d->aranges);
+    debug_section(d, ".debug_str", &d->str);
+    debug_section(d, ".debug_line_str", &d->line_str);
+    d->done = create_map();
+    read_aranges(d);
+    return d;
+}
+
+void dwarf_lines_close(dwarf_lines_t *d)
+{
+    if (!d) return;
+    const dwarf_section_t *sections[] = {&d->line, &d->info, &d->abbrev, &d->aranges, &d->str, &d->line_str};
+    for (size_t i = 0; i < sizeof(sections) / sizeof(sections[0]); i++)
+        if (sections[i]->data) {
+            elf_section_put(d->views, sections[i]->index);
+            free(sections[i]->copy);
+        }
+    elf_sections_close(d->views);
+    for (size_t i = 0; i < d->nfiles; i++) free(d->files[i]);
+    free(d->files);
+    free(d->rows);
+    free(d->ranges);
+    if (d->done) free_map(d->done);
+    free(d);
+}
+// ===== END SECTIONS =====
+
+// ===== BEGIN LINE PROGRAM =====
+/**
+ * @brief Offset of the line program of the unit at `info_off`
+ * (DW_AT_stmt_list of its first DIE).
+ */
+static bool unit_stmt_list(const dwarf_lines_t *d, uint64_t info_off, uint64_t *stmt)
+{
+    if (!d->info.data || !d->abbrev.data || info_off >= d->info.size) return false;
+
+    dwarf_cursor_t c = dwarf_cursor(d->info.data + info_off, d->info.size - info_off);
+    int off_size;
+    dwarf_cursor_t u = rd_unit(&c, &off_size);
+    int version = rd_uint(&u, 2);
+    uint64_t abbrev_off;
+    int addr_size;
+    if (version >= 5) {
+        unsigned type = rd_uint(&u, 1);
+        addr_size = rd_uint(&u, 1);
+        abbrev_off = rd_uint(&u, off_size);
+        if (type == DW_UT_skeleton || type == DW_UT_split_compile) rd_skip(&u, 8);
+        else if (type != DW_UT_compile && type != DW_UT_partial) return false;
+    } else if (version >= 2) {
+        abbrev_off = rd_uint(&u, off_size);
+        addr_size = rd_uint(&u, 1);
+    } else {
+        return false;
+    }
+    uint64_t code = rd_uleb(&u);
+    if (u.bad || code == 0 || abbrev_off >= d->abbrev.size) return false;
+
+    // abbreviation of the unit DIE
+    dwarf_cursor_t a = dwarf_cursor(d->abbrev.data + abbrev_off, d->abbrev.size - abbrev_off);
+    for (;;) {
+        uint64_t entry = rd_uleb(&a);
+        if (a.bad || entry == 0) return false;
+        rd_uleb(&a);                    // tag
+        rd_uint(&a, 1);                 // has children
+        if (entry == code) break;
+        for (;;) {
+            uint64_t name = rd_uleb(&a), form = rd_uleb(&a);
+            if (form == DW_FORM_implicit_const) rd_sleb(&a);
+            if (a.bad) return false;
+            if (name == 0 && form == 0) break;
+        }
+    }
+
+    for (;;) {
+        uint64_t name = rd_uleb(&a), form = rd_uleb(&a), value;
+        if (a.bad || (name == 0 && form == 0)) return false;
+        if (form == DW_FORM_implicit_const) {
+            value = (uint64_t)rd_sleb(&a);
+        } else if (!rd_form(&u, form, off_size, addr_size, version, &value)) {
+            return false;
+        }
+        if (name == DW_AT_stmt_list) {
+            *stmt = value;
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief Add "dir/name" to the file table.
+ *
+ * @return Index in d->files, DWARF_NO_FILE if out of memory.
+ */
+static uint32_t add_file(dwarf_lines_t *d, const char *dir, const char *name)
+{
+    if (!name) name = "?";
+    if (d->nfiles == d->files_cap) {
+        size_t cap = d->files_cap ? d->files_cap * 2 : 64;
+        char **grown = realloc(d->files, cap * sizeof(*grown));
+        if (!grown) return DWARF_NO_FILE;
+        d->files = grown;
+        d->files_cap = cap;
+    }
+    size_t dlen = (dir && *dir && name[0] != '/') ? strlen(dir) : 0;
+    char *path = malloc(dlen + strlen(name) + 2);
+    if (!path) return DWARF_NO_FILE;
+    if (dlen) sprintf(path, "%s/%s", dir, name);
+    else strcpy(path, name);
+    d->files[d->nfiles] = path;
+    return (uint32_t)d->nfiles++;
+}
+
+/**
+ * @brief Local file numbers of one unit, mapped to d->files.
+ */
+typedef struct {
+    uint32_t *map;
+    size_t count, cap;
+} dwarf_unit_files_t;
+
+static void unit_file(dwarf_lines_t *d, dwarf_unit_files_t *f, const char *dir, const char *name)
+{
+    if (f->count == f->cap) {
+        size_t cap = f->cap ? f->cap * 2 : 16;
+        uint32_t *grown = realloc(f->map, cap * sizeof(*grown));
+        if (!grown) return;
+        f->map = grown;
+        f->cap = cap;
+    }
+    f->map[f->count++] = add_file(d, dir, name);
+}
+
+/**
+ * @brief Read a DWARF 5 directory or file name table.
+ *
+ * @param names Output paths (DW_LNCT_path), NULL where unknown.
+ * @param dirs  Output directory indices (DW_LNCT_directory_index), or NULL.
+ * @return Number of entries, 0 on error.
+ */
+static size_t read_entry_table(const dwarf_lines_t *d, dwarf_cursor_t *u, int off_size, int addr_size,
+                               const char ***names, uint64_t **dirs)
+{
+    uint64_t formats[32][2];
+    unsigned nformats = rd_uint(u, 1);
+    if (nformats > 32) return 0;
+    for (unsigned i = 0; i < nformats; i++) {
+        formats[i][0] = rd_uleb(u);
+        formats[i][1] = rd_uleb(u);
+    }
+    uint64_t count = rd_uleb(u);
+    if (u->bad || count == 0 || count > (uint64_t)(u->end - u->p)) return 0;
+
+    *names = calloc(count, sizeof(**names));
+    if (dirs) *dirs = calloc(count, sizeof(**dirs));
+    if (!*names || (dirs && !*dirs)) return 0;
+
+    for (uint64_t i = 0; i < count && !u->bad; i++) {
+        for (unsigned k = 0; k < nformats; k++) {
+            uint64_t type = formats[k][0], form = formats[k][1], value = 0;
+            if (type == DW_LNCT_path && form == DW_FORM_string) {
+                (*names)[i] = rd_str(u);
+                continue;
+            }
+            if (!rd_form(u, form, off_size, addr_size, 5, &value)) return 0;
+            if (type == DW_LNCT_path && form == DW_FORM_line_strp)
+                (*names)[i] = section_str(&d->line_str, value);
+            else if (type == DW_LNCT_path && form == DW_FORM_strp)
+                (*names)[i] = section_str(&d->str, value);
+            else if (type == DW_LNCT_directory_index && dirs)
+                (*dirs)[i] = value;
+        }
+    }
+    return u->bad ? 0 : count;
+}
+
+static uint32_t unit_file_index(const dwarf_unit_files_t *f, uint64_t local)
+{
+    return (local < f->count) ? f->map[local] : DWARF_NO_FILE;
+}
+
+static uint32_t row_line(int64_t line)
+{
+    return (line > 0 && line <= UINT32_MAX) ? (uint32_t)line : 0;
+}
+
+/**
+ * @brief Append a row. Within a sequence, a row at the same address as the
+ * previous one replaces it, so the last row for an address wins.
+ */
+static void emit_row(dwarf_lines_t *d, size_t seq_start, uint64_t addr, uint32_t file, uint32_t line)
+{
+    if (d->nrows > seq_start && d->rows[d->nrows - 1].addr == addr) {
+        d->rows[d->nrows - 1] = (dwarf_row_t){addr, file, line};
+        return;
+    }
+    if (d->nrows == d->rows_cap) {
+        size_t cap = d->rows_cap ? d->rows_cap * 2 : 1024;
+        dwarf_row_t *grown = realloc(d->rows, cap * sizeof(*grown));
+        if (!grown) return;
+        d->rows = grown;
+        d->rows_cap = cap;
+    }
+    d->rows[d->nrows++] = (dwarf_row_t){addr, file, line};
+}
+
+/**
+ * @brief Run the line program at `off` of .debug_line, once.
+ *
+ * @return 1 if the program was decoded now, 0 if it was already decoded or
+ *         is invalid.
+ */
+static size_t decode_program(dwarf_lines_t *d, uint64_t off)
+{
+    char key[24];
+    if (off >= d->line.size) return 0;
+    snprintf(key, sizeof(key), "%llx", (unsigned long long)off);
+    if (get(d->done, key)) return 0;
+    insert(d->done, key, (void*)1);
+
+    dwarf_cursor_t c = dwarf_cursor(d->line.data + off, d->line.size - off);
+    int off_size;
+    dwarf_cursor_t u = rd_unit(&c, &off_size);
+    int version = rd_uint(&u, 2);
+    int addr_size = 8;
+    if (u.bad || version < 2 || version > 5) return 0;
+    if (version >= 5) {
+        addr_size = rd_uint(&u, 1);
+        rd_uint(&u, 1);                 // segment selector size
+    }
+    uint64_t header_len = rd_uint(&u, off_size);
+    if (u.bad || header_len > (uint64_t)(u.end - u.p)) return 0;
+    const unsigned char *program = u.p + header_len;
+
+    unsigned min_insn = rd_uint(&u, 1);
+    if (version >= 4) rd_uint(&u, 1);   // maximum operations per instruction (VLIW)
+    rd_uint(&u, 1);                     // default is_stmt
+    int line_base = (int8_t)rd_uint(&u, 1);
+    unsigned line_range = rd_uint(&u, 1);
+    unsigned opcode_base = rd_uint(&u, 1);
+    const unsigned char *op_lengths = u.p;
+    rd_skip(&u, opcode_base ? opcode_base - 1 : 0);
+    if (u.bad || line_range == 0 || opcode_base == 0) return 0;
+
+    // file numbers start at 1 before DWARF 5, at 0 from DWARF 5
+    dwarf_unit_files_t files = {0};
+    uint64_t first_file = (version >= 5) ? 0 : 1;
+    if (version >= 5) {
+        const char **dir_names = NULL, **file_names = NULL;
+        uint64_t *file_dirs = NULL;
+        size_t ndirs = read_entry_table(d, &u, off_size, addr_size, &dir_names, NULL);
+        size_t nfiles = ndirs ? read_entry_table(d, &u, off_size, addr_size, &file_names, &file_dirs) : 0;
+        for (size_t i = 0; i < nfiles; i++)
+            unit_file(d, &files, file_dirs[i] < ndirs ? dir_names[file_dirs[i]] : NULL, file_names[i]);
+        free(dir_names);
+        free(file_names);
+        free(file_dirs);
+    } else {
+        const char *dirs[256];
+        size_t ndirs = 1;
+        dirs[0] = NULL;                 // the compilation directory, not in the table
+        for (const char *dir; (dir = rd_str(&u)) && *dir; )
+            if (ndirs < 256) dirs[ndirs++] = dir;
+        for (const char *name; (name = rd_str(&u)) && *name; ) {
+            uint64_t dir = rd_uleb(&u);
+            rd_uleb(&u);                // modification time
+            rd_uleb(&u);                // length
+            unit_file(d, &files, dir < ndirs ? dirs[dir] : NULL, name);
+        }
+    }
+
+    dwarf_cursor_t p = {program, u.end, false};
+    uint64_t addr = 0, file = 1;
+    int64_t line = 1;
+    size_t seq_start = d->nrows;
+    while (p.p < p.end && !p.bad) {
+        unsigned op = rd_uint(&p, 1);
+        if (op >= opcode_base) {
+            // special opcode: advance address and line, then add a row
+            unsigned adj = op - opcode_base;
+            addr += (uint64_t)(adj / line_range) * min_insn;
+            line += line_base + (int)(adj % line_range);
+            emit_row(d, seq_start, addr, unit_file_index(&files, file - first_file), row_line(line));
+        } else if (op == 0) {
+            uint64_t len = rd_uleb(&p);
+            if (p.bad || len == 0 || len > (uint64_t)(p.end - p.p)) break;
+            const unsigned char *next = p.p + len;
+            unsigned sub = rd_uint(&p, 1);
+            if (sub == DW_LNE_end_sequence) {
+                emit_row(d, seq_start, addr, DWARF_NO_FILE, 0);
+                addr = 0, file = 1, line = 1;
+                seq_start = d->nrows;
+            } else if (sub == DW_LNE_set_address) {
+                addr = rd_uint(&p, (len - 1 <= 8) ? (int)(len - 1) : 8);
+            } else if (sub == DW_LNE_define_file) {
+                const char *name = rd_str(&p);
+                uint64_t dir = rd_uleb(&p);
+                (void)dir;
+                if (!p.bad) unit_file(d, &files, NULL, name);
+            }
+            p.p = next;
+            p.bad = false;
+        } else if (op == DW_LNS_copy) {
+            emit_row(d, seq_start, addr, unit_file_index(&files, file - first_file), row_line(line));
+        } else if (op == DW_LNS_advance_pc) {
+            addr += rd_uleb(&p) * min_insn;
+        } else if (op == DW_LNS_advance_line) {
+            line += rd_sleb(&p);
+        } else if (op == DW_LNS_set_file) {
+            file = rd_uleb(&p);
+        } else if (op == DW_LNS_const_add_pc) {
+            addr += (uint64_t)((255 - opcode_base) / line_range) * min_insn;
+        } else if (op == DW_LNS_fixed_advance_pc) {
+            addr += rd_uint(&p, 2);
+        } else {
+            // flags and DW_LNS_set_column, DW_LNS_set_isa or unknown: skip the operands
+            for (unsigned i = 0; i < op_lengths[op - 1] && !p.bad; i++) rd_uleb(&p);
+        }
+    }
+    free(files.map);
+    d->sorted = false;
+    return 1;
+}
+
+size_t dwarf_lines_load(dwarf_lines_t *d, uint64_t lo, uint64_t hi)
+{
+    size_t decoded = 0;
+    bool covered = false;
+    if (d->all_loaded || lo >= hi) return 0;
+
+    if (d->nranges) {
+        // ranges starting before hi; max_hi stops the walk at the first one that cannot reach lo
+        size_t a = 0, b = d->nranges;
+        while (a < b) {
+            size_t mid = a + (b - a) / 2;
+            if (d->ranges[mid].lo < hi) a = mid + 1;
+            else b = mid;
+        }
+        for (size_t i = a; i-- > 0 && d->ranges[i].max_hi > lo; ) {
+            uint64_t stmt;
+            if (d->ranges[i].hi > lo && unit_stmt_list(d, d->ranges[i].info_off, &stmt)) {
+                covered = true;
+                decoded += decode_program(d, stmt);
+            }
+        }
+    }
+
+    if (!covered) {
+        // no .debug_aranges for these addresses: decode every unit, once
+        dwarf_cursor_t c = dwarf_cursor(d->line.data, d->line.size);
+        while (c.p < c.end && !c.bad) {
+            uint64_t off = c.p - d->line.data;
+            int off_size;
+            rd_unit(&c, &off_size);
+            if (c.bad) break;
+            decoded += decode_program(d, off);
+        }
+        d->all_loaded = true;
+    }
+    return decoded;
+}
+// ===== END LINE PROGRAM =====
+
+// ===== BEGIN LOOKUP =====
+static int cmp_row(const void *a, const void *b)
+{
+    const dwarf_row_t *x = a, *y = b;
+    if (x->addr != y->addr) return (x->addr > y->addr) - (x->addr < y->addr);
+    // the end of a sequence sorts before a sequence starting at the same address
+    return (x->line != 0) - (y->line != 0);
+}
+
+const dwarf_row_t *dwarf_lines_find(dwarf_lines_t *d, uint64_t addr)
+{
+    if (!d->sorted && d->nrows) {
+        qsort(d->rows, d->nrows, sizeof(*d->rows), cmp_row);
+        d->sorted = true;
+    }
+
+    // last row at or before addr
+    size_t a = 0, b = d->nrows;
+    while (a < b) {
+        size_t mid = a + (b - a) / 2;
+        if (d->rows[mid].addr <= addr) a = mid + 1;
+        else b = mid;
+    }
+    if (a == 0 || d->rows[a - 1].line == 0) return NULL;
+    return &d->rows[a - 1];
+}
+
+const char *dwarf_lines_file(const dwarf_lines_t *d, const dwarf_row_t *row)
+{
+    return (row->file < d->nfiles) ? d->files[row->file] : "?";
+}
+// ===== END LOOKUP =====
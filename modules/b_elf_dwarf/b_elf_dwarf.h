@@ -0,0 +1,107 @@
+/**
+ * @file b_elf_dwarf.h
+ * @brief DWARF line tables (.debug_line): address to file and line.
+ *
+ * The line program of a compile unit is run once and its rows are appended
+ * to one table. The table is sorted by address, so a lookup is a binary
+ * search instead of one addr2line run per address.
+ *
+ * Only the compile units that cover the requested addresses are decoded.
+ * `.debug_aranges` maps an address range to its unit in `.debug_info`,
+ * whose DW_AT_stmt_list gives the offset of its line program. Without
+ * `.debug_aranges` (or for a range it does not cover), every line program
+ * is decoded once.
+ *
+ * DWARF 2 to 5, 32 and 64-bit DWARF. The sections are read through
+ * b_elf_sections, so compressed debug sections work. In relocatable
+ * objects, the absolute relocations of the debug sections are applied to a
+ * copy (string offsets and section-relative addresses). Little-endian files
+ * only.
+ *
+ * Options (read from the command line):
+ * - `-a --source`  Print the file and line above the instructions.
+ */
+#ifndef B_ELF_DWARF_H
+#define B_ELF_DWARF_H
+#include "../bparser/bparser.h"
+#include "../../baseer.h"
+#include "../b_hashmap/b_hashmap.h"
+#include "../b_elf_sections/b_elf_sections.h"
+#include <elf.h>
+#include <stdint.h>
+
+/**
+ * @brief Bytes of one debug section.
+ */
+typedef struct {
+    const unsigned char *data;  /**< NULL if the section is absent */
+    uint64_t size;
+    uint32_t index;
+    unsigned char *copy;        /**< Relocated copy (relocatable objects), or NULL */
+} dwarf_section_t;
+
+/**
+ * @brief One `.debug_aranges` range.
+ */
+typedef struct {
+    uint64_t lo, hi;            /**< [lo, hi) */
+    uint64_t info_off;          /**< Unit offset in .debug_info */
+    uint64_t max_hi;            /**< Largest hi of this and the previous ranges */
+} dwarf_arange_t;
+
+/**
+ * @brief One row of the line table.
+ *
+ * Line 0 means no source line: it marks the end of a sequence (and the code
+ * a compiler did not attribute to a line).
+ */
+typedef struct {
+    uint64_t addr;
+    uint32_t file;              /**< Index in dwarf_lines_t.files */
+    uint32_t line;
+} dwarf_row_t;
+
+/**
+ * @brief Line tables of an ELF file, decoded lazily.
+ */
+typedef struct {
+    elf_sections_t *views;
+    dwarf_section_t line, info, abbrev, aranges, str, line_str;
+    dwarf_arange_t *ranges;     /**< Sorted by lo */
+    size_t nranges;
+    hashmap_t *done;            /**< Line program offsets already decoded */
+    bool all_loaded;            /**< Every line program was decoded */
+    dwarf_row_t *rows;
+    size_t nrows, rows_cap;
+    char **files;               /**< "dir/name" */
+    size_t nfiles, files_cap;
+    bool sorted;
+} dwarf_lines_t;
+
+/**
+ * @brief Find the debug sections of a file. Nothing is decoded yet.
+ *
+ * @return The line tables (free with dwarf_lines_close()), NULL if the file
+ *         has no `.debug_line`.
+ */
+dwarf_lines_t *dwarf_lines_open(bparser *parser);
+void dwarf_lines_close(dwarf_lines_t *d);
+
+/**
+ * @brief Decode the line programs of the units that cover [lo, hi).
+ *
+ * Units already decoded are skipped, so regions can be loaded one by one.
+ *
+ * @return Number of units decoded by this call.
+ */
+size_t dwarf_lines_load(dwarf_lines_t *d, uint64_t lo, uint64_t hi);
+
+/**
+ * @brief Source line of an address (binary search).
+ *
+ * @return The row covering `addr`, NULL if there is no source line.
+ */
+const dwarf_row_t *dwarf_lines_find(dwarf_lines_t *d, uint64_t addr);
+const char *dwarf_lines_file(const dwarf_lines_t *d, const dwarf_row_t *row);
+
+#endif
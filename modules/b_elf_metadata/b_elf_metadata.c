@@ -83,9 +83,39 @@ void dump_elf64hdr(Elf64_Ehdr *elf)
     printf(COLOR_GREEN "Machine: " COLOR_RESET "%s (%d)\n",
             elf_machine_to_str(elf->e_machine), elf->e_machine);
 }
+
+/**
+ * @brief Print the real section count and string table index of a file
+ * using extended numbering (more than 0xff00 sections).
+ *
+ * @param parser   Pointer to a bparser structure containing the ELF file.
+ * @param shnum    `e_shnum` of the header.
+ * @param shstrndx `e_shstrndx` of the header.
+ */
+static void print_extended_numbering(bparser *parser, unsigned int shnum, unsigned int shstrndx)
+{
+    if (shnum != 0 && shstrndx != SHN_XINDEX) return;
+    if (elf_shnum(parser) == 0) return;
+    printf(COLOR_GREEN "Extended numbering: " COLOR_RESET "%u sections, string table index %u (from section 0)\n",
+           elf_shnum(parser), elf_shstrndx(parser));
+}
 // ========================= END ELF HEADER ==================================
 
 // ========================= BEGIN SECTION HEADER ==================================
+/**
+ * @brief Print the compression header of a section, if it has one.
+ *
+ * Only the Elf*_Chdr (or `.zdebug` header) is read; the data is not inflated.
+ */
+static void print_section_compression(elf_sections_t *views, uint32_t i)
+{
+    uint32_t type;
+    uint64_t size;
+    if (views && elf_section_compression(views, i, &type, &size))
+        printf(COLOR_CYAN "|---%-*s" COLOR_RESET "%s, 0x%llx bytes inflated\n", META_LABEL_WIDTH, "Compress:",
+               elf_compress_type_to_str(type), (unsigned long long)size);
+}
+
 /**
  * @brief Dump the section header table of a 32-bit ELF file.
  *
@@ -113,7 +143,8 @@ void dump_elf64hdr(Elf64_Ehdr *elf)
  */
 void dump_elf32_shdr(Elf32_Ehdr* elf, Elf32_Shdr* shdrs, bparser* parser, void* arg) 
 {
-    Elf32_Shdr shstr = shdrs[elf->e_shstrndx];
+    uint32_t shnum = elf_shnum(parser);
+    Elf32_Shdr shstr = shdrs[elf_shstrndx(parser)];
     const char* shstrtab = (const char*)(parser->block + shstr.sh_offset);
 
     printf(COLOR_BLUE "\n=== Section Headers ===\n" COLOR_RESET);
@@ -136,7 +167,8 @@ void dump_elf32_shdr(Elf32_Ehdr* elf, Elf32_Shdr* shdrs, bparser* parser, void*
     hashmap_t *map = (hashmap_t*)get(maps, "sections");
     hashmap_t *symbols = (hashmap_t*)get(maps, "symbols");
 
-    for (int i = 0; i < elf->e_shnum; i++) {
+    elf_sections_t *views = elf_sections_open(parser, 0);
+    for (uint32_t i = 0; i < shnum; i++) {
         // ============================ BEGIN SECTION METADATA =============================
         // Section name
         const char* name = &shstrtab[shdrs[i].sh_name];
@@ -155,6 +187,7 @@ void dump_elf32_shdr(Elf32_Ehdr* elf, Elf32_Shdr* shdrs, bparser* parser, void*
         printf("\n");
 
         print_section_header_metadata_32bit(i, name, type_str, flags, shdrs);
+        print_section_compression(views, i);
         // ============================ END SECTION METADATA =============================
         
 
@@ -171,9 +204,14 @@ void dump_elf32_shdr(Elf32_Ehdr* elf, Elf32_Shdr* shdrs, bparser* parser, void*
         // ============================ END SECTION BODY =============================
     }
     // ================ print tables ==================
-    for (int i = 0; i < elf->e_shnum; i++) {
+    for (uint32_t i = 0; i < shnum; i++) {
         Elf32_Shdr curr_shd = shdrs[i];
-        if(curr_shd.sh_link == 0) continue;
+        // REL, RELA, RELR and Android packed tables (RELR has no linked symbol table).
+        if (elf_is_reloc_section(curr_shd.sh_type)) {
+            print_elf_relocs(views, i);
+            continue;
+        }
+        if(curr_shd.sh_link == 0 || curr_shd.sh_link >= shnum) continue;
         Elf32_Shdr linked_shd = shdrs[curr_shd.sh_link];
 
         // check is it table type and have like `SYMTAB` `DYNSYMTAB` `REL` `RELA` and so on... and there LINK section for names.
@@ -184,21 +222,13 @@ void dump_elf32_shdr(Elf32_Ehdr* elf, Elf32_Shdr* shdrs, bparser* parser, void*
             // TODO: need to make print_dynmaic_symbols ...
             print_symbols_32bit(parser, elf, shdrs, &curr_shd, &linked_shd);
 
-        } else if(curr_shd.sh_type == SHT_REL){
-            // TODO: need to make print_rel ...
-            print_rela_32bit(parser, elf, shdrs, &curr_shd, &linked_shd);
-        } else if(curr_shd.sh_type == SHT_RELA){
-            print_rela_32bit(parser, elf, shdrs, &curr_shd, &linked_shd);
-
-        } else if(curr_shd.sh_type == SHT_RELR){
-            // TODO: need to make print_rela ...
-            print_rela_32bit(parser, elf, shdrs, &curr_shd, &linked_shd);
         } else if(curr_shd.sh_type == SHT_DYNAMIC){
             // TODO
             // print_symbols_32bit(parser, elf, shdrs, &curr_shd, &linked_shd);
             print_dynamic_table_32bit(parser, elf, shdrs, &curr_shd, &linked_shd);
         }
     }
+    elf_sections_close(views);
 
 
 
@@ -224,16 +254,6 @@ void dump_elf32_shdr(Elf32_Ehdr* elf, Elf32_Shdr* shdrs, bparser* parser, void*
         printf("\n\n");
     }
 
-    // if((symtab = (Elf32_Shdr*)get(map, ".rel.plt")) != NULL) {
-    //     print_rela_32bit(parser, elf, shdrs, symtab, strtab);
-    //     printf("\n\n");
-    // }
-
-    // if((symtab = (Elf32_Shdr*)get(map, ".rela.plt")) != NULL) {
-    //     print_rela_32bit(parser, elf, shdrs, symtab, strtab);
-    //     printf("\n\n");
-    // }
-
     // free_map(map);
 }
 
@@ -264,7 +284,8 @@ void dump_elf32_shdr(Elf32_Ehdr* elf, Elf32_Shdr* shdrs, bparser* parser, void*
  */
 void dump_elf64_shdr(Elf64_Ehdr* elf , Elf64_Shdr* shdrs, bparser* parser, void* arg) 
 {
-    Elf64_Shdr shstr = shdrs[elf->e_shstrndx];
+    uint32_t shnum = elf_shnum(parser);
+    Elf64_Shdr shstr = shdrs[elf_shstrndx(parser)];
     const char* shstrtab = (const char*)(parser->block + shstr.sh_offset);
     printf(COLOR_BLUE "\n=== Section Headers ===\n" COLOR_RESET);
     print_section_header_legend();
@@ -288,7 +309,8 @@ void dump_elf64_shdr(Elf64_Ehdr* elf , Elf64_Shdr* shdrs, bparser* parser, void*
     hashmap_t *symbols = (hashmap_t*)get(maps, "symbols");
 
 
-    for (int i = 0; i < elf->e_shnum; i++) {
+    elf_sections_t *views = elf_sections_open(parser, 0);
+    for (uint32_t i = 0; i < shnum; i++) {
         // ============================ BEGIN SECTION METADATA =============================
         // Section name
         const char* name = &shstrtab[shdrs[i].sh_name];
@@ -307,6 +329,7 @@ void dump_elf64_shdr(Elf64_Ehdr* elf , Elf64_Shdr* shdrs, bparser* parser, void*
         printf("\n");       
 
         print_section_header_metadata_64bit(i, name, type_str, flags, shdrs);
+        print_section_compression(views, i);
         // ============================ END SECTION METADATA =============================
 
         // ============================ BEGIN SECTION BODY =============================
@@ -323,9 +346,14 @@ void dump_elf64_shdr(Elf64_Ehdr* elf , Elf64_Shdr* shdrs, bparser* parser, void*
     }
 
     // ================ print tables ==================
-    for (int i = 0; i < elf->e_shnum; i++) {
+    for (uint32_t i = 0; i < shnum; i++) {
         Elf64_Shdr curr_shd = shdrs[i];
-        if(curr_shd.sh_link == 0) continue;
+        // REL, RELA, RELR and Android packed tables (RELR has no linked symbol table).
+        if (elf_is_reloc_section(curr_shd.sh_type)) {
+            print_elf_relocs(views, i);
+            continue;
+        }
+        if(curr_shd.sh_link == 0 || curr_shd.sh_link >= shnum) continue;
         Elf64_Shdr linked_shd = shdrs[curr_shd.sh_link];
 
         // check is it table type and have like `SYMTAB` `DYNSYMTAB` `REL` `RELA` and so on... and there LINK section for names.
@@ -336,18 +364,11 @@ void dump_elf64_shdr(Elf64_Ehdr* elf , Elf64_Shdr* shdrs, bparser* parser, void*
             // TODO: need to make print_dynmaic_symbols ...
             print_symbols_64bit(parser, elf, shdrs, &curr_shd, &linked_shd);
 
-        } else if(curr_shd.sh_type == SHT_REL){
-            // TODO: need to make print_rel ...
-            print_rela_64bit(parser, elf, shdrs, &curr_shd, &linked_shd);
-        } else if(curr_shd.sh_type == SHT_RELA){
-            print_rela_64bit(parser, elf, shdrs, &curr_shd, &linked_shd);
-        } else if(curr_shd.sh_type == SHT_RELR){
-            // TODO: need to make print_relr ...
-            print_rela_64bit(parser, elf, shdrs, &curr_shd, &linked_shd);
         } else if(curr_shd.sh_type == SHT_DYNAMIC){
             print_dynamic_table_64bit(parser, elf, shdrs, &curr_shd, &linked_shd);
         }
     }
+    elf_sections_close(views);
 
     Elf64_Shdr *symtab, *strtab;
     if((symtab = (Elf64_Shdr*)get(map, ".symtab")) != NULL && (strtab = (Elf64_Shdr*)get(map, ".strtab")) != NULL) {
@@ -552,8 +573,9 @@ bool print_meta_data(bparser* parser, void* arg)
         Elf32_Phdr* phdr = (Elf32_Phdr*) (data + elf->e_phoff);
         Elf32_Shdr* shdrs = (Elf32_Shdr*)(data + elf->e_shoff);
         dump_elf32hdr(elf);
+        print_extended_numbering(parser, elf->e_shnum, elf->e_shstrndx);
 
-        if(elf->e_shnum > 0)
+        if(elf_shnum(parser) > 0)
             dump_elf32_shdr(elf, shdrs, parser, arg);
 
         if(elf->e_phnum > 0)
@@ -564,7 +586,8 @@ bool print_meta_data(bparser* parser, void* arg)
         Elf64_Phdr* phdr = (Elf64_Phdr*) (data + elf->e_phoff);
         Elf64_Shdr* shdrs = (Elf64_Shdr*)(data + elf->e_shoff);
         dump_elf64hdr(elf);
-        if(elf->e_shnum > 0)
+        print_extended_numbering(parser, elf->e_shnum, elf->e_shstrndx);
+        if(elf_shnum(parser) > 0)
             dump_elf64_shdr(elf, shdrs, parser, arg);
 
         if(elf->e_phnum > 0)
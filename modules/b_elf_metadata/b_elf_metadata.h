@@ -24,6 +24,8 @@
 #include <elf.h>
 #include<string.h>
 #include "../bx_elf_utils/bx_elf_utils.h"
+#include "../b_elf_sections/b_elf_sections.h"
+#include "../b_elf_relocs/b_elf_relocs.h"
 #include "udis86.h"
 
 void dump_elf32hdr(Elf32_Ehdr *elf);
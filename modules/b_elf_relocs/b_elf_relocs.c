@@ -0,0 +1,466 @@
+/**
+ * @file b_elf_relocs.c
+ * @brief REL, RELA, RELR and Android APS2 relocation decoders.
+ */
+#include "b_elf_relocs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ===== BEGIN APS2 CONSTANTS =====
+#define APS2_GROUPED_BY_INFO            1
+#define APS2_GROUPED_BY_OFFSET_DELTA    2
+#define APS2_GROUPED_BY_ADDEND          4
+#define APS2_GROUP_HAS_ADDEND           8
+// ===== END APS2 CONSTANTS =====
+
+bool elf_is_reloc_section(uint32_t sh_type)
+{
+    return sh_type == SHT_REL || sh_type == SHT_RELA || sh_type == SHT_RELR ||
+           sh_type == SHT_ANDROID_REL || sh_type == SHT_ANDROID_RELA || sh_type == SHT_ANDROID_RELR;
+}
+
+/**
+ * @brief R_*_RELATIVE type of a machine (the type of every RELR entry).
+ */
+static uint32_t relative_type(uint16_t machine)
+{
+    switch (machine) {
+        case EM_386:     return R_386_RELATIVE;
+        case EM_ARM:     return R_ARM_RELATIVE;
+        case EM_AARCH64: return R_AARCH64_RELATIVE;
+        case EM_PPC64:   return R_PPC64_RELATIVE;
+        case EM_RISCV:   return R_RISCV_RELATIVE;
+        case EM_X86_64:
+        default:         return R_X86_64_RELATIVE;
+    }
+}
+
+/**
+ * @brief Name of an i386 relocation type.
+ */
+static const char *rel_R_386_type_to_str(uint32_t type)
+{
+    switch (type) {
+        case R_386_NONE:         return "R_386_NONE";
+        case R_386_32:           return "R_386_32";
+        case R_386_PC32:         return "R_386_PC32";
+        case R_386_GOT32:        return "R_386_GOT32";
+        case R_386_PLT32:        return "R_386_PLT32";
+        case R_386_COPY:         return "R_386_COPY";
+        case R_386_GLOB_DAT:     return "R_386_GLOB_DAT";
+        case R_386_JMP_SLOT:     return "R_386_JMP_SLOT";
+        case R_386_RELATIVE:     return "R_386_RELATIVE";
+        case R_386_GOTOFF:       return "R_386_GOTOFF";
+        case R_386_GOTPC:        return "R_386_GOTPC";
+        case R_386_TLS_TPOFF:    return "R_386_TLS_TPOFF";
+        case R_386_TLS_IE:       return "R_386_TLS_IE";
+        case R_386_TLS_GOTIE:    return "R_386_TLS_GOTIE";
+        case R_386_TLS_LE:       return "R_386_TLS_LE";
+        case R_386_TLS_GD:       return "R_386_TLS_GD";
+        case R_386_TLS_LDM:      return "R_386_TLS_LDM";
+        case R_386_16:           return "R_386_16";
+        case R_386_PC16:         return "R_386_PC16";
+        case R_386_8:            return "R_386_8";
+        case R_386_PC8:          return "R_386_PC8";
+        case R_386_TLS_DTPMOD32: return "R_386_TLS_DTPMOD32";
+        case R_386_TLS_DTPOFF32: return "R_386_TLS_DTPOFF32";
+        case R_386_TLS_TPOFF32:  return "R_386_TLS_TPOFF32";
+        case R_386_IRELATIVE:    return "R_386_IRELATIVE";
+        case R_386_GOT32X:       return "R_386_GOT32X";
+        default:                 return NULL;
+    }
+}
+
+const char *elf_reloc_type_to_str(uint16_t machine, uint32_t type)
+{
+    switch (machine) {
+        case EM_X86_64:  return rel_R_X86_64_type_to_str(type);
+        case EM_386:     return rel_R_386_type_to_str(type);
+        case EM_ARM:     return type == R_ARM_RELATIVE ? "R_ARM_RELATIVE" : NULL;
+        case EM_AARCH64: return type == R_AARCH64_RELATIVE ? "R_AARCH64_RELATIVE" : NULL;
+        case EM_PPC64:   return type == R_PPC64_RELATIVE ? "R_PPC64_RELATIVE" : NULL;
+        case EM_RISCV:   return type == R_RISCV_RELATIVE ? "R_RISCV_RELATIVE" : NULL;
+        default:         return NULL;
+    }
+}
+
+/**
+ * @brief Name of a section, "?" if it is not NUL-terminated inside the file.
+ */
+static const char *reloc_section_name(const elf_sections_t *s, uint32_t index)
+{
+    const char *name = elf_section_name(s->parser, index);
+    if (!name) return "?";
+    size_t off = (size_t)(name - (const char*)s->parser->block);
+    return memchr(name, 0, s->parser->size - off) ? name : "?";
+}
+
+// ===== BEGIN DECODERS =====
+/**
+ * @brief Decode Elf32_Rel(a) or Elf64_Rel(a) entries.
+ */
+static bool decode_rel(const unsigned char *p, uint64_t size, bool is64, bool rela, elf_reloc_table_t *out)
+{
+    size_t ent = is64 ? (rela ? sizeof(Elf64_Rela) : sizeof(Elf64_Rel))
+                      : (rela ? sizeof(Elf32_Rela) : sizeof(Elf32_Rel));
+    size_t count = size / ent;
+    if (count > ELF_RELOCS_MAX) return false;
+
+    out->relocs = malloc((count ? count : 1) * sizeof(elf_reloc_t));
+    if (!out->relocs) return false;
+
+    for (size_t i = 0; i < count; i++, p += ent) {
+        elf_reloc_t *r = &out->relocs[i];
+        if (is64) {
+            Elf64_Rela e = {0};
+            memcpy(&e, p, ent);
+            r->offset = e.r_offset;
+            r->sym    = ELF64_R_SYM(e.r_info);
+            r->type   = ELF64_R_TYPE(e.r_info);
+            r->addend = rela ? e.r_addend : 0;
+        } else {
+            Elf32_Rela e = {0};
+            memcpy(&e, p, ent);
+            r->offset = e.r_offset;
+            r->sym    = ELF32_R_SYM(e.r_info);
+            r->type   = ELF32_R_TYPE(e.r_info);
+            r->addend = rela ? e.r_addend : 0;
+        }
+    }
+    out->count = count;
+    return true;
+}
+
+static inline uint64_t relr_word(const unsigned char *p, bool is64)
+{
+    if (is64) {
+        uint64_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/**
+ * @brief Expand a RELR table.
+ *
+ * An even word is the address of a relocation; the next bitmap starts one
+ * word after it. An odd word is a bitmap: bit n (n >= 1) relocates
+ * base + (n - 1) words, then base moves by 63 (or 31) words.
+ */
+static bool decode_relr(const unsigned char *p, uint64_t size, bool is64, uint32_t type, elf_reloc_table_t *out)
+{
+    const uint64_t w = is64 ? 8 : 4;
+    const uint64_t mask = is64 ? UINT64_MAX : UINT32_MAX;
+    size_t nwords = size / w;
+
+    // Counting pass: one popcount per bitmap, so the output is allocated once.
+    uint64_t count = 0;
+    for (size_t i = 0; i < nwords; i++) {
+        uint64_t v = relr_word(p + i * w, is64);
+        count += (v & 1) ? (uint64_t)__builtin_popcountll(v >> 1) : 1;
+    }
+    if (count > ELF_RELOCS_MAX) return false;
+
+    elf_reloc_t *r = malloc((count ? count : 1) * sizeof(elf_reloc_t));
+    if (!r) return false;
+
+    size_t n = 0;
+    uint64_t base = 0;
+    for (size_t i = 0; i < nwords; i++) {
+        uint64_t v = relr_word(p + i * w, is64);
+        if (!(v & 1)) {
+            r[n++] = (elf_reloc_t){v, 0, 0, type};
+            base = (v + w) & mask;
+            continue;
+        }
+        for (uint64_t bits = v >> 1; bits; bits &= bits - 1) {
+            unsigned bit = __builtin_ctzll(bits);
+            r[n++] = (elf_reloc_t){(base + bit * w) & mask, 0, 0, type};
+        }
+        base = (base + (w * 8 - 1) * w) & mask;
+    }
+    out->relocs = r;
+    out->count = n;
+    return true;
+}
+
+static bool aps2_sleb(const unsigned char **p, const unsigned char *end, int64_t *out)
+{
+    uint64_t v = 0;
+    unsigned shift = 0;
+    unsigned char b;
+    do {
+        if (*p >= end || shift >= 64) return false;
+        b = *(*p)++;
+        v |= (uint64_t)(b & 0x7f) << shift;
+        shift += 7;
+    } while (b & 0x80);
+    if (shift < 64 && (b & 0x40)) v |= ~0ull << shift;
+    *out = (int64_t)v;
+    return true;
+}
+
+/**
+ * @brief Decode an Android "APS2" packed table.
+ *
+ * The count and the first offset, then groups: a size, flags, the fields
+ * shared by the group (offset delta, r_info, addend delta), then per
+ * relocation the fields that are not shared.
+ */
+static bool decode_aps2(const unsigned char *p, uint64_t size, bool is64, bool rela, elf_reloc_table_t *out)
+{
+    const unsigned char *end = p + size;
+    const uint64_t mask = is64 ? UINT64_MAX : UINT32_MAX;
+    int64_t total, offset, info = 0, addend = 0;
+
+    if (size < 4 || memcmp(p, "APS2", 4) != 0) return false;
+    p += 4;
+    if (!aps2_sleb(&p, end, &total) || !aps2_sleb(&p, end, &offset)) return false;
+    if (total < 0 || (uint64_t)total > ELF_RELOCS_MAX) return false;
+
+    // Grouped relocations may take no bytes, so the count cannot be checked
+    // against the size: grow as they are decoded.
+    size_t cap = total < 4096 ? (size_t)total : 4096;
+    elf_reloc_t *r = malloc((cap ? cap : 1) * sizeof(elf_reloc_t));
+    if (!r) return false;
+
+    size_t n = 0;
+    while (n < (size_t)total) {
+        int64_t group, flags, delta = 0, v;
+        if (!aps2_sleb(&p, end, &group) || !aps2_sleb(&p, end, &flags)) goto bad;
+        if (group < 0 || (uint64_t)group > (uint64_t)total - n) goto bad;
+        if ((flags & APS2_GROUP_HAS_ADDEND) && !rela) goto bad;
+
+        if ((flags & APS2_GROUPED_BY_OFFSET_DELTA) && !aps2_sleb(&p, end, &delta)) goto bad;
+        if ((flags & APS2_GROUPED_BY_INFO) && !aps2_sleb(&p, end, &info)) goto bad;
+        if ((flags & APS2_GROUP_HAS_ADDEND) && (flags & APS2_GROUPED_BY_ADDEND)) {
+            if (!aps2_sleb(&p, end, &v)) goto bad;
+            addend = (int64_t)((uint64_t)addend + (uint64_t)v);
+        } else if (!(flags & APS2_GROUP_HAS_ADDEND)) {
+            addend = 0;
+        }
+
+        for (int64_t j = 0; j < group; j++) {
+            if (flags & APS2_GROUPED_BY_OFFSET_DELTA) v = delta;
+            else if (!aps2_sleb(&p, end, &v)) goto bad;
+            offset = (int64_t)((uint64_t)offset + (uint64_t)v);
+            if (!(flags & APS2_GROUPED_BY_INFO) && !aps2_sleb(&p, end, &info)) goto bad;
+            if ((flags & APS2_GROUP_HAS_ADDEND) && !(flags & APS2_GROUPED_BY_ADDEND)) {
+                if (!aps2_sleb(&p, end, &v)) goto bad;
+                addend = (int64_t)((uint64_t)addend + (uint64_t)v);
+            }
+
+            if (n == cap) {
+                cap *= 2;
+                elf_reloc_t *grown = realloc(r, cap * sizeof(elf_reloc_t));
+                if (!grown) goto bad;
+                r = grown;
+            }
+            uint64_t i = (uint64_t)info;
+            r[n++] = (elf_reloc_t){
+                (uint64_t)offset & mask, addend,
+                is64 ? ELF64_R_SYM(i) : ELF32_R_SYM((uint32_t)i),
+                is64 ? ELF64_R_TYPE(i) : ELF32_R_TYPE((uint32_t)i),
+            };
+        }
+    }
+    out->relocs = r;
+    out->count = n;
+    return true;
+
+bad:
+    free(r);
+    return false;
+}
+// ===== END DECODERS =====
+
+bool elf_reloc_table_decode(elf_sections_t *views, uint32_t index, elf_reloc_table_t *out)
+{
+    const unsigned char *data = (const unsigned char*)views->parser->block;
+    bool is64 = data[EI_CLASS] == ELFCLASS64;
+    uint16_t machine = ((Elf32_Ehdr*)data)->e_machine;
+
+    memset(out, 0, sizeof(*out));
+    if (index >= views->shnum) return false;
+
+    Elf64_Shdr sh = elf_section_header(views, index);
+    if (!elf_is_reloc_section(sh.sh_type)) return false;
+    out->section = index;
+    out->sh_type = sh.sh_type;
+    out->symtab = (sh.sh_link < views->shnum) ? sh.sh_link : SHN_UNDEF;
+    out->has_addend = sh.sh_type == SHT_RELA || sh.sh_type == SHT_ANDROID_RELA;
+
+    uint64_t size;
+    const unsigned char *p = elf_section_get(views, index, &size);
+    if (!p) return false;
+
+    bool ok;
+    switch (sh.sh_type) {
+        case SHT_REL:
+        case SHT_RELA:
+            ok = decode_rel(p, size, is64, out->has_addend, out);
+            break;
+        case SHT_RELR:
+        case SHT_ANDROID_RELR:
+            out->symtab = SHN_UNDEF;
+            ok = decode_relr(p, size, is64, relative_type(machine), out);
+            break;
+        default:
+            ok = decode_aps2(p, size, is64, out->has_addend, out);
+            break;
+    }
+    elf_section_put(views, index);
+
+    if (!ok) {
+        fprintf(stderr, COLOR_RED "[!] Malformed relocation table: " COLOR_RESET "%s\n",
+                reloc_section_name(views, index));
+        elf_reloc_table_free(out);
+    }
+    return ok;
+}
+
+void elf_reloc_table_free(elf_reloc_table_t *t)
+{
+    if (!t) return;
+    free(t->relocs);
+    t->relocs = NULL;
+    t->count = 0;
+}
+
+// ===== BEGIN PRINT =====
+/**
+ * @brief Symbol and string tables linked to a relocation table.
+ */
+typedef struct {
+    const unsigned char *syms, *strs;
+    uint64_t nsyms, strsize;
+    uint32_t symtab, strtab;
+} reloc_symbols_t;
+
+static bool open_reloc_symbols(elf_sections_t *views, uint32_t symtab, reloc_symbols_t *rs)
+{
+    memset(rs, 0, sizeof(*rs));
+    if (symtab == SHN_UNDEF) return false;
+
+    Elf64_Shdr sh = elf_section_header(views, symtab);
+    if ((sh.sh_type != SHT_SYMTAB && sh.sh_type != SHT_DYNSYM) || sh.sh_link >= views->shnum) return false;
+
+    uint64_t size;
+    rs->syms = elf_section_get(views, symtab, &size);
+    if (!rs->syms) return false;
+    bool is64 = ((const unsigned char*)views->parser->block)[EI_CLASS] == ELFCLASS64;
+    rs->nsyms = size / (is64 ? sizeof(Elf64_Sym) : sizeof(Elf32_Sym));
+    rs->symtab = symtab;
+
+    rs->strtab = sh.sh_link;
+    rs->strs = elf_section_get(views, rs->strtab, &rs->strsize);
+    if (!rs->strs) {
+        elf_section_put(views, symtab);
+        rs->syms = NULL;
+        return false;
+    }
+    return true;
+}
+
+static void close_reloc_symbols(elf_sections_t *views, reloc_symbols_t *rs)
+{
+    if (!rs->syms) return;
+    elf_section_put(views, rs->symtab);
+    elf_section_put(views, rs->strtab);
+}
+
+/**
+ * @brief Name of a relocation's symbol; section symbols are named after their section.
+ */
+static const char *reloc_symbol_name(const elf_sections_t *views, const reloc_symbols_t *rs, bool is64, uint32_t sym)
+{
+    if (!rs->syms || sym == 0) return "";
+    if (sym >= rs->nsyms) return "<invalid>";
+
+    uint32_t st_name;
+    unsigned char st_type;
+    uint16_t st_shndx;
+    if (is64) {
+        Elf64_Sym s;
+        memcpy(&s, rs->syms + (size_t)sym * sizeof(s), sizeof(s));
+        st_name = s.st_name, st_type = ELF64_ST_TYPE(s.st_info), st_shndx = s.st_shndx;
+    } else {
+        Elf32_Sym s;
+        memcpy(&s, rs->syms + (size_t)sym * sizeof(s), sizeof(s));
+        st_name = s.st_name, st_type = ELF32_ST_TYPE(s.st_info), st_shndx = s.st_shndx;
+    }
+    if (st_name == 0 && st_type == STT_SECTION && st_shndx != SHN_UNDEF && st_shndx < views->shnum)
+        return reloc_section_name(views, st_shndx);
+    if (st_name >= rs->strsize || !memchr(rs->strs + st_name, 0, rs->strsize - st_name)) return "<invalid>";
+    return (const char*)rs->strs + st_name;
+}
+
+static const char *reloc_format_to_str(uint32_t sh_type)
+{
+    switch (sh_type) {
+        case SHT_REL:          return "REL (addend at the target)";
+        case SHT_RELA:         return "RELA";
+        case SHT_RELR:
+        case SHT_ANDROID_RELR: return "RELR (relative, packed bitmaps)";
+        case SHT_ANDROID_REL:  return "Android APS2 packed REL";
+        default:               return "Android APS2 packed RELA";
+    }
+}
+
+void print_elf_relocs(elf_sections_t *views, uint32_t index)
+{
+    const unsigned char *data = (const unsigned char*)views->parser->block;
+    bool is64 = data[EI_CLASS] == ELFCLASS64;
+    uint16_t machine = ((Elf32_Ehdr*)data)->e_machine;
+
+    elf_reloc_table_t t;
+    if (!elf_reloc_table_decode(views, index, &t)) return;
+
+    reloc_symbols_t rs;
+    open_reloc_symbols(views, t.symtab, &rs);
+
+    printf(COLOR_YELLOW "\n=== Relocation Table: %-15s ===\n" COLOR_RESET, reloc_section_name(views, index));
+    printf("  Format:             %s, %zu entries\n", reloc_format_to_str(t.sh_type), t.count);
+    if (rs.syms) {
+        printf("  Uses symbol table:  %s\n", reloc_section_name(views, rs.symtab));
+        printf("  Uses string table:  %s\n", reloc_section_name(views, rs.strtab));
+    }
+    printf(COLOR_WHITE "--------------------------------------------------------------------------\n" COLOR_RESET);
+    printf(COLOR_WHITE "%-6s %-14s %-14s %-10s %-20s %-12s\n" COLOR_RESET,
+           "Idx", "Offset", "Info", "Addend", "Symbol", "Type");
+    printf(COLOR_WHITE "--------------------------------------------------------------------------\n" COLOR_RESET);
+
+    for (size_t i = 0; i < t.count; i++) {
+        const elf_reloc_t *r = &t.relocs[i];
+        uint64_t info = is64 ? ELF64_R_INFO((uint64_t)r->sym, r->type) : ELF32_R_INFO(r->sym, r->type);
+
+        const char* type_str = elf_reloc_type_to_str(machine, r->type);
+        if (!type_str) type_str = "UNKNOWN";
+
+        const char* type_color = COLOR_CYAN;
+        if (strstr(type_str, "PLT")) type_color = COLOR_GREEN;
+        else if (strstr(type_str, "GLOB")) type_color = COLOR_MAGENTA;
+        else if (strstr(type_str, "RELATIVE")) type_color = COLOR_BLUE;
+
+        char addend[24] = "-";
+        if (t.has_addend) snprintf(addend, sizeof(addend), "%lld", (long long)r->addend);
+
+        printf("%-6zu 0x%012llx 0x%012llx %-10s %-20s %s%-12s" COLOR_RESET "\n",
+               i,
+               (unsigned long long)r->offset,
+               (unsigned long long)info,
+               addend,
+               reloc_symbol_name(views, &rs, is64, r->sym),
+               type_color,
+               type_str);
+    }
+    printf("\n\n");
+
+    close_reloc_symbols(views, &rs);
+    elf_reloc_table_free(&t);
+}
+// ===== END PRINT =====
@@ -0,0 +1,78 @@
+/**
+ * @file b_elf_relocs.h
+ * @brief Relocation tables of an ELF file, decoded into one flat layout.
+ *
+ * Every table format is decoded into the same array of elf_reloc_t:
+ * - SHT_REL:  Elf32_Rel / Elf64_Rel, the addend is stored at the target.
+ * - SHT_RELA: Elf32_Rela / Elf64_Rela.
+ * - SHT_RELR (and SHT_ANDROID_RELR): relative relocations packed as an
+ *   address word followed by bitmap words. Each bitmap is expanded with a
+ *   bit-scan loop (count trailing zeros, clear the lowest bit), so the cost
+ *   is one step per relocation and not per bit. The output is counted with
+ *   popcount first and allocated once.
+ * - SHT_ANDROID_REL / SHT_ANDROID_RELA: "APS2" packed relocations, groups of
+ *   SLEB128 deltas (Android's `--pack-dyn-relocs=android`).
+ *
+ * Little-endian files only.
+ */
+#ifndef B_ELF_RELOCS_H
+#define B_ELF_RELOCS_H
+#include "../bparser/bparser.h"
+#include "../../baseer.h"
+#include "../b_elf_sections/b_elf_sections.h"
+#include "../bx_elf_utils/bx_elf_utils.h"
+#include <elf.h>
+#include <stdint.h>
+
+#define ELF_RELOCS_MAX      (64ull * 1024 * 1024)   /**< Most relocations decoded from one table */
+
+/**
+ * @brief One relocation.
+ */
+typedef struct {
+    uint64_t offset;            /**< r_offset (a virtual address, or a section offset in ET_REL) */
+    int64_t addend;             /**< 0 when the addend is stored at the target (REL, RELR) */
+    uint32_t sym;               /**< Symbol index in the linked table, 0 for none */
+    uint32_t type;              /**< Machine-specific R_* type */
+} elf_reloc_t;
+
+/**
+ * @brief One decoded relocation table.
+ */
+typedef struct {
+    elf_reloc_t *relocs;
+    size_t count;
+    uint32_t section;           /**< Index of the relocation section */
+    uint32_t sh_type;
+    uint32_t symtab;            /**< Linked symbol table (sh_link), SHN_UNDEF for none */
+    bool has_addend;            /**< The addends are explicit (RELA and APS2 RELA) */
+} elf_reloc_table_t;
+
+/**
+ * @brief Is this section type a relocation table decoded here?
+ */
+bool elf_is_reloc_section(uint32_t sh_type);
+
+/**
+ * @brief Decode the relocation section `index`.
+ *
+ * @param out Output table (free with elf_reloc_table_free()).
+ * @return false if the section is not a relocation table or is malformed
+ *         (an error is printed).
+ */
+bool elf_reloc_table_decode(elf_sections_t *views, uint32_t index, elf_reloc_table_t *out);
+void elf_reloc_table_free(elf_reloc_table_t *t);
+
+/**
+ * @brief R_* name of a relocation type.
+ *
+ * @return The name, NULL if the type or machine is not known.
+ */
+const char *elf_reloc_type_to_str(uint16_t machine, uint32_t type);
+
+/**
+ * @brief Print a relocation table (any of the formats above).
+ */
+void print_elf_relocs(elf_sections_t *views, uint32_t index);
+
+#endif
@@ -0,0 +1,320 @@
+/**
+ * @file b_elf_sections.c
+ * @brief Section views with on-demand decompression and an LRU cache.
+ */
+#include "b_elf_sections.h"
+#include "../bx_elf_utils/bx_elf_utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+#ifdef BASEER_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+// ===== BEGIN HEADERS =====
+Elf64_Shdr elf_section_header(const elf_sections_t *s, uint32_t index)
+{
+    const unsigned char *data = (const unsigned char*)s->parser->block;
+    Elf64_Shdr sh;
+    if (data[EI_CLASS] == ELFCLASS32) {
+        Elf32_Shdr *h = (Elf32_Shdr*)(data + ((Elf32_Ehdr*)data)->e_shoff) + index;
+        sh = (Elf64_Shdr){h->sh_name, h->sh_type, h->sh_flags, h->sh_addr, h->sh_offset,
+                          h->sh_size, h->sh_link, h->sh_info, h->sh_addralign, h->sh_entsize};
+    } else {
+        sh = ((Elf64_Shdr*)(data + ((Elf64_Ehdr*)data)->e_shoff))[index];
+    }
+    return sh;
+}
+
+/**
+ * @brief Name of a section, NULL if it is not NUL-terminated inside the file.
+ */
+static const char *section_name(const elf_sections_t *s, uint32_t index)
+{
+    const char *name = elf_section_name(s->parser, index);
+    if (!name) return NULL;
+    size_t off = (size_t)(name - (const char*)s->parser->block);
+    return memchr(name, 0, s->parser->size - off) ? name : NULL;
+}
+
+/**
+ * @brief Locate the compressed stream of a section.
+ *
+ * @param src    Output start of the compressed data.
+ * @param srclen Output length of the compressed data.
+ * @return true if the section is compressed (SHF_COMPRESSED or `.zdebug`).
+ */
+static bool compressed_payload(const elf_sections_t *s, uint32_t index, const Elf64_Shdr *sh,
+                               uint32_t *type, uint64_t *size, const unsigned char **src, uint64_t *srclen)
+{
+    const unsigned char *data = (const unsigned char*)s->parser->block;
+    const unsigned char *p = data + sh->sh_offset;
+
+    if (sh->sh_type == SHT_NOBITS) return false;
+    if (sh->sh_flags & SHF_COMPRESSED) {
+        uint64_t hdr;
+        if (data[EI_CLASS] == ELFCLASS32) {
+            Elf32_Chdr ch;
+            if (sh->sh_size < sizeof(ch)) return false;
+            memcpy(&ch, p, sizeof(ch));
+            *type = ch.ch_type, *size = ch.ch_size, hdr = sizeof(ch);
+        } else {
+            Elf64_Chdr ch;
+            if (sh->sh_size < sizeof(ch)) return false;
+            memcpy(&ch, p, sizeof(ch));
+            *type = ch.ch_type, *size = ch.ch_size, hdr = sizeof(ch);
+        }
+        *src = p + hdr;
+        *srclen = sh->sh_size - hdr;
+        return true;
+    }
+
+    // GNU .zdebug_* sections: "ZLIB", 64-bit big-endian size, zlib stream
+    const char *name = section_name(s, index);
+    if (name && strncmp(name, ".zdebug", 7) == 0 && sh->sh_size >= ELF_ZDEBUG_HEADER && memcmp(p, "ZLIB", 4) == 0) {
+        uint64_t n = 0;
+        for (int i = 4; i < ELF_ZDEBUG_HEADER; i++) n = (n << 8) | p[i];
+        *type = ELFCOMPRESS_ZLIB, *size = n;
+        *src = p + ELF_ZDEBUG_HEADER;
+        *srclen = sh->sh_size - ELF_ZDEBUG_HEADER;
+        return true;
+    }
+    return false;
+}
+
+const char *elf_compress_type_to_str(uint32_t type)
+{
+    switch (type) {
+    case ELFCOMPRESS_ZLIB: return "zlib";
+    case ELFCOMPRESS_ZSTD: return "zstd";
+    default:               return "unknown";
+    }
+}
+// ===== END HEADERS =====
+
+// ===== BEGIN CACHE =====
+elf_sections_t *elf_sections_open(bparser *parser, uint64_t budget)
+{
+    uint32_t shnum = elf_shnum(parser);
+    if (!shnum) return NULL;
+
+    elf_sections_t *s = calloc(1, sizeof(*s));
+    if (!s) return NULL;
+    s->parser = parser;
+    s->shnum = shnum;
+    s->slots = calloc(shnum, sizeof(*s->slots));
+    s->cached = malloc(shnum * sizeof(*s->cached));
+    if (!s->slots || !s->cached) {
+        elf_sections_close(s);
+        return NULL;
+    }
+
+    const char *env = getenv("BASEER_SECTION_CACHE_MB");
+    if (!budget && env && *env) budget = strtoull(env, NULL, 10) * 1024 * 1024;
+    s->budget = budget ? budget : ELF_SECTIONS_BUDGET;
+    return s;
+}
+
+void elf_sections_close(elf_sections_t *s)
+{
+    if (!s) return;
+    for (size_t i = 0; s->cached && i < s->ncached; i++)
+        free(s->slots[s->cached[i]].buf);
+    if (s->names) free_map(s->names);
+    free(s->slots);
+    free(s->cached);
+    free(s);
+}
+
+/**
+ * @brief Free least recently used, unpinned sections until `need` more
+ * bytes fit in the budget (or nothing more can be freed).
+ */
+static void make_room(elf_sections_t *s, uint64_t need)
+{
+    while (s->used + need > s->budget) {
+        size_t victim = s->ncached;
+        for (size_t i = 0; i < s->ncached; i++) {
+            const elf_cached_section_t *slot = &s->slots[s->cached[i]];
+            if (slot->pins == 0 && (victim == s->ncached || slot->last_use < s->slots[s->cached[victim]].last_use))
+                victim = i;
+        }
+        if (victim == s->ncached) return;
+
+        elf_cached_section_t *slot = &s->slots[s->cached[victim]];
+        s->used -= slot->size;
+        free(slot->buf);
+        slot->buf = NULL;
+        s->cached[victim] = s->cached[--s->ncached];
+    }
+}
+
+/**
+ * @brief Inflate `srclen` bytes into exactly `size` bytes.
+ */
+static bool inflate_section(uint32_t type, const unsigned char *src, uint64_t srclen, unsigned char *dst, uint64_t size, const char *name)
+{
+    if (type == ELFCOMPRESS_ZLIB) {
+        uLongf len = size;
+        int ret = uncompress(dst, &len, src, srclen);
+        if (ret == Z_OK && len == size) return true;
+        fprintf(stderr, COLOR_RED "[!] Corrupt zlib data in section: " COLOR_RESET "%s\n", name);
+        return false;
+    }
+    if (type == ELFCOMPRESS_ZSTD) {
+#ifdef BASEER_HAVE_ZSTD
+        size_t ret = ZSTD_decompress(dst, size, src, srclen);
+        if (!ZSTD_isError(ret) && ret == size) return true;
+        fprintf(stderr, COLOR_RED "[!] Corrupt zstd data in section: " COLOR_RESET "%s\n", name);
+#else
+        fprintf(stderr, COLOR_YELLOW "[!] zstd-compressed section (baseer was built without zstd): " COLOR_RESET "%s\n", name);
+#endif
+        return false;
+    }
+    fprintf(stderr, COLOR_RED "[!] Unknown compression type %u in section: " COLOR_RESET "%s\n", type, name);
+    return false;
+}
+
+const unsigned char *elf_section_get(elf_sections_t *s, uint32_t index, uint64_t *size)
+{
+    static const unsigned char empty[1];
+    const unsigned char *data = (const unsigned char*)s->parser->block;
+    *size = 0;
+    if (index >= s->shnum) return NULL;
+
+    elf_cached_section_t *slot = &s->slots[index];
+    if (slot->buf) {
+        slot->pins++;
+        slot->last_use = ++s->clock;
+        *size = slot->size;
+        return slot->buf;
+    }
+
+    Elf64_Shdr sh = elf_section_header(s, index);
+    const char *name = section_name(s, index);
+    if (!name) name = "?";
+    if (sh.sh_type == SHT_NOBITS) return empty;
+    if (sh.sh_offset > s->parser->size || sh.sh_size > s->parser->size - sh.sh_offset) {
+        fprintf(stderr, COLOR_RED "[!] Section extends past the end of the file: " COLOR_RESET "%s\n", name);
+        return NULL;
+    }
+
+    uint32_t type;
+    uint64_t usize, srclen;
+    const unsigned char *src;
+    if (!compressed_payload(s, index, &sh, &type, &usize, &src, &srclen)) {
+        *size = sh.sh_size;
+        return data + sh.sh_offset;
+    }
+    if (usize > ELF_SECTION_MAX) {
+        fprintf(stderr, COLOR_RED "[!] Compressed section too large (0x%llx bytes): " COLOR_RESET "%s\n",
+                (unsigned long long)usize, name);
+        return NULL;
+    }
+
+    make_room(s, usize);
+    unsigned char *buf = malloc(usize ? usize : 1);
+    if (!buf) {
+        fprintf(stderr, COLOR_RED "[!] Out of memory inflating section: " COLOR_RESET "%s\n", name);
+        return NULL;
+    }
+    if (!inflate_section(type, src, srclen, buf, usize, name)) {
+        free(buf);
+        return NULL;
+    }
+
+    slot->buf = buf;
+    slot->size = usize;
+    slot->pins = 1;
+    slot->last_use = ++s->clock;
+    s->used += usize;
+    s->cached[s->ncached++] = index;
+    *size = usize;
+    return buf;
+}
+
+void elf_section_put(elf_sections_t *s, uint32_t index)
+{
+    if (index < s->shnum && s->slots[index].buf && s->slots[index].pins > 0)
+        s->slots[index].pins--;
+}
+
+uint32_t elf_section_find(elf_sections_t *s, const char *name)
+{
+    if (!s->names) {
+        // one pass over the headers, then every lookup is a hash probe
+        s->names = create_map();
+        for (uint32_t i = 1; i < s->shnum; i++) {
+            const char *n = section_name(s, i);
+            if (n && !get(s->names, n)) insert(s->names, n, (void*)(uintptr_t)(i + 1));
+        }
+    }
+    uintptr_t v = (uintptr_t)get(s->names, name);
+    return v ? (uint32_t)(v - 1) : SHN_UNDEF;
+}
+
+bool elf_section_compression(elf_sections_t *s, uint32_t index, uint32_t *type, uint64_t *size)
+{
+    if (index >= s->shnum) return false;
+    Elf64_Shdr sh = elf_section_header(s, index);
+    const unsigned char *src;
+    uint64_t srclen;
+    if (sh.sh_offset > s->parser->size || sh.sh_size > s->parser->size - sh.sh_offset) return false;
+    return compressed_payload(s, index, &sh, type, size, &src, &srclen);
+}
+// ===== END CACHE =====
+
+// ===== BEGIN DUMP =====
+/**
+ * @brief `--dump <section>`: hex dump of the plain bytes of one section.
+ *
+ * Uncompressed sections are dumped at their file offsets, inflated ones at
+ * offsets in the inflated data.
+ */
+bool b_elf_section_dump(bparser *parser, void *arg)
+{
+    const char *spec = baseer_get_opt((inputs*)arg, "--dump");
+    if (!spec) return false;
+
+    elf_sections_t *s = elf_sections_open(parser, 0);
+    if (!s) {
+        fprintf(stderr, COLOR_RED "[!] No section headers\n" COLOR_RESET);
+        return false;
+    }
+
+    char *end;
+    unsigned long n = strtoul(spec, &end, 0);
+    uint32_t index = (*spec && !*end) ? (uint32_t)n : elf_section_find(s, spec);
+    if (index == SHN_UNDEF || index >= s->shnum) {
+        fprintf(stderr, COLOR_RED "[!] No such section: " COLOR_RESET "%s\n", spec);
+        elf_sections_close(s);
+        return false;
+    }
+
+    uint32_t type;
+    uint64_t size, usize;
+    Elf64_Shdr sh = elf_section_header(s, index);
+    const char *name = section_name(s, index);
+    bool compressed = elf_section_compression(s, index, &type, &usize);
+    const unsigned char *bytes = elf_section_get(s, index, &size);
+    if (!bytes) {
+        elf_sections_close(s);
+        return false;
+    }
+
+    printf(COLOR_BLUE "\n=== Section [%u] %s ===\n" COLOR_RESET, index, name ? name : "?");
+    printf(COLOR_GREEN "|--offset    :" COLOR_RESET " 0x%llx\n", (unsigned long long)sh.sh_offset);
+    if (compressed)
+        printf(COLOR_GREEN "|--compressed:" COLOR_RESET " %s, 0x%llx -> 0x%llx bytes\n", elf_compress_type_to_str(type),
+               (unsigned long long)sh.sh_size, (unsigned long long)size);
+    printf(COLOR_GREEN "|--size      :" COLOR_RESET " 0x%llx\n", (unsigned long long)size);
+    if (size)
+        print_body_bytes((unsigned char*)bytes, size, compressed ? 0 : sh.sh_offset, 0,
+                         ((unsigned char*)parser->block)[EI_CLASS]);
+
+    elf_section_put(s, index);
+    elf_sections_close(s);
+    return true;
+}
+// ===== END DUMP =====
@@ -0,0 +1,112 @@
+/**
+ * @file b_elf_sections.h
+ * @brief Section contents of an ELF file, decompressed on demand.
+ *
+ * A view hands out the plain bytes of a section. Uncompressed sections are
+ * returned in place, with no copy. SHF_COMPRESSED sections (an Elf32_Chdr or
+ * Elf64_Chdr, then zlib or zstd data) and legacy `.zdebug_*` sections
+ * ("ZLIB", a big-endian size, then zlib data) are inflated the first time
+ * they are requested and kept in a cache.
+ *
+ * The cache has a memory budget. When a new section does not fit, the least
+ * recently used sections that are not pinned are freed. A section is pinned
+ * from elf_section_get() to elf_section_put(), so a consumer can hold
+ * several sections at once (a DWARF table and its string sections). Pinned
+ * sections are never freed, and may take the cache over its budget.
+ *
+ * Reading the compression header (elf_section_compression()) never
+ * inflates, so listing sections stays as cheap as before.
+ *
+ * zstd needs libzstd at build time (BASEER_HAVE_ZSTD). Without it, zstd
+ * sections are reported and left compressed.
+ *
+ * Options (read from the command line):
+ * - `--dump <section>`  Hex dump of the plain bytes of a section (name or index).
+ */
+#ifndef B_ELF_SECTIONS_H
+#define B_ELF_SECTIONS_H
+#include "../bparser/bparser.h"
+#include "../../baseer.h"
+#include "../b_hashmap/b_hashmap.h"
+#include <elf.h>
+#include <stdint.h>
+
+#ifndef ELFCOMPRESS_ZSTD
+#define ELFCOMPRESS_ZSTD 2
+#endif
+
+#define ELF_SECTIONS_BUDGET   (256ull * 1024 * 1024)   /**< Default cache budget (BASEER_SECTION_CACHE_MB) */
+#define ELF_SECTION_MAX       (4ull * 1024 * 1024 * 1024) /**< Largest section inflated */
+#define ELF_ZDEBUG_HEADER     12                       /**< "ZLIB" and the 64-bit big-endian size */
+
+/**
+ * @brief One section in the cache.
+ */
+typedef struct {
+    unsigned char *buf;         /**< Inflated bytes, NULL while not cached */
+    uint64_t size;
+    uint32_t pins;              /**< elf_section_get() calls not yet matched by elf_section_put() */
+    uint64_t last_use;          /**< Cache clock at the last elf_section_get() */
+} elf_cached_section_t;
+
+/**
+ * @brief Section views of one ELF file.
+ */
+typedef struct {
+    bparser *parser;
+    uint32_t shnum;
+    elf_cached_section_t *slots; /**< Per section index */
+    uint32_t *cached;           /**< Indices of the sections holding a buffer */
+    size_t ncached;
+    uint64_t budget;            /**< Bytes of inflated sections kept */
+    uint64_t used;
+    uint64_t clock;
+    hashmap_t *names;           /**< Name -> index + 1, built on the first lookup */
+} elf_sections_t;
+
+/**
+ * @brief Create the section views of an ELF file.
+ *
+ * @param budget Bytes of inflated sections to keep, 0 for the default
+ *               (ELF_SECTIONS_BUDGET, or BASEER_SECTION_CACHE_MB).
+ * @return The views (free with elf_sections_close()), NULL if the file has
+ *         no section headers.
+ */
+elf_sections_t *elf_sections_open(bparser *parser, uint64_t budget);
+void elf_sections_close(elf_sections_t *s);
+
+/**
+ * @brief Section header `index` (< s->shnum) as a 64-bit header.
+ */
+Elf64_Shdr elf_section_header(const elf_sections_t *s, uint32_t index);
+
+/**
+ * @brief Get the plain bytes of a section and pin them.
+ *
+ * @param size Output size in bytes (0 for SHT_NOBITS).
+ * @return Pointer valid until the matching elf_section_put(), NULL if the
+ *         section cannot be read (an error is printed).
+ */
+const unsigned char *elf_section_get(elf_sections_t *s, uint32_t index, uint64_t *size);
+void elf_section_put(elf_sections_t *s, uint32_t index);
+
+/**
+ * @brief Find a section by name.
+ *
+ * @return Section index, SHN_UNDEF if there is none.
+ */
+uint32_t elf_section_find(elf_sections_t *s, const char *name);
+
+/**
+ * @brief Read the compression header of a section without inflating it.
+ *
+ * @param type Output ELFCOMPRESS_* type.
+ * @param size Output inflated size.
+ * @return true if the section is compressed.
+ */
+bool elf_section_compression(elf_sections_t *s, uint32_t index, uint32_t *type, uint64_t *size);
+const char *elf_compress_type_to_str(uint32_t type);
+
+bool b_elf_section_dump(bparser *parser, void *arg);
+
+#endif
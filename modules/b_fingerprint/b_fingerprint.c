@@ -0,0 +1,566 @@
+/**
+ * @file b_fingerprint.c
+ * @brief Function fingerprints, MinHash signatures and the LSH index file.
+ */
+#include "b_fingerprint.h"
+#include "../b_hash/b_hash.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define FP_BUCKETS      (1u << FP_BUCKET_BITS)
+#define FP_TABLE_COUNT  (FP_BANDS + 1)   /**< Band tables plus the exact-hash table */
+#define FP_PATH_TABLE   FP_TABLE_COUNT   /**< Table of fp_batch_t chains, after the posting tables */
+#define FP_TABLES_SIZE  ((uint64_t)(FP_TABLE_COUNT + 1) * FP_BUCKETS * sizeof(uint64_t))
+#define FP_DATA_START   (FP_INDEX_TABLES + FP_TABLES_SIZE)
+#define FP_ALIGN8(n)    (((n) + 7) & ~(uint64_t)7)
+
+static uint64_t splitmix64(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// ========================= BEGIN NORMALIZATION ==================================
+/**
+ * @brief Mask the bytes of one instruction that depend on where it is linked.
+ *
+ * udis86 does not record where each field starts, but x86 always encodes
+ * `[... modrm sib][displacement][immediates]`, so the fields are found from
+ * the end of the instruction using the operand sizes.
+ *
+ * @param u   Decoder holding the instruction just decoded.
+ * @param buf Copy of the instruction bytes, masked in place.
+ * @param len Instruction length.
+ */
+static void mask_insn(const struct ud *u, unsigned char *buf, unsigned int len)
+{
+    unsigned int imm_total = 0, disp = 0;
+    bool mask_disp = false;
+
+    for (int i = 0; i < 4 && u->operand[i].type != UD_NONE; i++) {
+        const struct ud_operand *op = &u->operand[i];
+        if (op->type == UD_OP_IMM || op->type == UD_OP_JIMM) {
+            imm_total += op->size / 8;
+        } else if (op->type == UD_OP_MEM) {
+            disp = op->offset / 8;
+            // RIP-relative and absolute addresses are relocated
+            mask_disp = op->base == UD_R_RIP || (op->base == UD_NONE && op->index == UD_NONE);
+        }
+    }
+    if (imm_total + disp > len) return;
+
+    unsigned int pos = len - imm_total;
+    for (int i = 0; i < 4 && u->operand[i].type != UD_NONE; i++) {
+        const struct ud_operand *op = &u->operand[i];
+        if (op->type != UD_OP_IMM && op->type != UD_OP_JIMM) continue;
+        unsigned int n = op->size / 8;
+        // branch targets and address-sized immediates change between links
+        if (op->type == UD_OP_JIMM || n >= 4)
+            memset(buf + pos, 0, n);
+        pos += n;
+    }
+    if (mask_disp)
+        memset(buf + len - imm_total - disp, 0, disp);
+}
+
+/**
+ * @brief Compute the fingerprint of one function.
+ *
+ * @return false if the function is too small to be fingerprinted.
+ */
+static bool fingerprint_function(const unsigned char *data, uint8_t mode, const elf_region_t *func, fp_func_t *fp)
+{
+    struct ud u;
+    struct ud_insn_info info;
+    unsigned char insn[16];
+    uint64_t exact = FNV1A_OFFSET;
+    uint16_t window[3] = {0};
+    unsigned int len;
+
+    ud_init(&u);
+    ud_set_mode(&u, mode);
+    ud_set_input_buffer(&u, data + func->off, func->size);
+    ud_set_pc(&u, func->vaddr);
+
+    fp->func = *func;
+    fp->insns = 0;
+    for (int i = 0; i < FP_MINHASH_K; i++) fp->sig[i] = UINT32_MAX;
+
+    while ((len = ud_decode_only(&u, &info)) > 0) {
+        memcpy(insn, ud_insn_ptr(&u), len > sizeof(insn) ? sizeof(insn) : len);
+        mask_insn(&u, insn, len);
+        exact = b_fnv1a_update(exact, insn, len < sizeof(insn) ? len : sizeof(insn));
+
+        window[0] = window[1];
+        window[1] = window[2];
+        window[2] = (uint16_t)info.mnemonic;
+        if (++fp->insns < 3) continue;
+
+        // one independent hash per value: h1 + i * h2 alone keeps the minima correlated
+        uint64_t h = splitmix64(window[0] | (uint64_t)window[1] << 16 | (uint64_t)window[2] << 32);
+        for (int i = 0; i < FP_MINHASH_K; i++) {
+            uint32_t v = (uint32_t)splitmix64(h + (uint64_t)i);
+            if (v < fp->sig[i]) fp->sig[i] = v;
+        }
+    }
+    fp->exact = exact;
+    return fp->insns >= FP_MIN_INSNS;
+}
+
+/**
+ * @brief Fingerprint every function of an ELF file.
+ *
+ * @return Newly allocated array (free with free()), or NULL if there are none.
+ */
+static fp_func_t *fingerprint_file(bparser *parser, size_t *count)
+{
+    const unsigned char *data = parser->block;
+    *count = 0;
+    if (data[EI_CLASS] != ELFCLASS32 && data[EI_CLASS] != ELFCLASS64) return NULL;
+    uint8_t mode = (data[EI_CLASS] == ELFCLASS64) ? 64 : 32;
+
+    b_addrmap *map = elf_build_addrmap(parser);
+    size_t func_count = 0;
+    elf_region_t *funcs = elf_functions(parser, map, &func_count);
+    b_addrmap_free(map);
+    if (!funcs) return NULL;
+
+    fp_func_t *fps = malloc(func_count * sizeof(*fps));
+    size_t n = 0;
+    for (size_t i = 0; fps && i < func_count; i++) {
+        if (fingerprint_function(data, mode, &funcs[i], &fps[n])) n++;
+    }
+    free(funcs);
+    if (n == 0) {
+        free(fps);
+        return NULL;
+    }
+    *count = n;
+    return fps;
+}
+
+static uint64_t band_key(const uint32_t *sig, int band)
+{
+    uint64_t h = splitmix64((uint64_t)band + 1);
+    for (int r = 0; r < FP_ROWS; r++)
+        h = splitmix64(h ^ sig[band * FP_ROWS + r]);
+    return h;
+}
+
+static double sig_similarity(const uint32_t *a, const uint32_t *b)
+{
+    int same = 0;
+    for (int i = 0; i < FP_MINHASH_K; i++) same += (a[i] == b[i]);
+    return (double)same / FP_MINHASH_K;
+}
+// ========================= END NORMALIZATION ==================================
+
+/**
+ * @brief Print the fingerprints of every function of an ELF file.
+ *
+ * @param parser Pointer to a bparser structure containing the ELF file.
+ * @param arg    Pointer to the command-line inputs (unused).
+ * @return true on success, false if no function could be fingerprinted.
+ */
+bool b_fingerprint(bparser *parser, void *arg)
+{
+    size_t count;
+    fp_func_t *fps = fingerprint_file(parser, &count);
+    if (!fps) {
+        fprintf(stderr, COLOR_RED "[!] No functions to fingerprint (needs a symbol table)\n" COLOR_RESET);
+        return false;
+    }
+
+    printf(COLOR_BLUE "\n=== Function Fingerprints ===\n" COLOR_RESET);
+    printf(COLOR_CYAN "%-18s %8s %7s  %-16s  %-35s  %s\n" COLOR_RESET,
+           "Address", "Size", "Insns", "Exact", "MinHash (first 4)", "Name");
+    for (size_t i = 0; i < count; i++) {
+        printf(COLOR_YELLOW "0x%016llx " COLOR_RESET "%8llu %7u  %016llx  %08x %08x %08x %08x  %s\n",
+               (unsigned long long)fps[i].func.vaddr, (unsigned long long)fps[i].func.size, fps[i].insns,
+               (unsigned long long)fps[i].exact, fps[i].sig[0], fps[i].sig[1], fps[i].sig[2], fps[i].sig[3],
+               fps[i].func.name);
+    }
+    free(fps);
+    return true;
+}
+
+// ========================= BEGIN INDEX ==================================
+/**
+ * @brief Size of the record at `off` with its postings, 0 if it does not fit.
+ *
+ * Every add writes a record, its name and path, padding to 8 bytes and then
+ * its FP_TABLE_COUNT postings, so this is also the offset of the next record.
+ */
+static uint64_t record_span(const unsigned char *index, uint64_t index_size, uint64_t off)
+{
+    if (off < FP_DATA_START || off % 8 || off > index_size || index_size - off < sizeof(fp_record_t)) return 0;
+    const fp_record_t *rec = (const fp_record_t*)(index + off);
+    uint64_t span = FP_ALIGN8(sizeof(fp_record_t) + rec->name_len + rec->path_len) +
+                    FP_TABLE_COUNT * sizeof(fp_posting_t);
+    return (span <= index_size - off) ? span : 0;
+}
+
+/**
+ * @brief Find the live batch of an earlier add of the same binary.
+ *
+ * Each add retires the one before it, so only the most recent batch of a
+ * path can still be live.
+ *
+ * @return File offset of its fp_batch_t, 0 if there is none.
+ */
+static uint64_t index_find_batch(const unsigned char *index, uint64_t index_size, uint64_t key,
+                                 const char *path, size_t path_len)
+{
+    const uint64_t *tables = (const uint64_t*)(index + FP_INDEX_TABLES);
+    uint64_t off = tables[(size_t)FP_PATH_TABLE * FP_BUCKETS + (key & (FP_BUCKETS - 1))];
+
+    while (off >= FP_DATA_START && off % 8 == 0 && off <= index_size - sizeof(fp_batch_t)) {
+        const fp_batch_t *batch = (const fp_batch_t*)(index + off);
+        if (batch->key == key && batch->count && record_span(index, index_size, batch->first)) {
+            const fp_record_t *rec = (const fp_record_t*)(index + batch->first);
+            const char *rec_path = (const char*)(rec + 1) + rec->name_len;
+            if (rec->path_len == path_len && memcmp(rec_path, path, path_len) == 0)
+                return (rec->flags & FP_RECORD_RETIRED) ? 0 : off;
+        }
+        if (batch->next >= off) break;   // chains only point backwards
+        off = batch->next;
+    }
+    return 0;
+}
+
+/**
+ * @brief Retire the records of a batch.
+ */
+static void index_retire_batch(unsigned char *index, uint64_t index_size, uint64_t batch_off)
+{
+    const fp_batch_t *batch = (const fp_batch_t*)(index + batch_off);
+    uint64_t off = batch->first, span;
+    for (uint64_t i = 0; i < batch->count && off < batch_off && (span = record_span(index, index_size, off)) != 0; i++) {
+        ((fp_record_t*)(index + off))->flags |= FP_RECORD_RETIRED;
+        off += span;
+    }
+}
+
+/**
+ * @brief Open (and create if needed) an index file for appending.
+ *
+ * The file is locked (LOCK_EX) until the descriptor is closed.
+ *
+ * @return File descriptor, or -1 on error.
+ */
+static int index_open_rw(const char *path, fp_index_header_t *hdr)
+{
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return -1;
+
+    // held until close(): concurrent adds would both append to the same end
+    struct stat st;
+    if (flock(fd, LOCK_EX) != 0 || fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+    if (st.st_size == 0) {
+        memset(hdr, 0, sizeof(*hdr));
+        memcpy(hdr->magic, FP_INDEX_MAGIC, sizeof(FP_INDEX_MAGIC));
+        hdr->version = FP_INDEX_VERSION;
+        hdr->k = FP_MINHASH_K;
+        hdr->bands = FP_BANDS;
+        hdr->rows = FP_ROWS;
+        hdr->bucket_bits = FP_BUCKET_BITS;
+        // the bucket tables stay sparse until they are written
+        if (pwrite(fd, hdr, sizeof(*hdr), 0) != sizeof(*hdr) || ftruncate(fd, FP_DATA_START) != 0) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+    if (pread(fd, hdr, sizeof(*hdr), 0) != sizeof(*hdr) || memcmp(hdr->magic, FP_INDEX_MAGIC, sizeof(FP_INDEX_MAGIC)) != 0 ||
+        hdr->version != FP_INDEX_VERSION || hdr->k != FP_MINHASH_K || hdr->bands != FP_BANDS || hdr->rows != FP_ROWS || hdr->bucket_bits != FP_BUCKET_BITS ||
+        (uint64_t)st.st_size < FP_DATA_START) {
+        errno = EINVAL;
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Add the fingerprints of an ELF file to an index file.
+ *
+ * Records, postings and the batch are built in memory against a private
+ * copy of the bucket heads and appended with one write. Once they and the
+ * header are on disk, the previous add of the same binary is retired and
+ * the touched heads are copied to the shared mapping.
+ *
+ * @param parser Pointer to a bparser structure containing the ELF file.
+ * @param arg    Pointer to the command-line inputs (`--fp-add` is read from it).
+ * @return true on success.
+ */
+bool b_fingerprint_add(bparser *parser, void *arg)
+{
+    inputs *input = arg;
+    const char *index_path = baseer_get_opt(input, "--fp-add");
+    if (!index_path) return false;
+
+    size_t count;
+    fp_func_t *fps = fingerprint_file(parser, &count);
+    if (!fps) {
+        fprintf(stderr, COLOR_RED "[!] No functions to fingerprint (needs a symbol table)\n" COLOR_RESET);
+        return false;
+    }
+
+    // members of one archive share its path, so they are told apart by name
+    char real[PATH_MAX], path[PATH_MAX + 256];
+    if (!realpath(input->args[1], real)) snprintf(real, sizeof(real), "%s", input->args[1]);
+    if (input->member) snprintf(path, sizeof(path), "%s(%s)", real, input->member);
+    else snprintf(path, sizeof(path), "%s", real);
+    size_t path_len = strlen(path);
+    uint64_t path_key = b_fnv1a(path, path_len);
+
+    fp_index_header_t hdr;
+    struct stat st;
+    int fd = index_open_rw(index_path, &hdr);
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        fprintf(stderr, COLOR_RED "[!] Cannot open fingerprint index: " COLOR_RESET "%s (%s)\n", index_path, strerror(errno));
+        if (fd >= 0) close(fd);
+        free(fps);
+        return false;
+    }
+
+    // the shared mapping is only written once the new data is on disk
+    unsigned char *index = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    uint64_t *heads = mmap(NULL, FP_TABLES_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, FP_INDEX_TABLES);
+    if (index == MAP_FAILED || heads == MAP_FAILED) {
+        fprintf(stderr, COLOR_RED "[!] Cannot map fingerprint index: " COLOR_RESET "%s\n", strerror(errno));
+        if (index != MAP_FAILED) munmap(index, st.st_size);
+        if (heads != MAP_FAILED) munmap(heads, FP_TABLES_SIZE);
+        close(fd);
+        free(fps);
+        return false;
+    }
+    uint64_t *tables = (uint64_t*)(index + FP_INDEX_TABLES);
+    uint64_t old_batch = index_find_batch(index, st.st_size, path_key, path, path_len);
+    uint64_t retired = old_batch ? ((const fp_batch_t*)(index + old_batch))->count : 0;
+
+    // size of everything appended by this file
+    size_t total = sizeof(fp_batch_t);
+    for (size_t i = 0; i < count; i++) {
+        size_t name_len = strnlen(fps[i].func.name, UINT16_MAX);
+        total += FP_ALIGN8(sizeof(fp_record_t) + name_len + path_len) + FP_TABLE_COUNT * sizeof(fp_posting_t);
+    }
+    unsigned char *buf = calloc(1, total);
+    size_t *slots = malloc((count * FP_TABLE_COUNT + 1) * sizeof(*slots));
+    uint64_t base = st.st_size;
+    bool ok = buf && slots;
+
+    size_t pos = 0, touched = 0;
+    for (size_t i = 0; ok && i < count; i++) {
+        size_t name_len = strnlen(fps[i].func.name, UINT16_MAX);
+        fp_record_t rec = {
+            .exact = fps[i].exact, .size = (uint32_t)fps[i].func.size, .insns = fps[i].insns,
+            .name_len = (uint16_t)name_len, .path_len = (uint16_t)path_len,
+        };
+        memcpy(rec.sig, fps[i].sig, sizeof(rec.sig));
+        uint64_t rec_off = base + pos;
+        memcpy(buf + pos, &rec, sizeof(rec));
+        memcpy(buf + pos + sizeof(rec), fps[i].func.name, name_len);
+        memcpy(buf + pos + sizeof(rec) + name_len, path, path_len);
+        pos += FP_ALIGN8(sizeof(rec) + name_len + path_len);
+
+        for (int t = 0; t < FP_TABLE_COUNT; t++) {
+            uint64_t key = (t < FP_BANDS) ? band_key(fps[i].sig, t) : fps[i].exact;
+            size_t slot = (size_t)t * FP_BUCKETS + (key & (FP_BUCKETS - 1));
+            fp_posting_t posting = {key, rec_off, heads[slot]};
+            memcpy(buf + pos, &posting, sizeof(posting));
+            heads[slot] = base + pos;
+            slots[touched++] = slot;
+            pos += sizeof(posting);
+        }
+    }
+    if (ok) {
+        size_t slot = (size_t)FP_PATH_TABLE * FP_BUCKETS + (path_key & (FP_BUCKETS - 1));
+        fp_batch_t batch = {path_key, base, count, heads[slot]};
+        memcpy(buf + pos, &batch, sizeof(batch));
+        heads[slot] = base + pos;
+        slots[touched++] = slot;
+        pos += sizeof(batch);
+    }
+
+    // the data and the header that counts it reach the disk before any head points to them
+    if (ok) ok = pwrite(fd, buf, pos, base) == (ssize_t)pos;
+    if (ok) {
+        hdr.records = hdr.records - (retired < hdr.records ? retired : hdr.records) + count;
+        hdr.postings += count * FP_TABLE_COUNT;
+        ok = pwrite(fd, &hdr, sizeof(hdr), 0) == sizeof(hdr) && fdatasync(fd) == 0;
+    }
+    if (ok) {
+        if (old_batch) index_retire_batch(index, st.st_size, old_batch);
+        for (size_t i = 0; i < touched; i++) tables[slots[i]] = heads[slots[i]];
+    }
+    munmap(heads, FP_TABLES_SIZE);
+    munmap(index, st.st_size);
+    close(fd);
+    free(slots);
+    free(buf);
+
+    if (ok && retired)
+        printf(COLOR_GREEN "[+] Replaced %llu functions of " COLOR_RESET "%s\n", (unsigned long long)retired, path);
+    if (ok)
+        printf(COLOR_GREEN "[+] Added %zu functions to " COLOR_RESET "%s" COLOR_GREEN " (%llu indexed)\n" COLOR_RESET,
+               count, index_path, (unsigned long long)hdr.records);
+    else
+        fprintf(stderr, COLOR_RED "[!] Failed to write fingerprint index: " COLOR_RESET "%s\n", index_path);
+    free(fps);
+    return ok;
+}
+
+/**
+ * @brief A candidate found by a query.
+ */
+typedef struct {
+    uint64_t record;
+    double similarity;
+    bool exact;
+} fp_match_t;
+
+static int cmp_match_record(const void *a, const void *b)
+{
+    const fp_match_t *x = a, *y = b;
+    return (x->record > y->record) - (x->record < y->record);
+}
+
+static int cmp_match_similarity(const void *a, const void *b)
+{
+    const fp_match_t *x = a, *y = b;
+    if (x->exact != y->exact) return y->exact - x->exact;
+    if (x->similarity != y->similarity) return x->similarity < y->similarity ? 1 : -1;
+    return cmp_match_record(a, b);
+}
+
+/**
+ * @brief Collect the candidates of one function from the mapped index.
+ *
+ * @return Number of matches written to `out` (deduplicated, best first).
+ */
+static size_t index_lookup(const unsigned char *index, size_t index_size, const fp_func_t *fp, fp_match_t *out, size_t max)
+{
+    const uint64_t *tables = (const uint64_t*)(index + FP_INDEX_TABLES);
+    size_t n = 0;
+
+    for (int t = 0; t < FP_TABLE_COUNT; t++) {
+        uint64_t key = (t < FP_BANDS) ? band_key(fp->sig, t) : fp->exact;
+        uint64_t off = tables[(size_t)t * FP_BUCKETS + (key & (FP_BUCKETS - 1))];
+
+        while (off >= FP_DATA_START && off % 8 == 0 && off <= index_size - sizeof(fp_posting_t) && n < max) {
+            const fp_posting_t *p = (const fp_posting_t*)(index + off);
+            // the whole record (name, path and postings) must be in the file
+            if (p->key == key && record_span(index, index_size, p->record)) {
+                const fp_record_t *rec = (const fp_record_t*)(index + p->record);
+                if (!(rec->flags & FP_RECORD_RETIRED)) {
+                    out[n].record = p->record;
+                    out[n].exact = rec->exact == fp->exact;
+                    out[n].similarity = sig_similarity(rec->sig, fp->sig);
+                    n++;
+                }
+            }
+            if (p->next >= off) break;   // chains only point backwards
+            off = p->next;
+        }
+    }
+
+    // drop the duplicates found through several bands
+    qsort(out, n, sizeof(*out), cmp_match_record);
+    size_t unique = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (unique > 0 && out[unique - 1].record == out[i].record) continue;
+        if (!out[i].exact && out[i].similarity < FP_MIN_SIMILARITY) continue;
+        out[unique++] = out[i];
+    }
+    qsort(out, unique, sizeof(*out), cmp_match_similarity);
+    return unique;
+}
+
+/**
+ * @brief Look up the functions of an ELF file in an index file.
+ *
+ * @param parser Pointer to a bparser structure containing the ELF file.
+ * @param arg    Pointer to the command-line inputs (`--fp-query` and
+ *               `--function` are read from it).
+ * @return true on success.
+ */
+bool b_fingerprint_query(bparser *parser, void *arg)
+{
+    inputs *input = arg;
+    const char *index_path = baseer_get_opt(input, "--fp-query");
+    const char *only = baseer_get_opt(input, "--function");
+    if (!index_path) return false;
+
+    int fd = open(index_path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || flock(fd, LOCK_SH) != 0 || fstat(fd, &st) != 0 || (uint64_t)st.st_size < FP_DATA_START) {
+        fprintf(stderr, COLOR_RED "[!] Cannot open fingerprint index: " COLOR_RESET "%s\n", index_path);
+        if (fd >= 0) close(fd);
+        return false;
+    }
+    // the shared lock is held until close(), so no add runs during the query
+    unsigned char *index = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (index == MAP_FAILED) {
+        fprintf(stderr, COLOR_RED "[!] Cannot map fingerprint index: " COLOR_RESET "%s\n", index_path);
+        close(fd);
+        return false;
+    }
+    const fp_index_header_t *hdr = (const fp_index_header_t*)index;
+    if (memcmp(hdr->magic, FP_INDEX_MAGIC, sizeof(FP_INDEX_MAGIC)) != 0 || hdr->version != FP_INDEX_VERSION || hdr->k != FP_MINHASH_K ||
+        hdr->bands != FP_BANDS || hdr->rows != FP_ROWS || hdr->bucket_bits != FP_BUCKET_BITS) {
+        fprintf(stderr, COLOR_RED "[!] Not a compatible fingerprint index: " COLOR_RESET "%s\n", index_path);
+        munmap(index, st.st_size);
+        close(fd);
+        return false;
+    }
+
+    size_t count;
+    fp_func_t *fps = fingerprint_file(parser, &count);
+    if (!fps) {
+        fprintf(stderr, COLOR_RED "[!] No functions to fingerprint (needs a symbol table)\n" COLOR_RESET);
+        munmap(index, st.st_size);
+        close(fd);
+        return false;
+    }
+
+    size_t max = 4096;
+    fp_match_t *matches = malloc(max * sizeof(*matches));
+    size_t matched = 0;
+    printf(COLOR_BLUE "\n=== Fingerprint Matches (%llu functions indexed) ===\n" COLOR_RESET,
+           (unsigned long long)hdr->records);
+
+    for (size_t i = 0; matches && i < count; i++) {
+        if (only && strcmp(only, fps[i].func.name) != 0) continue;
+        size_t n = index_lookup(index, st.st_size, &fps[i], matches, max);
+        if (n == 0) continue;
+        matched++;
+
+        printf(COLOR_WHITE "\n|-- %s" COLOR_RESET " (0x%llx, %llu bytes, %u insns):\n", fps[i].func.name,
+               (unsigned long long)fps[i].func.vaddr, (unsigned long long)fps[i].func.size, fps[i].insns);
+        for (size_t j = 0; j < n && j < FP_MAX_MATCHES; j++) {
+            const fp_record_t *rec = (const fp_record_t*)(index + matches[j].record);
+            const char *name = (const char*)(rec + 1);
+            printf(COLOR_YELLOW "|----%5.2f %-6s" COLOR_RESET "%.*s " COLOR_GRAY "%.*s" COLOR_RESET "\n",
+                   matches[j].similarity, matches[j].exact ? "exact" : "",
+                   rec->name_len, name, rec->path_len, name + rec->name_len);
+        }
+    }
+    printf(COLOR_GREEN "\nFunctions with matches: " COLOR_RESET "%zu of %zu\n", matched, count);
+
+    free(matches);
+    free(fps);
+    munmap(index, st.st_size);
+    close(fd);
+    return true;
+}
+// ========================= END INDEX ==================================
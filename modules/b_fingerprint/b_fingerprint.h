@@ -0,0 +1,122 @@
+/**
+ * @file b_fingerprint.h
+ * @brief Function fingerprints and an on-disk similarity index.
+ *
+ * Every function is decoded with udis86 and its bytes are normalized by
+ * masking the parts that change when the same code is linked elsewhere:
+ * relative branch targets, RIP-relative and absolute displacements and
+ * 32/64-bit immediates. Two fingerprints are derived from a function:
+ * - an exact hash of the normalized bytes,
+ * - a MinHash signature of its mnemonic trigrams.
+ *
+ * Fingerprints can be appended to an index file and queried with LSH
+ * (banded MinHash). The index is a single file:
+ *
+ *     [header][bucket tables][records and postings ...]
+ *
+ * Each band (plus one table for exact hashes) has a fixed table of bucket
+ * heads; postings are chained through their `next` offsets. Adding a binary
+ * appends to the file and rewrites the touched heads, and a query follows
+ * one chain per band instead of comparing against every record. Chains get
+ * longer as the corpus grows (about records / 2^FP_BUCKET_BITS postings
+ * each), so a query stays cheap but is not constant time. The appended data
+ * and the header are flushed before the heads are rewritten, so the heads
+ * never point past what is on disk.
+ *
+ * Each add also ends with an fp_batch_t chained from a last table, keyed by
+ * the path of the binary (`archive(member)` for archive members and carved
+ * payloads). Adding a binary that is already indexed follows that chain to
+ * its previous add and retires those records, so a query does not report it
+ * twice. Adds take an exclusive flock() on the index and queries a shared one.
+ *
+ * Options (read from the command line):
+ * - `--fingerprint`          Print the fingerprints of every function.
+ * - `--fp-add <index>`       Add the functions of the file to an index.
+ * - `--fp-query <index>`     Look up the functions of the file in an index
+ *                            (only `--function <name>` when given).
+ */
+#ifndef B_FINGERPRINT_H
+#define B_FINGERPRINT_H
+#include "../bparser/bparser.h"
+#include "../../baseer.h"
+#include <elf.h>
+#include <stdint.h>
+#include "udis86.h"
+#include "../bx_elf_utils/bx_elf_utils.h"
+
+#define FP_MINHASH_K     32   /**< MinHash signature length */
+#define FP_BANDS         8    /**< LSH bands */
+#define FP_ROWS          4    /**< Signature values per band */
+#define FP_BUCKET_BITS   18   /**< log2 of buckets per band */
+#define FP_MIN_INSNS     8    /**< Smaller functions are not fingerprinted */
+#define FP_MIN_SIMILARITY 0.5 /**< Lowest estimated similarity reported */
+#define FP_MAX_MATCHES   10   /**< Matches printed per function */
+
+#define FP_INDEX_MAGIC   "BFPIDX1"
+#define FP_INDEX_VERSION 2
+#define FP_INDEX_TABLES  4096 /**< File offset of the bucket tables */
+
+/**
+ * @brief Fingerprint of one function.
+ */
+typedef struct {
+    elf_region_t func;
+    uint64_t exact;                  /**< Hash of the normalized bytes */
+    uint32_t sig[FP_MINHASH_K];      /**< MinHash of mnemonic trigrams */
+    uint32_t insns;
+} fp_func_t;
+
+/**
+ * @brief Header at the start of an index file.
+ */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t k;
+    uint32_t bands;
+    uint32_t rows;
+    uint32_t bucket_bits;
+    uint32_t reserved;
+    uint64_t records;
+    uint64_t postings;
+} fp_index_header_t;
+
+/**
+ * @brief One indexed function, followed by its name and binary path.
+ */
+typedef struct {
+    uint64_t exact;
+    uint32_t sig[FP_MINHASH_K];
+    uint32_t size;
+    uint32_t insns;
+    uint16_t name_len;
+    uint16_t path_len;
+    uint32_t flags;          /**< FP_RECORD_* */
+} fp_record_t;
+
+#define FP_RECORD_RETIRED 1  /**< Replaced by a later add of the same binary */
+
+/**
+ * @brief Entry of a bucket chain.
+ */
+typedef struct {
+    uint64_t key;      /**< Band hash or exact hash */
+    uint64_t record;   /**< File offset of the fp_record_t */
+    uint64_t next;     /**< File offset of the next posting, 0 at the end */
+} fp_posting_t;
+
+/**
+ * @brief Records appended by one add, at the end of its data.
+ */
+typedef struct {
+    uint64_t key;      /**< Hash of the binary path */
+    uint64_t first;    /**< File offset of the first fp_record_t */
+    uint64_t count;    /**< Records appended (they follow each other) */
+    uint64_t next;     /**< File offset of the previous batch in the chain, 0 at the end */
+} fp_batch_t;
+
+bool b_fingerprint(bparser *parser, void *arg);
+bool b_fingerprint_add(bparser *parser, void *arg);
+bool b_fingerprint_query(bparser *parser, void *arg);
+
+#endif
@@ -0,0 +1,410 @@
+/**
+ * @file b_gadgets.c
+ * @brief Parallel ROP/JOP gadget finder.
+ */
+#define _GNU_SOURCE
+#include "b_gadgets.h"
+#include "../b_hash/b_hash.h"
+#include <pthread.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief Work shared by all gadget worker threads.
+ */
+typedef struct {
+    const unsigned char *data;
+    const gadget_region_t *regions;
+    int region_count;
+    const uint64_t (*chunks)[2];   /**< {region index, start offset inside region} */
+    size_t chunk_count;
+    size_t next_chunk;             /**< Next chunk to pick up (atomic) */
+    uint8_t mode;                  /**< 32 or 64 */
+    int depth;
+} gadget_job_t;
+
+/**
+ * @brief Per-thread gadget list.
+ */
+typedef struct {
+    gadget_job_t *job;
+    gadget_t *items;
+    size_t count;
+    size_t cap;
+} gadget_worker_t;
+
+/**
+ * @brief Check whether the instruction just decoded ends a gadget.
+ */
+static bool is_terminator(const struct ud *u, enum ud_mnemonic_code m)
+{
+    switch (m) {
+    case UD_Iret:
+    case UD_Isyscall:
+    case UD_Isysenter:
+        return true;
+    case UD_Iint:
+        return u->operand[0].type == UD_OP_IMM && u->operand[0].lval.ubyte == 0x80;
+    case UD_Ijmp:
+    case UD_Icall:
+        // jmp reg / call reg, and their memory forms through a register
+        return u->operand[0].type == UD_OP_REG ||
+               (u->operand[0].type == UD_OP_MEM && u->operand[0].base != UD_NONE && u->operand[0].base != UD_R_RIP);
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Check whether an instruction changes control flow (not allowed inside a gadget).
+ */
+static bool is_branch(enum ud_mnemonic_code m)
+{
+    switch (m) {
+    case UD_Iret: case UD_Iretf: case UD_Ijmp: case UD_Icall:
+    case UD_Ijo: case UD_Ijno: case UD_Ijb: case UD_Ijae: case UD_Ijz: case UD_Ijnz:
+    case UD_Ijbe: case UD_Ija: case UD_Ijs: case UD_Ijns: case UD_Ijp: case UD_Ijnp:
+    case UD_Ijl: case UD_Ijge: case UD_Ijle: case UD_Ijg:
+    case UD_Ijcxz: case UD_Ijecxz: case UD_Ijrcxz:
+    case UD_Iloop: case UD_Iloope: case UD_Iloopne:
+    case UD_Isyscall: case UD_Isysenter: case UD_Isysret: case UD_Isysexit:
+    case UD_Iint: case UD_Iint1: case UD_Iint3: case UD_Iinto:
+    case UD_Ihlt: case UD_Iinvalid:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static void worker_push(gadget_worker_t *w, const gadget_t *g)
+{
+    if (w->count == w->cap) {
+        size_t cap = w->cap ? w->cap * 2 : 1024;
+        gadget_t *items = realloc(w->items, cap * sizeof(*items));
+        if (!items) return;
+        w->items = items;
+        w->cap = cap;
+    }
+    w->items[w->count++] = *g;
+}
+
+/**
+ * @brief Decode backwards from a terminator at `pos` and record every valid gadget.
+ *
+ * Each start offset in the window before the terminator is decoded forward;
+ * a start is kept only if the decoding lands exactly on the end of the
+ * terminator without passing through another branch.
+ */
+static void collect_at(gadget_worker_t *w, struct ud *u, const gadget_region_t *r, uint64_t pos)
+{
+    gadget_job_t *job = w->job;
+    const unsigned char *base = job->data + r->off;
+    struct ud_insn_info info;
+
+    // decode the terminator itself to know where the gadget ends
+    ud_set_input_buffer(u, base + pos, r->size - pos);
+    ud_set_pc(u, r->vaddr + pos);
+    if (!ud_decode_only(u, &info) || !is_terminator(u, info.mnemonic)) return;
+    uint64_t end = pos + info.len;
+
+    uint64_t window = (uint64_t)job->depth * GADGET_INSN_BYTES;
+    uint64_t first = (pos > window) ? pos - window : 0;
+
+    for (uint64_t start = pos + 1; start-- > first; ) {
+        uint64_t cur = start;
+        int count = 0;
+        bool ok = false;
+
+        ud_set_input_buffer(u, base + start, end - start);
+        ud_set_pc(u, r->vaddr + start);
+        while (cur < end && count <= job->depth) {
+            unsigned int len = ud_decode_only(u, &info);
+            if (len == 0) break;
+            cur += len;
+            count++;
+            if (cur == end) {
+                ok = is_terminator(u, info.mnemonic);
+                break;
+            }
+            if (is_branch(info.mnemonic)) break;
+        }
+        if (!ok) continue;
+
+        gadget_t g = {
+            .off = r->off + start,
+            .vaddr = r->vaddr + start,
+            .hash = b_fnv1a(base + start, end - start),
+            .len = (uint32_t)(end - start),
+        };
+        worker_push(w, &g);
+    }
+}
+
+/**
+ * @brief Return a bitmask of candidate terminator bytes in a 16-byte block.
+ *
+ * Bit i is set when block[i] may start `ret` (c3/c2), `jmp/call reg` (ff),
+ * `syscall`/`sysenter` (0f 05 / 0f 34) or `int 0x80` (cd 80).
+ */
+static inline unsigned int scan_block(const unsigned char *p)
+{
+#ifdef __SSE2__
+    __m128i v    = _mm_loadu_si128((const __m128i*)p);
+    __m128i next = _mm_loadu_si128((const __m128i*)(p + 1));
+    __m128i m = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8((char)0xc3)),
+                             _mm_cmpeq_epi8(v, _mm_set1_epi8((char)0xc2)));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8((char)0xff)));
+    __m128i sys = _mm_and_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(0x0f)),
+                                _mm_or_si128(_mm_cmpeq_epi8(next, _mm_set1_epi8(0x05)),
+                                             _mm_cmpeq_epi8(next, _mm_set1_epi8(0x34))));
+    __m128i i80 = _mm_and_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8((char)0xcd)),
+                                _mm_cmpeq_epi8(next, _mm_set1_epi8((char)0x80)));
+    m = _mm_or_si128(m, _mm_or_si128(sys, i80));
+    return (unsigned int)_mm_movemask_epi8(m);
+#else
+    unsigned int mask = 0;
+    for (int i = 0; i < 16; i++) {
+        unsigned char c = p[i], n = p[i + 1];
+        if (c == 0xc3 || c == 0xc2 || c == 0xff ||
+            (c == 0x0f && (n == 0x05 || n == 0x34)) || (c == 0xcd && n == 0x80))
+            mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+static void *gadget_worker(void *arg)
+{
+    gadget_worker_t *w = arg;
+    gadget_job_t *job = w->job;
+    struct ud u;
+    ud_init(&u);
+    ud_set_mode(&u, job->mode);
+
+    for (;;) {
+        size_t c = __atomic_fetch_add(&job->next_chunk, 1, __ATOMIC_RELAXED);
+        if (c >= job->chunk_count) break;
+
+        const gadget_region_t *r = &job->regions[job->chunks[c][0]];
+        const unsigned char *base = job->data + r->off;
+        uint64_t pos = job->chunks[c][1];
+        uint64_t stop = pos + GADGET_CHUNK_SIZE;
+        if (stop > r->size) stop = r->size;
+
+        // SIMD scan while a full block plus the look-ahead byte is available
+        for (; pos < stop && pos + 17 <= r->size; pos += 16) {
+            unsigned int mask = scan_block(base + pos);
+            while (mask) {
+                unsigned int bit = __builtin_ctz(mask);
+                mask &= mask - 1;
+                if (pos + bit < stop)
+                    collect_at(w, &u, r, pos + bit);
+            }
+        }
+        for (; pos < stop; pos++) {
+            unsigned char b = base[pos];
+            unsigned char n = (pos + 1 < r->size) ? base[pos + 1] : 0;
+            if (b == 0xc3 || b == 0xc2 || b == 0xff ||
+                (b == 0x0f && (n == 0x05 || n == 0x34)) || (b == 0xcd && n == 0x80))
+                collect_at(w, &u, r, pos);
+        }
+    }
+    return NULL;
+}
+
+// ========================= BEGIN REGIONS ==================================
+/**
+ * @brief Collect the executable regions of an ELF file.
+ *
+ * Executable PT_LOAD segments are used when present; relocatable objects
+ * fall back to SHF_EXECINSTR sections.
+ *
+ * @return Number of regions written to `out` (at most `max`).
+ */
+static int elf_exec_regions(bparser *parser, gadget_region_t *out, int max)
+{
+    const unsigned char *data = parser->block;
+    int n = 0;
+
+#define COLLECT_EXEC_REGIONS(EHDR, PHDR, SHDR)                                               \
+    do {                                                                                     \
+        EHDR *elf = (EHDR*)data;                                                             \
+        if (elf->e_phoff && elf->e_phoff + (uint64_t)elf->e_phnum * sizeof(PHDR) <= parser->size) { \
+            PHDR *ph = (PHDR*)(data + elf->e_phoff);                                         \
+            for (int i = 0; i < elf->e_phnum && n < max; i++) {                              \
+                if (ph[i].p_type != PT_LOAD || !(ph[i].p_flags & PF_X)) continue;            \
+                if (ph[i].p_offset >= parser->size) continue;                                \
+                uint64_t size = ph[i].p_filesz;                                              \
+                if (size > parser->size - ph[i].p_offset) size = parser->size - ph[i].p_offset; \
+                out[n++] = (gadget_region_t){ph[i].p_offset, size, ph[i].p_vaddr};          \
+            }                                                                                \
+        }                                                                                    \
+        uint64_t shnum = elf->e_shnum;                                                       \
+        if (shnum == 0 && elf->e_shoff && elf->e_shoff < parser->size &&                     \
+            parser->size - elf->e_shoff >= sizeof(SHDR))                                     \
+            shnum = ((SHDR*)(data + elf->e_shoff))->sh_size;    /* extended numbering */     \
+        if (n == 0 && elf->e_shoff && elf->e_shoff < parser->size &&                         \
+            shnum <= (parser->size - elf->e_shoff) / sizeof(SHDR)) {                         \
+            SHDR *sh = (SHDR*)(data + elf->e_shoff);                                         \
+            for (uint64_t i = 0; i < shnum && n < max; i++) {                                \
+                if (!(sh[i].sh_flags & SHF_EXECINSTR) || sh[i].sh_type == SHT_NOBITS) continue; \
+                if (sh[i].sh_offset >= parser->size) continue;                               \
+                uint64_t size = sh[i].sh_size;                                               \
+                if (size > parser->size - sh[i].sh_offset) size = parser->size - sh[i].sh_offset; \
+                out[n++] = (gadget_region_t){sh[i].sh_offset, size, sh[i].sh_addr};          \
+            }                                                                                \
+        }                                                                                    \
+    } while (0)
+
+    if (data[EI_CLASS] == ELFCLASS32) {
+        COLLECT_EXEC_REGIONS(Elf32_Ehdr, Elf32_Phdr, Elf32_Shdr);
+    } else if (data[EI_CLASS] == ELFCLASS64) {
+        COLLECT_EXEC_REGIONS(Elf64_Ehdr, Elf64_Phdr, Elf64_Shdr);
+    }
+#undef COLLECT_EXEC_REGIONS
+    return n;
+}
+// ========================= END REGIONS ==================================
+
+static int cmp_gadget_bytes(const void *a, const void *b, void *data)
+{
+    const gadget_t *x = a, *y = b;
+    if (x->hash != y->hash) return x->hash < y->hash ? -1 : 1;
+    if (x->len != y->len) return x->len < y->len ? -1 : 1;
+    int c = memcmp((const unsigned char*)data + x->off, (const unsigned char*)data + y->off, x->len);
+    if (c) return c;
+    return (x->vaddr > y->vaddr) - (x->vaddr < y->vaddr);
+}
+
+static int cmp_gadget_vaddr(const void *a, const void *b)
+{
+    const gadget_t *x = a, *y = b;
+    if (x->vaddr != y->vaddr) return x->vaddr < y->vaddr ? -1 : 1;
+    return (x->len > y->len) - (x->len < y->len);
+}
+
+/**
+ * @brief Print one gadget as `address: insn ; insn ; terminator`.
+ */
+static void print_gadget(struct ud *u, const unsigned char *data, const gadget_t *g)
+{
+    ud_set_input_buffer(u, data + g->off, g->len);
+    ud_set_pc(u, g->vaddr);
+    printf(COLOR_YELLOW "0x%08llx: " COLOR_RESET, (unsigned long long)g->vaddr);
+    bool first = true;
+    while (ud_disassemble(u)) {
+        printf("%s%s", first ? "" : COLOR_GRAY " ; " COLOR_RESET, ud_insn_asm(u));
+        first = false;
+    }
+    printf("\n");
+}
+
+/**
+ * @brief Find and print the ROP/JOP gadgets of an ELF file.
+ *
+ * @param parser Pointer to a bparser structure containing the ELF file.
+ * @param arg    Pointer to the command-line inputs (`--depth` is read from it).
+ * @return true on success, false if the file has no executable code.
+ */
+bool b_gadgets(bparser *parser, void *arg)
+{
+    const unsigned char *data = parser->block;
+    if (data[EI_CLASS] != ELFCLASS32 && data[EI_CLASS] != ELFCLASS64) {
+        fprintf(stderr, COLOR_RED "[!] Unknown ELF class: %d\n" COLOR_RESET, data[EI_CLASS]);
+        return false;
+    }
+
+    int depth = GADGET_DEFAULT_DEPTH;
+    const char *depth_opt = baseer_get_opt(arg, "--depth");
+    if (depth_opt) {
+        depth = atoi(depth_opt);
+        if (depth < 0) depth = 0;
+        if (depth > GADGET_MAX_DEPTH) depth = GADGET_MAX_DEPTH;
+    }
+
+    gadget_region_t regions[64];
+    int region_count = elf_exec_regions(parser, regions, 64);
+    if (region_count == 0) {
+        fprintf(stderr, COLOR_RED "[!] No executable code found\n" COLOR_RESET);
+        return false;
+    }
+
+    // split the regions into fixed-size chunks for the workers
+    size_t chunk_count = 0;
+    for (int i = 0; i < region_count; i++)
+        chunk_count += (regions[i].size + GADGET_CHUNK_SIZE - 1) / GADGET_CHUNK_SIZE;
+    uint64_t (*chunks)[2] = malloc((chunk_count ? chunk_count : 1) * sizeof(*chunks));
+    if (!chunks) return false;
+    size_t c = 0;
+    for (int i = 0; i < region_count; i++) {
+        for (uint64_t off = 0; off < regions[i].size; off += GADGET_CHUNK_SIZE) {
+            chunks[c][0] = i;
+            chunks[c][1] = off;
+            c++;
+        }
+    }
+
+    gadget_job_t job = {
+        .data = data, .regions = regions, .region_count = region_count,
+        .chunks = (const uint64_t (*)[2])chunks, .chunk_count = chunk_count, .next_chunk = 0,
+        .mode = (data[EI_CLASS] == ELFCLASS64) ? 64 : 32, .depth = depth,
+    };
+
+    int threads = get_thread_count();
+    if ((size_t)threads > chunk_count) threads = chunk_count ? (int)chunk_count : 1;
+    gadget_worker_t workers[BASEER_MAX_THREADS] = {0};
+    pthread_t tids[BASEER_MAX_THREADS];
+    for (int t = 0; t < threads; t++) {
+        workers[t].job = &job;
+        if (t > 0 && pthread_create(&tids[t], NULL, gadget_worker, &workers[t]) != 0) {
+            // run the remaining work on this thread
+            threads = t;
+            break;
+        }
+    }
+    gadget_worker(&workers[0]);
+    for (int t = 1; t < threads; t++)
+        pthread_join(tids[t], NULL);
+    free(chunks);
+
+    // merge the per-thread lists
+    size_t total = 0;
+    for (int t = 0; t < threads; t++) total += workers[t].count;
+    gadget_t *all = malloc((total ? total : 1) * sizeof(*all));
+    if (!all) {
+        for (int t = 0; t < threads; t++) free(workers[t].items);
+        return false;
+    }
+    size_t n = 0;
+    for (int t = 0; t < threads; t++) {
+        if (workers[t].count)
+            memcpy(all + n, workers[t].items, workers[t].count * sizeof(*all));
+        n += workers[t].count;
+        free(workers[t].items);
+    }
+
+    // dedupe by bytes, keeping the lowest address of every gadget
+    qsort_r(all, n, sizeof(*all), cmp_gadget_bytes, (void*)data);
+    size_t unique = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (unique > 0 && all[unique - 1].hash == all[i].hash && all[unique - 1].len == all[i].len &&
+            memcmp(data + all[unique - 1].off, data + all[i].off, all[i].len) == 0)
+            continue;
+        all[unique++] = all[i];
+    }
+    qsort(all, unique, sizeof(*all), cmp_gadget_vaddr);
+
+    printf(COLOR_BLUE "\n=== Gadgets ===\n" COLOR_RESET);
+    struct ud u;
+    ud_init(&u);
+    ud_set_mode(&u, job.mode);
+    ud_set_syntax(&u, UD_SYN_INTEL);
+    for (size_t i = 0; i < unique; i++)
+        print_gadget(&u, data, &all[i]);
+
+    printf(COLOR_GREEN "\nUnique gadgets found: " COLOR_RESET "%zu (%zu total, depth %d, %d threads)\n",
+           unique, n, depth, threads);
+    free(all);
+    return true;
+}
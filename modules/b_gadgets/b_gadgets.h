@@ -0,0 +1,53 @@
+/**
+ * @file b_gadgets.h
+ * @brief ROP/JOP gadget finder for ELF files.
+ *
+ * Candidate terminators (`ret`, `jmp reg`, `call reg`, `syscall`, `int 0x80`)
+ * are located with a SIMD byte scan over the executable segments. Every
+ * candidate is decoded backwards with udis86 up to a configurable depth,
+ * gadgets are deduplicated by a hash of their bytes and printed with their
+ * virtual address.
+ *
+ * Segments are split into chunks that worker threads pick up, so large
+ * libraries are processed in parallel.
+ *
+ * Options (read from the command line):
+ * - `--depth <n>` Maximum number of instructions before the terminator (default 4).
+ *
+ * @see b_gadgets()
+ */
+#ifndef B_GADGETS_H
+#define B_GADGETS_H
+#include "../bparser/bparser.h"
+#include "../../baseer.h"
+#include <elf.h>
+#include <stdint.h>
+#include "udis86.h"
+
+#define GADGET_DEFAULT_DEPTH 4   /**< Instructions before the terminator */
+#define GADGET_MAX_DEPTH     16
+#define GADGET_INSN_BYTES    8   /**< Bytes scanned back per instruction of depth */
+#define GADGET_CHUNK_SIZE    (256 * 1024)
+
+/**
+ * @brief One executable region of the file.
+ */
+typedef struct {
+    uint64_t off;    /**< File offset */
+    uint64_t size;   /**< Bytes backed by the file */
+    uint64_t vaddr;  /**< Virtual address of the first byte */
+} gadget_region_t;
+
+/**
+ * @brief One gadget found in the file.
+ */
+typedef struct {
+    uint64_t off;    /**< File offset of the first instruction */
+    uint64_t vaddr;  /**< Virtual address of the first instruction */
+    uint64_t hash;   /**< FNV-1a hash of the gadget bytes */
+    uint32_t len;    /**< Length of the gadget in bytes */
+} gadget_t;
+
+bool b_gadgets(bparser *parser, void *arg);
+
+#endif
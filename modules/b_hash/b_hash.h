@@ -0,0 +1,59 @@
+/**
+ * @file b_hash.h
+ * @brief SHA-256 of a file or of a sub-range of it (`--hash`), and the
+ * FNV-1a hash used by the in-memory and on-disk hash tables.
+ */
+#ifndef B_HASH_H
+#define B_HASH_H
+#include "../bparser/bparser.h"
+#include "../../baseer.h"
+#include <stdint.h>
+
+#define SHA256_DIGEST_SIZE 32
+#define FNV1A_OFFSET 0xcbf29ce484222325ULL
+#define FNV1A_PRIME  0x100000001b3ULL
+
+/**
+ * @brief 64-bit FNV-1a of a block, continued from `h` (FNV1A_OFFSET to start).
+ */
+static inline uint64_t b_fnv1a_update(uint64_t h, const void *data, size_t len)
+{
+    const unsigned char *p = data;
+    for (size_t i = 0; i < len; i++) h = (h ^ p[i]) * FNV1A_PRIME;
+    return h;
+}
+
+static inline uint64_t b_fnv1a(const void *data, size_t len)
+{
+    return b_fnv1a_update(FNV1A_OFFSET, data, len);
+}
+
+/**
+ * @brief Incremental SHA-256 state.
+ */
+typedef struct {
+    uint32_t state[8];
+    uint64_t length;        /**< Bytes hashed so far */
+    unsigned char buf[64];
+    size_t used;            /**< Bytes pending in buf */
+} b_sha256_ctx;
+
+void b_sha256_init(b_sha256_ctx *ctx);
+void b_sha256_update(b_sha256_ctx *ctx, const void *data, size_t len);
+void b_sha256_final(b_sha256_ctx *ctx, unsigned char out[SHA256_DIGEST_SIZE]);
+
+/**
+ * @brief Hash a memory block in one call.
+ */
+void b_sha256(const void *data, size_t len, unsigned char out[SHA256_DIGEST_SIZE]);
+
+/**
+ * @brief Print the size and SHA-256 of the parser content.
+ *
+ * @param parser Pointer to a bparser structure (a file or a slice of one).
+ * @param arg    Unused.
+ * @return true on success, false if nothing could be read.
+ */
+bool b_hash(bparser *parser, void *arg);
+
+#endif
@@ -4,7 +4,10 @@
  *
  * This file provides a basic hash table implementation that maps
  * string keys to generic pointer values (`void*`). It uses
- * separate chaining (linked lists) for collision handling.
+ * separate chaining (linked lists) for collision handling, and doubles
+ * the number of buckets when there are as many keys as buckets, so
+ * chains stay short however many keys are inserted (sections and
+ * symbols of large object files).
  */
 #include "b_hashmap.h"
 
@@ -15,15 +18,15 @@
  * an unsigned integer hash for the given key.
  *
  * @param key Null-terminated string key.
- * @return unsigned int Hash value within the range [0, TABLE_SIZE).
+ * @return unsigned int Hash value, masked by the bucket count of the map.
  */
 unsigned int hash(const char *key)
 {
-    unsigned long hash = 5381;
+    unsigned int hash = 5381;
     int c;
     while ((c = *key++))
         hash = ((hash << 5) + hash) + c;
-    return hash % TABLE_SIZE;
+    return hash;
 }
 
 /**
@@ -36,11 +39,38 @@ unsigned int hash(const char *key)
 hashmap_t *create_map(void)
 {
     hashmap_t *map = malloc(sizeof(hashmap_t));
-    for (int i = 0; i < TABLE_SIZE; i++)
-        map->buckets[i] = NULL;
+    map->buckets = calloc(TABLE_SIZE, sizeof(bht_node_t*));
+    map->size = TABLE_SIZE;
+    map->count = 0;
     return map;
 }
 
+/**
+ * @brief Double the number of buckets and relink every node.
+ *
+ * The map is left unchanged if the new bucket array cannot be allocated
+ * (lookups still work, only with longer chains).
+ */
+static void grow_map(hashmap_t *map)
+{
+    size_t size = map->size * 2;
+    bht_node_t **buckets = calloc(size, sizeof(bht_node_t*));
+    if (!buckets) return;
+    for (size_t i = 0; i < map->size; i++) {
+        bht_node_t *bht_node = map->buckets[i];
+        while (bht_node != NULL) {
+            bht_node_t *next = bht_node->next;
+            size_t index = bht_node->hash & (size - 1);
+            bht_node->next = buckets[index];
+            buckets[index] = bht_node;
+            bht_node = next;
+        }
+    }
+    free(map->buckets);
+    map->buckets = buckets;
+    map->size = size;
+}
+
 
 /**
  * @brief Insert a key-value pair into the hashmap.
@@ -54,12 +84,17 @@ hashmap_t *create_map(void)
  */
 void insert(hashmap_t *map, const char *name, void *bht_node_p)
 {
-    unsigned int index = hash(name);
+    if (map->count >= map->size)
+        grow_map(map);
+    unsigned int h = hash(name);
+    size_t index = h & (map->size - 1);
     bht_node_t *new_bht_node = malloc(sizeof(bht_node_t));
     new_bht_node->name = strdup(name);
     new_bht_node->bht_node_p = bht_node_p;
+    new_bht_node->hash = h;
     new_bht_node->next = map->buckets[index];
     map->buckets[index] = new_bht_node;
+    map->count++;
 }
 
 /**
@@ -74,10 +109,10 @@ void insert(hashmap_t *map, const char *name, void *bht_node_p)
  */
 void* get(hashmap_t *map, const char *name)
 {
-    unsigned int index = hash(name);
-    bht_node_t *bht_node = map->buckets[index];
+    unsigned int h = hash(name);
+    bht_node_t *bht_node = map->buckets[h & (map->size - 1)];
     while (bht_node != NULL) {
-        if (strcmp(bht_node->name, name) == 0)
+        if (bht_node->hash == h && strcmp(bht_node->name, name) == 0)
             return bht_node->bht_node_p;
         bht_node = bht_node->next;
     }
@@ -95,7 +130,7 @@ void* get(hashmap_t *map, const char *name)
  */
 void free_map(hashmap_t *map)
 {
-    for (int i = 0; i < TABLE_SIZE; i++) {
+    for (size_t i = 0; i < map->size; i++) {
         bht_node_t *bht_node = map->buckets[i];
         while (bht_node != NULL) {
             bht_node_t *temp = bht_node;
@@ -104,12 +139,13 @@ void free_map(hashmap_t *map)
             free(temp);
         }
     }
+    free(map->buckets);
     free(map);
 }
 
 void free_maps(hashmap_t *map)
 {
-    for (int i = 0; i < TABLE_SIZE; i++) {
+    for (size_t i = 0; i < map->size; i++) {
         bht_node_t *bht_node = map->buckets[i];
         while (bht_node != NULL) {
             bht_node_t *temp = bht_node;
@@ -119,6 +155,7 @@ void free_maps(hashmap_t *map)
             free(temp);
         }
     }
+    free(map->buckets);
     free(map);
 }
 
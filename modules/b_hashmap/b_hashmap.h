@@ -3,16 +3,19 @@
 
 #include "stdlib.h"
 #include "string.h"
-#define TABLE_SIZE 200
+#define TABLE_SIZE 256    /**< Initial number of buckets (power of two) */
 
 typedef struct bht_node {
     char *name;
     void *bht_node_p;
+    unsigned int hash;      /**< Full hash of name, kept to rehash when growing */
     struct bht_node *next;
 } bht_node_t;
 
 typedef struct {
-    bht_node_t *buckets[TABLE_SIZE];
+    bht_node_t **buckets;
+    size_t size;            /**< Number of buckets, doubled when count reaches it */
+    size_t count;
 } hashmap_t;
 
 
@@ -0,0 +1,672 @@
+/**
+ * @file b_scan.c
+ * @brief Aho-Corasick signature scanner with wildcard verification.
+ */
+#include "b_scan.h"
+#include <elf.h>
+#include <pthread.h>
+#include <time.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#endif
+#include "../b_addrmap/b_addrmap.h"
+#include "../bx_elf_utils/bx_elf_utils.h"
+
+// ========================= BEGIN RULES ==================================
+static int hex_value(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * @brief Parse `{ 4d 5a ?? 00 }` into bytes and mask.
+ *
+ * @return Pattern length, or -1 on a syntax error.
+ */
+static int parse_hex(const char *s, unsigned char *bytes, unsigned char *mask)
+{
+    int n = 0;
+    for (s++; *s && *s != '}'; ) {
+        if (isspace((unsigned char)*s)) { s++; continue; }
+        if (n == SCAN_MAX_PATTERN || !s[1]) return -1;
+        if (s[0] == '?' && s[1] == '?') {
+            bytes[n] = 0;
+            mask[n++] = 0x00;
+        } else {
+            int hi = hex_value(s[0]), lo = hex_value(s[1]);
+            if (hi < 0 || lo < 0) return -1;
+            bytes[n] = (unsigned char)(hi << 4 | lo);
+            mask[n++] = 0xff;
+        }
+        s += 2;
+    }
+    return (*s == '}') ? n : -1;
+}
+
+/**
+ * @brief Parse a quoted string with C escapes into bytes and mask.
+ *
+ * @return Pattern length, or -1 on a syntax error.
+ */
+static int parse_string(const char *s, unsigned char *bytes, unsigned char *mask)
+{
+    int n = 0;
+    for (s++; *s && *s != '"'; s++) {
+        if (n == SCAN_MAX_PATTERN) return -1;
+        unsigned char c = (unsigned char)*s;
+        if (c == '\\') {
+            s++;
+            switch (*s) {
+            case 'n': c = '\n'; break;
+            case 'r': c = '\r'; break;
+            case 't': c = '\t'; break;
+            case '0': c = '\0'; break;
+            case '\\': c = '\\'; break;
+            case '"': c = '"'; break;
+            case 'x': {
+                int hi = hex_value(s[1]), lo = (hi >= 0) ? hex_value(s[2]) : -1;
+                if (lo < 0) return -1;
+                c = (unsigned char)(hi << 4 | lo);
+                s += 2;
+                break;
+            }
+            default: return -1;
+            }
+        }
+        bytes[n] = c;
+        mask[n++] = 0xff;
+    }
+    return (*s == '"') ? n : -1;
+}
+
+/**
+ * @brief Load a rule file.
+ *
+ * Malformed lines are reported and skipped.
+ *
+ * @return Array of rules (free with free_rules()), or NULL if none was loaded.
+ */
+static scan_rule_t *load_rules(const char *path, size_t *count)
+{
+    FILE *fp = fopen(path, "r");
+    if (!fp) return NULL;
+
+    size_t cap = 16, n = 0;
+    scan_rule_t *rules = malloc(cap * sizeof(*rules));
+    unsigned char bytes[SCAN_MAX_PATTERN], mask[SCAN_MAX_PATTERN];
+    char line[4096];
+    int lineno = 0;
+
+    while (rules && fgets(line, sizeof(line), fp)) {
+        lineno++;
+        char *s = line;
+        while (isspace((unsigned char)*s)) s++;
+        if (*s == '\0' || *s == '#') continue;
+
+        char *colon = strchr(s, ':');
+        if (!colon || colon == s || colon - s >= SCAN_MAX_NAME) {
+            fprintf(stderr, COLOR_RED "[!] %s:%d: expected <name>: <pattern>\n" COLOR_RESET, path, lineno);
+            continue;
+        }
+        char *body = colon + 1;
+        while (isspace((unsigned char)*body)) body++;
+
+        int len = -1;
+        if (*body == '{') len = parse_hex(body, bytes, mask);
+        else if (*body == '"') len = parse_string(body, bytes, mask);
+        if (len <= 0) {
+            fprintf(stderr, COLOR_RED "[!] %s:%d: invalid pattern\n" COLOR_RESET, path, lineno);
+            continue;
+        }
+
+        // the anchor is the longest run of literal bytes
+        int best_off = 0, best_len = 0;
+        for (int i = 0; i < len; ) {
+            if (!mask[i]) { i++; continue; }
+            int j = i;
+            while (j < len && mask[j]) j++;
+            if (j - i > best_len) { best_off = i; best_len = j - i; }
+            i = j;
+        }
+        if (best_len == 0) {
+            fprintf(stderr, COLOR_RED "[!] %s:%d: pattern has no literal bytes\n" COLOR_RESET, path, lineno);
+            continue;
+        }
+
+        if (n == cap) {
+            scan_rule_t *grown = realloc(rules, cap * 2 * sizeof(*rules));
+            if (!grown) break;
+            rules = grown;
+            cap *= 2;
+        }
+        scan_rule_t *r = &rules[n];
+        memset(r, 0, sizeof(*r));
+        memcpy(r->name, s, colon - s);
+        for (char *e = r->name + strlen(r->name); e > r->name && isspace((unsigned char)e[-1]); ) *--e = '\0';
+        r->bytes = malloc(len);
+        r->mask = malloc(len);
+        if (!r->bytes || !r->mask) {
+            free(r->bytes);
+            free(r->mask);
+            break;
+        }
+        memcpy(r->bytes, bytes, len);
+        memcpy(r->mask, mask, len);
+        r->len = len;
+        r->anchor_off = best_off;
+        r->anchor_len = best_len;
+        n++;
+    }
+    fclose(fp);
+
+    if (rules && n == 0) {
+        free(rules);
+        rules = NULL;
+    }
+    *count = n;
+    return rules;
+}
+
+static void free_rules(scan_rule_t *rules, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        free(rules[i].bytes);
+        free(rules[i].mask);
+    }
+    free(rules);
+}
+// ========================= END RULES ==================================
+
+// ========================= BEGIN AUTOMATON ==================================
+/**
+ * @brief Goto trie while the rules are added (edges in per-node lists).
+ */
+typedef struct {
+    uint32_t *head;         /**< First edge of a node, 0 for none (edges start at 1) */
+    size_t nodes, node_cap;
+    unsigned char *ebyte;
+    uint32_t *echild, *enext;
+    size_t edges, edge_cap;
+} scan_trie_t;
+
+static uint32_t trie_new_node(scan_trie_t *t)
+{
+    if (t->nodes == t->node_cap) {
+        size_t cap = t->node_cap ? t->node_cap * 2 : 64;
+        uint32_t *head = realloc(t->head, cap * sizeof(*head));
+        if (!head) return UINT32_MAX;
+        t->head = head;
+        t->node_cap = cap;
+    }
+    t->head[t->nodes] = 0;
+    return (uint32_t)t->nodes++;
+}
+
+static uint32_t trie_child(scan_trie_t *t, uint32_t node, unsigned char c)
+{
+    for (uint32_t e = t->head[node]; e; e = t->enext[e])
+        if (t->ebyte[e] == c) return t->echild[e];
+
+    uint32_t child = trie_new_node(t);
+    if (child == UINT32_MAX) return UINT32_MAX;
+    if (t->edges + 1 >= t->edge_cap) {
+        size_t cap = t->edge_cap ? t->edge_cap * 2 : 64;
+        unsigned char *b = realloc(t->ebyte, cap);
+        if (b) t->ebyte = b;
+        uint32_t *ch = realloc(t->echild, cap * sizeof(*ch));
+        if (ch) t->echild = ch;
+        uint32_t *nx = realloc(t->enext, cap * sizeof(*nx));
+        if (nx) t->enext = nx;
+        if (!b || !ch || !nx) return UINT32_MAX;
+        t->edge_cap = cap;
+    }
+    uint32_t e = (uint32_t)++t->edges;
+    t->ebyte[e] = c;
+    t->echild[e] = child;
+    t->enext[e] = t->head[node];
+    t->head[node] = e;
+    return child;
+}
+
+static void trie_free(scan_trie_t *t)
+{
+    free(t->head);
+    free(t->ebyte);
+    free(t->echild);
+    free(t->enext);
+}
+
+/**
+ * @brief Goto edge of a node, 0 if it has none for `c`.
+ */
+static inline uint32_t ac_edge(const scan_automaton_t *ac, const scan_node_t *n, unsigned char c)
+{
+    uint64_t word = n->edges[c >> 6], bit = 1ull << (c & 63);
+    if (!(word & bit)) return 0;
+    return ac->child[n->first + n->rank[c >> 6] + __builtin_popcountll(word & (bit - 1))];
+}
+
+/**
+ * @brief Next state: the node's edges and failure links down to a dense state, then its row.
+ */
+static inline uint32_t ac_step(const scan_automaton_t *ac, uint32_t state, unsigned char c)
+{
+    while (state >= ac->nrows) {
+        const scan_node_t *n = &ac->node[state];
+        uint32_t next = ac_edge(ac, n, c);
+        if (next) return next;
+        state = n->fail;
+    }
+    return ac->rows[state][c];
+}
+
+/**
+ * @brief Build the shufti tables of the first bytes.
+ *
+ * Every high nibble goes to one of 8 buckets; a byte is a candidate when the
+ * bucket of its high nibble is set for its low nibble. With at most 8
+ * distinct high nibbles this is exact, otherwise the candidates are
+ * confirmed with `first`.
+ */
+static void ac_build_shufti(scan_automaton_t *ac)
+{
+    int bucket[16], buckets = 0;
+    for (int h = 0; h < 16; h++) {
+        bucket[h] = -1;
+        for (int l = 0; l < 16; l++)
+            if (ac->first[h << 4 | l]) { bucket[h] = buckets++ % 8; break; }
+    }
+    memset(ac->shufti_lo, 0, sizeof(ac->shufti_lo));
+    memset(ac->shufti_hi, 0, sizeof(ac->shufti_hi));
+    for (int h = 0; h < 16; h++) {
+        if (bucket[h] < 0) continue;
+        ac->shufti_hi[h] = 1u << bucket[h];
+        for (int l = 0; l < 16; l++)
+            if (ac->first[h << 4 | l]) ac->shufti_lo[l] |= 1u << bucket[h];
+    }
+#if defined(__SSE2__) && defined(__GNUC__)
+    ac->shufti = __builtin_cpu_supports("ssse3");
+#endif
+}
+
+/**
+ * @brief Build the automaton from the rule anchors.
+ *
+ * The anchors go into a goto trie, which is then packed in breadth-first
+ * order: every node gets an edge bitmap and a slice of one child array.
+ * In that order a node's failure target always comes before it, so one pass
+ * sets the failure and dictionary links and completes the dense rows.
+ */
+static bool ac_build(scan_automaton_t *ac, const scan_rule_t *rules, size_t count)
+{
+    scan_trie_t t = {0};
+    bool ok = false;
+    uint32_t *order = NULL, *id = NULL, *terminal = NULL;
+
+    memset(ac, 0, sizeof(*ac));
+    ac->out_rule = malloc(count * sizeof(*ac->out_rule));
+    ac->out_next = malloc(count * sizeof(*ac->out_next));
+    terminal = malloc(count * sizeof(*terminal));
+    if (!ac->out_rule || !ac->out_next || !terminal || trie_new_node(&t) == UINT32_MAX) goto done;
+
+    for (size_t r = 0; r < count; r++) {
+        const unsigned char *a = rules[r].bytes + rules[r].anchor_off;
+        uint32_t node = 0;
+        for (uint32_t i = 0; i < rules[r].anchor_len && node != UINT32_MAX; i++)
+            node = trie_child(&t, node, a[i]);
+        if (node == UINT32_MAX) goto done;
+        terminal[r] = node;
+
+        if (!ac->first[a[0]]) {
+            ac->first[a[0]] = 1;
+            if (ac->first_count >= 0 && ac->first_count < SCAN_SIMD_FIRST_BYTES)
+                ac->first_list[ac->first_count++] = a[0];
+            else
+                ac->first_count = -1;
+        }
+    }
+
+    // breadth-first numbering: order[new] = trie node, id[trie node] = new
+    order = malloc(t.nodes * sizeof(*order));
+    id = malloc(t.nodes * sizeof(*id));
+    if (!order || !id) goto done;
+    size_t tail = 0;
+    order[tail++] = 0;
+    for (size_t head = 0; head < tail; head++)
+        for (uint32_t e = t.head[order[head]]; e; e = t.enext[e])
+            order[tail++] = t.echild[e];
+    for (size_t i = 0; i < t.nodes; i++) id[order[i]] = (uint32_t)i;
+
+    // pack the trie: edge bitmaps and one child array in byte order
+    ac->nodes = t.nodes;
+    ac->nrows = (t.nodes < SCAN_DENSE_ROWS) ? t.nodes : SCAN_DENSE_ROWS;
+    ac->node = calloc(t.nodes, sizeof(*ac->node));
+    ac->child = malloc((t.edges ? t.edges : 1) * sizeof(*ac->child));
+    ac->rows = malloc(ac->nrows * sizeof(*ac->rows));
+    ac->out_head = malloc(t.nodes * sizeof(*ac->out_head));
+    ac->dict = calloc(t.nodes, sizeof(*ac->dict));
+    if (!ac->node || !ac->child || !ac->rows || !ac->out_head || !ac->dict) goto done;
+
+    uint32_t by_byte[256], next_child = 0;
+    for (size_t i = 0; i < t.nodes; i++) {
+        scan_node_t *n = &ac->node[i];
+        for (uint32_t e = t.head[order[i]]; e; e = t.enext[e]) {
+            n->edges[t.ebyte[e] >> 6] |= 1ull << (t.ebyte[e] & 63);
+            by_byte[t.ebyte[e]] = id[t.echild[e]];
+        }
+        n->first = next_child;
+        for (int w = 0, seen = 0; w < 4; w++) {
+            n->rank[w] = (uint8_t)seen;
+            for (uint64_t bits = n->edges[w]; bits; bits &= bits - 1)
+                ac->child[next_child++] = by_byte[w * 64 + __builtin_ctzll(bits)];
+            seen += __builtin_popcountll(n->edges[w]);
+        }
+        ac->out_head[i] = -1;
+    }
+    for (size_t r = 0; r < count; r++) {
+        uint32_t node = id[terminal[r]];
+        ac->out_rule[ac->outs] = (int32_t)r;
+        ac->out_next[ac->outs] = ac->out_head[node];
+        ac->out_head[node] = (int32_t)ac->outs++;
+    }
+
+    // failure links, dictionary links and the dense rows
+    for (uint32_t s = 0; s < ac->nodes; s++) {
+        scan_node_t *n = &ac->node[s];
+        for (int w = 0; w < 4; w++) {
+            for (uint64_t bits = n->edges[w]; bits; bits &= bits - 1) {
+                unsigned char c = (unsigned char)(w * 64 + __builtin_ctzll(bits));
+                uint32_t child = ac_edge(ac, n, c);
+                uint32_t f = (s == 0) ? 0 : ac_step(ac, n->fail, c);
+                ac->node[child].fail = f;
+                ac->dict[child] = (ac->out_head[f] >= 0) ? f : ac->dict[f];
+            }
+        }
+        if (s < ac->nrows) {
+            for (int c = 0; c < 256; c++) {
+                uint32_t next = ac_edge(ac, n, (unsigned char)c);
+                ac->rows[s][c] = (next || s == 0) ? next : ac->rows[n->fail][c];
+            }
+        }
+    }
+    ac_build_shufti(ac);
+    ok = true;
+
+done:
+    free(order);
+    free(id);
+    free(terminal);
+    trie_free(&t);
+    return ok;
+}
+
+static void ac_free(scan_automaton_t *ac)
+{
+    free(ac->node);
+    free(ac->child);
+    free(ac->rows);
+    free(ac->out_head);
+    free(ac->dict);
+    free(ac->out_rule);
+    free(ac->out_next);
+}
+
+#if defined(__SSE2__) && defined(__GNUC__)
+/**
+ * @brief Shufti prefilter: 16 bytes per step for any set of first bytes.
+ */
+__attribute__((target("ssse3")))
+static size_t ac_skip_shufti(const scan_automaton_t *ac, const unsigned char *data, size_t pos, size_t end)
+{
+    const __m128i lo = _mm_loadu_si128((const __m128i*)ac->shufti_lo);
+    const __m128i hi = _mm_loadu_si128((const __m128i*)ac->shufti_hi);
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    const __m128i zero = _mm_setzero_si128();
+
+    while (pos + 16 <= end) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(data + pos));
+        __m128i l = _mm_shuffle_epi8(lo, _mm_and_si128(v, nibble));
+        __m128i h = _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+        unsigned int bits = ~(unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(l, h), zero)) & 0xffff;
+        for (; bits; bits &= bits - 1) {
+            size_t p = pos + __builtin_ctz(bits);
+            if (ac->first[data[p]]) return p;
+        }
+        pos += 16;
+    }
+    while (pos < end && !ac->first[data[pos]]) pos++;
+    return pos;
+}
+#endif
+
+/**
+ * @brief Find the next byte at or after `pos` that can start an anchor.
+ */
+static inline size_t ac_skip(const scan_automaton_t *ac, const unsigned char *data, size_t pos, size_t end)
+{
+    if (pos < end && ac->first[data[pos]]) return pos;
+#ifdef __SSE2__
+#ifdef __GNUC__
+    if (ac->shufti) return ac_skip_shufti(ac, data, pos, end);
+#endif
+    if (ac->first_count > 0) {
+        __m128i needles[SCAN_SIMD_FIRST_BYTES];
+        for (int i = 0; i < ac->first_count; i++)
+            needles[i] = _mm_set1_epi8((char)ac->first_list[i]);
+        while (pos + 16 <= end) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(data + pos));
+            __m128i m = _mm_cmpeq_epi8(v, needles[0]);
+            for (int i = 1; i < ac->first_count; i++)
+                m = _mm_or_si128(m, _mm_cmpeq_epi8(v, needles[i]));
+            unsigned int bits = (unsigned int)_mm_movemask_epi8(m);
+            if (bits) return pos + __builtin_ctz(bits);
+            pos += 16;
+        }
+    }
+#endif
+    while (pos < end && !ac->first[data[pos]]) pos++;
+    return pos;
+}
+// ========================= END AUTOMATON ==================================
+
+// ========================= BEGIN SCAN ==================================
+typedef struct {
+    const unsigned char *data;
+    size_t size;
+    const scan_rule_t *rules;
+    const scan_automaton_t *ac;
+    uint32_t max_len;
+    size_t chunk_count;
+    size_t next_chunk;   /**< Next chunk to pick up (atomic) */
+} scan_job_t;
+
+typedef struct {
+    scan_job_t *job;
+    scan_match_t *items;
+    size_t count;
+    size_t cap;
+} scan_worker_t;
+
+static void worker_push(scan_worker_t *w, uint64_t off, uint32_t rule)
+{
+    if (w->count == w->cap) {
+        size_t cap = w->cap ? w->cap * 2 : 256;
+        scan_match_t *items = realloc(w->items, cap * sizeof(*items));
+        if (!items) return;
+        w->items = items;
+        w->cap = cap;
+    }
+    w->items[w->count++] = (scan_match_t){off, rule};
+}
+
+static inline bool verify_rule(const scan_rule_t *r, const unsigned char *p)
+{
+    for (uint32_t i = 0; i < r->len; i++)
+        if ((p[i] & r->mask[i]) != r->bytes[i]) return false;
+    return true;
+}
+
+static void *scan_worker(void *arg)
+{
+    scan_worker_t *w = arg;
+    scan_job_t *job = w->job;
+    const scan_automaton_t *ac = job->ac;
+    const unsigned char *data = job->data;
+
+    for (;;) {
+        size_t c = __atomic_fetch_add(&job->next_chunk, 1, __ATOMIC_RELAXED);
+        if (c >= job->chunk_count) break;
+
+        size_t start = c * SCAN_CHUNK_SIZE;
+        size_t stop = start + SCAN_CHUNK_SIZE;
+        if (stop > job->size) stop = job->size;
+        // read past the end so matches starting in this chunk are complete
+        size_t end = stop + job->max_len - 1;
+        if (end > job->size) end = job->size;
+
+        uint32_t state = 0;
+        for (size_t pos = start; pos < end; pos++) {
+            if (state == 0) {
+                pos = ac_skip(ac, data, pos, end);
+                if (pos >= end) break;
+            }
+            state = ac_step(ac, state, data[pos]);
+
+            for (uint32_t s = (ac->out_head[state] >= 0) ? state : ac->dict[state]; s; s = ac->dict[s]) {
+                for (int32_t o = ac->out_head[s]; o >= 0; o = ac->out_next[o]) {
+                    const scan_rule_t *r = &job->rules[ac->out_rule[o]];
+                    uint64_t anchor_start = pos + 1 - r->anchor_len;
+                    if (anchor_start < r->anchor_off) continue;
+                    uint64_t match = anchor_start - r->anchor_off;
+                    if (match < start || match >= stop || match + r->len > job->size) continue;
+                    if (verify_rule(r, data + match))
+                        worker_push(w, match, (uint32_t)ac->out_rule[o]);
+                }
+            }
+        }
+    }
+    return NULL;
+}
+
+static int cmp_match(const void *a, const void *b)
+{
+    const scan_match_t *x = a, *y = b;
+    if (x->off != y->off) return x->off < y->off ? -1 : 1;
+    return (x->rule > y->rule) - (x->rule < y->rule);
+}
+
+/**
+ * @brief Print one match, with its section and virtual address when known.
+ */
+static void print_match(bparser *parser, const b_addrmap *map, const scan_rule_t *r, uint64_t off)
+{
+    printf(COLOR_YELLOW "|----0x%08llx:  " COLOR_RESET "%-24s", (unsigned long long)off, r->name);
+    if (map) {
+        uint64_t va;
+        int sec = b_addrmap_off_to_section(map, off);
+        const char *name = (sec > 0) ? elf_section_name(parser, sec) : NULL;
+        if (name) printf(COLOR_CYAN " %-20s" COLOR_RESET, name);
+        if (b_addrmap_off_to_va(map, off, &va)) printf(COLOR_GREEN " va 0x%llx" COLOR_RESET, (unsigned long long)va);
+    }
+    printf("\n");
+}
+
+/**
+ * @brief Scan a file for the signatures of a rule file.
+ *
+ * @param parser Pointer to a bparser structure containing the file.
+ * @param arg    Pointer to the command-line inputs (`--scan` is read from it).
+ * @return true on success, false if the rules could not be loaded.
+ */
+bool b_scan(bparser *parser, void *arg)
+{
+    const char *rules_path = baseer_get_opt(arg, "--scan");
+    if (!rules_path) return false;
+
+    size_t rule_count = 0;
+    scan_rule_t *rules = load_rules(rules_path, &rule_count);
+    if (!rules) {
+        fprintf(stderr, COLOR_RED "[!] No rules loaded from: " COLOR_RESET "%s\n", rules_path);
+        return false;
+    }
+
+    scan_automaton_t ac;
+    if (!ac_build(&ac, rules, rule_count)) {
+        fprintf(stderr, COLOR_RED "[!] Out of memory while compiling the rules\n" COLOR_RESET);
+        ac_free(&ac);
+        free_rules(rules, rule_count);
+        return false;
+    }
+
+    uint32_t max_len = 1;
+    for (size_t i = 0; i < rule_count; i++)
+        if (rules[i].len > max_len) max_len = rules[i].len;
+
+    scan_job_t job = {
+        .data = parser->block, .size = parser->size, .rules = rules, .ac = &ac,
+        .max_len = max_len, .chunk_count = (parser->size + SCAN_CHUNK_SIZE - 1) / SCAN_CHUNK_SIZE,
+    };
+
+    int threads = get_thread_count();
+    if ((size_t)threads > job.chunk_count) threads = job.chunk_count ? (int)job.chunk_count : 1;
+    scan_worker_t workers[BASEER_MAX_THREADS] = {0};
+    pthread_t tids[BASEER_MAX_THREADS];
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int t = 0; t < threads; t++) {
+        workers[t].job = &job;
+        if (t > 0 && pthread_create(&tids[t], NULL, scan_worker, &workers[t]) != 0) {
+            // run the remaining work on this thread
+            threads = t;
+            break;
+        }
+    }
+    scan_worker(&workers[0]);
+    for (int t = 1; t < threads; t++)
+        pthread_join(tids[t], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double seconds = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+    size_t total = 0;
+    for (int t = 0; t < threads; t++) total += workers[t].count;
+    scan_match_t *all = malloc((total ? total : 1) * sizeof(*all));
+    size_t n = 0;
+    for (int t = 0; t < threads; t++) {
+        if (all && workers[t].count) memcpy(all + n, workers[t].items, workers[t].count * sizeof(*all));
+        n += workers[t].count;
+        free(workers[t].items);
+    }
+    if (!all) n = 0;
+    qsort(all, n, sizeof(*all), cmp_match);
+
+    // matches in ELF files get their section and virtual address
+    const unsigned char *data = parser->block;
+    b_addrmap *map = NULL;
+    if (parser->size >= EI_NIDENT && memcmp(data, ELFMAG, SELFMAG) == 0)
+        map = elf_build_addrmap(parser);
+
+    printf(COLOR_BLUE "\n=== Signature Scan ===\n" COLOR_RESET);
+    uint64_t *hits = calloc(rule_count, sizeof(*hits));
+    for (size_t i = 0; i < n; i++) {
+        print_match(parser, map, &rules[all[i].rule], all[i].off);
+        if (hits) hits[all[i].rule]++;
+    }
+
+    printf(COLOR_BLUE "\n=== Rules ===\n" COLOR_RESET);
+    for (size_t i = 0; hits && i < rule_count; i++)
+        printf(COLOR_GREEN "|-- %-24s" COLOR_RESET " %llu\n", rules[i].name, (unsigned long long)hits[i]);
+    printf(COLOR_GREEN "\nScanned " COLOR_RESET "%zu bytes with %zu rules in %.3f s (%.2f GB/s, %d threads), %zu matches\n",
+           parser->size, rule_count, seconds, seconds > 0 ? parser->size / seconds / 1e9 : 0.0, threads, n);
+
+    free(hits);
+    b_addrmap_free(map);
+    free(all);
+    ac_free(&ac);
+    free_rules(rules, rule_count);
+    return true;
+}
+// ========================= END SCAN ==================================
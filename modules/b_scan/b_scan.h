@@ -0,0 +1,107 @@
+/**
+ * @file b_scan.h
+ * @brief Multi-pattern byte signature scanner (`--scan rules.txt`).
+ *
+ * Rules are read from a text file, one per line:
+ *
+ *     # comment
+ *     mz_header:   { 4d 5a ?? 00 }
+ *     get_pc:      { e8 00 00 00 00 ?? }
+ *     shell_str:   "/bin/sh"
+ *
+ * Hex rules accept `??` as a full-byte wildcard; string rules accept the C
+ * escapes `\\`, `\"`, `\n`, `\r`, `\t`, `\0` and `\xHH`.
+ *
+ * The longest literal run of every rule (its anchor) is compiled into an
+ * Aho-Corasick automaton; an anchor hit is then verified against the whole
+ * rule with its wildcard mask. Nodes are numbered breadth-first and the
+ * first SCAN_DENSE_ROWS of them (the shallow nodes, where a scan spends most
+ * of its time) have dense rows indexed by the state itself, with every
+ * transition resolved, so most bytes cost a single lookup. The other nodes
+ * only store their own edges (a 256-bit bitmap and a rank into one edge
+ * array) and fall back through their failure links, so a large rule file
+ * takes tens of bytes per node instead of 1 KiB.
+ *
+ * While the automaton is in its root state, a prefilter skips to the next
+ * byte that can start an anchor. With SSSE3 (checked at run time) it is a
+ * shufti nibble-table match, which works for any set of first bytes;
+ * otherwise an SSE2 compare handles up to SCAN_SIMD_FIRST_BYTES of them.
+ * The file is split into chunks scanned in parallel; every chunk
+ * reads `longest rule - 1` bytes past its end and only reports matches that
+ * start inside it, so no match is lost or reported twice.
+ *
+ * Matches in ELF files are attributed to their section and virtual address.
+ *
+ * @see b_scan()
+ */
+#ifndef B_SCAN_H
+#define B_SCAN_H
+#include "../bparser/bparser.h"
+#include "../../baseer.h"
+#include <stdint.h>
+
+#define SCAN_MAX_NAME        64
+#define SCAN_MAX_PATTERN     1024
+#define SCAN_CHUNK_SIZE      (1024 * 1024)
+#define SCAN_SIMD_FIRST_BYTES 8   /**< Up to this many distinct first bytes use the SSE2 compare prefilter */
+#define SCAN_DENSE_ROWS      4096 /**< Breadth-first nodes with a dense row (1 KiB each) */
+
+/**
+ * @brief One compiled rule.
+ */
+typedef struct {
+    char name[SCAN_MAX_NAME];
+    unsigned char *bytes;   /**< Pattern bytes (0 where wildcarded) */
+    unsigned char *mask;    /**< 0xff for literal bytes, 0x00 for `??` */
+    uint32_t len;
+    uint32_t anchor_off;    /**< Start of the longest literal run */
+    uint32_t anchor_len;
+} scan_rule_t;
+
+/**
+ * @brief One automaton node.
+ *
+ * States below `nrows` resolve every byte through their dense row. The
+ * other nodes look a byte up in their edge bitmap and follow `fail` when it
+ * has no edge.
+ */
+typedef struct {
+    uint64_t edges[4];      /**< Bytes with a goto edge */
+    uint32_t first;         /**< Index of the first child in `child` (ordered by byte) */
+    uint32_t fail;
+    uint8_t rank[4];        /**< Edges in the bitmap words before edges[i] */
+} scan_node_t;
+
+/**
+ * @brief Aho-Corasick automaton with dense shallow rows and sparse deeper nodes.
+ */
+typedef struct {
+    scan_node_t *node;
+    uint32_t *child;        /**< Goto targets of all nodes */
+    uint32_t (*rows)[256];  /**< Complete transitions of states 0 .. nrows-1 */
+    size_t nrows;           /**< Dense states, at most SCAN_DENSE_ROWS */
+    int32_t *out_head;      /**< First output of a node, -1 if none */
+    uint32_t *dict;         /**< Nearest suffix node with outputs, 0 if none */
+    int32_t *out_rule;      /**< Output list: rule index */
+    int32_t *out_next;      /**< Output list: next entry, -1 at the end */
+    size_t nodes;
+    size_t outs;
+    unsigned char first[256];    /**< 1 if a byte can start an anchor */
+    unsigned char first_list[SCAN_SIMD_FIRST_BYTES];
+    int first_count;             /**< Distinct first bytes, or -1 if too many for the SSE2 compare */
+    unsigned char shufti_lo[16]; /**< Buckets of each low nibble */
+    unsigned char shufti_hi[16]; /**< Bucket of each high nibble */
+    bool shufti;                 /**< The CPU has SSSE3 */
+} scan_automaton_t;
+
+/**
+ * @brief One match.
+ */
+typedef struct {
+    uint64_t off;
+    uint32_t rule;
+} scan_match_t;
+
+bool b_scan(bparser *parser, void *arg);
+
+#endif
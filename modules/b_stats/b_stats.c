@@ -0,0 +1,375 @@
+/**
+ * @file b_stats.c
+ * @brief Parallel instruction and mnemonic statistics.
+ */
+#define _GNU_SOURCE
+#include "b_stats.h"
+#include <pthread.h>
+
+#define STATS_LABEL_WIDTH -16
+#define STATS_MAX_SECTIONS 64
+
+#define MCLASS_BRANCH 0x01
+
+/**
+ * @brief Flat per-mnemonic class table, filled once before counting.
+ */
+static uint8_t mnemonic_class[UD_MAX_MNEMONIC_CODE];
+
+/**
+ * @brief A contiguous part of one section, starting on a function boundary.
+ */
+typedef struct {
+    int section;
+    uint64_t start;       /**< File offset */
+    uint64_t end;         /**< File offset (exclusive) */
+    size_t first_func;    /**< First function starting inside the unit */
+    size_t end_func;      /**< One past the last function starting inside the unit */
+} stats_unit_t;
+
+typedef struct {
+    const unsigned char *data;
+    const elf_region_t *sections;
+    int section_count;
+    const elf_region_t *funcs;
+    stats_count_t *func_counts;   /**< Written by the unit that owns the function */
+    const stats_unit_t *units;
+    size_t unit_count;
+    size_t next_unit;             /**< Next unit to pick up (atomic) */
+    uint8_t mode;
+} stats_job_t;
+
+/**
+ * @brief Per-thread counters, merged after all workers finish.
+ */
+typedef struct {
+    stats_job_t *job;
+    uint64_t *hist;                              /**< [section][mnemonic] */
+    stats_count_t counts[STATS_MAX_SECTIONS];
+} stats_worker_t;
+
+static void init_mnemonic_class(void)
+{
+    static const enum ud_mnemonic_code branches[] = {
+        UD_Ijmp, UD_Icall, UD_Iret, UD_Iretf,
+        UD_Ijo, UD_Ijno, UD_Ijb, UD_Ijae, UD_Ijz, UD_Ijnz, UD_Ijbe, UD_Ija,
+        UD_Ijs, UD_Ijns, UD_Ijp, UD_Ijnp, UD_Ijl, UD_Ijge, UD_Ijle, UD_Ijg,
+        UD_Ijcxz, UD_Ijecxz, UD_Ijrcxz, UD_Iloop, UD_Iloope, UD_Iloopne,
+    };
+    for (size_t i = 0; i < sizeof(branches) / sizeof(branches[0]); i++)
+        mnemonic_class[branches[i]] |= MCLASS_BRANCH;
+}
+
+/**
+ * @brief Count one decoded instruction into a counter set.
+ */
+static inline void count_insn(stats_count_t *c, const struct ud *u, enum ud_mnemonic_code m, unsigned int len)
+{
+    c->insns++;
+    c->bytes += len;
+    if (mnemonic_class[m] & MCLASS_BRANCH) c->branches++;
+    if (m == UD_Iinvalid) c->invalid++;
+
+    bool xmm = false, ymm = false;
+    for (int i = 0; i < 4 && u->operand[i].type != UD_NONE; i++) {
+        if (u->operand[i].type != UD_OP_REG) continue;
+        if (u->operand[i].base >= UD_R_XMM0 && u->operand[i].base <= UD_R_XMM15) xmm = true;
+        if (u->operand[i].base >= UD_R_YMM0 && u->operand[i].base <= UD_R_YMM15) ymm = true;
+    }
+    if (u->vex_op != 0 || ymm) c->avx++;
+    else if (xmm) c->sse++;
+}
+
+static void *stats_worker(void *arg)
+{
+    stats_worker_t *w = arg;
+    stats_job_t *job = w->job;
+    struct ud u;
+    struct ud_insn_info info;
+    ud_init(&u);
+    ud_set_mode(&u, job->mode);
+
+    for (;;) {
+        size_t k = __atomic_fetch_add(&job->next_unit, 1, __ATOMIC_RELAXED);
+        if (k >= job->unit_count) break;
+
+        const stats_unit_t *unit = &job->units[k];
+        const elf_region_t *sec = &job->sections[unit->section];
+        uint64_t *hist = w->hist + (size_t)unit->section * UD_MAX_MNEMONIC_CODE;
+        stats_count_t *sc = &w->counts[unit->section];
+        size_t f = unit->first_func;
+        uint64_t pos = unit->start;
+
+        ud_set_input_buffer(&u, job->data + unit->start, unit->end - unit->start);
+        ud_set_pc(&u, sec->vaddr + (unit->start - sec->off));
+        unsigned int len;
+        while ((len = ud_decode_only(&u, &info)) > 0) {
+            hist[info.mnemonic]++;
+            count_insn(sc, &u, info.mnemonic, len);
+
+            // functions are sorted, so the owner of pos only moves forward
+            while (f < unit->end_func && job->funcs[f].off + job->funcs[f].size <= pos) f++;
+            if (f < unit->end_func && job->funcs[f].off <= pos)
+                count_insn(&job->func_counts[f], &u, info.mnemonic, len);
+            pos += len;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Index of the first function (sorted by offset) starting at or after off.
+ */
+static size_t first_func_at(const elf_region_t *funcs, size_t func_count, uint64_t off)
+{
+    size_t lo = 0, hi = func_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (funcs[mid].off < off) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * @brief Split the sections into work units that start on function boundaries.
+ *
+ * Section headers need not be in file order, so the functions of each
+ * section are looked up on their own.
+ */
+static stats_unit_t *build_units(const elf_region_t *sections, int section_count,
+                                 const elf_region_t *funcs, size_t func_count, size_t *unit_count)
+{
+    size_t cap = 16, n = 0;
+    stats_unit_t *units = malloc(cap * sizeof(*units));
+    if (!units) return NULL;
+
+    for (int s = 0; s < section_count; s++) {
+        uint64_t sec_end = sections[s].off + sections[s].size;
+        uint64_t start = sections[s].off;
+        size_t first = first_func_at(funcs, func_count, start);
+        while (start < sec_end) {
+            uint64_t end = sec_end;
+            size_t last = first;
+            // extend to the first function start past the chunk size
+            while (last < func_count && funcs[last].off < sec_end) {
+                if (funcs[last].off > start && funcs[last].off - start >= STATS_CHUNK_SIZE) {
+                    end = funcs[last].off;
+                    break;
+                }
+                last++;
+            }
+            if (n == cap) {
+                cap *= 2;
+                stats_unit_t *grown = realloc(units, cap * sizeof(*units));
+                if (!grown) { free(units); return NULL; }
+                units = grown;
+            }
+            units[n++] = (stats_unit_t){s, start, end, first, last};
+            start = end;
+            first = last;
+        }
+    }
+    *unit_count = n;
+    return units;
+}
+
+static int cmp_hist_desc(const void *a, const void *b, void *arg)
+{
+    const uint64_t *hist = arg;
+    uint64_t x = hist[*(const int*)a], y = hist[*(const int*)b];
+    return (x < y) - (x > y);
+}
+
+/**
+ * @brief Print the counters of a section or of the whole file.
+ */
+static void print_counts(const char *title, const stats_count_t *c, const uint64_t *hist)
+{
+    printf(COLOR_BG_WHITE COLOR_BCYAN "|--%s" COLOR_RESET COLOR_CYAN ":\n" COLOR_RESET, title);
+    printf(COLOR_CYAN "|---%-*s" COLOR_RESET "%llu\n", STATS_LABEL_WIDTH, "Instructions:", (unsigned long long)c->insns);
+    printf(COLOR_CYAN "|---%-*s" COLOR_RESET "%llu\n", STATS_LABEL_WIDTH, "Bytes:", (unsigned long long)c->bytes);
+    printf(COLOR_CYAN "|---%-*s" COLOR_RESET "%llu (%.2f per 100 insns)\n", STATS_LABEL_WIDTH, "Branches:",
+           (unsigned long long)c->branches, c->insns ? 100.0 * c->branches / c->insns : 0.0);
+    printf(COLOR_CYAN "|---%-*s" COLOR_RESET "%llu (%.2f%%)\n", STATS_LABEL_WIDTH, "SSE:",
+           (unsigned long long)c->sse, c->insns ? 100.0 * c->sse / c->insns : 0.0);
+    printf(COLOR_CYAN "|---%-*s" COLOR_RESET "%llu (%.2f%%)\n", STATS_LABEL_WIDTH, "AVX:",
+           (unsigned long long)c->avx, c->insns ? 100.0 * c->avx / c->insns : 0.0);
+    printf(COLOR_CYAN "|---%-*s" COLOR_RESET "%llu\n", STATS_LABEL_WIDTH, "Invalid:", (unsigned long long)c->invalid);
+
+    int order[UD_MAX_MNEMONIC_CODE];
+    for (int i = 0; i < UD_MAX_MNEMONIC_CODE; i++) order[i] = i;
+    qsort_r(order, UD_MAX_MNEMONIC_CODE, sizeof(order[0]), cmp_hist_desc, (void*)hist);
+
+    printf(COLOR_CYAN "|---%-*s" COLOR_RESET "\n", STATS_LABEL_WIDTH, "Top mnemonics:");
+    for (int i = 0; i < STATS_TOP_MNEMONICS && hist[order[i]] > 0; i++) {
+        printf(COLOR_GREEN "|------" COLOR_RESET "%-12s %10llu  %6.2f%%\n",
+               ud_lookup_mnemonic(order[i]), (unsigned long long)hist[order[i]],
+               100.0 * hist[order[i]] / c->insns);
+    }
+}
+
+static void add_counts(stats_count_t *dst, const stats_count_t *src)
+{
+    dst->insns += src->insns;
+    dst->bytes += src->bytes;
+    dst->branches += src->branches;
+    dst->sse += src->sse;
+    dst->avx += src->avx;
+    dst->invalid += src->invalid;
+}
+
+/**
+ * @brief Print the power-of-two distribution of function sizes.
+ */
+static void print_size_distribution(const elf_region_t *funcs, size_t func_count)
+{
+    uint64_t buckets[STATS_SIZE_BUCKETS] = {0};
+    uint64_t most = 0;
+    for (size_t i = 0; i < func_count; i++) {
+        int b = 0;
+        while (b < STATS_SIZE_BUCKETS - 1 && funcs[i].size >= (16ULL << b)) b++;
+        if (++buckets[b] > most) most = buckets[b];
+    }
+
+    printf(COLOR_BLUE "\n=== Function Sizes ===\n" COLOR_RESET);
+    for (int b = 0; b < STATS_SIZE_BUCKETS; b++) {
+        if (buckets[b] == 0) continue;
+        unsigned long long lo = b ? (8ULL << b) : 0, hi = (16ULL << b) - 1;
+        if (b == STATS_SIZE_BUCKETS - 1)
+            printf(COLOR_CYAN "|---%8llu+          bytes: " COLOR_RESET, lo);
+        else
+            printf(COLOR_CYAN "|---%8llu - %8llu bytes: " COLOR_RESET, lo, hi);
+        printf("%8llu ", (unsigned long long)buckets[b]);
+        int bar = (int)(40 * buckets[b] / most);
+        printf(COLOR_GREEN);
+        for (int i = 0; i < (bar ? bar : 1); i++) putchar('#');
+        printf(COLOR_RESET "\n");
+    }
+}
+
+/**
+ * @brief Print instruction statistics for an ELF file.
+ *
+ * @param parser Pointer to a bparser structure containing the ELF file.
+ * @param arg    Pointer to the command-line inputs (unused).
+ * @return true on success, false if the file has no executable code.
+ */
+bool b_stats(bparser *parser, void *arg)
+{
+    const unsigned char *data = parser->block;
+    if (data[EI_CLASS] != ELFCLASS32 && data[EI_CLASS] != ELFCLASS64) {
+        fprintf(stderr, COLOR_RED "[!] Unknown ELF class: %d\n" COLOR_RESET, data[EI_CLASS]);
+        return false;
+    }
+
+    elf_region_t sections[STATS_MAX_SECTIONS];
+    int section_count = elf_code_sections(parser, sections, STATS_MAX_SECTIONS);
+    if (section_count == 0) {
+        fprintf(stderr, COLOR_RED "[!] No executable code found\n" COLOR_RESET);
+        return false;
+    }
+
+    b_addrmap *map = elf_build_addrmap(parser);
+    size_t func_count = 0;
+    elf_region_t *funcs = elf_functions(parser, map, &func_count);
+    b_addrmap_free(map);
+
+    size_t unit_count = 0;
+    stats_unit_t *units = build_units(sections, section_count, funcs, func_count, &unit_count);
+    stats_count_t *func_counts = calloc(func_count ? func_count : 1, sizeof(*func_counts));
+    if (!units || !func_counts || unit_count == 0) {
+        if (units && func_counts)
+            fprintf(stderr, COLOR_RED "[!] No executable code found (every code section is empty)\n" COLOR_RESET);
+        free(units);
+        free(func_counts);
+        free(funcs);
+        return false;
+    }
+
+    if (mnemonic_class[UD_Iret] == 0) init_mnemonic_class();
+
+    stats_job_t job = {
+        .data = data, .sections = sections, .section_count = section_count,
+        .funcs = funcs, .func_counts = func_counts, .units = units,
+        .unit_count = unit_count, .next_unit = 0,
+        .mode = (data[EI_CLASS] == ELFCLASS64) ? 64 : 32,
+    };
+
+    int threads = get_thread_count();
+    if ((size_t)threads > unit_count) threads = (int)unit_count;
+    stats_worker_t *workers = calloc(threads, sizeof(*workers));
+    pthread_t tids[BASEER_MAX_THREADS];
+    int started = 0;
+    for (int t = 0; workers && t < threads; t++) {
+        workers[t].job = &job;
+        workers[t].hist = calloc((size_t)section_count * UD_MAX_MNEMONIC_CODE, sizeof(uint64_t));
+        if (!workers[t].hist) break;
+        started++;
+        if (t > 0 && pthread_create(&tids[t], NULL, stats_worker, &workers[t]) != 0) {
+            // run the remaining work on this thread
+            free(workers[t].hist);
+            started--;
+            break;
+        }
+    }
+    if (started == 0) {
+        free(workers);
+        free(units);
+        free(func_counts);
+        free(funcs);
+        return false;
+    }
+    stats_worker(&workers[0]);
+    for (int t = 1; t < started; t++)
+        pthread_join(tids[t], NULL);
+
+    // merge the per-thread histograms into worker 0
+    uint64_t *hist = workers[0].hist;
+    for (int t = 1; t < started; t++) {
+        for (size_t i = 0; i < (size_t)section_count * UD_MAX_MNEMONIC_CODE; i++)
+            hist[i] += workers[t].hist[i];
+        for (int s = 0; s < section_count; s++)
+            add_counts(&workers[0].counts[s], &workers[t].counts[s]);
+        free(workers[t].hist);
+    }
+
+    uint64_t total_hist[UD_MAX_MNEMONIC_CODE] = {0};
+    stats_count_t total = {0};
+    for (int s = 0; s < section_count; s++) {
+        add_counts(&total, &workers[0].counts[s]);
+        for (int m = 0; m < UD_MAX_MNEMONIC_CODE; m++)
+            total_hist[m] += hist[(size_t)s * UD_MAX_MNEMONIC_CODE + m];
+    }
+
+    printf(COLOR_BLUE "\n=== Instruction Statistics ===\n" COLOR_RESET);
+    print_counts("Total", &total, total_hist);
+    for (int s = 0; s < section_count; s++) {
+        char title[128];
+        snprintf(title, sizeof(title), "Section %s", sections[s].name);
+        printf("\n");
+        print_counts(title, &workers[0].counts[s], hist + (size_t)s * UD_MAX_MNEMONIC_CODE);
+    }
+
+    if (func_count > 0) {
+        print_size_distribution(funcs, func_count);
+
+        printf(COLOR_BLUE "\n=== Functions ===\n" COLOR_RESET);
+        printf(COLOR_CYAN "%-18s %10s %10s %10s %8s %8s  %s\n" COLOR_RESET,
+               "Address", "Size", "Insns", "Branch/100", "SSE", "AVX", "Name");
+        for (size_t i = 0; i < func_count; i++) {
+            const stats_count_t *c = &func_counts[i];
+            printf(COLOR_YELLOW "0x%016llx " COLOR_RESET "%10llu %10llu %10.2f %8llu %8llu  %s\n",
+                   (unsigned long long)funcs[i].vaddr, (unsigned long long)funcs[i].size,
+                   (unsigned long long)c->insns, c->insns ? 100.0 * c->branches / c->insns : 0.0,
+                   (unsigned long long)c->sse, (unsigned long long)c->avx, funcs[i].name);
+        }
+    }
+
+    free(workers[0].hist);
+    free(workers);
+    free(units);
+    free(func_counts);
+    free(funcs);
+    return true;
+}
@@ -0,0 +1,43 @@
+/**
+ * @file b_stats.h
+ * @brief Instruction and mnemonic statistics for ELF files (`--stats`).
+ *
+ * Every executable section is decoded with the decode-only udis86 entry
+ * point and counted into flat arrays indexed by `ud_mnemonic_code`, so no
+ * text is produced while counting. Reports instruction counts, mnemonic
+ * histograms, SSE/AVX usage, branch density and the function-size
+ * distribution, per section and per function.
+ *
+ * Sections are split at function boundaries into work units that are
+ * decoded in parallel.
+ *
+ * @see b_stats()
+ */
+#ifndef B_STATS_H
+#define B_STATS_H
+#include "../bparser/bparser.h"
+#include "../../baseer.h"
+#include <elf.h>
+#include <stdint.h>
+#include "udis86.h"
+#include "../bx_elf_utils/bx_elf_utils.h"
+
+#define STATS_CHUNK_SIZE   (256 * 1024) /**< Target size of one work unit */
+#define STATS_TOP_MNEMONICS 15          /**< Mnemonics printed per histogram */
+#define STATS_SIZE_BUCKETS 18           /**< Power-of-two function size buckets */
+
+/**
+ * @brief Counters shared by sections, functions and the whole file.
+ */
+typedef struct {
+    uint64_t insns;     /**< Decoded instructions */
+    uint64_t bytes;     /**< Bytes covered */
+    uint64_t branches;  /**< jmp/jcc/call/ret/loop */
+    uint64_t sse;       /**< Legacy-encoded instructions using XMM registers */
+    uint64_t avx;       /**< VEX-encoded instructions */
+    uint64_t invalid;   /**< Undecodable bytes */
+} stats_count_t;
+
+bool b_stats(bparser *parser, void *arg);
+
+#endif
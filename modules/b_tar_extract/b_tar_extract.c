@@ -0,0 +1,405 @@
+/**
+ * @file b_tar_extract.c
+ * @brief Extract a tar archive with parallel copy_file_range()/pwrite().
+ */
+#define _GNU_SOURCE
+#include "b_tar_extract.h"
+#include "../b_hash/b_hash.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/stat.h>
+
+// ========================= BEGIN PATHS ==================================
+/**
+ * @brief Refuse paths that would land outside the destination.
+ */
+static bool safe_path(const char *path)
+{
+    if (path[0] == '/' || path[0] == '\0') return false;
+    for (const char *p = path; *p; ) {
+        const char *end = strchr(p, '/');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+        if (len == 2 && p[0] == '.' && p[1] == '.') return false;
+        if (!end) break;
+        p = end + 1;
+    }
+    return true;
+}
+
+/**
+ * @brief Open the directory that holds the last component of path, below root.
+ *
+ * Every component is opened relative to the previous one with
+ * O_NOFOLLOW | O_DIRECTORY, so a symlink anywhere on the way (already in
+ * the destination, or created by an earlier member) is refused instead of
+ * followed. With `create`, missing directories are made on the way.
+ *
+ * @param buf  Scratch copy of path (TAR_MAX_PATH bytes)
+ * @param name Receives the last component, inside buf ("" for the destination itself)
+ * @return Directory descriptor to close, -1 on error or for the destination itself.
+ */
+static int open_parent(int root, const char *path, bool create, char *buf, const char **name)
+{
+    size_t len = strlen(path);
+    *name = path;
+    if (len >= TAR_MAX_PATH) return -1;
+    memcpy(buf, path, len + 1);
+    // no trailing '/' (directory members)
+    while (len > 0 && buf[len - 1] == '/') buf[--len] = '\0';
+
+    int fd = openat(root, ".", O_PATH | O_DIRECTORY | O_CLOEXEC);
+    char *comp = buf;
+    while (fd >= 0) {
+        while (*comp == '/') comp++;
+        char *end = strchr(comp, '/');
+        if (!end) break;
+        *end = '\0';
+        if (strcmp(comp, ".") != 0) {
+            if (create) mkdirat(fd, comp, 0755);
+            int next = openat(fd, comp, O_PATH | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+            close(fd);
+            fd = next;
+        }
+        comp = end + 1;
+    }
+    *name = comp;
+    if (fd >= 0 && (*comp == '\0' || strcmp(comp, ".") == 0)) {
+        // the destination itself: no name, nothing to create
+        *name = "";
+        close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+/**
+ * @brief Canonical form of a member path: no empty, "." or trailing components.
+ *
+ * @return The path to free(), NULL on allocation failure.
+ */
+static char *canonical_path(const char *path)
+{
+    char *out = malloc(strlen(path) + 1);
+    if (!out) return NULL;
+    size_t n = 0;
+    for (const char *p = path; *p; ) {
+        const char *end = strchrnul(p, '/');
+        size_t len = end - p;
+        if (len && !(len == 1 && p[0] == '.')) {
+            if (n) out[n++] = '/';
+            memcpy(out + n, p, len);
+            n += len;
+        }
+        p = *end ? end + 1 : end;
+    }
+    out[n] = '\0';
+    return out;
+}
+// ========================= END PATHS ==================================
+
+// ========================= BEGIN COPY ==================================
+typedef struct {
+    bparser *parser;
+    int archive_fd;             /**< -1 when the archive is only in memory */
+    int root;                   /**< Destination directory */
+    tar_entry_t *files;
+    size_t count;
+    size_t next;                /**< Next file to extract (atomic) */
+    uint64_t bytes;             /**< Bytes written (atomic) */
+    size_t failed;              /**< Files that could not be written (atomic) */
+} extract_job_t;
+
+/**
+ * @brief Copy len bytes of member data, from src in the archive data to dst in fd.
+ *
+ * copy_file_range() lets the kernel move (or reflink) the data without a
+ * round trip through user space; it is abandoned for pwrite() from the
+ * archive image as soon as the kernel refuses it.
+ */
+static bool copy_data(extract_job_t *job, uint64_t src, uint64_t len, int fd, uint64_t dst)
+{
+    uint64_t done = 0;
+    if (job->archive_fd >= 0) {
+        loff_t in = job->parser->base + src, out = dst;
+        while (done < len) {
+            size_t n = len - done > TAR_EXTRACT_CHUNK ? TAR_EXTRACT_CHUNK : len - done;
+            ssize_t r = copy_file_range(job->archive_fd, &in, fd, &out, n, 0);
+            if (r <= 0) break;
+            done += r;
+        }
+        if (done == len) return true;
+    }
+    if (!job->parser->block) {
+        // stream mode: bounce through a buffer
+        if (job->archive_fd < 0) return false;
+        size_t cap = len - done > TAR_EXTRACT_CHUNK ? TAR_EXTRACT_CHUNK : len - done;
+        unsigned char *buf = malloc(cap);
+        while (buf && done < len) {
+            size_t n = len - done > cap ? cap : len - done;
+            ssize_t r = pread(job->archive_fd, buf, n, job->parser->base + src + done);
+            if (r <= 0 || pwrite(fd, buf, r, dst + done) != r) break;
+            done += r;
+        }
+        free(buf);
+        return done == len;
+    }
+
+    const unsigned char *data = (const unsigned char*)job->parser->block + src;
+    while (done < len) {
+        size_t n = len - done > TAR_EXTRACT_CHUNK ? TAR_EXTRACT_CHUNK : len - done;
+        ssize_t r = pwrite(fd, data + done, n, dst + done);
+        if (r <= 0) return false;
+        done += r;
+    }
+    return true;
+}
+
+/**
+ * @brief Write a sparse member: only its data segments, the rest stays a hole.
+ */
+static bool copy_sparse(extract_job_t *job, const tar_entry_t *e, int fd)
+{
+    if (ftruncate(fd, e->real_size) != 0) return false;
+    uint64_t src = e->data_off;
+    for (size_t i = 0; i < e->sparse_count; i++) {
+        const tar_sparse_t *s = &e->sparse[i];
+        if (s->size && !copy_data(job, src, s->size, fd, s->offset)) return false;
+        src += s->size;
+    }
+    return true;
+}
+
+static bool extract_file(extract_job_t *job, const tar_entry_t *e)
+{
+    char buf[TAR_MAX_PATH];
+    const char *name;
+    int parent = open_parent(job->root, e->path, false, buf, &name);
+    int fd = -1;
+    if (parent >= 0) {
+        // never write through an existing symlink
+        unlinkat(parent, name, 0);
+        fd = openat(parent, name, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0600);
+        close(parent);
+    }
+    bool ok = fd >= 0;
+    if (ok && e->sparse) {
+        ok = copy_sparse(job, e, fd);
+    } else if (ok && e->size > 0) {
+        // reserve the space once instead of growing the file chunk by chunk
+        posix_fallocate(fd, 0, e->size);
+        ok = copy_data(job, e->data_off, e->size, fd, 0);
+    }
+    if (ok) {
+        fchmod(fd, e->mode & 07777);
+        struct timespec times[2] = {{0, UTIME_OMIT}, {e->mtime, 0}};
+        futimens(fd, times);
+        __atomic_fetch_add(&job->bytes, e->size, __ATOMIC_RELAXED);
+    }
+    if (fd >= 0) close(fd);
+    if (!ok) fprintf(stderr, COLOR_RED "[!] Could not extract: " COLOR_RESET "%s\n", e->path);
+    return ok;
+}
+
+static void *extract_worker(void *arg)
+{
+    extract_job_t *job = arg;
+    for (;;) {
+        size_t i = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED);
+        if (i >= job->count) break;
+        if (!extract_file(job, &job->files[i]))
+            __atomic_fetch_add(&job->failed, 1, __ATOMIC_RELAXED);
+    }
+    return NULL;
+}
+
+static int cmp_size_desc(const void *a, const void *b)
+{
+    const tar_entry_t *x = a, *y = b;
+    return (x->size < y->size) - (x->size > y->size);
+}
+/**
+ * @brief Mark the members replaced by a later member with the same path, as tar does.
+ *
+ * Files are extracted in parallel and in size order and links after them,
+ * so a path stored twice (`tar rf` appends a new copy) is resolved before
+ * anything is written. Directories are never replaced.
+ *
+ * @return Array of count flags to free(), NULL on allocation failure.
+ */
+static bool *replaced_members(const tar_entry_t *entries, size_t count)
+{
+    size_t buckets = 16;
+    while (buckets < count * 2) buckets <<= 1;
+    uint32_t *table = calloc(buckets, sizeof(*table));   // member index + 1, 0 when empty
+    char **paths = calloc(count ? count : 1, sizeof(*paths));
+    bool *replaced = calloc(count ? count : 1, sizeof(*replaced));
+    bool ok = table && paths && replaced;
+
+    for (size_t i = 0; ok && i < count; i++) {
+        if (entries[i].type == DIRTYPE) continue;
+        paths[i] = canonical_path(entries[i].path);
+        if (!paths[i]) {
+            ok = false;
+            break;
+        }
+        size_t b = b_fnv1a(paths[i], strlen(paths[i])) & (buckets - 1);
+        while (table[b] && strcmp(paths[table[b] - 1], paths[i]) != 0) b = (b + 1) & (buckets - 1);
+        if (table[b]) replaced[table[b] - 1] = true;
+        table[b] = (uint32_t)(i + 1);
+    }
+
+    for (size_t i = 0; paths && i < count; i++) free(paths[i]);
+    free(paths);
+    free(table);
+    if (!ok) {
+        free(replaced);
+        return NULL;
+    }
+    return replaced;
+}
+// ========================= END COPY ==================================
+
+// ========================= BEGIN EXTRACT ==================================
+/**
+ * @brief Extract the archive into the directory given with `-x`.
+ *
+ * @param parser Pointer to a bparser structure containing the archive.
+ * @param arg    Pointer to the command-line inputs.
+ * @return true if every member was extracted, false if any failed or was skipped.
+ */
+bool b_tar_extract(bparser *parser, void *arg)
+{
+    const char *dir = baseer_get_opt(arg, "-x");
+    if (!dir) return false;
+    int root = -1;
+    if (mkdir(dir, 0755) == 0 || errno == EEXIST)
+        root = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (root < 0) {
+        fprintf(stderr, COLOR_RED "[!] Could not create: " COLOR_RESET "%s\n", dir);
+        return false;
+    }
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    size_t count = 0;
+    tar_entry_t *entries = tar_list_members(parser, &count);
+
+    // split the members: directories, regular files, links
+    tar_entry_t *files = malloc((count ? count : 1) * sizeof(*files));
+    size_t nfiles = 0, ndirs = 0, nlinks = 0, skipped = 0, failed = 0;
+    char buf[TAR_MAX_PATH], tbuf[TAR_MAX_PATH];
+    const char *name, *tname;
+    if (!files) count = 0;
+    // a later member with the same path replaces the earlier ones
+    bool *replaced = replaced_members(entries, count);
+    for (size_t i = 0; i < count; i++) {
+        tar_entry_t *e = &entries[i];
+        if (replaced && replaced[i]) continue;
+        if (!safe_path(e->path)) {
+            fprintf(stderr, COLOR_YELLOW "[!] Skipping unsafe path: " COLOR_RESET "%s\n", e->path);
+            e->type = CHRTYPE;   // not extracted below
+            skipped++;
+            continue;
+        }
+        if (e->type == DIRTYPE) {
+            int parent = open_parent(root, e->path, true, buf, &name);
+            if (parent >= 0 && (mkdirat(parent, name, 0700) == 0 || errno == EEXIST)) {
+                ndirs++;
+            } else if (parent >= 0 || name[0] != '\0') {
+                fprintf(stderr, COLOR_RED "[!] Could not create: " COLOR_RESET "%s\n", e->path);
+                failed++;
+            }
+            if (parent >= 0) close(parent);
+        } else if (e->type == REGTYPE || e->type == AREGTYPE || e->type == CONTTYPE) {
+            int parent = open_parent(root, e->path, true, buf, &name);
+            if (parent >= 0) close(parent);
+            if (e->data_off <= parser->size && e->size <= parser->size - e->data_off) {
+                files[nfiles++] = *e;
+            } else {
+                fprintf(stderr, COLOR_RED "[!] Truncated member: " COLOR_RESET "%s\n", e->path);
+                failed++;
+            }
+        } else if (e->type != LNKTYPE && e->type != SYMTYPE) {
+            // devices and FIFOs are not recreated
+            skipped++;
+        }
+    }
+
+    // largest files first, so one big file does not finish last on its own
+    qsort(files, nfiles, sizeof(*files), cmp_size_desc);
+    extract_job_t job = {
+        .parser = parser, .archive_fd = parser->fp ? fileno(parser->fp) : -1,
+        .root = root, .files = files, .count = nfiles,
+    };
+    int threads = get_thread_count();
+    if ((size_t)threads > nfiles) threads = nfiles ? (int)nfiles : 1;
+    pthread_t tids[BASEER_MAX_THREADS];
+    int started = 1;
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&tids[t], NULL, extract_worker, &job) != 0) break;
+        started++;
+    }
+    extract_worker(&job);
+    for (int t = 1; t < started; t++)
+        pthread_join(tids[t], NULL);
+    failed += job.failed;
+
+    // links once their targets exist, then directory modes and times
+    for (size_t i = 0; i < count; i++) {
+        tar_entry_t *e = &entries[i];
+        if ((e->type != LNKTYPE && e->type != SYMTYPE) || (replaced && replaced[i])) continue;
+        bool ok = false;
+        int parent = e->link ? open_parent(root, e->path, true, buf, &name) : -1;
+        if (parent >= 0) {
+            unlinkat(parent, name, 0);
+            if (e->type == SYMTYPE) {
+                // the link is created, never followed: every lookup above uses O_NOFOLLOW
+                ok = symlinkat(e->link, parent, name) == 0;
+                struct timespec times[2] = {{0, UTIME_OMIT}, {e->mtime, 0}};
+                if (ok) utimensat(parent, name, times, AT_SYMLINK_NOFOLLOW);
+            } else if (safe_path(e->link)) {
+                int tparent = open_parent(root, e->link, false, tbuf, &tname);
+                ok = tparent >= 0 && linkat(tparent, tname, parent, name, 0) == 0;
+                if (tparent >= 0) close(tparent);
+            }
+            close(parent);
+        }
+        if (ok) {
+            nlinks++;
+        } else {
+            fprintf(stderr, COLOR_RED "[!] Could not create link: " COLOR_RESET "%s\n", e->path);
+            failed++;
+        }
+    }
+    for (size_t i = count; i-- > 0; ) {
+        tar_entry_t *e = &entries[i];
+        if (e->type != DIRTYPE) continue;
+        int parent = open_parent(root, e->path, false, buf, &name);
+        int fd = parent >= 0 ? openat(parent, name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC) : -1;
+        if (fd >= 0) {
+            fchmod(fd, e->mode & 07777);
+            struct timespec times[2] = {{0, UTIME_OMIT}, {e->mtime, 0}};
+            futimens(fd, times);
+            close(fd);
+        }
+        if (parent >= 0) close(parent);
+    }
+    close(root);
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double seconds = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+    printf(COLOR_GREEN "Extracted " COLOR_RESET "%zu files, %zu directories, %zu links (%llu bytes) to %s in %.3f s "
+           "(%.2f GB/s, %d threads)", nfiles - job.failed, ndirs, nlinks, (unsigned long long)job.bytes, dir,
+           seconds, seconds > 0 ? job.bytes / seconds / 1e9 : 0.0, started);
+    if (skipped) printf(", %zu skipped", skipped);
+    if (failed) printf(COLOR_RED ", %zu failed" COLOR_RESET, failed);
+    printf("\n");
+
+    free(replaced);
+    free(files);
+    tar_free_members(entries, count);
+    return failed == 0 && skipped == 0;
+}
+// ========================= END EXTRACT ==================================
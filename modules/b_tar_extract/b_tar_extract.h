@@ -0,0 +1,37 @@
+/**
+ * @file b_tar_extract.h
+ * @brief Parallel tar extraction (`-x <dir>`).
+ *
+ * The header chain is scanned once and, as with tar, a member stored again
+ * under the same path (`tar rf`) replaces the earlier copies. Then:
+ * 1. directories (and missing parents) are created,
+ * 2. regular files are copied by get_thread_count() workers, with
+ *    copy_file_range() from the archive descriptor when the kernel allows
+ *    it, and large pwrite()s from the archive image otherwise; sparse
+ *    members only get their data segments written, so holes stay holes,
+ * 3. links are created,
+ * 4. modes and mtimes are restored, directories last so that creating
+ *    their content does not change them again.
+ *
+ * Absolute paths and paths with ".." components are refused. Every path is
+ * resolved one component at a time from the destination directory with
+ * O_NOFOLLOW, so a symlink (already in the destination, or created by an
+ * earlier member) is never followed to write outside of it.
+ */
+#ifndef B_TAR_EXTRACT_H
+#define B_TAR_EXTRACT_H
+#include "../bparser/bparser.h"
+#include "../../baseer.h"
+#include "../bx_tar/bx_tar.h"
+
+#define TAR_EXTRACT_CHUNK (8 * 1024 * 1024)   /**< Bytes per copy call */
+
+/**
+ * @brief Extract the archive into the directory given with `-x`.
+ *
+ * @return true if every member was extracted; false if any member failed or
+ *         was skipped (the counts are printed).
+ */
+bool b_tar_extract(bparser *parser, void *arg);
+
+#endif
@@ -0,0 +1,414 @@
+/**
+ * @file b_tar_index.c
+ * @brief Build, persist and query tar member indexes.
+ */
+#include "b_tar_index.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include "../binhead/bx_binhead.h"
+#include "../b_hash/b_hash.h"
+
+// ========================= BEGIN HELPERS ==================================
+/**
+ * @brief Drop a leading "./" and trailing '/' so "./dir/" and "dir" match.
+ */
+static const char *normalize_path(const char *path, size_t *len)
+{
+    while (path[0] == '.' && path[1] == '/') path += 2;
+    size_t n = strlen(path);
+    while (n > 1 && path[n - 1] == '/') n--;
+    *len = n;
+    return path;
+}
+
+static const tar_index_entry_t *index_lookup(const tar_index_header_t *header, const tar_index_entry_t *entries,
+                                             const uint32_t *table, const char *strings,
+                                             const char *path, size_t len, uint64_t hash, uint64_t *bucket)
+{
+    uint64_t mask = header->buckets - 1;
+    for (uint64_t b = hash & mask; ; b = (b + 1) & mask) {
+        *bucket = b;
+        if (table[b] == 0) return NULL;
+        const tar_index_entry_t *e = &entries[table[b] - 1];
+        if (e->hash == hash && e->path_len == len && memcmp(strings + e->path_off, path, len) == 0)
+            return e;
+    }
+}
+// ========================= END HELPERS ==================================
+
+// ========================= BEGIN LOCATION ==================================
+/**
+ * @brief Path of the index of an archive in the cache directory.
+ *
+ * The file name is the hash of the absolute archive path, so archives with
+ * the same name in different directories do not collide.
+ */
+static bool cache_index_path(const char *archive, char *out, size_t len)
+{
+    char dir[PATH_MAX], real[PATH_MAX];
+    const char *env = getenv("BASEER_CACHE_DIR");
+    if (env && *env) {
+        snprintf(dir, sizeof(dir), "%s", env);
+    } else if ((env = getenv("XDG_CACHE_HOME")) && *env) {
+        snprintf(dir, sizeof(dir), "%s/baseer", env);
+    } else if ((env = getenv("HOME")) && *env) {
+        snprintf(dir, sizeof(dir), "%s/.cache", env);
+        mkdir(dir, 0755);
+        snprintf(dir, sizeof(dir), "%s/.cache/baseer", env);
+    } else {
+        return false;
+    }
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) return false;
+    if (!realpath(archive, real)) return false;
+    return snprintf(out, len, "%s/%016llx" TAR_INDEX_SUFFIX, dir,
+                    (unsigned long long)b_fnv1a(real, strlen(real))) < (int)len;
+}
+
+/**
+ * @brief Location of the index of an archive.
+ *
+ * Indexes live in the cache directory, so looking up a member never writes
+ * next to the archive (which may be in someone else's directory).
+ * `<archive>.bidx` is only used when there is no usable cache directory.
+ */
+static bool index_location(const char *archive, char path[PATH_MAX])
+{
+    if (cache_index_path(archive, path, PATH_MAX))
+        return true;
+    return snprintf(path, PATH_MAX, "%s" TAR_INDEX_SUFFIX, archive) < PATH_MAX;
+}
+// ========================= END LOCATION ==================================
+
+// ========================= BEGIN BUILD ==================================
+static void index_attach(tar_index_t *index)
+{
+    const unsigned char *p = index->data;
+    index->header = (const tar_index_header_t*)p;
+    index->entries = (const tar_index_entry_t*)(p + sizeof(tar_index_header_t));
+    index->table = (const uint32_t*)(index->entries + index->header->count);
+    index->strings = (const char*)(index->table + index->header->buckets);
+}
+
+/**
+ * @brief Whether a walk that stopped at pos reached the end of the archive.
+ *
+ * tar_next_member() also stops on a bad checksum or a truncated member;
+ * only a zero block, or the end of the file on a block boundary, ends it.
+ */
+static bool walk_complete(bparser *parser, uint64_t pos)
+{
+    unsigned char block[BLOCK_SIZE];
+    if (pos >= parser->size) return true;
+    if (bparser_read(parser, block, pos, sizeof(block)) != sizeof(block)) return false;
+    for (size_t i = 0; i < sizeof(block); i++)
+        if (block[i]) return false;
+    return true;
+}
+
+/**
+ * @brief Build the index image of an archive in memory.
+ *
+ * index->partial is set when the walk stopped before the end of the archive.
+ */
+static bool index_build(bparser *parser, tar_index_t *index)
+{
+    size_t count = 0, cap = 0, strings_size = 0, strings_cap = 0;
+    tar_index_entry_t *entries = NULL;
+    char *strings = NULL;
+    tar_member_t *m = malloc(sizeof(*m));
+    if (!m) return false;
+
+    // one pass over the header chain, checksums are checked by the walker
+    uint64_t pos = 0;
+    while (tar_next_member(parser, &pos, m)) {
+        size_t len;
+        const char *path = normalize_path(m->path, &len);
+        // only the number of segments is kept; the map is read again on extraction
+        free(m->sparse);
+        m->sparse = NULL;
+        if (count == cap) {
+            cap = cap ? cap * 2 : 256;
+            tar_index_entry_t *grown = realloc(entries, cap * sizeof(*entries));
+            if (!grown) goto fail;
+            entries = grown;
+        }
+        while (strings_size + len + 1 > strings_cap) {
+            strings_cap = strings_cap ? strings_cap * 2 : 4096;
+            char *grown = realloc(strings, strings_cap);
+            if (!grown) goto fail;
+            strings = grown;
+        }
+        memcpy(strings + strings_size, path, len);
+        strings[strings_size + len] = '\0';
+        entries[count++] = (tar_index_entry_t){
+            .hdr_off = m->hdr_off, .data_off = m->data_off, .size = m->size, .real_size = m->real_size,
+            .mtime = m->mtime, .hash = b_fnv1a(path, len), .path_off = strings_size, .path_len = (uint32_t)len,
+            .mode = m->mode, .sparse_count = (uint32_t)m->sparse_count, .type = m->type,
+        };
+        strings_size += len + 1;
+    }
+    index->partial = !walk_complete(parser, pos);
+    if (index->partial)
+        fprintf(stderr, COLOR_YELLOW "[!] Archive walk stopped at " COLOR_RESET "0x%llx" COLOR_YELLOW
+                ", only %zu members indexed\n" COLOR_RESET, (unsigned long long)pos, count);
+
+    uint64_t buckets = 16;
+    while (buckets < (uint64_t)count * 2) buckets <<= 1;
+    size_t total = sizeof(tar_index_header_t) + count * sizeof(*entries) + buckets * sizeof(uint32_t) + strings_size;
+    unsigned char *image = calloc(1, total);
+    if (!image) goto fail;
+
+    tar_index_header_t *header = (tar_index_header_t*)image;
+    memcpy(header->magic, TAR_INDEX_MAGIC, sizeof(header->magic));
+    header->version = TAR_INDEX_VERSION;
+    header->archive_size = parser->size;
+    header->count = count;
+    header->buckets = buckets;
+    header->strings_size = strings_size;
+    index->data = image;
+    index->data_size = total;
+    index->mapped = false;
+    index_attach(index);
+
+    memcpy((void*)index->entries, entries, count * sizeof(*entries));
+    memcpy((void*)index->strings, strings, strings_size);
+    uint32_t *table = (uint32_t*)index->table;
+    for (size_t i = 0; i < count; i++) {
+        const tar_index_entry_t *e = &index->entries[i];
+        uint64_t bucket;
+        // a later member with the same path replaces the earlier one
+        index_lookup(header, index->entries, table, index->strings, index->strings + e->path_off,
+                     e->path_len, e->hash, &bucket);
+        table[bucket] = (uint32_t)(i + 1);
+    }
+
+    free(m);
+    free(entries);
+    free(strings);
+    return true;
+
+fail:
+    free(m);
+    free(entries);
+    free(strings);
+    return false;
+}
+
+/**
+ * @brief Write the index in the cache directory (or next to the archive).
+ *
+ * The file is written under a temporary name and renamed, so readers never
+ * see a partial index.
+ */
+static void index_save(tar_index_t *index, const char *archive)
+{
+    char path[PATH_MAX], tmp[PATH_MAX + 16];
+    if (!index_location(archive, path)) return;
+    snprintf(tmp, sizeof(tmp), "%s.%d", path, (int)getpid());
+    FILE *fp = fopen(tmp, "wb");
+    if (!fp) return;
+    bool ok = fwrite(index->data, 1, index->data_size, fp) == index->data_size;
+    ok = (fclose(fp) == 0) && ok;
+    if (ok && rename(tmp, path) == 0) {
+        snprintf(index->path, sizeof(index->path), "%s", path);
+        return;
+    }
+    unlink(tmp);
+}
+
+/**
+ * @brief Check the layout of a mapped index before anything is read through it.
+ *
+ * Every size term is checked against what is left of the file (no sum can
+ * wrap), every entry's path must lie inside the strings, and every bucket
+ * must be empty or name an entry. At least one bucket stays empty, so a
+ * lookup always ends.
+ */
+static bool index_valid(const tar_index_header_t *h, uint64_t file_size)
+{
+    uint64_t left = file_size - sizeof(*h);
+    if (!h->buckets || (h->buckets & (h->buckets - 1)) != 0 || h->count >= h->buckets) return false;
+    if (h->count > left / sizeof(tar_index_entry_t)) return false;
+    left -= h->count * sizeof(tar_index_entry_t);
+    if (h->buckets > left / sizeof(uint32_t)) return false;
+    left -= h->buckets * sizeof(uint32_t);
+    if (h->strings_size != left) return false;
+
+    const tar_index_entry_t *entries = (const tar_index_entry_t*)(h + 1);
+    const uint32_t *table = (const uint32_t*)(entries + h->count);
+    for (uint64_t i = 0; i < h->count; i++)
+        if (entries[i].path_off >= h->strings_size || entries[i].path_len >= h->strings_size - entries[i].path_off)
+            return false;
+    uint64_t used = 0;
+    for (uint64_t b = 0; b < h->buckets; b++) {
+        if (table[b] == 0) continue;
+        if (table[b] - 1 >= h->count) return false;
+        used++;
+    }
+    return used < h->buckets;
+}
+
+/**
+ * @brief Map a saved index if it matches the archive.
+ */
+static bool index_load(tar_index_t *index, const char *archive, const struct stat *st)
+{
+    char path[PATH_MAX];
+    if (!index_location(archive, path)) return false;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat ist;
+    void *map = MAP_FAILED;
+    if (fstat(fd, &ist) == 0 && (size_t)ist.st_size >= sizeof(tar_index_header_t))
+        map = mmap(NULL, ist.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return false;
+
+    const tar_index_header_t *h = map;
+    bool valid = memcmp(h->magic, TAR_INDEX_MAGIC, sizeof(h->magic)) == 0 &&
+                 h->version == TAR_INDEX_VERSION &&
+                 h->archive_size == (uint64_t)st->st_size &&
+                 h->archive_mtime == (int64_t)st->st_mtim.tv_sec &&
+                 h->archive_mtime_ns == (int64_t)st->st_mtim.tv_nsec &&
+                 index_valid(h, ist.st_size);
+    if (!valid) {
+        munmap(map, ist.st_size);
+        return false;
+    }
+    index->data = map;
+    index->data_size = ist.st_size;
+    index->mapped = true;
+    index_attach(index);
+    snprintf(index->path, sizeof(index->path), "%s", path);
+    return true;
+}
+// ========================= END BUILD ==================================
+
+// ========================= BEGIN API ==================================
+tar_index_t *tar_index_open(bparser *parser, const char *archive)
+{
+    tar_index_t *index = calloc(1, sizeof(*index));
+    if (!index) return NULL;
+
+    // only a whole archive on disk can be matched with a saved index
+    struct stat st;
+    bool on_disk = archive && parser->base == 0 && stat(archive, &st) == 0 &&
+                   (uint64_t)st.st_size == parser->size;
+    if (on_disk && index_load(index, archive, &st))
+        return index;
+
+    if (!index_build(parser, index)) {
+        free(index);
+        return NULL;
+    }
+    index->built = true;
+    // a partial index would hide the members after the damage until the archive changes
+    if (on_disk && !index->partial) {
+        tar_index_header_t *header = (tar_index_header_t*)index->data;
+        header->archive_mtime = st.st_mtim.tv_sec;
+        header->archive_mtime_ns = st.st_mtim.tv_nsec;
+        index_save(index, archive);
+    }
+    return index;
+}
+
+const tar_index_entry_t *tar_index_find(const tar_index_t *index, const char *path)
+{
+    size_t len;
+    uint64_t bucket;
+    path = normalize_path(path, &len);
+    return index_lookup(index->header, index->entries, index->table, index->strings, path, len,
+                        b_fnv1a(path, len), &bucket);
+}
+
+void tar_index_close(tar_index_t *index)
+{
+    if (!index) return;
+    if (index->mapped) munmap(index->data, index->data_size);
+    else free(index->data);
+    free(index);
+}
+// ========================= END API ==================================
+
+// ========================= BEGIN COMMANDS ==================================
+static const char *archive_path(bparser *parser, inputs *input)
+{
+    // slices (members of other archives, carved files) are not on disk
+    return parser->base == 0 ? input->args[1] : NULL;
+}
+
+/**
+ * @brief Build or refresh the index of an archive and print its summary.
+ */
+bool b_tar_index(bparser *parser, void *arg)
+{
+    tar_index_t *index = tar_index_open(parser, archive_path(parser, arg));
+    if (!index) {
+        fprintf(stderr, COLOR_RED "[!] Could not index the archive\n" COLOR_RESET);
+        return false;
+    }
+    printf(COLOR_BLUE "\n=== TAR Index ===\n" COLOR_RESET);
+    printf(COLOR_GREEN "|--members   :" COLOR_RESET " %llu\n", (unsigned long long)index->header->count);
+    printf(COLOR_GREEN "|--buckets   :" COLOR_RESET " %llu\n", (unsigned long long)index->header->buckets);
+    printf(COLOR_GREEN "|--file      :" COLOR_RESET " %s (%s)\n", index->path[0] ? index->path : "in memory",
+           index->partial ? "partial, not saved" : index->built ? "built" : "up to date");
+    tar_index_close(index);
+    return true;
+}
+
+/**
+ * @brief Print one member found through the index, and run the flags that
+ * follow `--member <path>` on it in place.
+ */
+bool b_tar_member(bparser *parser, void *arg)
+{
+    inputs *input = arg;
+    const char *path = baseer_get_opt(input, "--member");
+    if (!path) return false;
+
+    tar_index_t *index = tar_index_open(parser, archive_path(parser, input));
+    if (!index) {
+        fprintf(stderr, COLOR_RED "[!] Could not index the archive\n" COLOR_RESET);
+        return false;
+    }
+    const tar_index_entry_t *e = tar_index_find(index, path);
+    if (!e) {
+        fprintf(stderr, COLOR_RED "[!] No such member: " COLOR_RESET "%s\n", path);
+        tar_index_close(index);
+        return false;
+    }
+
+    // a sparse member's packed data is not the file, so it is not analyzed in place
+    bparser *slice = (!e->sparse_count && e->data_off <= parser->size && e->size <= parser->size - e->data_off) ? bparser_slice(parser, e->data_off, e->size) : NULL;
+    const char *format = slice ? bx_binhead_identify(slice) : NULL;
+    printf(COLOR_BLUE "\n=== %.*s ===\n" COLOR_RESET, (int)e->path_len, index->strings + e->path_off);
+    printf(COLOR_GREEN "|--type      :" COLOR_RESET " %c\n", e->type ? e->type : '0');
+    printf(COLOR_GREEN "|--mode      :" COLOR_RESET " %o\n", e->mode);
+    printf(COLOR_GREEN "|--size      :" COLOR_RESET " %llu\n", (unsigned long long)e->size);
+    if (e->sparse_count)
+        printf(COLOR_GREEN "|--sparse    :" COLOR_RESET " %llu bytes, %u segments\n",
+               (unsigned long long)e->real_size, e->sparse_count);
+    printf(COLOR_GREEN "|--mtime     :" COLOR_RESET " %lld\n", (long long)e->mtime);
+    printf(COLOR_GREEN "|--header    :" COLOR_RESET " 0x%llx\n", (unsigned long long)e->hdr_off);
+    printf(COLOR_GREEN "|--data      :" COLOR_RESET " 0x%llx\n", (unsigned long long)e->data_off);
+    printf(COLOR_GREEN "|--format    :" COLOR_RESET " %s\n", format ? format : "unknown");
+
+    // <prog> <archive> <flags after --member <path>...>
+    int argc = *input->argc, at = 2;
+    while (at < argc && strcmp("--member", input->args[at]) != 0) at++;
+    if (slice && at + 2 < argc) {
+        int sub_argc;
+        inputs sub;
+        char **args = baseer_sub_args(input, at + 2, &sub_argc, &sub);
+        sub.member = path;
+        if (args) bx_binhead_dispatch(slice, &sub);
+        free(args);
+    }
+
+    free(slice);
+    tar_index_close(index);
+    return true;
+}
+// ========================= END COMMANDS ==================================
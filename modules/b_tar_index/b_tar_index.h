@@ -0,0 +1,108 @@
+/**
+ * @file b_tar_index.h
+ * @brief Persistent tar member index: O(1) lookup of a member by path.
+ *
+ * The index is built in one pass over the header chain (checksums are
+ * validated by tar_next_member()) and saved in a cache directory
+ * (`BASEER_CACHE_DIR`, `$XDG_CACHE_HOME/baseer` or `~/.cache/baseer`), named
+ * by the hash of the absolute archive path. Only when no cache directory is
+ * usable is it saved as `<archive>.bidx` next to the archive. It is rebuilt
+ * when the size or mtime of the archive changes, and a saved index is fully
+ * validated before use, so a corrupt or crafted file is rebuilt over. When
+ * the walk stops before the end of the archive (bad checksum, truncated
+ * member), the members read so far are still usable but the index is
+ * reported as partial and not saved.
+ *
+ * Layout of an index file:
+ *
+ *     [header][entries][hash table][path strings]
+ *
+ * The hash table is open-addressed on the FNV-1a hash of the path and
+ * stores entry numbers + 1 (0 marks an empty bucket). When a path appears
+ * more than once in the archive, the last member wins, as on extraction.
+ *
+ * Options (read from the command line):
+ * - `--index`                    Build (or refresh) the index and print its summary.
+ * - `--member <path> [flags...]` Print one member, and run the flags on it in place.
+ */
+#ifndef B_TAR_INDEX_H
+#define B_TAR_INDEX_H
+#include "../bparser/bparser.h"
+#include "../../baseer.h"
+#include "../bx_tar/bx_tar.h"
+#include <stdint.h>
+
+#define TAR_INDEX_MAGIC   "BTARIDX1"
+#define TAR_INDEX_VERSION 2
+#define TAR_INDEX_SUFFIX  ".bidx"
+
+/**
+ * @brief Header at the start of an index file.
+ */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t archive_size;      /**< Size of the indexed archive */
+    int64_t archive_mtime;      /**< mtime of the indexed archive (seconds) */
+    int64_t archive_mtime_ns;
+    uint64_t count;             /**< Number of entries */
+    uint64_t buckets;           /**< Hash table size (power of two) */
+    uint64_t strings_size;
+} tar_index_header_t;
+
+/**
+ * @brief One member in the index.
+ */
+typedef struct {
+    uint64_t hdr_off;
+    uint64_t data_off;
+    uint64_t size;              /**< Stored size */
+    uint64_t real_size;         /**< Size once extracted (differs for sparse members) */
+    int64_t mtime;
+    uint64_t hash;              /**< FNV-1a of the path */
+    uint64_t path_off;          /**< Offset in the path strings */
+    uint32_t path_len;
+    uint32_t mode;
+    uint32_t sparse_count;      /**< Data segments of a sparse member, 0 otherwise */
+    char type;
+    char pad[3];
+} tar_index_entry_t;
+
+/**
+ * @brief An index, loaded from disk (mapped) or built in memory.
+ */
+typedef struct {
+    void *data;
+    size_t data_size;
+    bool mapped;
+    const tar_index_header_t *header;
+    const tar_index_entry_t *entries;
+    const uint32_t *table;
+    const char *strings;
+    char path[4096];            /**< Index file, empty if not persisted */
+    bool built;                 /**< Built by this run (not loaded) */
+    bool partial;               /**< The walk stopped before the end of the archive */
+} tar_index_t;
+
+/**
+ * @brief Load the index of an archive, building and saving it if needed.
+ *
+ * @param parser  Parser over the archive.
+ * @param archive Path of the archive, or NULL for a slice (the index is
+ *                then only kept in memory).
+ * @return The index (free with tar_index_close()), NULL on failure.
+ */
+tar_index_t *tar_index_open(bparser *parser, const char *archive);
+
+/**
+ * @brief Find a member by path ("./" prefixes and trailing '/' are ignored).
+ */
+const tar_index_entry_t *tar_index_find(const tar_index_t *index, const char *path);
+
+void tar_index_close(tar_index_t *index);
+
+bool b_tar_index(bparser *parser, void *arg);
+bool b_tar_member(bparser *parser, void *arg);
+
+#endif
@@ -6,6 +6,16 @@
 #include "bx_binhead.h"
 #include "../bx_elf/bx_elf.h"
 #include "../bx_tar/bx_tar.h"
+#include "../bx_zip/bx_zip.h"
+#include "../bx_png/bx_png.h"
+#include "../bx_pdf/bx_pdf.h"
+#include "../bx_macho/bx_macho.h"
+#include "../bx_pe/bx_pe.h"
+#include "../bx_ar/bx_ar.h"
+#include "../bx_wasm/bx_wasm.h"
+#include "../b_scan/b_scan.h"
+#include "../b_carve/b_carve.h"
+#include "../b_hash/b_hash.h"
 
 unsigned int count_bits(unsigned long long int n)
 {
@@ -50,25 +60,57 @@ bool bx_binhead(baseer_target_t *target, void *arg)
     bparser* bp = NULL;
     // printf("%d\n", target->size);
     bp = bparser_load(target);
+    if (bp == NULL)
+        return false;
+
+    bool ok = bx_binhead_dispatch(bp, arg);
+    free(bp);
+    return ok;
+}
 
-    bmagic magics[] = {
+#define BX_MAX_MAGICS 16
+
+/**
+ * @brief Fill the table of known magic numbers.
+ *
+ * @return Number of entries.
+ */
+static int load_magics(bmagic *magics)
+{
+    bmagic table[] = {
         {"ELF", ELF_MAGIC, reverse_bytes(ELF_MAGIC), bx_elf, 0},
         {"TAR", TAR_MAGIC, reverse_bytes(TAR_MAGIC), bx_tar, 257},
-        // {"PDF", PDF_MAGIC, reverse_bytes(PDF_MAGIC), NULL, 0},
-        // {"PNG", PNG_MAGIC, reverse_bytes(PNG_MAGIC), NULL, 0},
-        // {"ZIP", ZIP_MAGIC, reverse_bytes(ZIP_MAGIC), NULL, 0},
-        // {"Mach-o", MACHO_MAGIC, reverse_bytes(MACHO_MAGIC), NULL, 0},
+        {"ZIP", ZIP_MAGIC, reverse_bytes(ZIP_MAGIC), bx_zip, 0},
+        {"PNG", PNG_MAGIC, reverse_bytes(PNG_MAGIC), bx_png, 0},
+        {"PDF", PDF_MAGIC, reverse_bytes(PDF_MAGIC), bx_pdf, 0},
+        {"Mach-O", MACHO_MAGIC, reverse_bytes(MACHO_MAGIC), bx_macho, 0},
+        {"Mach-O", MACHO_MAGIC_64, reverse_bytes(MACHO_MAGIC_64), bx_macho, 0},
+        {"Mach-O fat", MACHO_FAT_MAGIC, reverse_bytes(MACHO_FAT_MAGIC), bx_macho, 0},
+        {"Mach-O fat", MACHO_FAT_MAGIC_64, reverse_bytes(MACHO_FAT_MAGIC_64), bx_macho, 0},
+        {"PE", PE_MAGIC, reverse_bytes(PE_MAGIC), bx_pe, 0},
+        {"AR", AR_MAGIC, reverse_bytes(AR_MAGIC), bx_ar, 0},
+        {"WASM", WASM_MAGIC, reverse_bytes(WASM_MAGIC), bx_wasm, 1},
         // { NULL, 0,         0,                 NULL }
     };
+    int count = sizeof(table)/sizeof(table[0]);
+    memcpy(magics, table, sizeof(table));
+    return count;
+}
 
-
-
+/**
+ * @brief Find the magic number a parser starts with.
+ *
+ * @return Index in magics, or -1 if none matches.
+ */
+static int match_magic(bparser *bp, const bmagic *magics, int count)
+{
     bool flag_1 = 1, flag_2 = 1, f=0;
-    for(int i=0; i< sizeof(magics)/sizeof(magics[0]); i++)
+    for(int i=0; i< count; i++)
     {
         int len = count_bytes(magics[i].number);
         void* pattern = malloc(len);
         size_t n = bparser_read(bp, pattern, magics[i].pos, len);
+        if (n < (size_t)len) n = 0; // too short to hold this magic
         unsigned char* p = (unsigned char*)pattern;
         unsigned char* mgn = (unsigned char*)&magics[i].number;
         unsigned char* mgn_r = (unsigned char*)&magics[i].rnumber;
@@ -86,21 +128,45 @@ bool bx_binhead(baseer_target_t *target, void *arg)
             flag_1 = 0, flag_2 = 0;
         }
 
-        if(flag_1 || flag_2){
-            // printf("This file is %s\n", magics[i].name);
-            bparser_apply(bp, *magics[i].parser, arg);
-            free(pattern); // clean up because next free will not be reached
-            break;
-        }
-
         free(pattern);
         pattern = NULL;
+        if(flag_1 || flag_2){
+            return i;
+        }
     }
-    free(bp);
+    return -1;
+}
+
+const char *bx_binhead_identify(bparser *bp)
+{
+    bmagic magics[BX_MAX_MAGICS];
+    int count = load_magics(magics);
+    int i = bp ? match_magic(bp, magics, count) : -1;
+    return (i < 0) ? NULL : magics[i].name;
+}
 
+bool bx_binhead_dispatch(bparser *bp, void *arg)
+{
+    if (bp == NULL)
+        return false;
 
-    if(!flag_1 && !flag_2) {
-        printf("unknown file\n");
+    bmagic magics[BX_MAX_MAGICS];
+    int count = load_magics(magics);
+    int i = match_magic(bp, magics, count);
+    if (i >= 0) {
+        // printf("This file is %s\n", magics[i].name);
+        bparser_apply(bp, *magics[i].parser, arg);
+        return true;
     }
+
+    // signature scanning, carving and hashing do not depend on the file format
+    if (baseer_get_opt((inputs*)arg, "--scan"))
+        bparser_apply(bp, b_scan, arg);
+    else if (strcmp("--carve", ((inputs*)arg)->args[2]) == 0)
+        bparser_apply(bp, b_carve, arg);
+    else if (strcmp("--hash", ((inputs*)arg)->args[2]) == 0)
+        bparser_apply(bp, b_hash, arg);
+    else
+        printf("unknown file\n");
     return true;
 }
@@ -17,9 +17,15 @@
 
 #define ELF_MAGIC 0x7F454C46 // https://en.wikipedia.org/wiki/Executable_and_Linkable_Format
 #define PNG_MAGIC 0x89504e470d0a1a0a // https://www.libpng.org/pub/png/spec/1.2/PNG-Structure.html 
-#define ZIP_MAGIC 0x504B
+#define ZIP_MAGIC 0x504B0304 // "PK\3\4", first local file header
 #define PDF_MAGIC 0x255044462D
-#define MACHO_MAGIC 0xCEFAEDFE
+#define MACHO_MAGIC 0xCEFAEDFE // https://github.com/apple-oss-distributions/xnu/blob/main/EXTERNAL_HEADERS/mach-o/loader.h
+#define MACHO_MAGIC_64 0xCFFAEDFE
+#define MACHO_FAT_MAGIC 0xCAFEBABE // fat (universal) binary, shared with Java class files
+#define MACHO_FAT_MAGIC_64 0xCAFEBABF
+#define AR_MAGIC 0x213C617263683E0A // "!<arch>\n", static libraries and .deb packages
+#define WASM_MAGIC 0x61736D // "asm" after the leading NUL, the handler checks byte 0 and the version
+#define PE_MAGIC 0x4D5A // "MZ", the handler checks the PE signature at e_lfanew
 #define TAR_MAGIC 0x7573746172 
                         // 00 30 30
                         // 20 20 00
@@ -35,4 +41,24 @@ typedef struct{
 
 bool bx_binhead(baseer_target_t *target, void *arg);
 
+/**
+ * @brief Identify the format of a parser and run its extension.
+ *
+ * Works on any parser, including a bparser_slice() of a larger file, so
+ * archive members and carved payloads can be analyzed in place.
+ *
+ * @param bp Parser over the data to identify
+ * @param arg Command-line inputs handed to the extension
+ * @return true once dispatched (or reported as unknown), false if bp is NULL
+ */
+bool bx_binhead_dispatch(bparser *bp, void *arg);
+
+/**
+ * @brief Name of the format a parser starts with ("ELF", "TAR", ...).
+ *
+ * @param bp Parser over the data to identify
+ * @return Format name, or NULL if the format is unknown
+ */
+const char *bx_binhead_identify(bparser *bp);
+
 #endif
@@ -18,36 +18,51 @@ bparser* bparser_load(baseer_target_t *target) {
     p->fp = target->fp; // if mem mode, this will be NULL
     p->block = target->block;
     p->size = target->size;
+    p->base = 0;
  
     return p;
 }
 
+/* ========================= Slice Parser ========================= */
+bparser* bparser_slice(const bparser* parent, size_t offset, size_t len) {
+    RETURN_NULL_IF(!parent);
+    RETURN_NULL_IF(offset > parent->size || len > parent->size - offset);
+
+    bparser *p = malloc(sizeof(bparser));
+    RETURN_NULL_IF(!p);
+
+    p->mode = parent->mode;
+    p->fp = parent->fp;
+    p->block = parent->block ? (const unsigned char*)parent->block + offset : NULL;
+    p->size = len;
+    p->base = parent->base + offset;
+
+    return p;
+}
+
 /* ========================= Read Data ========================= */
-size_t bparser_read(bparser* parser, void* buf, unsigned int pos, size_t size) {
+size_t bparser_read(bparser* parser, void* buf, size_t pos, size_t size) {
     if (!parser || !buf) return 0;
+    if (pos >= parser->size) return 0;
+    // never read past the end of a slice
+    if (size > parser->size - pos) size = parser->size - pos;
 
     switch (parser->mode) {
         case BASEER_MODE_MEMORY:
-            unsigned int chunck_size=0;
-            if(pos + size > parser->size) {
-                return 0;
-            } else {
-                chunck_size = size;
-            }
-            memcpy(buf, (unsigned char*)parser->block+pos, chunck_size);
+            memcpy(buf, (unsigned char*)parser->block+pos, size);
             return size;
 
         case BASEER_MODE_STREAM:
             if (!parser->fp) return 0;
-            if (fseek(parser->fp, pos, SEEK_SET) != 0) return 0;
+            if (fseeko(parser->fp, parser->base + pos, SEEK_SET) != 0) return 0;
             return fread(buf, 1, size, parser->fp);
 
         case BASEER_MODE_BOTH:
-            if (parser->block && pos + size < parser->size) {
+            if (parser->block) {
                 memcpy(buf, (unsigned char*)parser->block + pos, size);
                 return size;
             } else if (parser->fp) {
-                if (fseek(parser->fp, pos, SEEK_SET) != 0) return 0;
+                if (fseeko(parser->fp, parser->base + pos, SEEK_SET) != 0) return 0;
                 return fread(buf, 1, size, parser->fp);
             }
             return 0;
@@ -11,16 +11,23 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
 #include "../../baseer.h"
 
 /**
  * @brief Parser object
+ *
+ * A parser may be a window (slice) over another parser: it shares the
+ * parent's memory block and FILE*, and `base` is the offset of the window
+ * in the underlying file.
  */
 typedef struct {
     baseer_mode_t mode;
     FILE *fp;
     size_t size;
     const void *block;
+    size_t base;        /**< Offset of this parser in the file (0 unless sliced) */
 } bparser;
 
 /**
@@ -50,7 +57,22 @@ bparser* bparser_load(baseer_target_t *data);
  * @param size Number of bytes to read
  * @return Number of bytes successfully read
  */
-size_t bparser_read(bparser* parser, void* buf, unsigned int pos, size_t size);
+size_t bparser_read(bparser* parser, void* buf, size_t pos, size_t size);
+
+/**
+ * @brief Create a window over a parser without copying
+ *
+ * The slice shares the parent's backing (memory block, mapping or FILE*)
+ * and only reads inside [offset, offset + len) of the parent. Slices can
+ * be sliced again and handed to any bparser callback. The parent must
+ * outlive the slice; free the slice with free().
+ *
+ * @param parent Parser to slice
+ * @param offset Start of the window in the parent
+ * @param len Size of the window
+ * @return Pointer to the new bparser, NULL if the window is out of bounds
+ */
+bparser* bparser_slice(const bparser* parent, size_t offset, size_t len);
 
 /**
  * @brief Execute a callback on the parser
@@ -62,5 +84,31 @@ size_t bparser_read(bparser* parser, void* buf, unsigned int pos, size_t size);
  */
 bool bparser_apply(bparser* parser, bparser_callback_t callback, void* arg);
 
+/* ========================= Byte Readers ========================= */
+/*
+ * Unaligned loads of little- and big-endian fields from a byte buffer.
+ * memcpy() compiles to a single load (and a bswap when the byte order
+ * differs from the host's).
+ */
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define BPARSER_LE(bits, v) __builtin_bswap##bits(v)
+#define BPARSER_BE(bits, v) (v)
+#else
+#define BPARSER_LE(bits, v) (v)
+#define BPARSER_BE(bits, v) __builtin_bswap##bits(v)
+#endif
+
+static inline uint16_t rd16le(const void *p) { uint16_t v; memcpy(&v, p, sizeof(v)); return BPARSER_LE(16, v); }
+static inline uint32_t rd32le(const void *p) { uint32_t v; memcpy(&v, p, sizeof(v)); return BPARSER_LE(32, v); }
+static inline uint64_t rd64le(const void *p) { uint64_t v; memcpy(&v, p, sizeof(v)); return BPARSER_LE(64, v); }
+static inline uint16_t rd16be(const void *p) { uint16_t v; memcpy(&v, p, sizeof(v)); return BPARSER_BE(16, v); }
+static inline uint32_t rd32be(const void *p) { uint32_t v; memcpy(&v, p, sizeof(v)); return BPARSER_BE(32, v); }
+static inline uint64_t rd64be(const void *p) { uint64_t v; memcpy(&v, p, sizeof(v)); return BPARSER_BE(64, v); }
+
+/** @brief Read a field whose byte order is only known at run time (e.g. ELF EI_DATA). */
+static inline uint16_t rd16_endian(const void *p, bool be) { return be ? rd16be(p) : rd16le(p); }
+static inline uint32_t rd32_endian(const void *p, bool be) { return be ? rd32be(p) : rd32le(p); }
+static inline uint64_t rd64_endian(const void *p, bool be) { return be ? rd64be(p) : rd64le(p); }
+
 #endif
 
@@ -0,0 +1,510 @@
+/**
+ * @file bx_ar.c
+ * @brief ar member headers, symbol index and member analysis.
+ */
+#include "bx_ar.h"
+#include <ctype.h>
+#include <time.h>
+#include "../binhead/bx_binhead.h"
+#include "../b_scan/b_scan.h"
+#include "../b_carve/b_carve.h"
+#include "../b_hash/b_hash.h"
+
+#define AR_HASH_CHUNK (256 * 1024)
+
+/**
+ * @brief Parse a space-padded decimal or octal header field.
+ *
+ * @return false if it holds anything but digits (and trailing spaces).
+ */
+static bool parse_field(const unsigned char *p, size_t len, int base, uint64_t *out)
+{
+    uint64_t v = 0;
+    size_t i = 0;
+    for (; i < len && p[i] >= '0' && p[i] < '0' + base; i++) v = v * base + (p[i] - '0');
+    *out = v;
+    for (; i < len; i++)
+        if (p[i] != ' ') return false;
+    return true;
+}
+
+// ========================= BEGIN HEADERS ==================================
+/**
+ * @brief Member name of a GNU/SysV header: "name/", or "/<offset>" into the
+ * long name table (entries end with "/\n").
+ */
+static char *gnu_name(const unsigned char *field, const char *names, uint64_t names_size)
+{
+    if (field[0] == '/' && isdigit(field[1]) && names) {
+        uint64_t at;
+        size_t digits = 1;
+        while (digits < 16 && isdigit(field[digits])) digits++;
+        parse_field(field + 1, digits - 1, 10, &at);
+        if (at >= names_size) return strdup("");
+        size_t len = 0;
+        while (at + len < names_size && names[at + len] != '\n' && len < AR_MAX_NAME) len++;
+        if (len && names[at + len - 1] == '/') len--;
+        return strndup(names + at, len);
+    }
+    size_t len = 16;
+    while (len && field[len - 1] == ' ') len--;
+    if (len && field[len - 1] == '/') len--;
+    return strndup((const char*)field, len);
+}
+
+/**
+ * @brief Copy len bytes of the archive, in one read.
+ *
+ * @return The bytes followed by a NUL (free with free()), NULL on a short read.
+ */
+static char *read_blob(bparser *parser, uint64_t off, uint64_t len)
+{
+    if (off > parser->size || len > parser->size - off) return NULL;
+    char *buf = malloc(len + 1);
+    if (!buf) return NULL;
+    if (bparser_read(parser, buf, off, len) != len) {
+        free(buf);
+        return NULL;
+    }
+    buf[len] = '\0';
+    return buf;
+}
+
+static int cmp_member_off(const void *key, const void *elem)
+{
+    uint64_t off = *(const uint64_t*)key, at = ((const ar_member_t*)elem)->header_off;
+    return (off > at) - (off < at);
+}
+
+/**
+ * @brief Add an armap entry for the member whose header is at off.
+ */
+static void add_symbol(ar_archive_t *ar, const char *name, uint64_t off)
+{
+    const ar_member_t *m = bsearch(&off, ar->members, ar->count, sizeof(*ar->members), cmp_member_off);
+    if (!m) {
+        ar->unresolved++;
+        return;
+    }
+    ar->symbols[ar->nsymbols++] = (ar_symbol_t){.name = name, .member = (uint32_t)(m - ar->members)};
+}
+
+/**
+ * @brief GNU/SysV index: count, member offsets (big-endian, 4 or 8 bytes),
+ * then as many NUL-terminated names.
+ */
+static bool load_gnu_armap(ar_archive_t *ar, const unsigned char *map, uint64_t size)
+{
+    size_t w = ar->armap64 ? 8 : 4;
+    if (size < w) return false;
+    uint64_t n = ar->armap64 ? rd64be(map) : rd32be(map);
+    if (n > AR_MAX_SYMBOLS || n > (size - w) / w) return false;
+    uint64_t strings = w + n * w;
+    ar->symstr = malloc(size - strings + 1);
+    ar->symbols = malloc((n + 1) * sizeof(*ar->symbols));
+    if (!ar->symstr || !ar->symbols) return false;
+    memcpy(ar->symstr, map + strings, size - strings);
+    ar->symstr[size - strings] = '\0';
+
+    const char *s = ar->symstr, *end = ar->symstr + (size - strings);
+    for (uint64_t i = 0; i < n && s < end; i++) {
+        const unsigned char *o = map + w + i * w;
+        add_symbol(ar, s, ar->armap64 ? rd64be(o) : rd32be(o));
+        s += strlen(s) + 1;
+    }
+    return true;
+}
+
+/**
+ * @brief BSD index: size of the ranlib array, {name, member offset} pairs,
+ * size of the strings, strings. The words are in the target byte order
+ * (little-endian on every current platform).
+ */
+static bool load_bsd_armap(ar_archive_t *ar, const unsigned char *map, uint64_t size)
+{
+    size_t w = ar->armap64 ? 8 : 4;
+    if (size < w) return false;
+    uint64_t bytes = ar->armap64 ? rd64le(map) : rd32le(map);
+    if (bytes > size - w || size - w - bytes < w) return false;
+    uint64_t n = bytes / (2 * w);
+    const unsigned char *strsize_at = map + w + bytes;
+    uint64_t strsize = ar->armap64 ? rd64le(strsize_at) : rd32le(strsize_at);
+    uint64_t strings = w + bytes + w;
+    if (n > AR_MAX_SYMBOLS || strsize > size - strings) return false;
+    ar->symstr = malloc(strsize + 1);
+    ar->symbols = malloc((n + 1) * sizeof(*ar->symbols));
+    if (!ar->symstr || !ar->symbols) return false;
+    memcpy(ar->symstr, map + strings, strsize);
+    ar->symstr[strsize] = '\0';
+
+    for (uint64_t i = 0; i < n; i++) {
+        const unsigned char *r = map + w + i * 2 * w;
+        uint64_t strx = ar->armap64 ? rd64le(r) : rd32le(r), off = ar->armap64 ? rd64le(r + w) : rd32le(r + 4);
+        if (strx >= strsize) {
+            ar->unresolved++;
+            continue;
+        }
+        add_symbol(ar, ar->symstr + strx, off);
+    }
+    return true;
+}
+
+static int cmp_symbol(const void *a, const void *b)
+{
+    const ar_symbol_t *x = a, *y = b;
+    int c = strcmp(x->name, y->name);
+    return c ? c : (x->member > y->member) - (x->member < y->member);
+}
+
+static bool add_member(ar_archive_t *ar, size_t *cap, const ar_member_t *m)
+{
+    if (ar->count == *cap) {
+        size_t n = *cap ? *cap * 2 : 64;
+        ar_member_t *grown = realloc(ar->members, n * sizeof(*grown));
+        if (!grown) return false;
+        ar->members = grown;
+        *cap = n;
+    }
+    ar->members[ar->count++] = *m;
+    return true;
+}
+
+ar_archive_t *ar_open(bparser *parser)
+{
+    char magic[AR_MAGIC_SIZE];
+    if (bparser_read(parser, magic, 0, sizeof(magic)) != sizeof(magic) || memcmp(magic, "!<arch>\n", 8) != 0)
+        return NULL;
+    ar_archive_t *ar = calloc(1, sizeof(*ar));
+    if (!ar) return NULL;
+    ar->parser = parser;
+
+    char *names = NULL;
+    uint64_t map_off = 0, map_size = 0;
+    bool have_map = false;
+    size_t cap = 0;
+    for (uint64_t pos = AR_MAGIC_SIZE; pos < parser->size && parser->size - pos >= AR_HEADER_SIZE;) {
+        unsigned char h[AR_HEADER_SIZE];
+        uint64_t size, mtime, uid, gid, mode;
+        if (bparser_read(parser, h, pos, sizeof(h)) != sizeof(h)) break;
+        if (h[58] != '`' || h[59] != '\n' || !parse_field(h + 48, 10, 10, &size)) {
+            fprintf(stderr, COLOR_RED "[!] Bad member header at " COLOR_RESET "0x%llx\n", (unsigned long long)pos);
+            break;
+        }
+        parse_field(h + 16, 12, 10, &mtime);
+        parse_field(h + 28, 6, 10, &uid);
+        parse_field(h + 34, 6, 10, &gid);
+        parse_field(h + 40, 8, 8, &mode);
+        uint64_t data = pos + AR_HEADER_SIZE;
+        if (size > parser->size - data) {
+            fprintf(stderr, COLOR_RED "[!] Truncated member at " COLOR_RESET "0x%llx\n", (unsigned long long)pos);
+            size = parser->size - data;
+        }
+        uint64_t next = data + size + (size & 1);   // data is 2-byte aligned
+
+        ar_member_t m = {.header_off = pos, .data_off = data, .size = size, .mtime = (int64_t)mtime,
+                         .uid = (uint32_t)uid, .gid = (uint32_t)gid, .mode = (uint32_t)mode};
+        if (memcmp(h, "#1/", 3) == 0) {
+            // BSD: the name is stored in front of the data
+            uint64_t len;
+            parse_field(h + 3, 13, 10, &len);
+            if (len > size) len = size;
+            char *name = read_blob(parser, data, len < AR_MAX_NAME ? len : AR_MAX_NAME);
+            if (!name) break;
+            name[strnlen(name, len < AR_MAX_NAME ? len : AR_MAX_NAME)] = '\0';
+            m.name = name;
+            m.data_off += len;
+            m.size -= len;
+            ar->format = AR_BSD;
+        } else if (memcmp(h, "/ ", 2) == 0 || memcmp(h, "/SYM64/ ", 8) == 0) {
+            // GNU index (a second "/" in Windows import libraries is skipped)
+            if (!have_map) {
+                have_map = true;
+                ar->armap64 = h[1] == 'S';
+                ar->armap_name = ar->armap64 ? "/SYM64/" : "/";
+                map_off = data;
+                map_size = size;
+            }
+            pos = next;
+            continue;
+        } else if (memcmp(h, "// ", 3) == 0) {
+            free(names);
+            names = read_blob(parser, data, size);
+            ar->names_size = names ? size : 0;
+            pos = next;
+            continue;
+        } else {
+            m.name = gnu_name(h, names, ar->names_size);
+        }
+        if (!m.name) break;
+        if (strncmp(m.name, "__.SYMDEF", 9) == 0) {
+            // BSD index
+            if (!have_map) {
+                have_map = true;
+                ar->armap64 = strncmp(m.name, "__.SYMDEF_64", 12) == 0;
+                ar->armap_name = ar->armap64 ? "__.SYMDEF_64" : "__.SYMDEF";
+                ar->format = AR_BSD;
+                map_off = m.data_off;
+                map_size = m.size;
+            }
+            free(m.name);
+        } else if (!add_member(ar, &cap, &m)) {
+            free(m.name);
+            break;
+        }
+        pos = next;
+    }
+    free(names);
+
+    if (have_map && ar->count) {
+        // in place in memory mode, a single read otherwise
+        unsigned char *copy = NULL;
+        const unsigned char *map = parser->block ? (const unsigned char*)parser->block + map_off
+                                                 : (copy = (unsigned char*)read_blob(parser, map_off, map_size));
+        bool ok = map && (ar->format == AR_BSD ? load_bsd_armap(ar, map, map_size) : load_gnu_armap(ar, map, map_size));
+        free(copy);
+        if (!ok) {
+            fprintf(stderr, COLOR_RED "[!] Bad symbol index: " COLOR_RESET "%s\n", ar->armap_name);
+            ar->nsymbols = 0;
+        }
+        if (ar->nsymbols) qsort(ar->symbols, ar->nsymbols, sizeof(*ar->symbols), cmp_symbol);
+    }
+    return ar;
+}
+
+void ar_close(ar_archive_t *ar)
+{
+    if (!ar) return;
+    for (size_t i = 0; i < ar->count; i++) free(ar->members[i].name);
+    free(ar->members);
+    free(ar->symstr);
+    free(ar->symbols);
+    free(ar);
+}
+
+const ar_member_t *ar_find(const ar_archive_t *ar, const char *name)
+{
+    for (size_t i = 0; i < ar->count; i++)
+        if (strcmp(ar->members[i].name, name) == 0) return &ar->members[i];
+    return NULL;
+}
+
+const ar_symbol_t *ar_lookup(const ar_archive_t *ar, const char *symbol, size_t *count)
+{
+    // lower bound
+    size_t lo = 0, hi = ar->nsymbols;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (strcmp(ar->symbols[mid].name, symbol) < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    *count = 0;
+    while (lo + *count < ar->nsymbols && strcmp(ar->symbols[lo + *count].name, symbol) == 0) (*count)++;
+    return *count ? &ar->symbols[lo] : NULL;
+}
+
+bparser *ar_member_slice(const ar_archive_t *ar, const ar_member_t *m)
+{
+    return bparser_slice(ar->parser, m->data_off, m->size);
+}
+// ========================= END HEADERS ==================================
+
+// ========================= BEGIN COMMANDS ==================================
+static void print_member_title(bparser *data, const ar_member_t *m)
+{
+    const char *format = bx_binhead_identify(data);
+    printf(COLOR_BLUE "\n=== %s " COLOR_RESET "(%llu bytes at 0x%llx, %s)\n", m->name, (unsigned long long)m->size,
+           (unsigned long long)m->data_off, format ? format : "unknown");
+}
+
+/**
+ * @brief Print a member's title and run the flags in sub on its slice
+ * (or only identify it when there are none).
+ */
+static void analyze_member(const ar_archive_t *ar, const ar_member_t *m, inputs *sub)
+{
+    bparser *slice = ar_member_slice(ar, m);
+    if (!slice) return;
+    print_member_title(slice, m);
+    sub->member = m->name;
+    if (*sub->argc > 2) bx_binhead_dispatch(slice, sub);
+    free(slice);
+}
+
+static void hash_member(const ar_archive_t *ar, const ar_member_t *m, unsigned char digest[SHA256_DIGEST_SIZE])
+{
+    bparser *parser = ar->parser;
+    if (parser->block) {
+        b_sha256((const unsigned char*)parser->block + m->data_off, m->size, digest);
+        return;
+    }
+    b_sha256_ctx ctx;
+    b_sha256_init(&ctx);
+    unsigned char *buf = malloc(AR_HASH_CHUNK);
+    for (uint64_t done = 0; buf && done < m->size;) {
+        size_t n = bparser_read(parser, buf, m->data_off + done,
+                                m->size - done < AR_HASH_CHUNK ? m->size - done : AR_HASH_CHUNK);
+        if (!n) break;
+        b_sha256_update(&ctx, buf, n);
+        done += n;
+    }
+    free(buf);
+    b_sha256_final(&ctx, digest);
+}
+
+static void ar_metadata(const ar_archive_t *ar)
+{
+    uint64_t total = 0;
+    for (size_t i = 0; i < ar->count; i++) total += ar->members[i].size;
+    printf(COLOR_BLUE "\n=== ar Archive ===\n" COLOR_RESET);
+    printf(COLOR_GREEN "|--format    :" COLOR_RESET " %s\n", ar->format == AR_BSD ? "BSD" : "GNU/SysV");
+    printf(COLOR_GREEN "|--members   :" COLOR_RESET " %zu (%llu bytes)\n", ar->count, (unsigned long long)total);
+    if (ar->names_size)
+        printf(COLOR_GREEN "|--long names:" COLOR_RESET " %llu bytes\n", (unsigned long long)ar->names_size);
+    if (ar->armap_name) {
+        printf(COLOR_GREEN "|--armap     :" COLOR_RESET " %s, %zu symbols (%s)\n", ar->armap_name, ar->nsymbols,
+               ar->armap64 ? "64-bit" : "32-bit");
+        if (ar->unresolved)
+            printf(COLOR_YELLOW "|--unresolved:" COLOR_RESET " %zu entries point to no member\n", ar->unresolved);
+    } else {
+        printf(COLOR_GREEN "|--armap     :" COLOR_RESET " none\n");
+    }
+}
+
+/**
+ * @brief List the members (`-l`), hashing their data with `-l --hash`.
+ */
+static void ar_list(const ar_archive_t *ar, bool hash)
+{
+    uint64_t total = 0;
+    for (size_t i = 0; i < ar->count; i++) {
+        const ar_member_t *m = &ar->members[i];
+        printf(COLOR_GREEN "%06o" COLOR_RESET " %5u/%-5u %12llu %12lld", m->mode & 07777, m->uid, m->gid,
+               (unsigned long long)m->size, (long long)m->mtime);
+        if (hash) {
+            unsigned char digest[SHA256_DIGEST_SIZE];
+            hash_member(ar, m, digest);
+            printf(" ");
+            for (int j = 0; j < SHA256_DIGEST_SIZE; j++) printf("%02x", digest[j]);
+        }
+        printf("  %s\n", m->name);
+        total += m->size;
+    }
+    printf(COLOR_BLUE "%zu members, %llu bytes\n" COLOR_RESET, ar->count, (unsigned long long)total);
+}
+
+/**
+ * @brief Run the flags that follow `-r` on every member.
+ *
+ * Without flags, the members are only identified, from their first bytes.
+ */
+static void ar_recursive(const ar_archive_t *ar, inputs *input)
+{
+    int sub_argc;
+    inputs sub;
+    char **args = baseer_sub_args(input, 3, &sub_argc, &sub);
+    if (!args) return;
+    for (size_t i = 0; i < ar->count; i++) analyze_member(ar, &ar->members[i], &sub);
+    fflush(stdout);
+    free(args);
+}
+
+/**
+ * @brief Run the flags that follow `<option> <value>` on a member.
+ */
+static void run_after(const ar_archive_t *ar, const ar_member_t *m, inputs *input, const char *option)
+{
+    int argc = *input->argc, at = 2;
+    while (at < argc && strcmp(option, input->args[at]) != 0) at++;
+    if (at + 2 >= argc) return;
+    int sub_argc;
+    inputs sub;
+    char **args = baseer_sub_args(input, at + 2, &sub_argc, &sub);
+    if (!args) return;
+    analyze_member(ar, m, &sub);
+    free(args);
+}
+
+/**
+ * @brief Print one member and run the flags that follow `--member <name>` on it.
+ */
+static bool ar_member(const ar_archive_t *ar, inputs *input)
+{
+    const char *name = baseer_get_opt(input, "--member");
+    const ar_member_t *m = name ? ar_find(ar, name) : NULL;
+    if (!m) {
+        fprintf(stderr, COLOR_RED "[!] No such member: " COLOR_RESET "%s\n", name ? name : "");
+        return false;
+    }
+    time_t t = (time_t)m->mtime;
+    const char *date = ctime(&t);
+    printf(COLOR_BLUE "\n=== %s ===\n" COLOR_RESET, m->name);
+    printf(COLOR_GREEN "|--size      :" COLOR_RESET " %llu\n", (unsigned long long)m->size);
+    printf(COLOR_GREEN "|--mode      :" COLOR_RESET " %o\n", m->mode);
+    printf(COLOR_GREEN "|--owner     :" COLOR_RESET " %u/%u\n", m->uid, m->gid);
+    printf(COLOR_GREEN "|--mtime     :" COLOR_RESET " %s", date ? date : "-\n");
+    printf(COLOR_GREEN "|--header    :" COLOR_RESET " 0x%llx\n", (unsigned long long)m->header_off);
+    printf(COLOR_GREEN "|--data      :" COLOR_RESET " 0x%llx\n", (unsigned long long)m->data_off);
+    run_after(ar, m, input, "--member");
+    return true;
+}
+
+/**
+ * @brief Members defining a symbol (from the armap alone); the flags that
+ * follow `--symbol <name>` run on the first one.
+ */
+static bool ar_symbol(const ar_archive_t *ar, inputs *input)
+{
+    const char *name = baseer_get_opt(input, "--symbol");
+    if (!ar->armap_name) {
+        fprintf(stderr, COLOR_RED "[!] The archive has no symbol index (run ranlib)\n" COLOR_RESET);
+        return false;
+    }
+    size_t count;
+    const ar_symbol_t *s = name ? ar_lookup(ar, name, &count) : NULL;
+    if (!s) {
+        fprintf(stderr, COLOR_RED "[!] Symbol not in the index: " COLOR_RESET "%s\n", name ? name : "");
+        return false;
+    }
+    printf(COLOR_BLUE "\n=== %s ===\n" COLOR_RESET, name);
+    for (size_t i = 0; i < count; i++) {
+        const ar_member_t *m = &ar->members[s[i].member];
+        printf(COLOR_GREEN "|--defined in:" COLOR_RESET " %s (member %u at 0x%llx)\n", m->name, s[i].member,
+               (unsigned long long)m->header_off);
+    }
+    run_after(ar, &ar->members[s[0].member], input, "--symbol");
+    return true;
+}
+
+bool bx_ar(bparser *parser, void *arg)
+{
+    inputs *input = arg;
+    int argc = *input->argc;
+    char **args = input->args;
+
+    // format-independent tools do not need the member table
+    if (strcmp("--scan", args[2]) == 0 && argc > 3) return bparser_apply(parser, b_scan, arg);
+    if (strcmp("--carve", args[2]) == 0) return bparser_apply(parser, b_carve, arg);
+    if (strcmp("--hash", args[2]) == 0) return bparser_apply(parser, b_hash, arg);
+
+    ar_archive_t *ar = ar_open(parser);
+    if (!ar) {
+        fprintf(stderr, COLOR_RED "[!] Not an ar archive\n" COLOR_RESET);
+        return false;
+    }
+    if (strcmp("-m", args[2]) == 0) {
+        ar_metadata(ar);
+    } else if (strcmp("-l", args[2]) == 0) {
+        ar_list(ar, argc > 3 && strcmp("--hash", args[3]) == 0);
+    } else if (strcmp("-r", args[2]) == 0) {
+        ar_recursive(ar, input);
+    } else if (strcmp("--member", args[2]) == 0 && argc > 3) {
+        ar_member(ar, input);
+    } else if (strcmp("--symbol", args[2]) == 0 && argc > 3) {
+        ar_symbol(ar, input);
+    } else {
+        fprintf(stderr, "[!] Unsupported flag: %s\n", args[2]);
+    }
+    ar_close(ar);
+    return true;
+}
+// ========================= END COMMANDS ==================================
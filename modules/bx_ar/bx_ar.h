@@ -0,0 +1,106 @@
+/**
+ * @file bx_ar.h
+ * @brief Static libraries and other `ar` archives (`!<arch>\n`).
+ *
+ * Opening an archive walks the 60-byte member headers only; member data is
+ * never read, and every member is available as a zero-copy bparser slice.
+ * Both header dialects are handled:
+ * - GNU/SysV: names end with '/', long names are "/<offset>" into the "//"
+ *   table, the symbol index is "/" (32-bit) or "/SYM64/" (64-bit), big-endian.
+ * - BSD: long names are "#1/<len>" and stored in front of the data, the
+ *   symbol index is "__.SYMDEF" (or "__.SYMDEF SORTED", "__.SYMDEF_64").
+ *
+ * The symbol index (armap) is sorted by name once, so "which member defines
+ * this symbol" is a binary search and no object has to be parsed.
+ *
+ * Options (read from the command line):
+ * - `-m`                         Format, member count, symbol index.
+ * - `-l [--hash]`                List the members (and their SHA-256).
+ * - `-r <flags...>`              Run the flags on every member.
+ * - `--member <name> [flags...]` Print one member, and run the flags on it.
+ * - `--symbol <name> [flags...]` Members defining a symbol, and run the flags on the first.
+ * - `--scan`, `--carve`, `--hash` As for any file.
+ */
+#ifndef BX_AR_H
+#define BX_AR_H
+#include "../bparser/bparser.h"
+#include "../../baseer.h"
+#include "../../utils/ui.h"
+#include <stdint.h>
+
+#define AR_MAGIC_SIZE     8
+#define AR_HEADER_SIZE    60
+#define AR_MAX_NAME       4096              /**< Longest member name kept */
+#define AR_MAX_SYMBOLS    (16u * 1024 * 1024)
+
+typedef enum {
+    AR_GNU,
+    AR_BSD,
+} ar_format_t;
+
+/**
+ * @brief One member (the symbol index and long name table are not members).
+ */
+typedef struct {
+    char *name;
+    uint64_t header_off;        /**< Offset of the member header */
+    uint64_t data_off;          /**< Offset of the data (after a BSD long name) */
+    uint64_t size;              /**< Size of the data */
+    int64_t mtime;
+    uint32_t uid, gid, mode;
+} ar_member_t;
+
+/**
+ * @brief One armap entry.
+ */
+typedef struct {
+    const char *name;           /**< Points into ar_archive_t.symstr */
+    uint32_t member;            /**< Index in ar_archive_t.members */
+} ar_symbol_t;
+
+/**
+ * @brief An opened archive.
+ */
+typedef struct {
+    bparser *parser;
+    ar_format_t format;
+    ar_member_t *members;
+    size_t count;
+    uint64_t names_size;        /**< Size of the GNU long name table, 0 if none */
+    const char *armap_name;     /**< Name of the symbol index member, NULL if none */
+    bool armap64;
+    char *symstr;               /**< NUL-terminated copy of the armap strings */
+    ar_symbol_t *symbols;       /**< Sorted by name */
+    size_t nsymbols;
+    size_t unresolved;          /**< armap entries pointing to no member */
+} ar_archive_t;
+
+/**
+ * @brief Walk the member headers and load the symbol index.
+ *
+ * @return The archive (free with ar_close()), NULL if the magic is missing.
+ */
+ar_archive_t *ar_open(bparser *parser);
+void ar_close(ar_archive_t *ar);
+
+/**
+ * @brief Find a member by name (the first one for duplicates).
+ */
+const ar_member_t *ar_find(const ar_archive_t *ar, const char *name);
+
+/**
+ * @brief Find the armap entries of a symbol, by binary search.
+ *
+ * @param count Receives the number of entries (members defining it).
+ * @return The first entry, NULL if the symbol is not in the index.
+ */
+const ar_symbol_t *ar_lookup(const ar_archive_t *ar, const char *symbol, size_t *count);
+
+/**
+ * @brief Zero-copy window over a member's data (free with free()).
+ */
+bparser *ar_member_slice(const ar_archive_t *ar, const ar_member_t *m);
+
+bool bx_ar(bparser *parser, void *arg);
+
+#endif
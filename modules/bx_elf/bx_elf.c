@@ -45,6 +45,47 @@ bool bx_elf(bparser* parser, void *arg)
             bparser_apply(parser, b_debugger, arg);
         } else if (strcmp("-c", args[i]) == 0) {
             bparser_apply(parser, decompile_elf, arg);
+        } else if (strcmp("-g", args[i]) == 0) {
+            bparser_apply(parser, b_gadgets, arg);
+        } else if (strcmp("--stats", args[i]) == 0) {
+            bparser_apply(parser, b_stats, arg);
+        } else if (strcmp("--fingerprint", args[i]) == 0) {
+            bparser_apply(parser, b_fingerprint, arg);
+        } else if (strcmp("--fp-add", args[i]) == 0 && i + 1 < argc) {
+            bparser_apply(parser, b_fingerprint_add, arg);
+            i++;
+        } else if (strcmp("--fp-query", args[i]) == 0 && i + 1 < argc) {
+            bparser_apply(parser, b_fingerprint_query, arg);
+            i++;
+        } else if (strcmp("--scan", args[i]) == 0 && i + 1 < argc) {
+            bparser_apply(parser, b_scan, arg);
+            i++;
+        } else if (strcmp("--hash", args[i]) == 0) {
+            bparser_apply(parser, b_hash, arg);
+        } else if (strcmp("--carve", args[i]) == 0) {
+            bparser_apply(parser, b_carve, arg);
+            // the remaining flags were applied to the carved files
+            break;
+        } else if (strcmp("--core", args[i]) == 0) {
+            bparser_apply(parser, b_elf_core, arg);
+        } else if (strcmp("--read", args[i]) == 0 && i + 1 < argc) {
+            bparser_apply(parser, b_elf_core_read, arg);
+            i++;
+        } else if (strcmp("--dump", args[i]) == 0 && i + 1 < argc) {
+            bparser_apply(parser, b_elf_section_dump, arg);
+            i++;
+        } else if (strcmp("--exe", args[i]) == 0) {
+            // executable for --core and --read, read by b_elf_core
+            i++;
+        } else if (strcmp("--depth", args[i]) == 0) {
+            // gadget depth for -g, read by b_gadgets
+            i++;
+        } else if (strcmp("--source", args[i]) == 0) {
+            // source lines for -a, read by print_elf_disasm
+        } else if (strcmp("--function", args[i]) == 0 || strcmp("--range", args[i]) == 0 ||
+                   strcmp("--section", args[i]) == 0) {
+            // region filters for -a, their value is read by print_elf_disasm
+            i++;
         }else if(strcmp("--args", args[i]) == 0){
             break;
         }else {
@@ -8,6 +8,14 @@
 #include "../b_elf_metadata/b_elf_metadata.h"
 #include "../bx_deElf/bx_deElf.h"
 #include "../bx_elf_disasm/bx_elf_disasm.h"
+#include "../b_gadgets/b_gadgets.h"
+#include "../b_stats/b_stats.h"
+#include "../b_fingerprint/b_fingerprint.h"
+#include "../b_scan/b_scan.h"
+#include "../b_carve/b_carve.h"
+#include "../b_hash/b_hash.h"
+#include "../b_elf_core/b_elf_core.h"
+#include "../b_elf_sections/b_elf_sections.h"
 
 bool bx_elf(bparser* parser, void *arg);
 
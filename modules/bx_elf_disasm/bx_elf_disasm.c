@@ -32,6 +32,55 @@
 //     return false;
 // }
 
+// ========================= BEGIN SOURCE LINES ==================================
+/**
+ * @brief print_disasm() with the source file and line above the first
+ * instruction of each line.
+ *
+ * Only the units covering [vaddr, vaddr + size) are decoded; each
+ * instruction is then one binary search in the line table.
+ *
+ * @param lines Line tables, or NULL for plain print_disasm().
+ */
+static void print_disasm_source(dwarf_lines_t *lines, unsigned char *ptr, size_t size, uint64_t vaddr, unsigned char bit_type)
+{
+    if (!lines) {
+        print_disasm(ptr, size, vaddr, bit_type);
+        return;
+    }
+    dwarf_lines_load(lines, vaddr, vaddr + size);
+
+    ud_t ud_obj;
+    ud_init(&ud_obj);
+    ud_set_input_buffer(&ud_obj, ptr, size);
+    ud_set_mode(&ud_obj, (bit_type == ELFCLASS32) ? 32 : 64);
+    ud_set_syntax(&ud_obj, UD_SYN_INTEL);
+    ud_set_pc(&ud_obj, vaddr);
+
+    const dwarf_row_t *last = NULL;
+    while (ud_disassemble(&ud_obj)) {
+        const dwarf_row_t *row = dwarf_lines_find(lines, ud_insn_off(&ud_obj));
+        if (row && (!last || row->file != last->file || row->line != last->line))
+            printf(COLOR_CYAN "|-- %s:%u\n" COLOR_RESET, dwarf_lines_file(lines, row), row->line);
+        last = row;
+        printf(COLOR_YELLOW "|----0x%08llx:  " COLOR_RESET, (unsigned long long)ud_insn_off(&ud_obj));
+        print_highlight_asm(ud_insn_asm(&ud_obj));
+    }
+}
+
+/**
+ * @brief Open the line tables when `--source` is given.
+ */
+static dwarf_lines_t *open_source_lines(bparser *parser, inputs *input)
+{
+    if (!baseer_has_flag(input, "--source")) return NULL;
+    dwarf_lines_t *lines = dwarf_lines_open(parser);
+    if (!lines)
+        fprintf(stderr, COLOR_YELLOW "[!] No .debug_line, disassembling without source lines\n" COLOR_RESET);
+    return lines;
+}
+// ========================= END SOURCE LINES ==================================
+
 // ========================= BEGIN SECTION HEADER ==================================
 /**
  * @brief Disassemble and print the ELF32 section headers.
@@ -44,10 +93,13 @@
  * @param elf Pointer to the ELF32 header.
  * @param shdrs Pointer to the array of ELF32 section headers.
  * @param parser Pointer to a bparser structure for reading binary data.
+ * @param addrmap Address map of the file, used to locate symbol bytes.
+ * @param lines Line tables for `--source`, or NULL.
  */
-void dump_disasm_elf32_shdr(Elf32_Ehdr* elf , Elf32_Shdr* shdrs, bparser* parser)
+void dump_disasm_elf32_shdr(Elf32_Ehdr* elf , Elf32_Shdr* shdrs, bparser* parser, const b_addrmap *addrmap, dwarf_lines_t *lines)
 {
-    Elf32_Shdr shstr = shdrs[elf->e_shstrndx];
+    uint32_t shnum = elf_shnum(parser);
+    Elf32_Shdr shstr = shdrs[elf_shstrndx(parser)];
     const char* shstrtab = (const char*)(parser->block + shstr.sh_offset);
 
     printf(COLOR_BLUE "\n=== Sections ===\n" COLOR_RESET);
@@ -56,7 +108,7 @@ void dump_disasm_elf32_shdr(Elf32_Ehdr* elf , Elf32_Shdr* shdrs, bparser* parser
     // create hashmap of section headers to retreve the specifa name of section header needed
     hashmap_t *map = create_map();
     
-    for (int i = 0; i < elf->e_shnum; i++) {
+    for (uint32_t i = 0; i < shnum; i++) {
 
         // ============================ BEGIN SECTION METADATA =============================
         // Section name
@@ -84,7 +136,7 @@ void dump_disasm_elf32_shdr(Elf32_Ehdr* elf , Elf32_Shdr* shdrs, bparser* parser
                 unsigned char *ptr = (unsigned char*)block;
                 unsigned char bit_type = ((unsigned char*)parser->block)[EI_CLASS];
                 // print_body_bytes(ptr, shdrs[i].sh_size, shdrs[i].sh_offset, shdrs[i].sh_flags, bit_type);
-                print_disasm(ptr, shdrs[i].sh_size, shdrs[i].sh_offset, bit_type);
+                print_disasm_source(lines, ptr, shdrs[i].sh_size, shdrs[i].sh_addr, bit_type);
                 free(block);
             }
         }
@@ -98,7 +150,7 @@ void dump_disasm_elf32_shdr(Elf32_Ehdr* elf , Elf32_Shdr* shdrs, bparser* parser
     // }
 
     if((symtab = (Elf32_Shdr*)get(map, ".symtab")) != NULL && (strtab = (Elf32_Shdr*)get(map, ".strtab")) != NULL) {
-        print_symbols_with_disasm_32bit(parser, elf, shdrs, symtab, strtab);
+        print_symbols_with_disasm_32bit(parser, elf, shdrs, symtab, strtab, addrmap);
     }
 
     free_map(map);
@@ -115,10 +167,13 @@ void dump_disasm_elf32_shdr(Elf32_Ehdr* elf , Elf32_Shdr* shdrs, bparser* parser
  * @param elf Pointer to the ELF64 header.
  * @param shdrs Pointer to the array of ELF64 section headers.
  * @param parser Pointer to a bparser structure for reading binary data.
+ * @param addrmap Address map of the file, used to locate symbol bytes.
+ * @param lines Line tables for `--source`, or NULL.
  */
-void dump_disasm_elf64_shdr(Elf64_Ehdr* elf , Elf64_Shdr* shdrs, bparser* parser)
+void dump_disasm_elf64_shdr(Elf64_Ehdr* elf , Elf64_Shdr* shdrs, bparser* parser, const b_addrmap *addrmap, dwarf_lines_t *lines)
 {
-    Elf64_Shdr shstr = shdrs[elf->e_shstrndx];
+    uint32_t shnum = elf_shnum(parser);
+    Elf64_Shdr shstr = shdrs[elf_shstrndx(parser)];
     const char* shstrtab = (const char*)(parser->block + shstr.sh_offset);
 
     printf(COLOR_BLUE "\n=== Sections ===\n" COLOR_RESET);
@@ -127,7 +182,7 @@ void dump_disasm_elf64_shdr(Elf64_Ehdr* elf , Elf64_Shdr* shdrs, bparser* parser
     // create hashmap of section headers to retreve the specifa name of section header needed
     hashmap_t *map = create_map();
     
-    for (int i = 0; i < elf->e_shnum; i++) {
+    for (uint32_t i = 0; i < shnum; i++) {
         // ============================ BEGIN SECTION METADATA =============================
         // Section name
         const char* name = &shstrtab[shdrs[i].sh_name];
@@ -153,7 +208,7 @@ void dump_disasm_elf64_shdr(Elf64_Ehdr* elf , Elf64_Shdr* shdrs, bparser* parser
                 unsigned char *ptr = (unsigned char*)block;
                 unsigned char bit_type = ((unsigned char*)parser->block)[EI_CLASS];
                 // print_body_bytes(ptr, shdrs[i].sh_size, shdrs[i].sh_offset, shdrs[i].sh_flags, bit_type);
-                print_disasm(ptr, shdrs[i].sh_size, shdrs[i].sh_offset, bit_type);
+                print_disasm_source(lines, ptr, shdrs[i].sh_size, shdrs[i].sh_addr, bit_type);
                 free(block);
             }
         }
@@ -167,7 +222,7 @@ void dump_disasm_elf64_shdr(Elf64_Ehdr* elf , Elf64_Shdr* shdrs, bparser* parser
     // }
 
     if((symtab = (Elf64_Shdr*)get(map, ".symtab")) != NULL && (strtab = (Elf64_Shdr*)get(map, ".strtab")) != NULL) {
-        print_symbols_with_disasm_64bit(parser, elf, shdrs, symtab, strtab);
+        print_symbols_with_disasm_64bit(parser, elf, shdrs, symtab, strtab, addrmap);
     }
 
     free_map(map);
@@ -232,7 +287,7 @@ void dump_disasm_elf32_phdr(Elf32_Ehdr *elf, Elf32_Phdr* phdr, bparser*parser)
             unsigned char* ptr = (unsigned char*)block;
             unsigned char bit_type = ((unsigned char*)parser->block)[EI_CLASS];
             print_body_bytes(ptr, phdr[i].p_filesz, phdr[i].p_offset, 0, 0);
-            print_disasm(ptr, phdr[i].p_filesz, phdr[i].p_offset, bit_type);
+            print_disasm(ptr, phdr[i].p_filesz, phdr[i].p_vaddr, bit_type);
             // print_body_bytes(ptr, phdr[i].p_filesz, phdr[i].p_offset, 0, 0);
             // print_body_bytes(ptr, phdr[i].p_filesz, phdr[i].p_offset, phdr[i].p_flags);
             free(block);
@@ -298,7 +353,7 @@ void dump_disasm_elf64_phdr(Elf64_Ehdr *elf, Elf64_Phdr* phdr, bparser*parser)
             unsigned char* ptr = (unsigned char*)block;
             unsigned char bit_type = ((unsigned char*)parser->block)[EI_CLASS];
             print_body_bytes(ptr, phdr[i].p_filesz, phdr[i].p_offset, 0, 0);
-            print_disasm(ptr, phdr[i].p_filesz, phdr[i].p_offset, bit_type);
+            print_disasm(ptr, phdr[i].p_filesz, phdr[i].p_vaddr, bit_type);
             // print_body_bytes(ptr, phdr[i].p_filesz, phdr[i].p_offset, phdr[i].p_flags);
             free(block);
         }
@@ -307,6 +362,246 @@ void dump_disasm_elf64_phdr(Elf64_Ehdr *elf, Elf64_Phdr* phdr, bparser*parser)
 }
 // ========================= END PROGRAM HEADER ==================================
 
+// ========================= BEGIN REGION ==================================
+/**
+ * @brief Disassemble a window of the file in place, without copying it.
+ *
+ * @param lines    Line tables for `--source`, or NULL.
+ * @param parser   Pointer to the parser holding the file.
+ * @param offset   File offset of the first byte to decode.
+ * @param size     Number of bytes to decode (clamped to the end of file).
+ * @param vaddr    Virtual address of the first byte, used as the program counter.
+ * @param bit_type ELF class: ELFCLASS32 or ELFCLASS64.
+ */
+static void disasm_file_window(dwarf_lines_t *lines, bparser *parser, uint64_t offset, uint64_t size, uint64_t vaddr, unsigned char bit_type)
+{
+    if (offset >= parser->size) {
+        fprintf(stderr, COLOR_RED "[!] Offset 0x%lx is outside the file\n" COLOR_RESET, (unsigned long)offset);
+        return;
+    }
+    if (size > parser->size - offset)
+        size = parser->size - offset;
+    print_disasm_source(lines, (unsigned char*)parser->block + offset, size, vaddr, bit_type);
+}
+
+/**
+ * @brief Find a defined function symbol by name in a 32-bit ELF.
+ *
+ * `.symtab` is searched first, then `.dynsym`, so stripped binaries can still
+ * be queried by their exported names.
+ *
+ * @return Pointer to the symbol inside the file image, or NULL.
+ */
+static Elf32_Sym *elf32_find_function(Elf32_Shdr *shdrs, bparser *parser, const char *name, uint32_t *shndx)
+{
+    const unsigned int kinds[] = {SHT_SYMTAB, SHT_DYNSYM};
+    uint32_t shnum = elf_shnum(parser);
+    for (int k = 0; k < 2; k++) {
+        for (uint32_t i = 0; i < shnum; i++) {
+            if (shdrs[i].sh_type != kinds[k] || shdrs[i].sh_link >= shnum) continue;
+            Elf32_Sym *syms = (Elf32_Sym*)(parser->block + shdrs[i].sh_offset);
+            const char *strs = (const char*)(parser->block + shdrs[shdrs[i].sh_link].sh_offset);
+            unsigned int count = shdrs[i].sh_size / sizeof(Elf32_Sym);
+
+            for (unsigned int j = 0; j < count; j++) {
+                if (ELF32_ST_TYPE(syms[j].st_info) != STT_FUNC || syms[j].st_shndx == SHN_UNDEF) continue;
+                if (strcmp(strs + syms[j].st_name, name) != 0) continue;
+                size_t nx;
+                const uint32_t *xindex = elf_symtab_shndx(parser, i, &nx);
+                *shndx = elf_sym_shndx(syms[j].st_shndx, xindex, nx, j);
+                return &syms[j];
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Find a defined function symbol by name in a 64-bit ELF.
+ *
+ * @see elf32_find_function()
+ */
+static Elf64_Sym *elf64_find_function(Elf64_Shdr *shdrs, bparser *parser, const char *name, uint32_t *shndx)
+{
+    const unsigned int kinds[] = {SHT_SYMTAB, SHT_DYNSYM};
+    uint32_t shnum = elf_shnum(parser);
+    for (int k = 0; k < 2; k++) {
+        for (uint32_t i = 0; i < shnum; i++) {
+            if (shdrs[i].sh_type != kinds[k] || shdrs[i].sh_link >= shnum) continue;
+            Elf64_Sym *syms = (Elf64_Sym*)(parser->block + shdrs[i].sh_offset);
+            const char *strs = (const char*)(parser->block + shdrs[shdrs[i].sh_link].sh_offset);
+            unsigned int count = shdrs[i].sh_size / sizeof(Elf64_Sym);
+
+            for (unsigned int j = 0; j < count; j++) {
+                if (ELF64_ST_TYPE(syms[j].st_info) != STT_FUNC || syms[j].st_shndx == SHN_UNDEF) continue;
+                if (strcmp(strs + syms[j].st_name, name) != 0) continue;
+                size_t nx;
+                const uint32_t *xindex = elf_symtab_shndx(parser, i, &nx);
+                *shndx = elf_sym_shndx(syms[j].st_shndx, xindex, nx, j);
+                return &syms[j];
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Disassemble only the regions of a 32-bit ELF selected on the command line.
+ *
+ * Handles `--function <name>`, `--section <name>` and
+ * `--range <vaddr>:<vaddr|+len>`. Only the requested bytes are decoded,
+ * straight from the file image, so the cost does not depend on the file size.
+ *
+ * @param elf     Pointer to the ELF32 header.
+ * @param shdrs   Pointer to the section header table.
+ * @param parser  Pointer to the parser holding the file.
+ * @param addrmap Address map used to translate virtual addresses.
+ * @param input   Command-line inputs holding the region options.
+ * @param lines   Line tables for `--source`, or NULL.
+ * @return true if every requested region was found and disassembled.
+ */
+bool dump_disasm_elf32_region(Elf32_Ehdr *elf, Elf32_Shdr *shdrs, bparser *parser, const b_addrmap *addrmap, inputs *input, dwarf_lines_t *lines)
+{
+    const char *func_name = baseer_get_opt(input, "--function");
+    const char *sec_name  = baseer_get_opt(input, "--section");
+    const char *range     = baseer_get_opt(input, "--range");
+    uint64_t offset, avail;
+    bool ok = true;
+
+    if (sec_name) {
+        Elf32_Shdr shstr = shdrs[elf_shstrndx(parser)];
+        const char *shstrtab = (const char*)(parser->block + shstr.sh_offset);
+        uint32_t shnum = elf_shnum(parser);
+        int64_t found = -1;
+        for (uint32_t i = 0; i < shnum && found < 0; i++) {
+            if (strcmp(&shstrtab[shdrs[i].sh_name], sec_name) == 0) found = i;
+        }
+        if (found < 0 || shdrs[found].sh_type == SHT_NOBITS) {
+            fprintf(stderr, COLOR_RED "[!] No section with contents named: " COLOR_RESET "%s\n", sec_name);
+            ok = false;
+        } else {
+            char flags[64] = "";
+            format_sh_flags(shdrs[found].sh_flags, flags, sizeof(flags));
+            printf("\n");
+            print_section_header_metadata_32bit(found, sec_name, sh_type_to_str(shdrs[found].sh_type), flags, shdrs);
+            disasm_file_window(lines, parser, shdrs[found].sh_offset, shdrs[found].sh_size, shdrs[found].sh_addr, ELFCLASS32);
+        }
+    }
+
+    if (func_name) {
+        uint32_t shndx = SHN_UNDEF;
+        Elf32_Sym *sym = elf32_find_function(shdrs, parser, func_name, &shndx);
+        if (!sym) {
+            fprintf(stderr, COLOR_RED "[!] Function not found: " COLOR_RESET "%s\n", func_name);
+            ok = false;
+        } else if (!elf_symbol_offset(parser, addrmap, shndx, sym->st_value, &offset, &avail)) {
+            fprintf(stderr, COLOR_RED "[!] Function has no file contents: " COLOR_RESET "%s\n", func_name);
+            ok = false;
+        } else {
+            printf(COLOR_WHITE "\n|-- %s:" COLOR_RESET "\n", func_name);
+            disasm_file_window(lines, parser, offset, (sym->st_size < avail) ? sym->st_size : avail, sym->st_value, ELFCLASS32);
+        }
+    }
+
+    if (range) {
+        uint64_t start, end;
+        if (!parse_vaddr_range(range, &start, &end)) {
+            fprintf(stderr, COLOR_RED "[!] Invalid range (use <vaddr>:<vaddr|+len>): " COLOR_RESET "%s\n", range);
+            ok = false;
+        } else if (!b_addrmap_va_to_off(addrmap, start, &offset, &avail)) {
+            fprintf(stderr, COLOR_RED "[!] Address 0x%lx is not backed by the file\n" COLOR_RESET, (unsigned long)start);
+            ok = false;
+        } else {
+            int sec = b_addrmap_va_to_section(addrmap, start);
+            printf(COLOR_WHITE "\n|-- Range [0x%08lx - 0x%08lx]", (unsigned long)start, (unsigned long)end);
+            if (sec > 0)
+                printf(" in %s", (const char*)(parser->block + shdrs[elf_shstrndx(parser)].sh_offset) + shdrs[sec].sh_name);
+            printf(":" COLOR_RESET "\n");
+            disasm_file_window(lines, parser, offset, (end - start < avail) ? end - start : avail, start, ELFCLASS32);
+        }
+    }
+    return ok;
+}
+
+/**
+ * @brief Disassemble only the regions of a 64-bit ELF selected on the command line.
+ *
+ * @see dump_disasm_elf32_region()
+ */
+bool dump_disasm_elf64_region(Elf64_Ehdr *elf, Elf64_Shdr *shdrs, bparser *parser, const b_addrmap *addrmap, inputs *input, dwarf_lines_t *lines)
+{
+    const char *func_name = baseer_get_opt(input, "--function");
+    const char *sec_name  = baseer_get_opt(input, "--section");
+    const char *range     = baseer_get_opt(input, "--range");
+    uint64_t offset, avail;
+    bool ok = true;
+
+    if (sec_name) {
+        Elf64_Shdr shstr = shdrs[elf_shstrndx(parser)];
+        const char *shstrtab = (const char*)(parser->block + shstr.sh_offset);
+        uint32_t shnum = elf_shnum(parser);
+        int64_t found = -1;
+        for (uint32_t i = 0; i < shnum && found < 0; i++) {
+            if (strcmp(&shstrtab[shdrs[i].sh_name], sec_name) == 0) found = i;
+        }
+        if (found < 0 || shdrs[found].sh_type == SHT_NOBITS) {
+            fprintf(stderr, COLOR_RED "[!] No section with contents named: " COLOR_RESET "%s\n", sec_name);
+            ok = false;
+        } else {
+            char flags[64] = "";
+            format_sh_flags(shdrs[found].sh_flags, flags, sizeof(flags));
+            printf("\n");
+            print_section_header_metadata_64bit(found, sec_name, sh_type_to_str(shdrs[found].sh_type), flags, shdrs);
+            disasm_file_window(lines, parser, shdrs[found].sh_offset, shdrs[found].sh_size, shdrs[found].sh_addr, ELFCLASS64);
+        }
+    }
+
+    if (func_name) {
+        uint32_t shndx = SHN_UNDEF;
+        Elf64_Sym *sym = elf64_find_function(shdrs, parser, func_name, &shndx);
+        if (!sym) {
+            fprintf(stderr, COLOR_RED "[!] Function not found: " COLOR_RESET "%s\n", func_name);
+            ok = false;
+        } else if (!elf_symbol_offset(parser, addrmap, shndx, sym->st_value, &offset, &avail)) {
+            fprintf(stderr, COLOR_RED "[!] Function has no file contents: " COLOR_RESET "%s\n", func_name);
+            ok = false;
+        } else {
+            printf(COLOR_WHITE "\n|-- %s:" COLOR_RESET "\n", func_name);
+            disasm_file_window(lines, parser, offset, (sym->st_size < avail) ? sym->st_size : avail, sym->st_value, ELFCLASS64);
+        }
+    }
+
+    if (range) {
+        uint64_t start, end;
+        if (!parse_vaddr_range(range, &start, &end)) {
+            fprintf(stderr, COLOR_RED "[!] Invalid range (use <vaddr>:<vaddr|+len>): " COLOR_RESET "%s\n", range);
+            ok = false;
+        } else if (!b_addrmap_va_to_off(addrmap, start, &offset, &avail)) {
+            fprintf(stderr, COLOR_RED "[!] Address 0x%lx is not backed by the file\n" COLOR_RESET, (unsigned long)start);
+            ok = false;
+        } else {
+            int sec = b_addrmap_va_to_section(addrmap, start);
+            printf(COLOR_WHITE "\n|-- Range [0x%08lx - 0x%08lx]", (unsigned long)start, (unsigned long)end);
+            if (sec > 0)
+                printf(" in %s", (const char*)(parser->block + shdrs[elf_shstrndx(parser)].sh_offset) + shdrs[sec].sh_name);
+            printf(":" COLOR_RESET "\n");
+            disasm_file_window(lines, parser, offset, (end - start < avail) ? end - start : avail, start, ELFCLASS64);
+        }
+    }
+    return ok;
+}
+
+/**
+ * @brief Check whether any region filter was given for the disassembler.
+ */
+static bool has_region_filter(inputs *input)
+{
+    return baseer_get_opt(input, "--function") != NULL ||
+           baseer_get_opt(input, "--section")  != NULL ||
+           baseer_get_opt(input, "--range")    != NULL;
+}
+// ========================= END REGION ==================================
+
 /**
  * @brief Print ELF file disassembly and metadata.
  *
@@ -316,8 +611,12 @@ void dump_disasm_elf64_phdr(Elf64_Ehdr *elf, Elf64_Phdr* phdr, bparser*parser)
  * It calls the appropriate ELF32 or ELF64 section and program header disassembly
  * functions. Only x86 (32-bit) and x86_64 (64-bit) architectures are supported.
  *
+ * When `--function`, `--section` or `--range` is given, only the selected
+ * regions are disassembled instead of the whole file. With `--source`, the
+ * file and line from `.debug_line` are printed above the instructions.
+ *
  * @param parser Pointer to a bparser structure containing the ELF file in memory.
- * @param args Optional arguments (currently unused).
+ * @param args Pointer to the command-line inputs (region filters are read from it).
  * 
  * @return true if the ELF file was successfully analyzed and disassembled; false
  * if the ELF class or machine type is unsupported or unknown.
@@ -326,6 +625,9 @@ bool print_elf_disasm(bparser* parser, void* args) {
     unsigned char *data = (unsigned char*) parser->block;
     char bit_type = data[EI_CLASS];
     char endian   = data[EI_DATA];
+    b_addrmap *addrmap = NULL;
+    dwarf_lines_t *lines = NULL;
+    bool ok = true;
 
     printf(COLOR_BLUE "=== ELF File Disasm ===\n" COLOR_RESET);
 
@@ -350,8 +652,8 @@ bool print_elf_disasm(bparser* parser, void* args) {
         Elf32_Shdr* shdrs = (Elf32_Shdr*)(data + elf->e_shoff);
 
         printf(COLOR_GREEN "Entry point: " COLOR_RESET "0x%x\n", elf->e_entry);
-        printf(COLOR_GREEN "Section headers: " COLOR_RESET "%d (offset: 0x%x)\n", elf->e_shnum, elf->e_shoff);
-        printf(COLOR_GREEN "Section header string table index: " COLOR_RESET "%d\n", elf->e_shstrndx);
+        printf(COLOR_GREEN "Section headers: " COLOR_RESET "%u (offset: 0x%x)\n", elf_shnum(parser), elf->e_shoff);
+        printf(COLOR_GREEN "Section header string table index: " COLOR_RESET "%u\n", elf_shstrndx(parser));
         printf(COLOR_GREEN "File Type: " COLOR_RESET "%s (%d)\n",
                 elf_type_to_str(elf->e_type), elf->e_type);
 
@@ -366,8 +668,15 @@ bool print_elf_disasm(bparser* parser, void* args) {
             return false;
         }
       
-        dump_disasm_elf32_shdr(elf, shdrs, parser);
-        dump_disasm_elf32_phdr(elf, phdr, parser);
+        // built once, every symbol and range lookup below is a binary search
+        addrmap = elf_build_addrmap(parser);
+        lines = open_source_lines(parser, args);
+        if (has_region_filter(args)) {
+            ok = dump_disasm_elf32_region(elf, shdrs, parser, addrmap, args, lines);
+        } else {
+            dump_disasm_elf32_shdr(elf, shdrs, parser, addrmap, lines);
+            dump_disasm_elf32_phdr(elf, phdr, parser);
+        }
 
     } else if (bit_type == ELFCLASS64) {
         Elf64_Ehdr* elf = (Elf64_Ehdr*) data;
@@ -375,8 +684,8 @@ bool print_elf_disasm(bparser* parser, void* args) {
         Elf64_Shdr* shdrs = (Elf64_Shdr*)(data + elf->e_shoff);
 
         printf(COLOR_GREEN "Entry point: " COLOR_RESET "0x%lx\n", elf->e_entry);
-        printf(COLOR_GREEN "Section headers: " COLOR_RESET "%d (offset: 0x%lx)\n", elf->e_shnum, elf->e_shoff);
-        printf(COLOR_GREEN "Section header string table index: " COLOR_RESET "%d\n", elf->e_shstrndx);
+        printf(COLOR_GREEN "Section headers: " COLOR_RESET "%u (offset: 0x%lx)\n", elf_shnum(parser), elf->e_shoff);
+        printf(COLOR_GREEN "Section header string table index: " COLOR_RESET "%u\n", elf_shstrndx(parser));
         printf(COLOR_GREEN "File Type: " COLOR_RESET "%s (%d)\n",
                 elf_type_to_str(elf->e_type), elf->e_type);
         printf(COLOR_GREEN "Machine: " COLOR_RESET "%s (%d)\n",
@@ -389,12 +698,21 @@ bool print_elf_disasm(bparser* parser, void* args) {
             return false;
         }
 
-        dump_disasm_elf64_shdr(elf, shdrs, parser);
-        dump_disasm_elf64_phdr(elf, phdr, parser);
+        // built once, every symbol and range lookup below is a binary search
+        addrmap = elf_build_addrmap(parser);
+        lines = open_source_lines(parser, args);
+        if (has_region_filter(args)) {
+            ok = dump_disasm_elf64_region(elf, shdrs, parser, addrmap, args, lines);
+        } else {
+            dump_disasm_elf64_shdr(elf, shdrs, parser, addrmap, lines);
+            dump_disasm_elf64_phdr(elf, phdr, parser);
+        }
 
     } else {
         printf(COLOR_RED "Unknown ELF class: %d\n" COLOR_RESET, bit_type);
         return false;
     }
-    return true;
+    dwarf_lines_close(lines);
+    b_addrmap_free(addrmap);
+    return ok;
 }
@@ -6,7 +6,10 @@
 #include <string.h>
 #include "udis86.h"
 #include "../bx_elf_utils/bx_elf_utils.h"
+#include "../b_elf_dwarf/b_elf_dwarf.h"
 
 bool print_elf_disasm(bparser* parser, void* args);
+bool dump_disasm_elf32_region(Elf32_Ehdr *elf, Elf32_Shdr *shdrs, bparser *parser, const b_addrmap *addrmap, inputs *input, dwarf_lines_t *lines);
+bool dump_disasm_elf64_region(Elf64_Ehdr *elf, Elf64_Shdr *shdrs, bparser *parser, const b_addrmap *addrmap, inputs *input, dwarf_lines_t *lines);
 
 #endif
@@ -98,7 +98,8 @@ void print_section_header_legend(void)
         {"L", "SHF_LINK_ORDER: Link order", COLOR_BLUE},
         {"O", "SHF_OS_NONCONFORMING: OS specific", COLOR_GRAY},
         {"G", "SHF_GROUP: Section group", COLOR_CYAN},
-        {"T", "SHF_TLS: Thread-Local Storage", COLOR_YELLOW}
+        {"T", "SHF_TLS: Thread-Local Storage", COLOR_YELLOW},
+        {"C", "SHF_COMPRESSED: Compressed (zlib/zstd)", COLOR_MAGENTA}
     };
 
     printf(COLOR_YELLOW "=== Section Header Flags Legend ===\n" COLOR_RESET);
@@ -303,6 +304,9 @@ const char* sh_type_to_str(unsigned int sh_type)
         case SHT_GROUP:         result= COLOR_MAGENTA "GROUP" COLOR_RESET; break;
         case SHT_SYMTAB_SHNDX:  result= COLOR_WHITE "SYMTAB_SHNDX" COLOR_RESET; break;
         case SHT_RELR:          result= COLOR_YELLOW "RELR" COLOR_RESET; break;
+        case SHT_ANDROID_REL:   result= COLOR_YELLOW "ANDROID_REL" COLOR_RESET; break;
+        case SHT_ANDROID_RELA:  result= COLOR_YELLOW "ANDROID_RELA" COLOR_RESET; break;
+        case SHT_ANDROID_RELR:  result= COLOR_YELLOW "ANDROID_RELR" COLOR_RESET; break;
 
         case SHT_GNU_ATTRIBUTES: result = "GNU_ATTRIBUTES"; break;
         case SHT_GNU_HASH:       result = "GNU_HASH"; break;
@@ -725,6 +729,8 @@ void format_sh_flags(uint64_t sh_flags, char *buf, size_t size)
         strncat(buf, COLOR_CYAN "G" COLOR_RESET, size - strlen(buf) - 1);
     if (sh_flags & SHF_TLS)
         strncat(buf, COLOR_YELLOW "T" COLOR_RESET, size - strlen(buf) - 1);
+    if (sh_flags & SHF_COMPRESSED)
+        strncat(buf, COLOR_MAGENTA "C" COLOR_RESET, size - strlen(buf) - 1);
 
     // printf("================= Size of flag: %ld ===========\n", size - strlen(buf) - 1);
     for(int i=0; i<5; i++)
@@ -763,7 +769,7 @@ void format_sh_flags(uint64_t sh_flags, char *buf, size_t size)
  */
 void print_symbols_32bit(bparser* parser, Elf32_Ehdr* elf, Elf32_Shdr* shdrs, Elf32_Shdr *symtab, Elf32_Shdr *strtab) 
 {
-    Elf32_Shdr shstr = shdrs[elf->e_shstrndx];
+    Elf32_Shdr shstr = shdrs[elf_shstrndx(parser)];
     const char* shstrtab = (const char*)(parser->block + shstr.sh_offset);
 
     const char* symname = &shstrtab[symtab -> sh_name];
@@ -837,7 +843,7 @@ void print_symbols_32bit(bparser* parser, Elf32_Ehdr* elf, Elf32_Shdr* shdrs, El
  */
 void print_symbols_64bit(bparser* parser, Elf64_Ehdr* elf, Elf64_Shdr* shdrs, Elf64_Shdr *symtab, Elf64_Shdr *strtab) 
 {
-    Elf64_Shdr shstr = shdrs[elf->e_shstrndx];
+    Elf64_Shdr shstr = shdrs[elf_shstrndx(parser)];
     const char* shstrtab = (const char*)(parser->block + shstr.sh_offset);
 
     const char* symname = &shstrtab[symtab -> sh_name];
@@ -995,123 +1001,10 @@ const char* dynamic_type(uint32_t type)
 }
 
 
-void print_rela_32bit(bparser* parser, Elf32_Ehdr* elf, Elf32_Shdr* shdrs, Elf32_Shdr *reltab, Elf32_Shdr *symtab) 
-{
-    Elf32_Shdr shstr  = shdrs[elf->e_shstrndx];
-    Elf32_Shdr strtab = shdrs[symtab->sh_link];
-
-    const char* shstrtab = (const char*)(parser->block + shstr.sh_offset);
-
-    const char* relname = &shstrtab[reltab->sh_name];
-    const char* symname = &shstrtab[symtab->sh_name];
-    const char* strname = &shstrtab[strtab.sh_name];
-
-    Elf32_Rela* rela = (Elf32_Rela*)(parser->block + reltab->sh_offset);
-    size_t count = reltab->sh_size / sizeof(Elf32_Rela);
-
-    Elf32_Sym* syms = (Elf32_Sym*)(parser->block + symtab->sh_offset);
-    const char* strs = (const char*)(parser->block + strtab.sh_offset);
-
-    printf(COLOR_YELLOW "\n=== Relocation Table: %-15s ===\n" COLOR_RESET, relname);
-    printf("  Uses symbol table:  %s\n", symname);
-    printf("  Uses string table:  %s\n", strname);
-    printf(COLOR_WHITE "--------------------------------------------------------------------------\n" COLOR_RESET);
-    printf(COLOR_WHITE "%-6s %-14s %-14s %-10s %-20s %-12s\n" COLOR_RESET,
-           "Idx", "Offset", "Info", "Addend", "Symbol", "Type");
-    printf(COLOR_WHITE "--------------------------------------------------------------------------\n" COLOR_RESET);
-
-    for (size_t i = 0; i < count; i++) {
-        uint32_t r_info  = rela[i].r_info;
-        uint32_t sym_idx = ELF32_R_SYM(r_info);
-        uint32_t type    = ELF32_R_TYPE(r_info);
-        int32_t  addend  = rela[i].r_addend;
-
-        const char* name = (sym_idx < (symtab->sh_size / sizeof(Elf32_Sym)))
-            ? (strs + syms[sym_idx].st_name)
-            : "<invalid>";
-
-        const char* type_str = rel_R_X86_64_type_to_str(type);
-        if (!type_str) type_str = "UNKNOWN";
-
-        // Optional: color the type for easier reading
-        const char* type_color = COLOR_CYAN;
-        if (strstr(type_str, "PLT")) type_color = COLOR_GREEN;
-        else if (strstr(type_str, "GLOB")) type_color = COLOR_MAGENTA;
-        else if (strstr(type_str, "RELATIVE")) type_color = COLOR_BLUE;
-
-        printf("%-6zu 0x%012x 0x%012x %-10d %-20s %s%-12s" COLOR_RESET "\n",
-               i,
-               rela[i].r_offset,
-               r_info,
-               addend,
-               name,
-               type_color,
-               type_str);
-    }
-    printf("\n\n");
-}
-
-void print_rela_64bit(bparser* parser, Elf64_Ehdr* elf, Elf64_Shdr* shdrs,
-                      Elf64_Shdr* reltab, Elf64_Shdr* symtab)
-{
-    Elf64_Shdr shstr  = shdrs[elf->e_shstrndx];
-    Elf64_Shdr strtab = shdrs[symtab->sh_link];
-
-    const char* shstrtab = (const char*)(parser->block + shstr.sh_offset);
-
-    const char* relname = &shstrtab[reltab->sh_name];
-    const char* symname = &shstrtab[symtab->sh_name];
-    const char* strname = &shstrtab[strtab.sh_name];
-
-    Elf64_Rela* rela = (Elf64_Rela*)(parser->block + reltab->sh_offset);
-    size_t count = reltab->sh_size / sizeof(Elf64_Rela);
-
-    Elf64_Sym* syms = (Elf64_Sym*)(parser->block + symtab->sh_offset);
-    const char* strs = (const char*)(parser->block + strtab.sh_offset);
-
-    printf(COLOR_YELLOW "\n=== Relocation Table: %-15s ===\n" COLOR_RESET, relname);
-    printf("  Uses symbol table:  %s\n", symname);
-    printf("  Uses string table:  %s\n", strname);
-    printf(COLOR_WHITE "--------------------------------------------------------------------------\n" COLOR_RESET);
-    printf(COLOR_WHITE "%-6s %-14s %-14s %-10s %-20s %-12s\n" COLOR_RESET,
-           "Idx", "Offset", "Info", "Addend", "Symbol", "Type");
-    printf(COLOR_WHITE "--------------------------------------------------------------------------\n" COLOR_RESET);
-
-    for (size_t i = 0; i < count; i++) {
-        uint64_t r_info  = rela[i].r_info;
-        uint64_t sym_idx = ELF64_R_SYM(r_info);
-        uint64_t type    = ELF64_R_TYPE(r_info);
-        int64_t  addend  = rela[i].r_addend;
-
-        const char* name = (sym_idx < (symtab->sh_size / sizeof(Elf64_Sym)))
-            ? (strs + syms[sym_idx].st_name)
-            : "<invalid>";
-
-        const char* type_str = rel_R_X86_64_type_to_str(type);
-        if (!type_str) type_str = "UNKNOWN";
-
-        // Optional: color the type for easier reading
-        const char* type_color = COLOR_CYAN;
-        if (strstr(type_str, "PLT")) type_color = COLOR_GREEN;
-        else if (strstr(type_str, "GLOB")) type_color = COLOR_MAGENTA;
-        else if (strstr(type_str, "RELATIVE")) type_color = COLOR_BLUE;
-
-        printf("%-6zu 0x%012lx 0x%012lx %-10ld %-20s %s%-12s" COLOR_RESET "\n",
-               i,
-               rela[i].r_offset,
-               r_info,
-               addend,
-               name,
-               type_color,
-               type_str);
-    }
-    printf("\n\n");
-}
-
 void print_dynamic_table_32bit(bparser* parser, Elf32_Ehdr* elf, Elf32_Shdr* shdrs,
                                Elf32_Shdr *dynmaictab, Elf32_Shdr *strtab)
 {
-    Elf32_Shdr shstr = shdrs[elf->e_shstrndx];
+    Elf32_Shdr shstr = shdrs[elf_shstrndx(parser)];
     const char* shstrtab = (const char*)(parser->block + shstr.sh_offset);
 
     const char* dynname = &shstrtab[dynmaictab -> sh_name];
@@ -1148,7 +1041,7 @@ void print_dynamic_table_32bit(bparser* parser, Elf32_Ehdr* elf, Elf32_Shdr* shd
 void print_dynamic_table_64bit(bparser* parser, Elf64_Ehdr* elf, Elf64_Shdr* shdrs, 
                                Elf64_Shdr *dynmaictab, Elf64_Shdr *strtab)
 {
-    Elf64_Shdr shstr = shdrs[elf->e_shstrndx];
+    Elf64_Shdr shstr = shdrs[elf_shstrndx(parser)];
     const char* shstrtab = (const char*)(parser->block + shstr.sh_offset);
 
     const char* dynname = &shstrtab[dynmaictab -> sh_name];
@@ -1193,6 +1086,7 @@ void print_dynamic_table_64bit(bparser* parser, Elf64_Ehdr* elf, Elf64_Shdr* shd
  * @param shdrs Pointer to the section header array (Elf32_Shdr[]).
  * @param symtab Pointer to the section header of the symbol table (Elf32_Shdr).
  * @param strtab Pointer to the section header of the associated string table (Elf32_Shdr).
+ * @param map Address map used to find the file offset of each function.
  *
  * @note The function assumes:
  *       - ANSI color macros (COLOR_RESET, COLOR_YELLOW, COLOR_BLUE, etc.) are defined.
@@ -1208,9 +1102,9 @@ void print_dynamic_table_64bit(bparser* parser, Elf64_Ehdr* elf, Elf64_Shdr* shd
  *   ...
  * @endcode
  */
-void print_symbols_with_disasm_32bit(bparser* parser, Elf32_Ehdr* elf, Elf32_Shdr* shdrs, Elf32_Shdr *symtab, Elf32_Shdr *strtab) 
+void print_symbols_with_disasm_32bit(bparser* parser, Elf32_Ehdr* elf, Elf32_Shdr* shdrs, Elf32_Shdr *symtab, Elf32_Shdr *strtab, const b_addrmap *map) 
 {
-    Elf32_Shdr shstr = shdrs[elf->e_shstrndx];
+    Elf32_Shdr shstr = shdrs[elf_shstrndx(parser)];
     const char* shstrtab = (const char*)(parser->block + shstr.sh_offset);
 
     const char* symname = &shstrtab[symtab -> sh_name];
@@ -1220,6 +1114,8 @@ void print_symbols_with_disasm_32bit(bparser* parser, Elf32_Ehdr* elf, Elf32_Shd
     const char *strs = (const char *)(parser->block + strtab->sh_offset);
 
     unsigned int count = symtab->sh_size / sizeof(Elf32_Sym);
+    size_t nx;
+    const uint32_t *xindex = elf_symtab_shndx(parser, symtab - shdrs, &nx);
 
     printf(COLOR_RESET);
     printf("\n");
@@ -1229,11 +1125,13 @@ void print_symbols_with_disasm_32bit(bparser* parser, Elf32_Ehdr* elf, Elf32_Shd
         const char *name = strs + syms[i].st_name;
         unsigned char type = ELF32_ST_TYPE(syms[i].st_info);
         if(syms[i].st_size > 0){
-            if(type == STT_FUNC) {
-                unsigned char* ptr = (unsigned char*)parser->block + syms[i].st_value;
+            uint64_t off, avail;
+            // st_value is a virtual address, the bytes live at its file offset
+            if(type == STT_FUNC && elf_symbol_offset(parser, map, elf_sym_shndx(syms[i].st_shndx, xindex, nx, i), syms[i].st_value, &off, &avail)) {
+                unsigned char* ptr = (unsigned char*)parser->block + off;
                 printf("\n");
                 printf(COLOR_WHITE "|-- %s:" COLOR_RESET "\n", name);
-                print_disasm(ptr, syms[i].st_size, syms[i].st_value, ELFCLASS32);
+                print_disasm(ptr, (syms[i].st_size < avail) ? syms[i].st_size : avail, syms[i].st_value, ELFCLASS32);
             }
         }
     }
@@ -1251,6 +1149,7 @@ void print_symbols_with_disasm_32bit(bparser* parser, Elf32_Ehdr* elf, Elf32_Shd
  * @param shdrs Pointer to the section header array (Elf64_Shdr[]).
  * @param symtab Pointer to the section header of the symbol table (Elf64_Shdr).
  * @param strtab Pointer to the section header of the associated string table (Elf64_Shdr).
+ * @param map Address map used to find the file offset of each function.
  *
  * @note The function assumes:
  *       - ANSI color macros (COLOR_RESET, COLOR_YELLOW, COLOR_BLUE, etc.) are defined.
@@ -1266,9 +1165,9 @@ void print_symbols_with_disasm_32bit(bparser* parser, Elf32_Ehdr* elf, Elf32_Shd
  *   ...
  * @endcode
  */
-void print_symbols_with_disasm_64bit(bparser* parser, Elf64_Ehdr* elf, Elf64_Shdr* shdrs, Elf64_Shdr *symtab, Elf64_Shdr *strtab) 
+void print_symbols_with_disasm_64bit(bparser* parser, Elf64_Ehdr* elf, Elf64_Shdr* shdrs, Elf64_Shdr *symtab, Elf64_Shdr *strtab, const b_addrmap *map) 
 {
-    Elf64_Shdr shstr = shdrs[elf->e_shstrndx];
+    Elf64_Shdr shstr = shdrs[elf_shstrndx(parser)];
     const char* shstrtab = (const char*)(parser->block + shstr.sh_offset);
 
     const char* symname = &shstrtab[symtab -> sh_name];
@@ -1278,6 +1177,8 @@ void print_symbols_with_disasm_64bit(bparser* parser, Elf64_Ehdr* elf, Elf64_Shd
     const char *strs = (const char *)(parser->block + strtab->sh_offset);
 
     unsigned int count = symtab->sh_size / sizeof(Elf64_Sym);
+    size_t nx;
+    const uint32_t *xindex = elf_symtab_shndx(parser, symtab - shdrs, &nx);
 
     printf(COLOR_RESET);
     printf("\n");
@@ -1287,11 +1188,13 @@ void print_symbols_with_disasm_64bit(bparser* parser, Elf64_Ehdr* elf, Elf64_Shd
         const char *name = strs + syms[i].st_name;
         unsigned char type = ELF64_ST_TYPE(syms[i].st_info);
         if(syms[i].st_size > 0){
-            if(type == STT_FUNC) {
-                unsigned char* ptr = (unsigned char*)parser->block + syms[i].st_value;
+            uint64_t off, avail;
+            // st_value is a virtual address, the bytes live at its file offset
+            if(type == STT_FUNC && elf_symbol_offset(parser, map, elf_sym_shndx(syms[i].st_shndx, xindex, nx, i), syms[i].st_value, &off, &avail)) {
+                unsigned char* ptr = (unsigned char*)parser->block + off;
                 printf("\n");
                 printf(COLOR_WHITE "|-- %s:" COLOR_RESET "\n", name);
-                print_disasm(ptr, syms[i].st_size, syms[i].st_value, ELFCLASS64);
+                print_disasm(ptr, (syms[i].st_size < avail) ? syms[i].st_size : avail, syms[i].st_value, ELFCLASS64);
             }
         }
     }
@@ -1630,3 +1533,434 @@ void format_p_flags(uint32_t p_flags, char *buf, size_t size)
     strncat(buf, COLOR_CYAN , size - strlen(buf) - 1);
 }
 
+
+/**
+ * @brief Read section header `index` as a 64-bit header.
+ *
+ * The caller checks that the table fits in the file (elf_shnum()).
+ */
+static Elf64_Shdr elf_shdr(bparser *parser, uint64_t shoff, uint32_t index)
+{
+    const unsigned char *data = (const unsigned char*)parser->block;
+    Elf64_Shdr sh;
+    if (data[EI_CLASS] == ELFCLASS32) {
+        Elf32_Shdr *s = (Elf32_Shdr*)(data + shoff) + index;
+        sh = (Elf64_Shdr){s->sh_name, s->sh_type, s->sh_flags, s->sh_addr, s->sh_offset,
+                          s->sh_size, s->sh_link, s->sh_info, s->sh_addralign, s->sh_entsize};
+    } else {
+        sh = ((Elf64_Shdr*)(data + shoff))[index];
+    }
+    return sh;
+}
+
+/**
+ * @brief Get the number of sections of an ELF file.
+ *
+ * With SHN_LORESERVE (0xff00) sections or more, `e_shnum` is 0 and the
+ * real count is the `sh_size` of section 0 (extended numbering).
+ *
+ * @param parser Pointer to a bparser structure containing the ELF file.
+ * @return Number of section headers, 0 if there are none or the table
+ *         does not fit in the file.
+ */
+uint32_t elf_shnum(bparser *parser)
+{
+    const unsigned char *data = (const unsigned char*)parser->block;
+    uint64_t shoff, num, entsize;
+
+    if (data[EI_CLASS] == ELFCLASS32) {
+        Elf32_Ehdr *elf = (Elf32_Ehdr*)data;
+        shoff = elf->e_shoff, num = elf->e_shnum, entsize = sizeof(Elf32_Shdr);
+    } else if (data[EI_CLASS] == ELFCLASS64) {
+        Elf64_Ehdr *elf = (Elf64_Ehdr*)data;
+        shoff = elf->e_shoff, num = elf->e_shnum, entsize = sizeof(Elf64_Shdr);
+    } else {
+        return 0;
+    }
+    if (!shoff || shoff >= parser->size || parser->size - shoff < entsize) return 0;
+    if (num == 0) num = elf_shdr(parser, shoff, 0).sh_size;
+    if (num > UINT32_MAX || num > (parser->size - shoff) / entsize) return 0;
+    return (uint32_t)num;
+}
+
+/**
+ * @brief Get the index of the section header string table.
+ *
+ * `e_shstrndx` is SHN_XINDEX when the index does not fit in 16 bits, the
+ * index is then the `sh_link` of section 0.
+ *
+ * @param parser Pointer to a bparser structure containing the ELF file.
+ * @return Section index, SHN_UNDEF if there is no valid string table.
+ */
+uint32_t elf_shstrndx(bparser *parser)
+{
+    const unsigned char *data = (const unsigned char*)parser->block;
+    uint32_t shnum = elf_shnum(parser);
+    uint64_t shoff, index;
+    if (!shnum) return SHN_UNDEF;
+
+    if (data[EI_CLASS] == ELFCLASS32) {
+        shoff = ((Elf32_Ehdr*)data)->e_shoff, index = ((Elf32_Ehdr*)data)->e_shstrndx;
+    } else {
+        shoff = ((Elf64_Ehdr*)data)->e_shoff, index = ((Elf64_Ehdr*)data)->e_shstrndx;
+    }
+    if (index == SHN_XINDEX) index = elf_shdr(parser, shoff, 0).sh_link;
+    return (index < shnum) ? (uint32_t)index : SHN_UNDEF;
+}
+
+/**
+ * @brief Find the SHT_SYMTAB_SHNDX table of a symbol table.
+ *
+ * It holds the section index of every symbol whose `st_shndx` is
+ * SHN_XINDEX. Look it up once per symbol table, then resolve each symbol
+ * with elf_sym_shndx().
+ *
+ * @param parser Pointer to a bparser structure containing the ELF file.
+ * @param symtab Section index of the symbol table.
+ * @param count  Output number of entries.
+ * @return Pointer into the file, or NULL if the symbol table has none.
+ */
+const uint32_t *elf_symtab_shndx(bparser *parser, uint32_t symtab, size_t *count)
+{
+    const unsigned char *data = (const unsigned char*)parser->block;
+    uint32_t shnum = elf_shnum(parser);
+    uint64_t shoff = (data[EI_CLASS] == ELFCLASS32) ? ((Elf32_Ehdr*)data)->e_shoff : ((Elf64_Ehdr*)data)->e_shoff;
+    *count = 0;
+
+    for (uint32_t i = 1; i < shnum; i++) {
+        Elf64_Shdr sh = elf_shdr(parser, shoff, i);
+        if (sh.sh_type != SHT_SYMTAB_SHNDX || sh.sh_link != symtab) continue;
+        if (sh.sh_offset > parser->size || sh.sh_size > parser->size - sh.sh_offset) return NULL;
+        *count = sh.sh_size / sizeof(uint32_t);
+        return (const uint32_t*)(data + sh.sh_offset);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Get the section index of a symbol.
+ *
+ * @param st_shndx `st_shndx` of the symbol.
+ * @param xindex   Table from elf_symtab_shndx(), may be NULL.
+ * @param count    Number of entries in `xindex`.
+ * @param i        Index of the symbol in its table.
+ * @return The section index (looked up in `xindex` for SHN_XINDEX), or
+ *         SHN_UNDEF for the other reserved indices (SHN_ABS, SHN_COMMON...),
+ *         which name no section.
+ */
+uint32_t elf_sym_shndx(unsigned int st_shndx, const uint32_t *xindex, size_t count, size_t i)
+{
+    if (st_shndx == SHN_XINDEX) return (xindex && i < count) ? xindex[i] : SHN_UNDEF;
+    return (st_shndx >= SHN_LORESERVE) ? SHN_UNDEF : st_shndx;
+}
+
+/**
+ * @brief Build the virtual address <-> file offset map of an ELF file.
+ *
+ * PT_LOAD segments form the address index and SHF_ALLOC sections the
+ * section index. Every section with file contents is also indexed by
+ * offset. Works for both 32-bit and 64-bit files.
+ *
+ * @param parser Pointer to a bparser structure containing the ELF file.
+ * @return Newly allocated map (free with b_addrmap_free()), or NULL.
+ */
+b_addrmap *elf_build_addrmap(bparser *parser)
+{
+    const unsigned char *data = (const unsigned char*)parser->block;
+    uint32_t shnum = elf_shnum(parser);
+    b_addrmap *map = b_addrmap_create();
+    if (!map) return NULL;
+
+    if (data[EI_CLASS] == ELFCLASS32) {
+        Elf32_Ehdr *elf = (Elf32_Ehdr*)data;
+        if (elf->e_phoff && elf->e_phoff + (uint64_t)elf->e_phnum * sizeof(Elf32_Phdr) <= parser->size) {
+            Elf32_Phdr *phdr = (Elf32_Phdr*)(data + elf->e_phoff);
+            for (int i = 0; i < elf->e_phnum; i++) {
+                if (phdr[i].p_type != PT_LOAD) continue;
+                b_addrmap_add_segment(map, phdr[i].p_vaddr, phdr[i].p_memsz, phdr[i].p_offset, phdr[i].p_filesz, i);
+            }
+        }
+        if (shnum) {
+            Elf32_Shdr *shdrs = (Elf32_Shdr*)(data + elf->e_shoff);
+            for (uint32_t i = 1; i < shnum; i++) {
+                bool alloc = (shdrs[i].sh_flags & SHF_ALLOC) && elf->e_type != ET_REL;
+                uint64_t filesz = (shdrs[i].sh_type == SHT_NOBITS) ? 0 : shdrs[i].sh_size;
+                b_addrmap_add_section(map, shdrs[i].sh_addr, shdrs[i].sh_size, shdrs[i].sh_offset, filesz, i, alloc);
+            }
+        }
+    } else if (data[EI_CLASS] == ELFCLASS64) {
+        Elf64_Ehdr *elf = (Elf64_Ehdr*)data;
+        if (elf->e_phoff && elf->e_phoff + (uint64_t)elf->e_phnum * sizeof(Elf64_Phdr) <= parser->size) {
+            Elf64_Phdr *phdr = (Elf64_Phdr*)(data + elf->e_phoff);
+            for (int i = 0; i < elf->e_phnum; i++) {
+                if (phdr[i].p_type != PT_LOAD) continue;
+                b_addrmap_add_segment(map, phdr[i].p_vaddr, phdr[i].p_memsz, phdr[i].p_offset, phdr[i].p_filesz, i);
+            }
+        }
+        if (shnum) {
+            Elf64_Shdr *shdrs = (Elf64_Shdr*)(data + elf->e_shoff);
+            for (uint32_t i = 1; i < shnum; i++) {
+                bool alloc = (shdrs[i].sh_flags & SHF_ALLOC) && elf->e_type != ET_REL;
+                uint64_t filesz = (shdrs[i].sh_type == SHT_NOBITS) ? 0 : shdrs[i].sh_size;
+                b_addrmap_add_section(map, shdrs[i].sh_addr, shdrs[i].sh_size, shdrs[i].sh_offset, filesz, i, alloc);
+            }
+        }
+    }
+
+    b_addrmap_finalize(map);
+    return map;
+}
+
+/**
+ * @brief Find the file offset of the bytes a symbol points to.
+ *
+ * In relocatable objects `st_value` is relative to the symbol's section,
+ * everywhere else it is a virtual address translated through the map.
+ *
+ * @param parser Pointer to a bparser structure containing the ELF file.
+ * @param map    Address map built by elf_build_addrmap().
+ * @param shndx  Section index of the symbol, from elf_sym_shndx().
+ * @param value  Symbol value (`st_value`).
+ * @param off    Output file offset.
+ * @param avail  Output number of file-backed bytes from that offset.
+ * @return true if the symbol points into file contents.
+ */
+bool elf_symbol_offset(bparser *parser, const b_addrmap *map, unsigned int shndx, uint64_t value, uint64_t *off, uint64_t *avail)
+{
+    const unsigned char *data = (const unsigned char*)parser->block;
+    if (shndx == SHN_UNDEF) return false;
+
+    if (data[EI_CLASS] == ELFCLASS32 && ((Elf32_Ehdr*)data)->e_type == ET_REL) {
+        Elf32_Ehdr *elf = (Elf32_Ehdr*)data;
+        Elf32_Shdr *shdrs = (Elf32_Shdr*)(data + elf->e_shoff);
+        if (shndx >= elf_shnum(parser) || shdrs[shndx].sh_type == SHT_NOBITS || value >= shdrs[shndx].sh_size) return false;
+        *off = shdrs[shndx].sh_offset + value;
+        *avail = shdrs[shndx].sh_size - value;
+        return true;
+    }
+    if (data[EI_CLASS] == ELFCLASS64 && ((Elf64_Ehdr*)data)->e_type == ET_REL) {
+        Elf64_Ehdr *elf = (Elf64_Ehdr*)data;
+        Elf64_Shdr *shdrs = (Elf64_Shdr*)(data + elf->e_shoff);
+        if (shndx >= elf_shnum(parser) || shdrs[shndx].sh_type == SHT_NOBITS || value >= shdrs[shndx].sh_size) return false;
+        *off = shdrs[shndx].sh_offset + value;
+        *avail = shdrs[shndx].sh_size - value;
+        return true;
+    }
+    return b_addrmap_va_to_off(map, value, off, avail);
+}
+
+/**
+ * @brief Collect the executable sections of an ELF file.
+ *
+ * Files without section headers fall back to their executable PT_LOAD
+ * segments, named "segment".
+ *
+ * @param parser Pointer to a bparser structure containing the ELF file.
+ * @param out    Output array of regions, clamped to the file size.
+ * @param max    Capacity of `out`.
+ * @return Number of regions written.
+ */
+int elf_code_sections(bparser *parser, elf_region_t *out, int max)
+{
+    const unsigned char *data = (const unsigned char*)parser->block;
+    uint32_t shnum = elf_shnum(parser), shstrndx = elf_shstrndx(parser);
+    int n = 0;
+
+    if (data[EI_CLASS] == ELFCLASS32) {
+        Elf32_Ehdr *elf = (Elf32_Ehdr*)data;
+        if (shstrndx != SHN_UNDEF) {
+            Elf32_Shdr *shdrs = (Elf32_Shdr*)(data + elf->e_shoff);
+            const char *shstrtab = (const char*)data + shdrs[shstrndx].sh_offset;
+            for (uint32_t i = 1; i < shnum && n < max; i++) {
+                if (!(shdrs[i].sh_flags & SHF_EXECINSTR) || shdrs[i].sh_type == SHT_NOBITS) continue;
+                if (shdrs[i].sh_offset >= parser->size) continue;
+                uint64_t size = shdrs[i].sh_size;
+                if (size > parser->size - shdrs[i].sh_offset) size = parser->size - shdrs[i].sh_offset;
+                out[n++] = (elf_region_t){shstrtab + shdrs[i].sh_name, shdrs[i].sh_offset, size, shdrs[i].sh_addr};
+            }
+        }
+        if (n == 0 && elf->e_phoff && elf->e_phoff + (uint64_t)elf->e_phnum * sizeof(Elf32_Phdr) <= parser->size) {
+            Elf32_Phdr *phdr = (Elf32_Phdr*)(data + elf->e_phoff);
+            for (int i = 0; i < elf->e_phnum && n < max; i++) {
+                if (phdr[i].p_type != PT_LOAD || !(phdr[i].p_flags & PF_X) || phdr[i].p_offset >= parser->size) continue;
+                uint64_t size = phdr[i].p_filesz;
+                if (size > parser->size - phdr[i].p_offset) size = parser->size - phdr[i].p_offset;
+                out[n++] = (elf_region_t){"segment", phdr[i].p_offset, size, phdr[i].p_vaddr};
+            }
+        }
+    } else if (data[EI_CLASS] == ELFCLASS64) {
+        Elf64_Ehdr *elf = (Elf64_Ehdr*)data;
+        if (shstrndx != SHN_UNDEF) {
+            Elf64_Shdr *shdrs = (Elf64_Shdr*)(data + elf->e_shoff);
+            const char *shstrtab = (const char*)data + shdrs[shstrndx].sh_offset;
+            for (uint32_t i = 1; i < shnum && n < max; i++) {
+                if (!(shdrs[i].sh_flags & SHF_EXECINSTR) || shdrs[i].sh_type == SHT_NOBITS) continue;
+                if (shdrs[i].sh_offset >= parser->size) continue;
+                uint64_t size = shdrs[i].sh_size;
+                if (size > parser->size - shdrs[i].sh_offset) size = parser->size - shdrs[i].sh_offset;
+                out[n++] = (elf_region_t){shstrtab + shdrs[i].sh_name, shdrs[i].sh_offset, size, shdrs[i].sh_addr};
+            }
+        }
+        if (n == 0 && elf->e_phoff && elf->e_phoff + (uint64_t)elf->e_phnum * sizeof(Elf64_Phdr) <= parser->size) {
+            Elf64_Phdr *phdr = (Elf64_Phdr*)(data + elf->e_phoff);
+            for (int i = 0; i < elf->e_phnum && n < max; i++) {
+                if (phdr[i].p_type != PT_LOAD || !(phdr[i].p_flags & PF_X) || phdr[i].p_offset >= parser->size) continue;
+                uint64_t size = phdr[i].p_filesz;
+                if (size > parser->size - phdr[i].p_offset) size = parser->size - phdr[i].p_offset;
+                out[n++] = (elf_region_t){"segment", phdr[i].p_offset, size, phdr[i].p_vaddr};
+            }
+        }
+    }
+    return n;
+}
+
+/**
+ * @brief Get the name of a section by index.
+ *
+ * @param parser Pointer to a bparser structure containing the ELF file.
+ * @param index  Section index.
+ * @return Name from the section header string table, or NULL.
+ */
+const char *elf_section_name(bparser *parser, int index)
+{
+    const unsigned char *data = (const unsigned char*)parser->block;
+    uint32_t shstrndx = elf_shstrndx(parser);
+    uint64_t name_off;
+
+    if (index < 0 || (uint32_t)index >= elf_shnum(parser) || shstrndx == SHN_UNDEF) return NULL;
+
+    if (data[EI_CLASS] == ELFCLASS32) {
+        Elf32_Ehdr *elf = (Elf32_Ehdr*)data;
+        Elf32_Shdr *shdrs = (Elf32_Shdr*)(data + elf->e_shoff);
+        name_off = (uint64_t)shdrs[shstrndx].sh_offset + shdrs[index].sh_name;
+    } else if (data[EI_CLASS] == ELFCLASS64) {
+        Elf64_Ehdr *elf = (Elf64_Ehdr*)data;
+        Elf64_Shdr *shdrs = (Elf64_Shdr*)(data + elf->e_shoff);
+        name_off = shdrs[shstrndx].sh_offset + shdrs[index].sh_name;
+    } else {
+        return NULL;
+    }
+    return (name_off < parser->size) ? (const char*)data + name_off : NULL;
+}
+
+static int cmp_region_off(const void *a, const void *b)
+{
+    const elf_region_t *x = a, *y = b;
+    if (x->off != y->off) return x->off < y->off ? -1 : 1;
+    return (x->size < y->size) - (x->size > y->size);
+}
+
+/**
+ * @brief Collect the defined functions of an ELF file, sorted by file offset.
+ *
+ * `.symtab` is used when present, `.dynsym` otherwise. Functions without a
+ * size or without file contents are skipped, and aliases (several names at
+ * the same offset) are reported once, keeping the largest one.
+ *
+ * @param parser Pointer to a bparser structure containing the ELF file.
+ * @param map    Address map built by elf_build_addrmap().
+ * @param count  Output number of functions.
+ * @return Newly allocated array (free with free()), or NULL if there are none.
+ */
+elf_region_t *elf_functions(bparser *parser, const b_addrmap *map, size_t *count)
+{
+    const unsigned char *data = (const unsigned char*)parser->block;
+    uint32_t shnum = elf_shnum(parser);
+    elf_region_t *funcs = NULL;
+    size_t n = 0;
+    *count = 0;
+
+    if (data[EI_CLASS] == ELFCLASS32) {
+        Elf32_Ehdr *elf = (Elf32_Ehdr*)data;
+        if (!shnum) return NULL;
+        Elf32_Shdr *shdrs = (Elf32_Shdr*)(data + elf->e_shoff);
+        Elf32_Shdr *symtab = NULL;
+        for (uint32_t i = 0; i < shnum && !symtab; i++)
+            if (shdrs[i].sh_type == SHT_SYMTAB) symtab = &shdrs[i];
+        for (uint32_t i = 0; i < shnum && !symtab; i++)
+            if (shdrs[i].sh_type == SHT_DYNSYM) symtab = &shdrs[i];
+        if (!symtab || symtab->sh_link >= shnum || symtab->sh_offset + symtab->sh_size > parser->size) return NULL;
+
+        Elf32_Sym *syms = (Elf32_Sym*)(data + symtab->sh_offset);
+        const char *strs = (const char*)data + shdrs[symtab->sh_link].sh_offset;
+        size_t total = symtab->sh_size / sizeof(Elf32_Sym), nx;
+        const uint32_t *xindex = elf_symtab_shndx(parser, symtab - shdrs, &nx);
+        funcs = malloc((total ? total : 1) * sizeof(*funcs));
+        if (!funcs) return NULL;
+        for (size_t i = 0; i < total; i++) {
+            uint64_t off, avail;
+            if (ELF32_ST_TYPE(syms[i].st_info) != STT_FUNC || syms[i].st_size == 0) continue;
+            uint32_t shndx = elf_sym_shndx(syms[i].st_shndx, xindex, nx, i);
+            if (!elf_symbol_offset(parser, map, shndx, syms[i].st_value, &off, &avail)) continue;
+            funcs[n++] = (elf_region_t){strs + syms[i].st_name, off, (syms[i].st_size < avail) ? syms[i].st_size : avail, syms[i].st_value};
+        }
+    } else if (data[EI_CLASS] == ELFCLASS64) {
+        Elf64_Ehdr *elf = (Elf64_Ehdr*)data;
+        if (!shnum) return NULL;
+        Elf64_Shdr *shdrs = (Elf64_Shdr*)(data + elf->e_shoff);
+        Elf64_Shdr *symtab = NULL;
+        for (uint32_t i = 0; i < shnum && !symtab; i++)
+            if (shdrs[i].sh_type == SHT_SYMTAB) symtab = &shdrs[i];
+        for (uint32_t i = 0; i < shnum && !symtab; i++)
+            if (shdrs[i].sh_type == SHT_DYNSYM) symtab = &shdrs[i];
+        if (!symtab || symtab->sh_link >= shnum || symtab->sh_offset + symtab->sh_size > parser->size) return NULL;
+
+        Elf64_Sym *syms = (Elf64_Sym*)(data + symtab->sh_offset);
+        const char *strs = (const char*)data + shdrs[symtab->sh_link].sh_offset;
+        size_t total = symtab->sh_size / sizeof(Elf64_Sym), nx;
+        const uint32_t *xindex = elf_symtab_shndx(parser, symtab - shdrs, &nx);
+        funcs = malloc((total ? total : 1) * sizeof(*funcs));
+        if (!funcs) return NULL;
+        for (size_t i = 0; i < total; i++) {
+            uint64_t off, avail;
+            if (ELF64_ST_TYPE(syms[i].st_info) != STT_FUNC || syms[i].st_size == 0) continue;
+            uint32_t shndx = elf_sym_shndx(syms[i].st_shndx, xindex, nx, i);
+            if (!elf_symbol_offset(parser, map, shndx, syms[i].st_value, &off, &avail)) continue;
+            funcs[n++] = (elf_region_t){strs + syms[i].st_name, off, (syms[i].st_size < avail) ? syms[i].st_size : avail, syms[i].st_value};
+        }
+    } else {
+        return NULL;
+    }
+
+    qsort(funcs, n, sizeof(*funcs), cmp_region_off);
+    size_t unique = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (unique > 0 && funcs[unique - 1].off == funcs[i].off) continue;
+        funcs[unique++] = funcs[i];
+    }
+    if (unique == 0) {
+        free(funcs);
+        return NULL;
+    }
+    *count = unique;
+    return funcs;
+}
+
+/**
+ * @brief Parse a `--range` (or `--read`) value of the form `<vaddr>:<vaddr>` or `<vaddr>:+<len>`.
+ *
+ * Numbers are parsed with base auto-detection, so `0x401000` and `4198400`
+ * are both accepted.
+ *
+ * @param spec  Range string from the command line.
+ * @param start Output start virtual address.
+ * @param end   Output end virtual address (exclusive).
+ * @return true if the range is well formed and not empty.
+ */
+bool parse_vaddr_range(const char *spec, uint64_t *start, uint64_t *end)
+{
+    char *sep = NULL, *tail = NULL;
+    *start = strtoull(spec, &sep, 0);
+    if (sep == spec || *sep != ':') return false;
+    sep++;
+
+    if (*sep == '+') {
+        uint64_t len = strtoull(sep + 1, &tail, 0);
+        if (tail == sep + 1 || *tail != '\0') return false;
+        *end = *start + len;
+    } else {
+        *end = strtoull(sep, &tail, 0);
+        if (tail == sep || *tail != '\0') return false;
+    }
+    return *end > *start;
+}
@@ -7,9 +7,23 @@
 #include<string.h>
 #include "udis86.h"
 #include "../../utils/ui.h"
+#include "../b_addrmap/b_addrmap.h"
 
 #define META_LABEL_WIDTH -10
 
+#ifndef SHT_RELR
+#define SHT_RELR            19
+#endif
+#ifndef SHT_ANDROID_REL
+#define SHT_ANDROID_REL     0x60000001
+#endif
+#ifndef SHT_ANDROID_RELA
+#define SHT_ANDROID_RELA    0x60000002
+#endif
+#ifndef SHT_ANDROID_RELR
+#define SHT_ANDROID_RELR    0x6fffff00
+#endif
+
 
 typedef struct {
     const char *name;
@@ -17,17 +31,39 @@ typedef struct {
     const char *color;
 } legend_entry;
 
+/**
+ * @brief A named byte range of an ELF file (code section or function).
+ */
+typedef struct {
+    const char *name;   /**< Points into the file's string table */
+    uint64_t off;       /**< File offset */
+    uint64_t size;      /**< Size in bytes */
+    uint64_t vaddr;     /**< Virtual address of the first byte */
+} elf_region_t;
+
 void print_program_header_legend(void);
 void print_section_header_legend(void);
 const char* elf_machine_to_str(unsigned int machine);
 const char* sh_type_to_str(unsigned int sh_type);
 const char* elf_type_to_str(unsigned int type);
 const char *type_p_to_str(unsigned int p_type);
+const char* rel_R_X86_64_type_to_str(uint32_t type);
 void print_highlight_asm(const char *asm_instructions);
 void print_disasm(unsigned char *ptr, size_t size, unsigned long long offset, unsigned char bit_type);
 
-void print_symbols_with_disasm_32bit(bparser* parser, Elf32_Ehdr* elf, Elf32_Shdr* shdrs, Elf32_Shdr *symtab, Elf32_Shdr *strtab);
-void print_symbols_with_disasm_64bit(bparser* parser, Elf64_Ehdr* elf, Elf64_Shdr* shdrs, Elf64_Shdr *symtab, Elf64_Shdr *strtab);
+void print_symbols_with_disasm_32bit(bparser* parser, Elf32_Ehdr* elf, Elf32_Shdr* shdrs, Elf32_Shdr *symtab, Elf32_Shdr *strtab, const b_addrmap *map);
+void print_symbols_with_disasm_64bit(bparser* parser, Elf64_Ehdr* elf, Elf64_Shdr* shdrs, Elf64_Shdr *symtab, Elf64_Shdr *strtab, const b_addrmap *map);
+
+uint32_t elf_shnum(bparser *parser);
+uint32_t elf_shstrndx(bparser *parser);
+const uint32_t *elf_symtab_shndx(bparser *parser, uint32_t symtab, size_t *count);
+uint32_t elf_sym_shndx(unsigned int st_shndx, const uint32_t *xindex, size_t count, size_t i);
+b_addrmap *elf_build_addrmap(bparser *parser);
+bool elf_symbol_offset(bparser *parser, const b_addrmap *map, unsigned int shndx, uint64_t value, uint64_t *off, uint64_t *avail);
+int elf_code_sections(bparser *parser, elf_region_t *out, int max);
+const char *elf_section_name(bparser *parser, int index);
+elf_region_t *elf_functions(bparser *parser, const b_addrmap *map, size_t *count);
+bool parse_vaddr_range(const char *spec, uint64_t *start, uint64_t *end);
 
 void format_sh_flags(uint64_t sh_flags, char *buf, size_t size);
 void print_symbols_32bit(bparser* parser, Elf32_Ehdr* elf, Elf32_Shdr* shdrs, Elf32_Shdr *symtab, Elf32_Shdr *strtab);
@@ -36,9 +72,6 @@ void print_symbols_64bit(bparser* parser, Elf64_Ehdr* elf, Elf64_Shdr* shdrs, El
 void print_dynamic_table_32bit(bparser* parser, Elf32_Ehdr* elf, Elf32_Shdr* shdrs, Elf32_Shdr *dynmaictab, Elf32_Shdr *strtab);
 void print_dynamic_table_64bit(bparser* parser, Elf64_Ehdr* elf, Elf64_Shdr* shdrs, Elf64_Shdr *dynmaictab, Elf64_Shdr *strtab);
 
-void print_rela_32bit(bparser* parser, Elf32_Ehdr* elf, Elf32_Shdr* shdrs, Elf32_Shdr *reltab, Elf32_Shdr *symtab);
-void print_rela_64bit(bparser* parser, Elf64_Ehdr* elf, Elf64_Shdr* shdrs, Elf64_Shdr *symtab, Elf64_Shdr *strtab);
-
 void print_section_header_metadata_32bit(unsigned int id, const char *name, const char *type_str, const char *flags, Elf32_Shdr *shdrs);
 void print_section_header_metadata_64bit(unsigned int id, const char *name, const char *type_str, const char *flags, Elf64_Shdr *shdrs);
 
@@ -0,0 +1,709 @@
+/**
+ * @file bx_macho.c
+ * @brief Mach-O load commands, symbols, disassembly and fat slices.
+ */
+#include "bx_macho.h"
+#include <ctype.h>
+#include "../bx_elf_utils/bx_elf_utils.h"
+#include "../b_scan/b_scan.h"
+#include "../b_carve/b_carve.h"
+#include "../b_hash/b_hash.h"
+
+static uint32_t rd32(const macho_file_t *m, const unsigned char *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return m->swap ? __builtin_bswap32(v) : v;
+}
+
+static uint16_t rd16(const macho_file_t *m, const unsigned char *p)
+{
+    uint16_t v;
+    memcpy(&v, p, sizeof(v));
+    return m->swap ? __builtin_bswap16(v) : v;
+}
+
+static uint64_t rd64(const macho_file_t *m, const unsigned char *p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return m->swap ? __builtin_bswap64(v) : v;
+}
+
+/**
+ * @brief Copy a fixed 16-byte name (segname, sectname) and terminate it.
+ */
+static void copy_name(char dst[17], const unsigned char *src)
+{
+    memcpy(dst, src, 16);
+    dst[16] = '\0';
+}
+
+const char *macho_arch_name(uint32_t cputype, uint32_t cpusubtype)
+{
+    cpusubtype &= CPU_SUBTYPE_MASK;
+    switch (cputype) {
+        case CPU_TYPE_X86: return "i386";
+        case CPU_TYPE_X86_64: return cpusubtype == 8 ? "x86_64h" : "x86_64";
+        case CPU_TYPE_ARM:
+            switch (cpusubtype) {
+                case 6: return "armv6";
+                case 9: return "armv7";
+                case 11: return "armv7s";
+                case 12: return "armv7k";
+                default: return "arm";
+            }
+        case CPU_TYPE_ARM64: return cpusubtype == 2 ? "arm64e" : "arm64";
+        case CPU_TYPE_ARM64_32: return "arm64_32";
+        case CPU_TYPE_POWERPC: return "ppc";
+        case CPU_TYPE_POWERPC64: return "ppc64";
+        default: return "unknown";
+    }
+}
+
+static const char *filetype_name(uint32_t type)
+{
+    static const char *names[] = {
+        NULL, "OBJECT", "EXECUTE", "FVMLIB", "CORE", "PRELOAD", "DYLIB", "DYLINKER",
+        "BUNDLE", "DYLIB_STUB", "DSYM", "KEXT_BUNDLE", "FILESET",
+    };
+    return (type < sizeof(names) / sizeof(names[0]) && names[type]) ? names[type] : "unknown";
+}
+
+static const char *lc_name(uint32_t cmd)
+{
+    switch (cmd) {
+        case LC_SEGMENT: return "LC_SEGMENT";
+        case LC_SYMTAB: return "LC_SYMTAB";
+        case LC_THREAD: return "LC_THREAD";
+        case LC_UNIXTHREAD: return "LC_UNIXTHREAD";
+        case LC_DYSYMTAB: return "LC_DYSYMTAB";
+        case LC_LOAD_DYLIB: return "LC_LOAD_DYLIB";
+        case LC_ID_DYLIB: return "LC_ID_DYLIB";
+        case LC_LOAD_DYLINKER: return "LC_LOAD_DYLINKER";
+        case LC_ID_DYLINKER: return "LC_ID_DYLINKER";
+        case LC_LOAD_WEAK_DYLIB: return "LC_LOAD_WEAK_DYLIB";
+        case LC_SEGMENT_64: return "LC_SEGMENT_64";
+        case LC_UUID: return "LC_UUID";
+        case LC_RPATH: return "LC_RPATH";
+        case LC_CODE_SIGNATURE: return "LC_CODE_SIGNATURE";
+        case LC_SEGMENT_SPLIT_INFO: return "LC_SEGMENT_SPLIT_INFO";
+        case LC_REEXPORT_DYLIB: return "LC_REEXPORT_DYLIB";
+        case LC_ENCRYPTION_INFO: return "LC_ENCRYPTION_INFO";
+        case LC_DYLD_INFO: return "LC_DYLD_INFO";
+        case LC_DYLD_INFO_ONLY: return "LC_DYLD_INFO_ONLY";
+        case LC_VERSION_MIN_MACOSX: return "LC_VERSION_MIN_MACOSX";
+        case LC_VERSION_MIN_IPHONEOS: return "LC_VERSION_MIN_IPHONEOS";
+        case LC_FUNCTION_STARTS: return "LC_FUNCTION_STARTS";
+        case LC_MAIN: return "LC_MAIN";
+        case LC_DATA_IN_CODE: return "LC_DATA_IN_CODE";
+        case LC_SOURCE_VERSION: return "LC_SOURCE_VERSION";
+        case LC_ENCRYPTION_INFO_64: return "LC_ENCRYPTION_INFO_64";
+        case LC_VERSION_MIN_TVOS: return "LC_VERSION_MIN_TVOS";
+        case LC_VERSION_MIN_WATCHOS: return "LC_VERSION_MIN_WATCHOS";
+        case LC_BUILD_VERSION: return "LC_BUILD_VERSION";
+        case LC_DYLD_EXPORTS_TRIE: return "LC_DYLD_EXPORTS_TRIE";
+        case LC_DYLD_CHAINED_FIXUPS: return "LC_DYLD_CHAINED_FIXUPS";
+        default: return "LC_?";
+    }
+}
+
+static const char *platform_name(uint32_t platform)
+{
+    static const char *names[] = {
+        NULL, "macOS", "iOS", "tvOS", "watchOS", "bridgeOS", "Mac Catalyst",
+        "iOS simulator", "tvOS simulator", "watchOS simulator", "DriverKit", "visionOS",
+    };
+    return (platform < sizeof(names) / sizeof(names[0]) && names[platform]) ? names[platform] : "unknown";
+}
+
+// ========================= BEGIN PARSER ==================================
+/**
+ * @brief Record the segment of an LC_SEGMENT(_64) and its section headers.
+ */
+static bool parse_segment(macho_file_t *m, const unsigned char *lc, uint32_t size)
+{
+    size_t head = m->is64 ? 72 : 56, sect = m->is64 ? 80 : 68;
+    if (size < head) return false;
+    macho_segment_t seg = {0};
+    copy_name(seg.name, lc + 8);
+    uint32_t nsects;
+    if (m->is64) {
+        seg.vmaddr = rd64(m, lc + 24);
+        seg.vmsize = rd64(m, lc + 32);
+        seg.fileoff = rd64(m, lc + 40);
+        seg.filesize = rd64(m, lc + 48);
+        seg.maxprot = rd32(m, lc + 56);
+        seg.initprot = rd32(m, lc + 60);
+        nsects = rd32(m, lc + 64);
+    } else {
+        seg.vmaddr = rd32(m, lc + 24);
+        seg.vmsize = rd32(m, lc + 28);
+        seg.fileoff = rd32(m, lc + 32);
+        seg.filesize = rd32(m, lc + 36);
+        seg.maxprot = rd32(m, lc + 40);
+        seg.initprot = rd32(m, lc + 44);
+        nsects = rd32(m, lc + 48);
+    }
+    if (nsects > (size - head) / sect) return false;
+    seg.nsects = nsects;
+
+    macho_segment_t *segs = realloc(m->segments, (m->nsegments + 1) * sizeof(*segs));
+    macho_section_t *secs = realloc(m->sections, (m->nsections + nsects + 1) * sizeof(*secs));
+    if (segs) m->segments = segs;
+    if (secs) m->sections = secs;
+    if (!segs || !secs) return false;
+    m->segments[m->nsegments++] = seg;
+
+    for (uint32_t i = 0; i < nsects; i++) {
+        const unsigned char *s = lc + head + i * sect;
+        macho_section_t *out = &m->sections[m->nsections++];
+        copy_name(out->sectname, s);
+        copy_name(out->segname, s + 16);
+        if (m->is64) {
+            out->addr = rd64(m, s + 32);
+            out->size = rd64(m, s + 40);
+            out->offset = rd32(m, s + 48);
+            out->flags = rd32(m, s + 64);
+        } else {
+            out->addr = rd32(m, s + 32);
+            out->size = rd32(m, s + 36);
+            out->offset = rd32(m, s + 40);
+            out->flags = rd32(m, s + 56);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Load the nlist entries and string table of LC_SYMTAB.
+ */
+static bool parse_symtab(macho_file_t *m, const unsigned char *lc, uint32_t size)
+{
+    if (size < 24) return false;
+    uint32_t symoff = rd32(m, lc + 8), nsyms = rd32(m, lc + 12);
+    uint32_t stroff = rd32(m, lc + 16), strsize = rd32(m, lc + 20);
+    bparser *parser = m->parser;
+    size_t entsize = m->is64 ? 16 : 12;
+    if (stroff > parser->size || strsize > parser->size - stroff) return false;
+    if (symoff > parser->size || nsyms > (parser->size - symoff) / entsize || nsyms > MACHO_MAX_SYMBOLS) return false;
+
+    m->strtab = malloc((size_t)strsize + 1);
+    unsigned char *raw = malloc(nsyms * entsize + 1);
+    m->symbols = calloc(nsyms + 1, sizeof(*m->symbols));
+    if (!m->strtab || !raw || !m->symbols) {
+        free(raw);
+        return false;
+    }
+    m->strsize = (uint32_t)bparser_read(parser, m->strtab, stroff, strsize);
+    m->strtab[m->strsize] = '\0';
+    bparser_read(parser, raw, symoff, nsyms * entsize);
+
+    for (uint32_t i = 0; i < nsyms; i++) {
+        const unsigned char *n = raw + i * entsize;
+        macho_symbol_t *sym = &m->symbols[m->nsymbols++];
+        uint32_t strx = rd32(m, n);
+        sym->name = strx < m->strsize ? m->strtab + strx : "";
+        sym->type = n[4];
+        sym->sect = n[5];
+        sym->desc = rd16(m, n + 6);
+        sym->value = m->is64 ? rd64(m, n + 8) : rd32(m, n + 8);
+    }
+    free(raw);
+    return true;
+}
+
+/**
+ * @brief Entry point of LC_UNIXTHREAD: rip (x86-64) or eip (i386).
+ */
+static void parse_thread(macho_file_t *m, const unsigned char *lc, uint32_t size)
+{
+    if (size < 16) return;
+    uint32_t flavor = rd32(m, lc + 8);
+    if (m->cputype == CPU_TYPE_X86_64 && flavor == 4 && size >= 16 + 17 * 8) {
+        m->entry = rd64(m, lc + 16 + 16 * 8);
+        m->has_entry = true;
+    } else if (m->cputype == CPU_TYPE_X86 && flavor == 1 && size >= 16 + 11 * 4) {
+        m->entry = rd32(m, lc + 16 + 10 * 4);
+        m->has_entry = true;
+    }
+}
+
+macho_file_t *macho_open(bparser *parser)
+{
+    unsigned char head[MACHO_HEADER_SIZE_64];
+    if (bparser_read(parser, head, 0, sizeof(head)) != sizeof(head)) return NULL;
+    uint32_t magic;
+    memcpy(&magic, head, sizeof(magic));
+
+    macho_file_t *m = calloc(1, sizeof(*m));
+    if (!m) return NULL;
+    m->parser = parser;
+    m->is64 = magic == MH_MAGIC_64 || magic == MH_CIGAM_64;
+    m->swap = magic == MH_CIGAM || magic == MH_CIGAM_64;
+    if (!m->is64 && magic != MH_MAGIC && magic != MH_CIGAM) {
+        free(m);
+        return NULL;
+    }
+    m->cputype = rd32(m, head + 4);
+    m->cpusubtype = rd32(m, head + 8);
+    m->filetype = rd32(m, head + 12);
+    uint32_t ncmds = rd32(m, head + 16), sizeofcmds = rd32(m, head + 20);
+    m->flags = rd32(m, head + 24);
+
+    size_t hsize = m->is64 ? MACHO_HEADER_SIZE_64 : MACHO_HEADER_SIZE;
+    if (sizeofcmds > parser->size - hsize || ncmds > sizeofcmds / 8) {
+        fprintf(stderr, COLOR_RED "[!] Load commands out of bounds: " COLOR_RESET "%u commands, %u bytes\n", ncmds,
+                sizeofcmds);
+        macho_close(m);
+        return NULL;
+    }
+    m->cmds = malloc(sizeofcmds ? sizeofcmds : 1);
+    m->lcs = calloc(ncmds ? ncmds : 1, sizeof(*m->lcs));
+    if (!m->cmds || !m->lcs || bparser_read(parser, m->cmds, hsize, sizeofcmds) != sizeofcmds) {
+        macho_close(m);
+        return NULL;
+    }
+
+    uint64_t text_vmaddr = 0, text_fileoff = 0, main_off = 0;
+    bool has_main = false;
+    for (uint32_t i = 0, off = 0; i < ncmds; i++) {
+        if (sizeofcmds - off < 8) break;
+        const unsigned char *lc = m->cmds + off;
+        uint32_t cmd = rd32(m, lc), size = rd32(m, lc + 4);
+        if (size < 8 || size > sizeofcmds - off) {
+            fprintf(stderr, COLOR_RED "[!] Bad load command size: " COLOR_RESET "#%u (%u bytes)\n", i, size);
+            break;
+        }
+        m->lcs[m->nlcs++] = (macho_lc_t){.cmd = cmd, .size = size, .off = off};
+
+        bool ok = true;
+        if (cmd == LC_SEGMENT || cmd == LC_SEGMENT_64) {
+            ok = (cmd == LC_SEGMENT_64) == m->is64 && parse_segment(m, lc, size);
+            if (ok && strcmp(m->segments[m->nsegments - 1].name, "__TEXT") == 0) {
+                text_vmaddr = m->segments[m->nsegments - 1].vmaddr;
+                text_fileoff = m->segments[m->nsegments - 1].fileoff;
+            }
+        } else if (cmd == LC_SYMTAB && !m->symbols) {
+            ok = parse_symtab(m, lc, size);
+        } else if (cmd == LC_MAIN && size >= 24) {
+            main_off = rd64(m, lc + 8);
+            has_main = true;
+        } else if (cmd == LC_UNIXTHREAD) {
+            parse_thread(m, lc, size);
+        }
+        if (!ok) fprintf(stderr, COLOR_RED "[!] Bad %s: " COLOR_RESET "#%u\n", lc_name(cmd), i);
+        off += size;
+    }
+    if (has_main) {
+        // entryoff is a file offset, __TEXT maps it
+        m->entry = text_vmaddr + main_off - text_fileoff;
+        m->has_entry = true;
+    }
+    return m;
+}
+
+void macho_close(macho_file_t *m)
+{
+    if (!m) return;
+    free(m->cmds);
+    free(m->lcs);
+    free(m->segments);
+    free(m->sections);
+    free(m->strtab);
+    free(m->symbols);
+    free(m);
+}
+
+bool macho_vaddr_to_offset(const macho_file_t *m, uint64_t vaddr, uint64_t *off)
+{
+    for (size_t i = 0; i < m->nsegments; i++) {
+        const macho_segment_t *s = &m->segments[i];
+        if (vaddr >= s->vmaddr && vaddr - s->vmaddr < s->filesize) {
+            *off = s->fileoff + (vaddr - s->vmaddr);
+            return *off < m->parser->size;
+        }
+    }
+    return false;
+}
+// ========================= END PARSER ==================================
+
+// ========================= BEGIN METADATA ==================================
+static void format_prot(uint32_t prot, char buf[4])
+{
+    buf[0] = (prot & 1) ? 'r' : '-';
+    buf[1] = (prot & 2) ? 'w' : '-';
+    buf[2] = (prot & 4) ? 'x' : '-';
+    buf[3] = '\0';
+}
+
+static void print_version(uint32_t v)
+{
+    printf("%u.%u.%u", v >> 16, (v >> 8) & 0xff, v & 0xff);
+}
+
+/**
+ * @brief NUL-terminated string at an offset inside a load command.
+ */
+static const char *lc_string(const macho_file_t *m, const macho_lc_t *lc, uint32_t name_off)
+{
+    const char *s = (const char*)m->cmds + lc->off + name_off;
+    if (name_off >= lc->size || !memchr(s, '\0', lc->size - name_off)) return "?";
+    return s;
+}
+
+static void print_load_command(const macho_file_t *m, const macho_lc_t *lc, size_t index)
+{
+    const unsigned char *p = m->cmds + lc->off;
+    printf(COLOR_GREEN "|--[%3zu] " COLOR_RESET "%-24s %5u ", index, lc_name(lc->cmd), lc->size);
+    switch (lc->cmd) {
+        case LC_SEGMENT:
+        case LC_SEGMENT_64: {
+            char name[17];
+            copy_name(name, p + 8);
+            printf(" %s", name);
+            break;
+        }
+        case LC_LOAD_DYLIB:
+        case LC_ID_DYLIB:
+        case LC_LOAD_WEAK_DYLIB:
+        case LC_REEXPORT_DYLIB:
+            if (lc->size >= 24) {
+                printf(" %s (", lc_string(m, lc, rd32(m, p + 8)));
+                print_version(rd32(m, p + 16));
+                printf(")");
+            }
+            break;
+        case LC_LOAD_DYLINKER:
+        case LC_ID_DYLINKER:
+        case LC_RPATH:
+            if (lc->size >= 12) printf(" %s", lc_string(m, lc, rd32(m, p + 8)));
+            break;
+        case LC_UUID:
+            if (lc->size >= 24) {
+                printf(" ");
+                for (int i = 0; i < 16; i++) printf("%02X%s", p[8 + i], (i == 3 || i == 5 || i == 7 || i == 9) ? "-" : "");
+            }
+            break;
+        case LC_MAIN:
+            if (lc->size >= 24)
+                printf(" entryoff 0x%llx, stack %llu", (unsigned long long)rd64(m, p + 8),
+                       (unsigned long long)rd64(m, p + 16));
+            break;
+        case LC_BUILD_VERSION:
+            if (lc->size >= 24) {
+                printf(" %s, min ", platform_name(rd32(m, p + 8)));
+                print_version(rd32(m, p + 12));
+                printf(", sdk ");
+                print_version(rd32(m, p + 16));
+            }
+            break;
+        case LC_VERSION_MIN_MACOSX:
+        case LC_VERSION_MIN_IPHONEOS:
+        case LC_VERSION_MIN_TVOS:
+        case LC_VERSION_MIN_WATCHOS:
+            if (lc->size >= 16) {
+                printf(" min ");
+                print_version(rd32(m, p + 8));
+                printf(", sdk ");
+                print_version(rd32(m, p + 12));
+            }
+            break;
+        case LC_SOURCE_VERSION:
+            if (lc->size >= 16) {
+                uint64_t v = rd64(m, p + 8);
+                printf(" %llu.%llu.%llu.%llu.%llu", (unsigned long long)(v >> 40), (unsigned long long)(v >> 30 & 0x3ff),
+                       (unsigned long long)(v >> 20 & 0x3ff), (unsigned long long)(v >> 10 & 0x3ff),
+                       (unsigned long long)(v & 0x3ff));
+            }
+            break;
+        case LC_SYMTAB:
+            if (lc->size >= 24)
+                printf(" %u symbols at 0x%x, strings 0x%x (%u bytes)", rd32(m, p + 12), rd32(m, p + 8), rd32(m, p + 16),
+                       rd32(m, p + 20));
+            break;
+        case LC_DYSYMTAB:
+            if (lc->size >= 32)
+                printf(" %u local, %u defined, %u undefined", rd32(m, p + 12), rd32(m, p + 20), rd32(m, p + 28));
+            break;
+        case LC_CODE_SIGNATURE:
+        case LC_SEGMENT_SPLIT_INFO:
+        case LC_FUNCTION_STARTS:
+        case LC_DATA_IN_CODE:
+        case LC_DYLD_EXPORTS_TRIE:
+        case LC_DYLD_CHAINED_FIXUPS:
+            if (lc->size >= 16) printf(" 0x%x (%u bytes)", rd32(m, p + 8), rd32(m, p + 12));
+            break;
+        case LC_ENCRYPTION_INFO:
+        case LC_ENCRYPTION_INFO_64:
+            if (lc->size >= 20)
+                printf(" 0x%x (%u bytes), %s", rd32(m, p + 8), rd32(m, p + 12),
+                       rd32(m, p + 16) ? COLOR_RED "encrypted" COLOR_RESET : "not encrypted");
+            break;
+        case LC_DYLD_INFO:
+        case LC_DYLD_INFO_ONLY:
+            if (lc->size >= 48)
+                printf(" rebase %u, bind %u, lazy %u, export %u bytes", rd32(m, p + 12), rd32(m, p + 20),
+                       rd32(m, p + 36), rd32(m, p + 44));
+            break;
+        default:
+            break;
+    }
+    printf("\n");
+}
+
+static char symbol_kind(const macho_symbol_t *s)
+{
+    char c;
+    switch (s->type & N_TYPE) {
+        case N_UNDF: c = s->value ? 'c' : 'u'; break;
+        case N_ABS: c = 'a'; break;
+        case N_SECT: c = 's'; break;
+        case N_INDR: c = 'i'; break;
+        default: c = '?'; break;
+    }
+    return (s->type & N_EXT) ? (char)toupper(c) : c;
+}
+
+static void macho_metadata(const macho_file_t *m)
+{
+    printf(COLOR_BLUE "\n=== Mach-O Header ===\n" COLOR_RESET);
+    printf(COLOR_GREEN "|--class     :" COLOR_RESET " %s, %s endian\n", m->is64 ? "64 bit" : "32 bit",
+           (m->swap == (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)) ? "big" : "little");
+    printf(COLOR_GREEN "|--cpu       :" COLOR_RESET " %s (0x%x, subtype 0x%x)\n",
+           macho_arch_name(m->cputype, m->cpusubtype), m->cputype, m->cpusubtype);
+    printf(COLOR_GREEN "|--type      :" COLOR_RESET " %s (%u)\n", filetype_name(m->filetype), m->filetype);
+    printf(COLOR_GREEN "|--flags     :" COLOR_RESET " 0x%08x\n", m->flags);
+    if (m->has_entry) printf(COLOR_GREEN "|--entry     :" COLOR_RESET " 0x%llx\n", (unsigned long long)m->entry);
+
+    printf(COLOR_BLUE "\n=== Load Commands (%zu) ===\n" COLOR_RESET, m->nlcs);
+    for (size_t i = 0; i < m->nlcs; i++) print_load_command(m, &m->lcs[i], i);
+
+    printf(COLOR_BLUE "\n=== Segments ===\n" COLOR_RESET);
+    size_t sect = 0;
+    for (size_t i = 0; i < m->nsegments; i++) {
+        const macho_segment_t *s = &m->segments[i];
+        char maxprot[4], initprot[4];
+        format_prot(s->maxprot, maxprot);
+        format_prot(s->initprot, initprot);
+        printf(COLOR_GREEN "|--%-16s" COLOR_RESET " vm 0x%012llx-0x%012llx  file 0x%08llx (%llu bytes)  %s/%s\n",
+               s->name[0] ? s->name : "-", (unsigned long long)s->vmaddr, (unsigned long long)(s->vmaddr + s->vmsize),
+               (unsigned long long)s->fileoff, (unsigned long long)s->filesize, initprot, maxprot);
+        for (uint32_t k = 0; k < s->nsects; k++, sect++) {
+            const macho_section_t *c = &m->sections[sect];
+            printf("|----[%2zu] %-18s 0x%012llx %10llu bytes  off 0x%08x  flags 0x%08x%s\n", sect + 1, c->sectname,
+                   (unsigned long long)c->addr, (unsigned long long)c->size, c->offset, c->flags,
+                   (c->flags & (S_ATTR_PURE_INSTRUCTIONS | S_ATTR_SOME_INSTRUCTIONS)) ? COLOR_YELLOW " code" COLOR_RESET : "");
+        }
+    }
+
+    printf(COLOR_BLUE "\n=== Symbols (%zu) ===\n" COLOR_RESET, m->nsymbols);
+    for (size_t i = 0; i < m->nsymbols; i++) {
+        const macho_symbol_t *s = &m->symbols[i];
+        if (s->type & N_STAB) continue;   // debugger entries
+        printf("|--0x%016llx %c %s\n", (unsigned long long)s->value, symbol_kind(s), s->name);
+    }
+}
+// ========================= END METADATA ==================================
+
+// ========================= BEGIN DISASM ==================================
+static int cmp_symbol_addr(const void *a, const void *b)
+{
+    const macho_symbol_t *x = *(const macho_symbol_t* const*)a, *y = *(const macho_symbol_t* const*)b;
+    return (x->value > y->value) - (x->value < y->value);
+}
+
+static bool is_code(const macho_section_t *s)
+{
+    return (s->flags & (S_ATTR_PURE_INSTRUCTIONS | S_ATTR_SOME_INSTRUCTIONS)) != 0;
+}
+
+/**
+ * @brief Disassemble [addr, addr + size) of a section, in place when the
+ * file is in memory.
+ */
+static void disasm_range(const macho_file_t *m, const macho_section_t *s, uint64_t addr, uint64_t size)
+{
+    bparser *parser = m->parser;
+    uint64_t off = (uint64_t)s->offset + (addr - s->addr);
+    if (off >= parser->size) return;
+    if (size > parser->size - off) size = parser->size - off;
+    unsigned char bit_type = m->cputype == CPU_TYPE_X86_64 ? ELFCLASS64 : ELFCLASS32;
+    if (parser->block) {
+        print_disasm((unsigned char*)parser->block + off, size, addr, bit_type);
+        return;
+    }
+    unsigned char *buf = malloc(size ? size : 1);
+    if (!buf) return;
+    size = bparser_read(parser, buf, off, size);
+    print_disasm(buf, size, addr, bit_type);
+    free(buf);
+}
+
+/**
+ * @brief Defined symbols of section index (1-based), sorted by address.
+ */
+static const macho_symbol_t **section_symbols(const macho_file_t *m, size_t index, size_t *count)
+{
+    const macho_symbol_t **out = malloc((m->nsymbols + 1) * sizeof(*out));
+    *count = 0;
+    if (!out) return NULL;
+    for (size_t i = 0; i < m->nsymbols; i++) {
+        const macho_symbol_t *s = &m->symbols[i];
+        if (!(s->type & N_STAB) && (s->type & N_TYPE) == N_SECT && s->sect == index) out[(*count)++] = s;
+    }
+    qsort(out, *count, sizeof(*out), cmp_symbol_addr);
+    return out;
+}
+
+/**
+ * @brief Disassemble every code section, split at its symbols; or only the
+ * symbol named by `--function` (with or without the leading '_').
+ */
+static bool macho_disasm(const macho_file_t *m, inputs *input)
+{
+    if (m->cputype != CPU_TYPE_X86_64 && m->cputype != CPU_TYPE_X86) {
+        fprintf(stderr, COLOR_RED "[!] Disassembly is only supported for x86 and x86-64 slices, not " COLOR_RESET
+                "%s\n", macho_arch_name(m->cputype, m->cpusubtype));
+        return false;
+    }
+    const char *function = baseer_get_opt(input, "--function");
+    bool found = false;
+    printf(COLOR_BLUE "=== Mach-O Disasm (%s) ===\n" COLOR_RESET, macho_arch_name(m->cputype, m->cpusubtype));
+    for (size_t i = 0; i < m->nsections; i++) {
+        const macho_section_t *s = &m->sections[i];
+        if (!is_code(s) || (s->flags & SECTION_TYPE) == S_ZEROFILL || s->size == 0) continue;
+        size_t count;
+        const macho_symbol_t **syms = section_symbols(m, i + 1, &count);
+        if (!syms) return false;
+        if (!function) printf(COLOR_YELLOW "\n=== %s,%s ===\n" COLOR_RESET, s->segname, s->sectname);
+
+        uint64_t end = s->addr + s->size;
+        if (!function && (count == 0 || syms[0]->value > s->addr))
+            disasm_range(m, s, s->addr, (count ? syms[0]->value : end) - s->addr);
+        for (size_t k = 0; k < count; k++) {
+            const macho_symbol_t *sym = syms[k];
+            if (sym->value < s->addr || sym->value >= end) continue;
+            if (k + 1 < count && syms[k + 1]->value == sym->value) continue;   // aliases: keep the last one
+            const char *name = sym->name;
+            if (function && strcmp(name, function) != 0 && !(name[0] == '_' && strcmp(name + 1, function) == 0))
+                continue;
+            uint64_t next = (k + 1 < count && syms[k + 1]->value < end) ? syms[k + 1]->value : end;
+            printf("\n" COLOR_WHITE "|-- %s:" COLOR_RESET "\n", name);
+            disasm_range(m, s, sym->value, next - sym->value);
+            found = true;
+        }
+        free(syms);
+    }
+    if (function && !found) {
+        fprintf(stderr, COLOR_RED "[!] Function not found: " COLOR_RESET "%s\n", function);
+        return false;
+    }
+    return true;
+}
+// ========================= END DISASM ==================================
+
+/**
+ * @brief Run the command-line flags on a thin Mach-O image.
+ */
+static bool macho_thin(bparser *parser, void *arg)
+{
+    int argc = *((inputs*)arg)->argc;
+    char **args = ((inputs*)arg)->args;
+
+    macho_file_t *m = NULL;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp("--scan", args[i]) == 0 && i + 1 < argc) {
+            bparser_apply(parser, b_scan, arg);
+            i++;
+        } else if (strcmp("--hash", args[i]) == 0) {
+            bparser_apply(parser, b_hash, arg);
+        } else if (strcmp("--carve", args[i]) == 0) {
+            bparser_apply(parser, b_carve, arg);
+            break;
+        } else if (strcmp("--arch", args[i]) == 0 || strcmp("--function", args[i]) == 0) {
+            i++;
+        } else if (strcmp("-m", args[i]) == 0 || strcmp("-a", args[i]) == 0) {
+            if (!m && !(m = macho_open(parser))) {
+                fprintf(stderr, COLOR_RED "[!] Not a Mach-O image\n" COLOR_RESET);
+                return false;
+            }
+            if (args[i][1] == 'm') macho_metadata(m);
+            else macho_disasm(m, arg);
+        } else {
+            fprintf(stderr, "[!] Unsupported flag: %s\n", args[i]);
+        }
+    }
+    macho_close(m);
+    return true;
+}
+
+/**
+ * @brief List the slices of a fat binary and run the flags on each (or on
+ * the one selected with `--arch`).
+ */
+static bool macho_fat(bparser *parser, void *arg)
+{
+    unsigned char head[8];
+    if (bparser_read(parser, head, 0, sizeof(head)) != sizeof(head)) return false;
+    bool fat64 = rd32be(head) == FAT_MAGIC_64;
+    uint32_t nfat = rd32be(head + 4);
+    size_t entsize = fat64 ? MACHO_FAT_ARCH_SIZE_64 : MACHO_FAT_ARCH_SIZE;
+    if (nfat == 0 || nfat > MACHO_MAX_FAT_ARCH) {
+        // 0xcafebabe followed by a class file version
+        fprintf(stderr, COLOR_RED "[!] Not a fat binary (%u architectures, Java class file?)\n" COLOR_RESET, nfat);
+        return false;
+    }
+    unsigned char table[MACHO_MAX_FAT_ARCH * MACHO_FAT_ARCH_SIZE_64];
+    if (bparser_read(parser, table, sizeof(head), nfat * entsize) != nfat * entsize) {
+        fprintf(stderr, COLOR_RED "[!] Truncated fat header\n" COLOR_RESET);
+        return false;
+    }
+
+    const char *want = baseer_get_opt(arg, "--arch");
+    bool matched = false;
+    printf(COLOR_BLUE "\n=== Fat Binary (%u architectures) ===\n" COLOR_RESET, nfat);
+    for (int pass = 0; pass < 2; pass++) {
+        // the table first, then the slices
+        for (uint32_t i = 0; i < nfat; i++) {
+            const unsigned char *a = table + i * entsize;
+            uint32_t cputype = rd32be(a), cpusubtype = rd32be(a + 4);
+            uint64_t offset = fat64 ? rd64be(a + 8) : rd32be(a + 8);
+            uint64_t size = fat64 ? rd64be(a + 16) : rd32be(a + 12);
+            uint32_t align = fat64 ? rd32be(a + 24) : rd32be(a + 16);
+            const char *name = macho_arch_name(cputype, cpusubtype);
+            bool inside = offset <= parser->size && size <= parser->size - offset && size > 0;
+            if (pass == 0) {
+                printf(COLOR_GREEN "|--[%u] %-9s" COLOR_RESET " offset 0x%08llx  size %10llu  align 2^%u\n", i, name,
+                       (unsigned long long)offset, (unsigned long long)size, align);
+                if (!inside) fprintf(stderr, COLOR_RED "[!] Slice %u is outside the file\n" COLOR_RESET, i);
+                continue;
+            }
+            if (!inside || (want && strcmp(want, name) != 0)) continue;
+            matched = true;
+
+            // zero-copy window, the slice is parsed like a thin file
+            bparser *slice = bparser_slice(parser, offset, size);
+            if (!slice) continue;
+            uint32_t magic = 0;
+            bparser_read(slice, &magic, 0, sizeof(magic));
+            printf(COLOR_BLUE "\n=== Slice %s ===\n" COLOR_RESET, name);
+            if (magic == MH_MAGIC || magic == MH_CIGAM || magic == MH_MAGIC_64 || magic == MH_CIGAM_64)
+                bparser_apply(slice, macho_thin, arg);
+            else
+                fprintf(stderr, COLOR_RED "[!] Slice %u is not a Mach-O image\n" COLOR_RESET, i);
+            free(slice);
+        }
+    }
+    if (want && !matched) fprintf(stderr, COLOR_RED "[!] No slice for architecture: " COLOR_RESET "%s\n", want);
+    return true;
+}
+
+bool bx_macho(bparser *parser, void *arg)
+{
+    unsigned char magic[4];
+    if (bparser_read(parser, magic, 0, sizeof(magic)) != sizeof(magic)) return false;
+    uint32_t m = rd32be(magic);
+    if (m == FAT_MAGIC || m == FAT_MAGIC_64) return macho_fat(parser, arg);
+    return macho_thin(parser, arg);
+}
@@ -0,0 +1,183 @@
+/**
+ * @file bx_macho.h
+ * @brief Mach-O executables and fat (universal) binaries.
+ *
+ * A fat binary is a big-endian table of architecture slices; each slice is
+ * handed to the Mach-O parser as a zero-copy bparser_slice() of the file.
+ * A Mach-O image is read through its load commands: segments and their
+ * sections, the symbol table, dylibs, entry point, UUID, build version and
+ * the __LINKEDIT blobs. 32/64-bit and both byte orders are handled; the
+ * definitions below mirror <mach-o/loader.h>, <mach-o/nlist.h> and
+ * <mach-o/fat.h>, which are not available on Linux.
+ *
+ * Options (read from the command line):
+ * - `-m`                   Header, load commands, sections and symbols.
+ * - `-a [--function <f>]`  Disassemble the code sections (x86 and x86-64).
+ * - `--arch <name>`        Only this slice of a fat binary (x86_64, arm64...).
+ * - `--scan`, `--carve`, `--hash` As for any file (per slice in a fat binary).
+ */
+#ifndef BX_MACHO_H
+#define BX_MACHO_H
+#include "../bparser/bparser.h"
+#include "../../baseer.h"
+#include "../../utils/ui.h"
+#include <stdint.h>
+
+#define MH_MAGIC        0xfeedface
+#define MH_CIGAM        0xcefaedfe
+#define MH_MAGIC_64     0xfeedfacf
+#define MH_CIGAM_64     0xcffaedfe
+#define FAT_MAGIC       0xcafebabe
+#define FAT_MAGIC_64    0xcafebabf
+
+#define MACHO_HEADER_SIZE    28
+#define MACHO_HEADER_SIZE_64 32
+#define MACHO_FAT_ARCH_SIZE    20
+#define MACHO_FAT_ARCH_SIZE_64 32
+#define MACHO_MAX_FAT_ARCH   32     /**< More is a Java class file (same magic) */
+#define MACHO_MAX_SYMBOLS    (16u * 1024 * 1024)
+
+#define CPU_ARCH_ABI64      0x01000000
+#define CPU_ARCH_ABI64_32   0x02000000
+#define CPU_TYPE_X86        7
+#define CPU_TYPE_X86_64     (CPU_TYPE_X86 | CPU_ARCH_ABI64)
+#define CPU_TYPE_ARM        12
+#define CPU_TYPE_ARM64      (CPU_TYPE_ARM | CPU_ARCH_ABI64)
+#define CPU_TYPE_ARM64_32   (CPU_TYPE_ARM | CPU_ARCH_ABI64_32)
+#define CPU_TYPE_POWERPC    18
+#define CPU_TYPE_POWERPC64  (CPU_TYPE_POWERPC | CPU_ARCH_ABI64)
+#define CPU_SUBTYPE_MASK    0x00ffffff
+
+// load commands
+#define LC_REQ_DYLD             0x80000000
+#define LC_SEGMENT              0x1
+#define LC_SYMTAB               0x2
+#define LC_THREAD               0x4
+#define LC_UNIXTHREAD           0x5
+#define LC_DYSYMTAB             0xb
+#define LC_LOAD_DYLIB           0xc
+#define LC_ID_DYLIB             0xd
+#define LC_LOAD_DYLINKER        0xe
+#define LC_ID_DYLINKER          0xf
+#define LC_LOAD_WEAK_DYLIB      (0x18 | LC_REQ_DYLD)
+#define LC_SEGMENT_64           0x19
+#define LC_UUID                 0x1b
+#define LC_RPATH                (0x1c | LC_REQ_DYLD)
+#define LC_CODE_SIGNATURE       0x1d
+#define LC_SEGMENT_SPLIT_INFO   0x1e
+#define LC_REEXPORT_DYLIB       (0x1f | LC_REQ_DYLD)
+#define LC_ENCRYPTION_INFO      0x21
+#define LC_DYLD_INFO            0x22
+#define LC_DYLD_INFO_ONLY       (0x22 | LC_REQ_DYLD)
+#define LC_VERSION_MIN_MACOSX   0x24
+#define LC_VERSION_MIN_IPHONEOS 0x25
+#define LC_FUNCTION_STARTS      0x26
+#define LC_MAIN                 (0x28 | LC_REQ_DYLD)
+#define LC_DATA_IN_CODE         0x29
+#define LC_SOURCE_VERSION       0x2a
+#define LC_ENCRYPTION_INFO_64   0x2c
+#define LC_VERSION_MIN_TVOS     0x2f
+#define LC_VERSION_MIN_WATCHOS  0x30
+#define LC_BUILD_VERSION        0x32
+#define LC_DYLD_EXPORTS_TRIE    (0x33 | LC_REQ_DYLD)
+#define LC_DYLD_CHAINED_FIXUPS  (0x34 | LC_REQ_DYLD)
+
+// section flags
+#define SECTION_TYPE                0x000000ff
+#define S_ZEROFILL                  0x1
+#define S_GB_ZEROFILL               0xc
+#define S_THREAD_LOCAL_ZEROFILL     0x12
+#define S_ATTR_PURE_INSTRUCTIONS    0x80000000
+#define S_ATTR_SOME_INSTRUCTIONS    0x00000400
+
+// nlist n_type
+#define N_STAB  0xe0
+#define N_PEXT  0x10
+#define N_TYPE  0x0e
+#define N_EXT   0x01
+#define N_UNDF  0x0
+#define N_ABS   0x2
+#define N_SECT  0xe
+#define N_INDR  0xa
+
+/**
+ * @brief One load command (offset into macho_file_t.cmds).
+ */
+typedef struct {
+    uint32_t cmd;
+    uint32_t size;
+    uint32_t off;
+} macho_lc_t;
+
+typedef struct {
+    char name[17];
+    uint64_t vmaddr, vmsize;
+    uint64_t fileoff, filesize;
+    uint32_t maxprot, initprot;
+    uint32_t nsects;        /**< Its sections follow the previous segment's in sections */
+} macho_segment_t;
+
+typedef struct {
+    char segname[17];
+    char sectname[17];
+    uint64_t addr, size;
+    uint32_t offset;
+    uint32_t flags;
+} macho_section_t;
+
+typedef struct {
+    const char *name;       /**< Points into macho_file_t.strtab */
+    uint64_t value;
+    uint8_t type;           /**< n_type */
+    uint8_t sect;           /**< 1-based section index for N_SECT */
+    uint16_t desc;
+} macho_symbol_t;
+
+/**
+ * @brief A parsed Mach-O image.
+ */
+typedef struct {
+    bparser *parser;
+    bool is64;
+    bool swap;              /**< Byte order differs from the host */
+    uint32_t cputype, cpusubtype;
+    uint32_t filetype, flags;
+    unsigned char *cmds;    /**< Copy of the load commands */
+    macho_lc_t *lcs;
+    size_t nlcs;
+    macho_segment_t *segments;
+    size_t nsegments;
+    macho_section_t *sections;
+    size_t nsections;
+    char *strtab;           /**< NUL-terminated copy of the string table */
+    uint32_t strsize;
+    macho_symbol_t *symbols;
+    size_t nsymbols;
+    bool has_entry;
+    uint64_t entry;         /**< Entry point (virtual address) */
+} macho_file_t;
+
+/**
+ * @brief Parse the header, load commands and symbol table of a thin image.
+ *
+ * @return The image (free with macho_close()), NULL if it is not Mach-O or
+ *         its load commands are out of bounds.
+ */
+macho_file_t *macho_open(bparser *parser);
+void macho_close(macho_file_t *m);
+
+/**
+ * @brief Name of a CPU type and subtype ("x86_64", "arm64e"...).
+ */
+const char *macho_arch_name(uint32_t cputype, uint32_t cpusubtype);
+
+/**
+ * @brief Translate a virtual address to a file offset through the segments.
+ *
+ * @return false if no segment maps the address to file data.
+ */
+bool macho_vaddr_to_offset(const macho_file_t *m, uint64_t vaddr, uint64_t *off);
+
+bool bx_macho(bparser *parser, void *arg);
+
+#endif
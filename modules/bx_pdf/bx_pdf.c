@@ -0,0 +1,1256 @@
+/**
+ * @file bx_pdf.c
+ * @brief PDF lexer, cross-reference chain, lazy objects and reports.
+ */
+#define _GNU_SOURCE
+#include "bx_pdf.h"
+#include <ctype.h>
+#include <zlib.h>
+#include "../b_scan/b_scan.h"
+#include "../b_carve/b_carve.h"
+#include "../b_hash/b_hash.h"
+
+// ========================= BEGIN LEXER ==================================
+typedef struct {
+    const unsigned char *p;
+    size_t len, at;
+    bool final;             /**< The buffer reaches the end of the file */
+    bool eof;               /**< A token ran past the end of the buffer */
+    int depth;
+} pdf_lexer_t;
+
+static bool is_ws(unsigned char c)
+{
+    return c == 0 || c == '\t' || c == '\n' || c == '\f' || c == '\r' || c == ' ';
+}
+
+static bool is_delim(unsigned char c)
+{
+    return c == '(' || c == ')' || c == '<' || c == '>' || c == '[' || c == ']' ||
+           c == '{' || c == '}' || c == '/' || c == '%';
+}
+
+static bool is_regular(unsigned char c)
+{
+    return !is_ws(c) && !is_delim(c);
+}
+
+/**
+ * @brief Skip white space and comments.
+ *
+ * @return false at the end of the buffer.
+ */
+static bool skip_ws(pdf_lexer_t *lx)
+{
+    while (lx->at < lx->len) {
+        unsigned char c = lx->p[lx->at];
+        if (is_ws(c)) {
+            lx->at++;
+        } else if (c == '%') {
+            while (lx->at < lx->len && lx->p[lx->at] != '\n' && lx->p[lx->at] != '\r') lx->at++;
+        } else {
+            return true;
+        }
+    }
+    if (!lx->final) lx->eof = true;
+    return false;
+}
+
+/**
+ * @brief Consume a keyword (`obj`, `xref`, `stream`...) if it is next.
+ */
+static bool lex_keyword(pdf_lexer_t *lx, const char *word)
+{
+    if (!skip_ws(lx)) return false;
+    size_t n = strlen(word);
+    if (lx->len - lx->at < n + (lx->final ? 0 : 1)) {
+        if (!lx->final) lx->eof = true;
+        return false;
+    }
+    if (memcmp(lx->p + lx->at, word, n) != 0) return false;
+    if (lx->at + n < lx->len && is_regular(lx->p[lx->at + n])) return false;
+    lx->at += n;
+    return true;
+}
+
+static bool lex_uint(pdf_lexer_t *lx, uint64_t *v)
+{
+    if (!skip_ws(lx)) return false;
+    size_t start = lx->at;
+    *v = 0;
+    while (lx->at < lx->len && isdigit(lx->p[lx->at])) *v = *v * 10 + (lx->p[lx->at++] - '0');
+    if (lx->at == lx->len && !lx->final) lx->eof = true;
+    return lx->at > start;
+}
+
+static pdf_obj_t *new_obj(pdf_type_t type)
+{
+    pdf_obj_t *o = calloc(1, sizeof(*o));
+    if (o) o->type = type;
+    return o;
+}
+
+void pdf_obj_free(pdf_obj_t *obj)
+{
+    if (!obj) return;
+    if (obj->type == PDF_NAME || obj->type == PDF_STRING) {
+        free(obj->str.s);
+    } else if (obj->type == PDF_ARRAY || obj->type == PDF_DICT) {
+        for (size_t i = 0; i < obj->list.n; i++) {
+            pdf_obj_free(obj->list.items[i]);
+            if (obj->list.keys) free(obj->list.keys[i]);
+        }
+        free(obj->list.items);
+        free(obj->list.keys);
+    }
+    free(obj);
+}
+
+static bool list_push(pdf_obj_t *list, char *key, pdf_obj_t *item)
+{
+    size_t n = list->list.n;
+    if (n == 0 || (n >= 4 && (n & (n - 1)) == 0)) {
+        size_t cap = n ? n * 2 : 4;
+        pdf_obj_t **items = realloc(list->list.items, cap * sizeof(*items));
+        if (!items) return false;
+        list->list.items = items;
+        if (list->type == PDF_DICT) {
+            char **keys = realloc(list->list.keys, cap * sizeof(*keys));
+            if (!keys) return false;
+            list->list.keys = keys;
+        }
+    }
+    list->list.items[n] = item;
+    if (list->type == PDF_DICT) list->list.keys[n] = key;
+    list->list.n++;
+    return true;
+}
+
+static pdf_obj_t *parse_value(pdf_lexer_t *lx);
+
+static pdf_obj_t *parse_name(pdf_lexer_t *lx)
+{
+    lx->at++;   // '/'
+    size_t start = lx->at;
+    while (lx->at < lx->len && is_regular(lx->p[lx->at])) lx->at++;
+    if (lx->at == lx->len && !lx->final) lx->eof = true;
+    pdf_obj_t *o = new_obj(PDF_NAME);
+    char *s = o ? malloc(lx->at - start + 1) : NULL;
+    if (!s) {
+        free(o);
+        return NULL;
+    }
+    size_t n = 0;
+    for (size_t i = start; i < lx->at; i++) {
+        // #xx escapes
+        if (lx->p[i] == '#' && i + 2 < lx->at && isxdigit(lx->p[i + 1]) && isxdigit(lx->p[i + 2])) {
+            char hex[3] = {(char)lx->p[i + 1], (char)lx->p[i + 2], 0};
+            s[n++] = (char)strtol(hex, NULL, 16);
+            i += 2;
+        } else {
+            s[n++] = (char)lx->p[i];
+        }
+    }
+    s[n] = '\0';
+    o->str.s = s;
+    o->str.len = n;
+    return o;
+}
+
+static pdf_obj_t *parse_literal(pdf_lexer_t *lx)
+{
+    size_t start = ++lx->at, depth = 1;
+    // first pass: find the end, balanced parentheses
+    for (; lx->at < lx->len; lx->at++) {
+        unsigned char c = lx->p[lx->at];
+        if (c == '\\') lx->at++;
+        else if (c == '(') depth++;
+        else if (c == ')' && --depth == 0) break;
+    }
+    if (lx->at >= lx->len) {
+        if (!lx->final) lx->eof = true;
+        return NULL;
+    }
+    size_t end = lx->at++;
+    pdf_obj_t *o = new_obj(PDF_STRING);
+    char *s = o ? malloc(end - start + 1) : NULL;
+    if (!s) {
+        free(o);
+        return NULL;
+    }
+    size_t n = 0;
+    for (size_t i = start; i < end; i++) {
+        unsigned char c = lx->p[i];
+        if (c != '\\' || i + 1 >= end) {
+            s[n++] = (char)c;
+            continue;
+        }
+        c = lx->p[++i];
+        switch (c) {
+            case 'n': s[n++] = '\n'; break;
+            case 'r': s[n++] = '\r'; break;
+            case 't': s[n++] = '\t'; break;
+            case 'b': s[n++] = '\b'; break;
+            case 'f': s[n++] = '\f'; break;
+            case '\r': if (i + 1 < end && lx->p[i + 1] == '\n') i++; break;   // line continuation
+            case '\n': break;
+            default:
+                if (c >= '0' && c <= '7') {
+                    int v = c - '0';
+                    for (int k = 0; k < 2 && i + 1 < end && lx->p[i + 1] >= '0' && lx->p[i + 1] <= '7'; k++)
+                        v = v * 8 + (lx->p[++i] - '0');
+                    s[n++] = (char)v;
+                } else {
+                    s[n++] = (char)c;
+                }
+        }
+    }
+    s[n] = '\0';
+    o->str.s = s;
+    o->str.len = n;
+    return o;
+}
+
+static pdf_obj_t *parse_hex(pdf_lexer_t *lx)
+{
+    size_t start = ++lx->at;
+    while (lx->at < lx->len && lx->p[lx->at] != '>') lx->at++;
+    if (lx->at >= lx->len) {
+        if (!lx->final) lx->eof = true;
+        return NULL;
+    }
+    size_t end = lx->at++;
+    pdf_obj_t *o = new_obj(PDF_STRING);
+    char *s = o ? malloc((end - start) / 2 + 2) : NULL;
+    if (!s) {
+        free(o);
+        return NULL;
+    }
+    size_t n = 0;
+    int hi = -1;
+    for (size_t i = start; i < end; i++) {
+        int c = lx->p[i];
+        if (!isxdigit(c)) continue;
+        int v = isdigit(c) ? c - '0' : (tolower(c) - 'a' + 10);
+        if (hi < 0) {
+            hi = v;
+        } else {
+            s[n++] = (char)(hi << 4 | v);
+            hi = -1;
+        }
+    }
+    if (hi >= 0) s[n++] = (char)(hi << 4);   // odd count: the last digit is followed by 0
+    s[n] = '\0';
+    o->str.s = s;
+    o->str.len = n;
+    return o;
+}
+
+static pdf_obj_t *parse_container(pdf_lexer_t *lx, bool dict)
+{
+    if (++lx->depth > PDF_MAX_DEPTH) return NULL;
+    lx->at += dict ? 2 : 1;
+    pdf_obj_t *o = new_obj(dict ? PDF_DICT : PDF_ARRAY);
+    while (o) {
+        if (!skip_ws(lx)) goto fail;
+        const unsigned char *p = lx->p + lx->at;
+        if (!dict && p[0] == ']') {
+            lx->at++;
+            break;
+        }
+        if (dict && p[0] == '>') {
+            if (lx->at + 1 >= lx->len) {
+                if (!lx->final) lx->eof = true;
+                goto fail;
+            }
+            if (p[1] != '>') goto fail;
+            lx->at += 2;
+            break;
+        }
+        char *key = NULL;
+        if (dict) {
+            if (p[0] != '/') goto fail;
+            pdf_obj_t *name = parse_name(lx);
+            if (!name) goto fail;
+            key = name->str.s;
+            free(name);
+        }
+        pdf_obj_t *value = parse_value(lx);
+        if (!value || !list_push(o, key, value)) {
+            free(key);
+            pdf_obj_free(value);
+            goto fail;
+        }
+    }
+    lx->depth--;
+    return o;
+
+fail:
+    pdf_obj_free(o);
+    return NULL;
+}
+
+/**
+ * @brief Parse a number, or a reference when it is followed by `<gen> R`.
+ */
+static pdf_obj_t *parse_number(pdf_lexer_t *lx)
+{
+    size_t start = lx->at;
+    if (lx->p[lx->at] == '+' || lx->p[lx->at] == '-') lx->at++;
+    bool real = false;
+    while (lx->at < lx->len && (isdigit(lx->p[lx->at]) || lx->p[lx->at] == '.')) {
+        if (lx->p[lx->at] == '.') real = true;
+        lx->at++;
+    }
+    if (lx->at == lx->len && !lx->final) lx->eof = true;
+    char num[64];
+    size_t n = lx->at - start < sizeof(num) - 1 ? lx->at - start : sizeof(num) - 1;
+    memcpy(num, lx->p + start, n);
+    num[n] = '\0';
+
+    pdf_obj_t *o = new_obj(real ? PDF_REAL : PDF_INT);
+    if (!o) return NULL;
+    if (real) {
+        o->r = strtod(num, NULL);
+        return o;
+    }
+    o->i = strtoll(num, NULL, 10);
+    if (o->i < 0 || num[0] == '+') return o;
+
+    // `num gen R`?
+    size_t save = lx->at;
+    bool eof = lx->eof;
+    uint64_t gen;
+    if (lex_uint(lx, &gen) && skip_ws(lx) && lx->p[lx->at] == 'R' &&
+        (lx->at + 1 >= lx->len || !is_regular(lx->p[lx->at + 1]))) {
+        lx->at++;
+        o->type = PDF_REF;
+        o->ref.num = (uint32_t)o->i;
+        o->ref.gen = (uint32_t)gen;
+        return o;
+    }
+    lx->at = save;
+    lx->eof = eof;
+    return o;
+}
+
+static pdf_obj_t *parse_value(pdf_lexer_t *lx)
+{
+    if (!skip_ws(lx)) return NULL;
+    unsigned char c = lx->p[lx->at];
+    if (c == '/') return parse_name(lx);
+    if (c == '(') return parse_literal(lx);
+    if (c == '[') return parse_container(lx, false);
+    if (c == '<') {
+        if (lx->at + 1 >= lx->len) {
+            if (!lx->final) lx->eof = true;
+            return NULL;
+        }
+        return lx->p[lx->at + 1] == '<' ? parse_container(lx, true) : parse_hex(lx);
+    }
+    if (isdigit(c) || c == '+' || c == '-' || c == '.') return parse_number(lx);
+    bool truth = lex_keyword(lx, "true");
+    if (truth || lex_keyword(lx, "false")) {
+        pdf_obj_t *o = new_obj(PDF_BOOL);
+        if (o) o->b = truth;
+        return o;
+    }
+    if (lex_keyword(lx, "null")) return new_obj(PDF_NULL);
+    return NULL;
+}
+// ========================= END LEXER ==================================
+
+// ========================= BEGIN OBJECTS ==================================
+pdf_obj_t *pdf_dict_get(const pdf_obj_t *dict, const char *key)
+{
+    if (!dict || dict->type != PDF_DICT) return NULL;
+    for (size_t i = 0; i < dict->list.n; i++)
+        if (strcmp(dict->list.keys[i], key) == 0) return dict->list.items[i];
+    return NULL;
+}
+
+pdf_obj_t *pdf_resolve(pdf_doc_t *doc, pdf_obj_t *obj)
+{
+    for (int hops = 0; obj && obj->type == PDF_REF && hops < 8; hops++)
+        obj = pdf_get_object(doc, obj->ref.num);
+    return (obj && obj->type == PDF_REF) ? NULL : obj;
+}
+
+static bool get_int(pdf_doc_t *doc, const pdf_obj_t *dict, const char *key, int64_t *v)
+{
+    pdf_obj_t *o = pdf_resolve(doc, pdf_dict_get(dict, key));
+    if (!o || o->type != PDF_INT) return false;
+    *v = o->i;
+    return true;
+}
+
+static bool name_is(const pdf_obj_t *o, const char *name)
+{
+    return o && o->type == PDF_NAME && strcmp(o->str.s, name) == 0;
+}
+
+/**
+ * @brief Pointer to [off, off + *len) of the file: in place when the file
+ * is in memory (up to the end of the file), read into *tmp otherwise.
+ */
+static const unsigned char *pdf_map(pdf_doc_t *doc, uint64_t off, size_t *len, unsigned char **tmp)
+{
+    bparser *parser = doc->parser;
+    *tmp = NULL;
+    if (off >= parser->size) return NULL;
+    if (parser->block) {
+        *len = parser->size - off;
+        return (const unsigned char*)parser->block + off;
+    }
+    if (*len > parser->size - off) *len = parser->size - off;
+    *tmp = malloc(*len ? *len : 1);
+    if (!*tmp) return NULL;
+    *len = bparser_read(parser, *tmp, off, *len);
+    return *tmp;
+}
+
+typedef bool (*pdf_parse_fn)(pdf_doc_t *doc, pdf_lexer_t *lx, uint64_t off, void *ctx);
+
+/**
+ * @brief Run fn over the file from off, with a window that grows while fn
+ * runs out of data (the whole rest of the file in memory mode).
+ */
+static bool parse_at(pdf_doc_t *doc, uint64_t off, pdf_parse_fn fn, void *ctx)
+{
+    for (size_t window = PDF_WINDOW; ; window *= 4) {
+        size_t len = window;
+        unsigned char *tmp;
+        const unsigned char *p = pdf_map(doc, off, &len, &tmp);
+        if (!p) return false;
+        pdf_lexer_t lx = {.p = p, .len = len, .final = off + len >= doc->parser->size};
+        bool ok = fn(doc, &lx, off, ctx);
+        free(tmp);
+        if (ok || !lx.eof || lx.final) return ok;
+    }
+}
+
+typedef struct {
+    uint32_t num;           /**< Expected object number (UINT32_MAX: any) */
+    pdf_obj_t *value;
+    bool is_stream;
+    uint64_t stream_off;
+} indirect_t;
+
+/**
+ * @brief Parse `num gen obj <value> [stream]`.
+ */
+static bool parse_indirect(pdf_doc_t *doc, pdf_lexer_t *lx, uint64_t off, void *ctx)
+{
+    (void)doc;
+    indirect_t *in = ctx;
+    uint64_t num, gen;
+    if (!lex_uint(lx, &num) || !lex_uint(lx, &gen) || !lex_keyword(lx, "obj")) return false;
+    if (in->num != UINT32_MAX && num != in->num) return false;
+    pdf_obj_t *value = parse_value(lx);
+    if (!value) return false;
+    in->is_stream = false;
+    if (value->type == PDF_DICT && lex_keyword(lx, "stream")) {
+        // the data starts after the end of line that follows `stream`
+        if (lx->at < lx->len && lx->p[lx->at] == '\r') lx->at++;
+        if (lx->at < lx->len && lx->p[lx->at] == '\n') lx->at++;
+        in->is_stream = true;
+        in->stream_off = off + lx->at;
+    } else if (lx->eof) {
+        pdf_obj_free(value);
+        return false;
+    }
+    in->value = value;
+    return true;
+}
+
+/**
+ * @brief Check that `endstream` follows a stream of length len.
+ */
+static bool stream_end_ok(pdf_doc_t *doc, uint64_t off, uint64_t len)
+{
+    unsigned char buf[32];
+    if (off + len < off) return false;
+    size_t n = bparser_read(doc->parser, buf, off + len, sizeof(buf));
+    size_t i = 0;
+    while (i < n && is_ws(buf[i])) i++;
+    return n - i >= 9 && memcmp(buf + i, "endstream", 9) == 0;
+}
+
+/**
+ * @brief Length of a stream whose /Length is missing or wrong: up to the
+ * next `endstream` (minus the end of line in front of it).
+ */
+static uint64_t find_stream_end(pdf_doc_t *doc, uint64_t off)
+{
+    bparser *parser = doc->parser;
+    const size_t chunk = 1024 * 1024;
+    unsigned char *buf = parser->block ? NULL : malloc(chunk + 9);
+    for (uint64_t pos = off; pos < parser->size; pos += chunk) {
+        const unsigned char *p;
+        size_t n;
+        if (parser->block) {
+            p = (const unsigned char*)parser->block + pos;
+            n = parser->size - pos;
+        } else {
+            if (!buf) return 0;
+            n = bparser_read(parser, buf, pos, chunk + 9);
+            p = buf;
+        }
+        const unsigned char *hit = memmem(p, n, "endstream", 9);
+        if (hit) {
+            uint64_t end = pos + (hit - p);
+            if (end > off && (hit > p ? hit[-1] : 0) == '\n') end--;
+            if (end > off && (hit - 1 > p ? hit[-2] : 0) == '\r') end--;
+            free(buf);
+            return end - off;
+        }
+        if (parser->block) break;
+    }
+    free(buf);
+    return 0;
+}
+
+static void set_stream(pdf_doc_t *doc, pdf_xref_t *x, const indirect_t *in)
+{
+    int64_t len = -1;
+    get_int(doc, in->value, "Length", &len);
+    x->is_stream = true;
+    x->stream_off = in->stream_off;
+    if (len >= 0 && stream_end_ok(doc, in->stream_off, (uint64_t)len))
+        x->stream_len = (uint64_t)len;
+    else
+        x->stream_len = find_stream_end(doc, in->stream_off);
+}
+
+/**
+ * @brief Apply a PNG predictor (/Predictor >= 10) in place.
+ *
+ * @return Length of the unfiltered data.
+ */
+static size_t png_unpredict(unsigned char *data, size_t len, size_t row, size_t bpp)
+{
+    size_t rows = len / (row + 1), out = 0;
+    unsigned char *prev = calloc(1, row ? row : 1);
+    if (!prev) return 0;
+    for (size_t r = 0; r < rows; r++) {
+        unsigned char filter = data[r * (row + 1)];
+        unsigned char *cur = data + r * (row + 1) + 1, *dst = data + out;
+        for (size_t i = 0; i < row; i++) {
+            unsigned a = i >= bpp ? dst[i - bpp] : 0, b = prev[i], c = i >= bpp ? prev[i - bpp] : 0;
+            unsigned v = cur[i];
+            switch (filter) {
+                case 1: v += a; break;
+                case 2: v += b; break;
+                case 3: v += (a + b) / 2; break;
+                case 4: {
+                    int pa = abs((int)b - (int)c), pb = abs((int)a - (int)c), pc = abs((int)(a + b) - 2 * (int)c);
+                    v += (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+                    break;
+                }
+                default: break;
+            }
+            dst[i] = (unsigned char)v;
+        }
+        memcpy(prev, dst, row);
+        out += row;
+    }
+    free(prev);
+    return out;
+}
+
+static unsigned char *inflate_all(const unsigned char *in, size_t len, size_t *out_len)
+{
+    size_t cap = len * 4 + 1024;
+    if (cap > PDF_MAX_DECODED) cap = PDF_MAX_DECODED;
+    unsigned char *out = malloc(cap);
+    z_stream zs = {0};
+    if (!out || inflateInit(&zs) != Z_OK) {
+        free(out);
+        return NULL;
+    }
+    zs.next_in = (Bytef*)in;
+    zs.avail_in = (uInt)len;
+    int rc;
+    do {
+        if (zs.total_out == cap) {
+            if (cap >= PDF_MAX_DECODED) break;
+            cap = cap * 2 > PDF_MAX_DECODED ? PDF_MAX_DECODED : cap * 2;
+            unsigned char *grown = realloc(out, cap);
+            if (!grown) break;
+            out = grown;
+        }
+        zs.next_out = out + zs.total_out;
+        zs.avail_out = (uInt)(cap - zs.total_out);
+        rc = inflate(&zs, Z_NO_FLUSH);
+    } while (rc == Z_OK);
+    // damaged streams keep what could be inflated
+    *out_len = zs.total_out;
+    inflateEnd(&zs);
+    return out;
+}
+
+/**
+ * @brief Decode the stream data of dict found at [off, off + stream_len).
+ */
+static unsigned char *decode_stream(pdf_doc_t *doc, pdf_obj_t *dict, uint64_t off, uint64_t stream_len,
+                                    size_t *out_len)
+{
+    pdf_obj_t *filter = pdf_resolve(doc, pdf_dict_get(dict, "Filter"));
+    pdf_obj_t *parms = pdf_resolve(doc, pdf_dict_get(dict, "DecodeParms"));
+    if (filter && filter->type == PDF_ARRAY) {
+        if (filter->list.n > 1) return NULL;
+        filter = filter->list.n ? pdf_resolve(doc, filter->list.items[0]) : NULL;
+        if (parms && parms->type == PDF_ARRAY)
+            parms = parms->list.n ? pdf_resolve(doc, parms->list.items[0]) : NULL;
+    }
+    bool flate = name_is(filter, "FlateDecode") || name_is(filter, "Fl");
+    if (filter && !flate) return NULL;
+
+    size_t len = stream_len;
+    unsigned char *tmp;
+    const unsigned char *raw = pdf_map(doc, off, &len, &tmp);
+    if (!raw) return NULL;
+    if (len > stream_len) len = stream_len;
+    unsigned char *data;
+    if (flate) {
+        data = inflate_all(raw, len, out_len);
+    } else {
+        data = malloc(len ? len : 1);
+        if (data) memcpy(data, raw, len);
+        *out_len = len;
+    }
+    free(tmp);
+
+    int64_t predictor = 1, columns = 1, colors = 1, bpc = 8;
+    get_int(doc, parms, "Predictor", &predictor);
+    get_int(doc, parms, "Columns", &columns);
+    get_int(doc, parms, "Colors", &colors);
+    get_int(doc, parms, "BitsPerComponent", &bpc);
+    if (data && predictor >= 10 && columns > 0 && colors > 0 && bpc > 0) {
+        size_t row = (size_t)((columns * colors * bpc + 7) / 8), bpp = (size_t)((colors * bpc + 7) / 8);
+        *out_len = png_unpredict(data, *out_len, row, bpp);
+    } else if (data && predictor == 2) {
+        free(data);   // TIFF predictor: not used by cross-reference or object streams
+        return NULL;
+    }
+    return data;
+}
+
+unsigned char *pdf_stream_decode(pdf_doc_t *doc, uint32_t num, size_t *len)
+{
+    pdf_obj_t *dict = pdf_get_object(doc, num);
+    if (!dict || !doc->xref[num].is_stream) return NULL;
+    return decode_stream(doc, dict, doc->xref[num].stream_off, doc->xref[num].stream_len, len);
+}
+
+/**
+ * @brief Decode an object stream and parse its header of N `objnum offset` pairs.
+ *
+ * Only the last object stream is kept, so reading every object of a stream
+ * decodes it and lexes its header once.
+ */
+static bool load_objstm(pdf_doc_t *doc, uint32_t stm)
+{
+    if (doc->objstm && doc->objstm_num == stm) return true;
+
+    // /N, /First and /Length may be references into another object stream,
+    // so they are resolved before the cached stream is replaced
+    int64_t n = 0, first = 0;
+    size_t len = 0;
+    unsigned char *data = NULL;
+    pdf_obj_t *dict = pdf_get_object(doc, stm);
+    if (dict && get_int(doc, dict, "N", &n) && get_int(doc, dict, "First", &first))
+        data = pdf_stream_decode(doc, stm, &len);
+    free(doc->objstm);
+    free(doc->objstm_index);
+    doc->objstm = data;
+    doc->objstm_len = len;
+    doc->objstm_num = stm;
+    doc->objstm_index = NULL;
+    doc->objstm_count = 0;
+    if (!data || n < 0 || first < 0 || (uint64_t)first > len) return false;
+    doc->objstm_first = (uint64_t)first;
+
+    // every pair takes at least 4 bytes ("1 2 "), so N cannot exceed that
+    if ((uint64_t)n > (uint64_t)first / 4 + 1) n = (int64_t)(first / 4 + 1);
+    doc->objstm_index = malloc((n ? n : 1) * sizeof(*doc->objstm_index));
+    if (!doc->objstm_index) return false;
+    pdf_lexer_t lx = {.p = doc->objstm, .len = (size_t)first, .final = true};
+    while (doc->objstm_count < (size_t)n) {
+        pdf_objstm_entry_t *e = &doc->objstm_index[doc->objstm_count];
+        if (!lex_uint(&lx, &e->num) || !lex_uint(&lx, &e->off)) break;
+        doc->objstm_count++;
+    }
+    return true;
+}
+
+/**
+ * @brief Load an object packed in an object stream (type 2 entry).
+ */
+static pdf_obj_t *load_compressed(pdf_doc_t *doc, uint32_t num, const pdf_xref_t *x)
+{
+    uint32_t stm = (uint32_t)x->offset;
+    if (stm >= doc->count || doc->xref[stm].type != 1) return NULL;
+    if (!load_objstm(doc, stm) || !doc->objstm_index) return NULL;
+
+    // the xref entry gives the index in the stream; fall back to a search if it is wrong
+    const pdf_objstm_entry_t *found = NULL;
+    if (x->gen < doc->objstm_count && doc->objstm_index[x->gen].num == num) {
+        found = &doc->objstm_index[x->gen];
+    } else {
+        for (size_t i = 0; i < doc->objstm_count && !found; i++)
+            if (doc->objstm_index[i].num == num) found = &doc->objstm_index[i];
+    }
+    if (!found || found->off >= doc->objstm_len - doc->objstm_first) return NULL;
+    pdf_lexer_t body = {.p = doc->objstm, .len = doc->objstm_len, .at = (size_t)(doc->objstm_first + found->off),
+                        .final = true};
+    return parse_value(&body);
+}
+
+pdf_obj_t *pdf_get_object(pdf_doc_t *doc, uint32_t num)
+{
+    if (num >= doc->count) return NULL;
+    pdf_xref_t *x = &doc->xref[num];
+    if (x->loaded) return x->obj;
+    x->loaded = true;   // also stops reference loops while loading
+
+    if (x->type == 1) {
+        indirect_t in = {.num = num};
+        if (parse_at(doc, x->offset, parse_indirect, &in)) {
+            x->obj = in.value;
+            if (in.is_stream) set_stream(doc, x, &in);
+        }
+    } else if (x->type == 2) {
+        x->obj = load_compressed(doc, num, x);
+    }
+    return x->obj;
+}
+// ========================= END OBJECTS ==================================
+
+// ========================= BEGIN CROSS-REFERENCE ==================================
+static pdf_xref_t *xref_slot(pdf_doc_t *doc, uint64_t num)
+{
+    if (num >= PDF_MAX_OBJECTS) return NULL;
+    if (num >= doc->count) {
+        size_t count = doc->count ? doc->count : 64;
+        while (count <= num) count *= 2;
+        pdf_xref_t *grown = realloc(doc->xref, count * sizeof(*grown));
+        if (!grown) return NULL;
+        memset(grown + doc->count, 0, (count - doc->count) * sizeof(*grown));
+        doc->xref = grown;
+        doc->count = count;
+    }
+    return &doc->xref[num];
+}
+
+/**
+ * @brief Record an entry unless a newer section already did.
+ *
+ * Within one section, an in-use entry of the `/XRefStm` stream of a hybrid
+ * file replaces a free entry of its classic table.
+ */
+static void xref_set(pdf_doc_t *doc, uint64_t num, uint16_t section, uint8_t type, uint64_t offset, uint32_t gen)
+{
+    pdf_xref_t *x = xref_slot(doc, num);
+    if (!x) return;
+    if (x->section && !(x->section == section + 1 && x->type == 0)) return;
+    x->section = section + 1;
+    x->type = type;
+    x->offset = offset;
+    x->gen = gen;
+}
+
+typedef struct {
+    uint16_t section;
+    pdf_obj_t *trailer;
+} section_t;
+
+/**
+ * @brief Parse a classic `xref` table and its trailer.
+ */
+static bool parse_xref_table(pdf_doc_t *doc, pdf_lexer_t *lx, uint64_t off, void *ctx)
+{
+    (void)off;
+    section_t *s = ctx;
+    if (!lex_keyword(lx, "xref")) return false;
+    for (;;) {
+        if (lex_keyword(lx, "trailer")) break;
+        uint64_t start, count;
+        if (!lex_uint(lx, &start) || !lex_uint(lx, &count)) return false;
+        for (uint64_t i = 0; i < count; i++) {
+            uint64_t offset, gen;
+            if (!lex_uint(lx, &offset) || !lex_uint(lx, &gen) || !skip_ws(lx)) return false;
+            char kind = (char)lx->p[lx->at++];
+            if (kind != 'n' && kind != 'f') return false;
+            // object 0 is the head of the free list
+            if (kind == 'n' && offset == 0) kind = 'f';
+            xref_set(doc, start + i, s->section, kind == 'n' ? 1 : 0, offset, (uint32_t)gen);
+        }
+    }
+    s->trailer = parse_value(lx);
+    if (s->trailer && s->trailer->type == PDF_DICT) return true;
+    pdf_obj_free(s->trailer);
+    s->trailer = NULL;
+    return false;
+}
+
+static uint64_t read_field(const unsigned char *p, int64_t width)
+{
+    uint64_t v = 0;
+    for (int64_t i = 0; i < width; i++) v = v << 8 | p[i];
+    return v;
+}
+
+/**
+ * @brief Parse a cross-reference stream; its dictionary is the trailer.
+ */
+static bool read_xref_stream(pdf_doc_t *doc, uint64_t off, section_t *s)
+{
+    indirect_t in = {.num = UINT32_MAX};
+    if (!parse_at(doc, off, parse_indirect, &in)) return false;
+    if (!in.is_stream || !name_is(pdf_dict_get(in.value, "Type"), "XRef")) {
+        pdf_obj_free(in.value);
+        return false;
+    }
+
+    pdf_obj_t *w = pdf_dict_get(in.value, "W");
+    int64_t widths[3] = {0}, size = 0;
+    get_int(doc, in.value, "Size", &size);
+    bool ok = w && w->type == PDF_ARRAY && w->list.n == 3;
+    for (int i = 0; ok && i < 3; i++) {
+        ok = w->list.items[i]->type == PDF_INT && w->list.items[i]->i >= 0 && w->list.items[i]->i <= 8;
+        if (ok) widths[i] = w->list.items[i]->i;
+    }
+    unsigned char *data = NULL;
+    size_t len = 0;
+    if (ok) {
+        pdf_xref_t stream = {0};
+        set_stream(doc, &stream, &in);
+        data = decode_stream(doc, in.value, stream.stream_off, stream.stream_len, &len);
+        ok = data != NULL;
+    }
+
+    size_t row = (size_t)(widths[0] + widths[1] + widths[2]), at = 0;
+    pdf_obj_t *index = pdf_dict_get(in.value, "Index");
+    size_t ranges = (index && index->type == PDF_ARRAY) ? index->list.n / 2 : 1;
+    for (size_t r = 0; ok && row && r < ranges; r++) {
+        int64_t start = 0, count = size;
+        if (index && index->type == PDF_ARRAY) {
+            start = index->list.items[2 * r]->type == PDF_INT ? index->list.items[2 * r]->i : 0;
+            count = index->list.items[2 * r + 1]->type == PDF_INT ? index->list.items[2 * r + 1]->i : 0;
+        }
+        for (int64_t i = 0; i < count && at + row <= len; i++, at += row) {
+            const unsigned char *p = data + at;
+            uint64_t type = widths[0] ? read_field(p, widths[0]) : 1;
+            uint64_t f2 = read_field(p + widths[0], widths[1]);
+            uint64_t f3 = read_field(p + widths[0] + widths[1], widths[2]);
+            if (type > 2) continue;
+            if (start + i >= 0) xref_set(doc, (uint64_t)(start + i), s->section, (uint8_t)type, f2, (uint32_t)f3);
+        }
+    }
+    free(data);
+    if (ok) {
+        s->trailer = in.value;
+        doc->stream_sections++;
+    } else {
+        pdf_obj_free(in.value);
+    }
+    return ok;
+}
+
+static bool read_section(pdf_doc_t *doc, uint64_t off, section_t *s)
+{
+    if (parse_at(doc, off, parse_xref_table, s)) {
+        int64_t xrefstm;
+        // hybrid file: the compressed objects are in a stream next to the table
+        if (get_int(doc, s->trailer, "XRefStm", &xrefstm) && xrefstm > 0) {
+            section_t hidden = {.section = s->section};
+            if (read_xref_stream(doc, (uint64_t)xrefstm, &hidden)) pdf_obj_free(hidden.trailer);
+        }
+        return true;
+    }
+    return read_xref_stream(doc, off, s);
+}
+
+/**
+ * @brief Find `startxref <offset>` in the last PDF_TAIL_SIZE bytes.
+ */
+static bool read_startxref(pdf_doc_t *doc)
+{
+    bparser *parser = doc->parser;
+    char tail[PDF_TAIL_SIZE + 1];
+    size_t len = parser->size < PDF_TAIL_SIZE ? parser->size : PDF_TAIL_SIZE;
+    len = bparser_read(parser, tail, parser->size - len, len);
+    tail[len] = '\0';
+    char *hit = NULL;
+    for (char *p = tail; (p = memmem(p, len - (p - tail), "startxref", 9)); p += 9) hit = p;
+    if (!hit) return false;
+    char *end;
+    doc->startxref = strtoull(hit + 9, &end, 10);
+    return end != hit + 9 && doc->startxref < parser->size;
+}
+
+pdf_doc_t *pdf_open(bparser *parser)
+{
+    pdf_doc_t *doc = calloc(1, sizeof(*doc));
+    if (!doc) return NULL;
+    doc->parser = parser;
+    char head[16] = {0};
+    bparser_read(parser, head, 0, sizeof(head) - 1);
+    if (memcmp(head, "%PDF-", 5) == 0) sscanf(head + 5, "%7[0-9.]", doc->version);
+
+    if (!read_startxref(doc)) {
+        fprintf(stderr, COLOR_RED "[!] No startxref in the last %d bytes\n" COLOR_RESET, PDF_TAIL_SIZE);
+        pdf_close(doc);
+        return NULL;
+    }
+    uint64_t visited[PDF_MAX_SECTIONS];
+    uint64_t off = doc->startxref;
+    for (uint16_t n = 0; n < PDF_MAX_SECTIONS; n++) {
+        for (uint16_t i = 0; i < n; i++)
+            if (visited[i] == off) off = 0;   // /Prev loop
+        if (off == 0) break;
+        visited[n] = off;
+        section_t s = {.section = n};
+        if (!read_section(doc, off, &s)) {
+            fprintf(stderr, COLOR_RED "[!] Bad cross-reference section at " COLOR_RESET "0x%llx\n",
+                    (unsigned long long)off);
+            if (n == 0) {
+                pdf_close(doc);
+                return NULL;
+            }
+            break;
+        }
+        doc->sections++;
+        int64_t prev = 0;
+        get_int(doc, s.trailer, "Prev", &prev);
+        off = prev > 0 ? (uint64_t)prev : 0;
+        if (n == 0) doc->trailer = s.trailer;
+        else pdf_obj_free(s.trailer);
+    }
+
+    // entries past the newest /Size are not part of the document
+    int64_t size;
+    if (get_int(doc, doc->trailer, "Size", &size) && size >= 0 && (uint64_t)size < doc->count) {
+        for (size_t i = (size_t)size; i < doc->count; i++) pdf_obj_free(doc->xref[i].obj);
+        doc->count = (size_t)size;
+    }
+    return doc;
+}
+
+void pdf_close(pdf_doc_t *doc)
+{
+    if (!doc) return;
+    for (size_t i = 0; i < doc->count; i++) pdf_obj_free(doc->xref[i].obj);
+    free(doc->xref);
+    pdf_obj_free(doc->trailer);
+    free(doc->objstm);
+    free(doc->objstm_index);
+    free(doc);
+}
+// ========================= END CROSS-REFERENCE ==================================
+
+// ========================= BEGIN REPORTS ==================================
+/**
+ * @brief Print a string, as text (UTF-16BE with a BOM is narrowed).
+ */
+static void print_text(const char *s, size_t len, size_t max)
+{
+    const unsigned char *p = (const unsigned char*)s;
+    size_t step = 1, start = 0;
+    if (len >= 2 && p[0] == 0xfe && p[1] == 0xff) {
+        step = 2;
+        start = 3;
+    }
+    size_t shown = 0;
+    for (size_t i = start; i < len && shown < max; i += step, shown++)
+        putchar(isprint(p[i]) ? p[i] : '.');
+    if ((len - start) / step > max) printf("...");
+}
+
+static void print_obj(const pdf_obj_t *o, int depth)
+{
+    if (!o) {
+        printf("?");
+        return;
+    }
+    switch (o->type) {
+        case PDF_NULL: printf("null"); break;
+        case PDF_BOOL: printf(o->b ? "true" : "false"); break;
+        case PDF_INT: printf("%lld", (long long)o->i); break;
+        case PDF_REAL: printf("%g", o->r); break;
+        case PDF_NAME: printf("/%s", o->str.s); break;
+        case PDF_STRING:
+            printf("(");
+            print_text(o->str.s, o->str.len, 80);
+            printf(")");
+            break;
+        case PDF_REF: printf("%u %u R", o->ref.num, o->ref.gen); break;
+        case PDF_ARRAY:
+        case PDF_DICT: {
+            bool dict = o->type == PDF_DICT;
+            printf(dict ? "<<" : "[");
+            size_t shown = o->list.n < 16 ? o->list.n : 16;
+            for (size_t i = 0; i < shown; i++) {
+                if (dict) printf(" /%s", o->list.keys[i]);
+                printf(" ");
+                if (depth < 4) print_obj(o->list.items[i], depth + 1);
+                else printf("...");
+            }
+            if (o->list.n > shown) printf(" ... (%zu more)", o->list.n - shown);
+            printf(dict ? " >>" : " ]");
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Short description of an object: /Type /Subtype and stream size.
+ */
+static void print_object_line(pdf_doc_t *doc, uint32_t num)
+{
+    const pdf_xref_t *x = &doc->xref[num];
+    pdf_obj_t *o = pdf_get_object(doc, num);
+    printf(COLOR_GREEN "|--[%6u %u] " COLOR_RESET, num, x->type == 1 ? x->gen : 0);
+    if (x->type == 1) printf("0x%010llx        ", (unsigned long long)x->offset);
+    else printf("objstm %6llu #%-4u ", (unsigned long long)x->offset, x->gen);
+    if (!o) {
+        printf(COLOR_RED "unreadable" COLOR_RESET "\n");
+        return;
+    }
+    pdf_obj_t *type = pdf_dict_get(o, "Type"), *subtype = pdf_dict_get(o, "Subtype");
+    if (type && type->type == PDF_NAME) printf("/%s ", type->str.s);
+    if (subtype && subtype->type == PDF_NAME) printf("/%s ", subtype->str.s);
+    if (!type && !subtype) printf("%s ", o->type == PDF_DICT ? "dict" : o->type == PDF_ARRAY ? "array" : "value");
+    if (x->is_stream) {
+        pdf_obj_t *filter = pdf_resolve(doc, pdf_dict_get(o, "Filter"));
+        printf(COLOR_YELLOW " stream %llu bytes" COLOR_RESET, (unsigned long long)x->stream_len);
+        if (filter) {
+            printf(" ");
+            print_obj(filter, 3);
+        }
+    }
+    printf("\n");
+}
+
+static void pdf_metadata(pdf_doc_t *doc)
+{
+    size_t used = 0, compressed = 0;
+    for (size_t i = 0; i < doc->count; i++) {
+        used += doc->xref[i].type != 0;
+        compressed += doc->xref[i].type == 2;
+    }
+    printf(COLOR_BLUE "\n=== PDF ===\n" COLOR_RESET);
+    printf(COLOR_GREEN "|--version   :" COLOR_RESET " %s\n", doc->version[0] ? doc->version : "?");
+    printf(COLOR_GREEN "|--startxref :" COLOR_RESET " 0x%llx\n", (unsigned long long)doc->startxref);
+    printf(COLOR_GREEN "|--sections  :" COLOR_RESET " %zu (%zu cross-reference streams)\n", doc->sections,
+           doc->stream_sections);
+    printf(COLOR_GREEN "|--objects   :" COLOR_RESET " %zu in use, %zu in object streams, size %zu\n", used, compressed,
+           doc->count);
+    printf(COLOR_GREEN "|--root      :" COLOR_RESET " ");
+    print_obj(pdf_dict_get(doc->trailer, "Root"), 0);
+    printf("\n");
+    printf(COLOR_GREEN "|--encrypted :" COLOR_RESET " %s\n", pdf_dict_get(doc->trailer, "Encrypt") ? "yes" : "no");
+
+    pdf_obj_t *info = pdf_resolve(doc, pdf_dict_get(doc->trailer, "Info"));
+    if (info && info->type == PDF_DICT) {
+        printf(COLOR_BLUE "\n=== Info ===\n" COLOR_RESET);
+        for (size_t i = 0; i < info->list.n; i++) {
+            printf(COLOR_GREEN "|--%-10s:" COLOR_RESET " ", info->list.keys[i]);
+            print_obj(pdf_resolve(doc, info->list.items[i]), 0);
+            printf("\n");
+        }
+    }
+}
+
+static void pdf_list(pdf_doc_t *doc)
+{
+    size_t objects = 0, streams = 0;
+    uint64_t stream_bytes = 0;
+    for (size_t i = 0; i < doc->count; i++) {
+        if (doc->xref[i].type == 0) continue;
+        print_object_line(doc, (uint32_t)i);
+        objects++;
+        if (doc->xref[i].is_stream) {
+            streams++;
+            stream_bytes += doc->xref[i].stream_len;
+        }
+    }
+    printf(COLOR_BLUE "%zu objects, %zu streams (%llu bytes)\n" COLOR_RESET, objects, streams,
+           (unsigned long long)stream_bytes);
+}
+
+static void pdf_print_object(pdf_doc_t *doc, const char *arg)
+{
+    char *end;
+    unsigned long num = strtoul(arg, &end, 10);
+    if (*end || num >= doc->count || doc->xref[num].type == 0) {
+        fprintf(stderr, COLOR_RED "[!] No such object: " COLOR_RESET "%s\n", arg);
+        return;
+    }
+    print_object_line(doc, (uint32_t)num);
+    pdf_obj_t *o = pdf_get_object(doc, (uint32_t)num);
+    if (!o) return;
+    print_obj(o, 0);
+    printf("\n");
+    const pdf_xref_t *x = &doc->xref[num];
+    if (x->is_stream)
+        printf(COLOR_GREEN "|--stream    :" COLOR_RESET " 0x%llx (%llu bytes)\n", (unsigned long long)x->stream_off,
+               (unsigned long long)x->stream_len);
+}
+
+typedef void (*pdf_name_fn)(pdf_doc_t *doc, pdf_obj_t *key, pdf_obj_t *value, void *ctx);
+
+/**
+ * @brief Visit the leaves of a name tree (/Names pairs, /Kids nodes).
+ */
+static void walk_name_tree(pdf_doc_t *doc, pdf_obj_t *node, int depth, pdf_name_fn fn, void *ctx)
+{
+    node = pdf_resolve(doc, node);
+    if (!node || node->type != PDF_DICT || depth > PDF_MAX_DEPTH) return;
+    pdf_obj_t *names = pdf_resolve(doc, pdf_dict_get(node, "Names"));
+    if (names && names->type == PDF_ARRAY)
+        for (size_t i = 0; i + 1 < names->list.n; i += 2)
+            fn(doc, pdf_resolve(doc, names->list.items[i]), names->list.items[i + 1], ctx);
+    pdf_obj_t *kids = pdf_resolve(doc, pdf_dict_get(node, "Kids"));
+    if (kids && kids->type == PDF_ARRAY)
+        for (size_t i = 0; i < kids->list.n; i++)
+            walk_name_tree(doc, kids->list.items[i], depth + 1, fn, ctx);
+}
+
+static pdf_obj_t *catalog_names(pdf_doc_t *doc, const char *tree)
+{
+    pdf_obj_t *root = pdf_resolve(doc, pdf_dict_get(doc->trailer, "Root"));
+    pdf_obj_t *names = pdf_resolve(doc, pdf_dict_get(root, "Names"));
+    return pdf_dict_get(names, tree);
+}
+
+static void embedded_file(pdf_doc_t *doc, pdf_obj_t *key, pdf_obj_t *value, void *ctx)
+{
+    size_t *count = ctx;
+    pdf_obj_t *spec = pdf_resolve(doc, value);
+    pdf_obj_t *name = pdf_resolve(doc, pdf_dict_get(spec, "UF"));
+    if (!name) name = pdf_resolve(doc, pdf_dict_get(spec, "F"));
+    if (!name) name = key;
+    printf(COLOR_BLUE "\n=== " COLOR_RESET);
+    if (name && name->type == PDF_STRING) print_text(name->str.s, name->str.len, 200);
+    printf(COLOR_BLUE " ===\n" COLOR_RESET);
+    (*count)++;
+
+    pdf_obj_t *ef = pdf_resolve(doc, pdf_dict_get(spec, "EF"));
+    pdf_obj_t *ref = pdf_dict_get(ef, "F");
+    if (!ref) ref = pdf_dict_get(ef, "UF");
+    if (!ref || ref->type != PDF_REF || !pdf_get_object(doc, ref->ref.num) || !doc->xref[ref->ref.num].is_stream) {
+        fprintf(stderr, COLOR_RED "[!] No embedded file stream\n" COLOR_RESET);
+        return;
+    }
+    const pdf_xref_t *x = &doc->xref[ref->ref.num];
+    pdf_obj_t *stream = x->obj;
+    int64_t size;
+    printf(COLOR_GREEN "|--object    :" COLOR_RESET " %u\n", ref->ref.num);
+    printf(COLOR_GREEN "|--stream    :" COLOR_RESET " 0x%llx (%llu bytes)\n", (unsigned long long)x->stream_off,
+           (unsigned long long)x->stream_len);
+    if (get_int(doc, pdf_resolve(doc, pdf_dict_get(stream, "Params")), "Size", &size))
+        printf(COLOR_GREEN "|--size      :" COLOR_RESET " %lld\n", (long long)size);
+    pdf_obj_t *subtype = pdf_dict_get(stream, "Subtype"), *filter = pdf_resolve(doc, pdf_dict_get(stream, "Filter"));
+    if (subtype) {
+        printf(COLOR_GREEN "|--subtype   :" COLOR_RESET " ");
+        print_obj(subtype, 0);
+        printf("\n");
+    }
+    if (filter) {
+        printf(COLOR_GREEN "|--filter    :" COLOR_RESET " ");
+        print_obj(filter, 0);
+        printf("\n");
+    }
+}
+
+/**
+ * @brief Describe a JavaScript action (`/S /JavaScript /JS ...`).
+ */
+static void javascript_action(pdf_doc_t *doc, const char *where, pdf_obj_t *action, size_t *count)
+{
+    action = pdf_resolve(doc, action);
+    if (!name_is(pdf_dict_get(action, "S"), "JavaScript")) return;
+    (*count)++;
+    printf(COLOR_BLUE "\n=== %s ===\n" COLOR_RESET, where);
+    pdf_obj_t *js = pdf_dict_get(action, "JS");
+    if (js && js->type == PDF_REF && pdf_get_object(doc, js->ref.num) && doc->xref[js->ref.num].is_stream) {
+        size_t len = 0;
+        unsigned char *code = pdf_stream_decode(doc, js->ref.num, &len);
+        printf(COLOR_GREEN "|--stream    :" COLOR_RESET " object %u, %llu bytes", js->ref.num,
+               (unsigned long long)doc->xref[js->ref.num].stream_len);
+        if (code) {
+            printf(", %zu decoded\n" COLOR_GREEN "|--code      :" COLOR_RESET " ", len);
+            print_text((const char*)code, len, 200);
+        }
+        printf("\n");
+        free(code);
+        return;
+    }
+    js = pdf_resolve(doc, js);
+    if (js && js->type == PDF_STRING) {
+        printf(COLOR_GREEN "|--code      :" COLOR_RESET " %zu bytes: ", js->str.len);
+        print_text(js->str.s, js->str.len, 200);
+        printf("\n");
+    }
+}
+
+static void javascript_name(pdf_doc_t *doc, pdf_obj_t *key, pdf_obj_t *value, void *ctx)
+{
+    char where[128] = "JavaScript";
+    if (key && key->type == PDF_STRING) snprintf(where, sizeof(where), "JavaScript %.*s", (int)key->str.len, key->str.s);
+    javascript_action(doc, where, value, ctx);
+}
+
+static void pdf_embedded(pdf_doc_t *doc)
+{
+    size_t count = 0;
+    walk_name_tree(doc, catalog_names(doc, "EmbeddedFiles"), 0, embedded_file, &count);
+    printf(COLOR_BLUE "%zu embedded files\n" COLOR_RESET, count);
+}
+
+static void pdf_javascript(pdf_doc_t *doc)
+{
+    size_t count = 0;
+    walk_name_tree(doc, catalog_names(doc, "JavaScript"), 0, javascript_name, &count);
+    pdf_obj_t *root = pdf_resolve(doc, pdf_dict_get(doc->trailer, "Root"));
+    javascript_action(doc, "OpenAction", pdf_dict_get(root, "OpenAction"), &count);
+    pdf_obj_t *aa = pdf_resolve(doc, pdf_dict_get(root, "AA"));
+    for (size_t i = 0; aa && aa->type == PDF_DICT && i < aa->list.n; i++) {
+        char where[64];
+        snprintf(where, sizeof(where), "AA /%s", aa->list.keys[i]);
+        javascript_action(doc, where, aa->list.items[i], &count);
+    }
+    printf(COLOR_BLUE "%zu JavaScript actions\n" COLOR_RESET, count);
+}
+// ========================= END REPORTS ==================================
+
+bool bx_pdf(bparser *parser, void *arg)
+{
+    int argc = *((inputs*)arg)->argc;
+    char **args = ((inputs*)arg)->args;
+
+    // format-independent tools do not need the cross-reference
+    if (strcmp("--scan", args[2]) == 0 && argc > 3) return bparser_apply(parser, b_scan, arg);
+    if (strcmp("--carve", args[2]) == 0) return bparser_apply(parser, b_carve, arg);
+    if (strcmp("--hash", args[2]) == 0) return bparser_apply(parser, b_hash, arg);
+
+    pdf_doc_t *doc = pdf_open(parser);
+    if (!doc) return false;
+    if (strcmp("-m", args[2]) == 0) {
+        pdf_metadata(doc);
+    } else if (strcmp("-l", args[2]) == 0) {
+        pdf_list(doc);
+    } else if (strcmp("--object", args[2]) == 0 && argc > 3) {
+        pdf_print_object(doc, args[3]);
+    } else if (strcmp("--embedded", args[2]) == 0) {
+        pdf_embedded(doc);
+    } else if (strcmp("--js", args[2]) == 0) {
+        pdf_javascript(doc);
+    } else {
+        fprintf(stderr, "[!] Unsupported flag: %s\n", args[2]);
+    }
+    pdf_close(doc);
+    return true;
+}
@@ -0,0 +1,141 @@
+/**
+ * @file bx_pdf.h
+ * @brief PDF cross-reference parser with lazy object loading.
+ *
+ * Opening a document reads `startxref` from the last kilobyte, then the
+ * cross-reference sections it chains to through `/Prev`: classic `xref`
+ * tables, cross-reference streams (PDF 1.5, FlateDecode with PNG
+ * predictors) and hybrid files (`/XRefStm`). The result is an
+ * object number -> offset index; objects are only parsed when they are
+ * asked for (pdf_get_object()), including objects packed in object
+ * streams, and are cached afterwards.
+ *
+ * Options (read from the command line):
+ * - `-m`              Version, cross-reference sections, trailer and /Info.
+ * - `-l`              Every object: offset, /Type and stream size.
+ * - `--object <n>`    Print one object.
+ * - `--embedded`      Embedded files (the /EmbeddedFiles name tree).
+ * - `--js`            JavaScript (/JavaScript name tree, /OpenAction, /AA).
+ * - `--scan`, `--carve`, `--hash` As for any file.
+ */
+#ifndef BX_PDF_H
+#define BX_PDF_H
+#include "../bparser/bparser.h"
+#include "../../baseer.h"
+#include "../../utils/ui.h"
+#include <stdint.h>
+
+#define PDF_TAIL_SIZE     1024                  /**< Bytes searched for startxref */
+#define PDF_WINDOW        (64 * 1024)           /**< First read when an object is streamed from disk */
+#define PDF_MAX_OBJECTS   (8u * 1024 * 1024)    /**< Largest object number accepted */
+#define PDF_MAX_SECTIONS  4096                  /**< Longest /Prev chain followed */
+#define PDF_MAX_DEPTH     64                    /**< Nesting limit of arrays and dictionaries */
+#define PDF_MAX_DECODED   (256u * 1024 * 1024)  /**< Largest stream decoded in memory */
+
+typedef enum {
+    PDF_NULL,
+    PDF_BOOL,
+    PDF_INT,
+    PDF_REAL,
+    PDF_NAME,               /**< str holds the name without '/' */
+    PDF_STRING,
+    PDF_ARRAY,
+    PDF_DICT,
+    PDF_REF,
+} pdf_type_t;
+
+/**
+ * @brief A parsed PDF value.
+ */
+typedef struct pdf_obj {
+    pdf_type_t type;
+    union {
+        bool b;
+        int64_t i;
+        double r;
+        struct { char *s; size_t len; } str;
+        struct { struct pdf_obj **items; char **keys; size_t n; } list;   /**< keys only for PDF_DICT */
+        struct { uint32_t num, gen; } ref;
+    };
+} pdf_obj_t;
+
+/**
+ * @brief One cross-reference entry, and the object once loaded.
+ */
+typedef struct {
+    uint8_t type;           /**< 0: free, 1: at offset, 2: in an object stream */
+    bool loaded;            /**< obj was parsed (or failed to) */
+    uint16_t section;       /**< Cross-reference section it comes from + 1 (1 = newest, 0 = none) */
+    uint32_t gen;           /**< Generation, or index in the object stream */
+    uint64_t offset;        /**< File offset, or number of the object stream */
+    pdf_obj_t *obj;
+    uint64_t stream_off;    /**< Stream data, when the object is a stream */
+    uint64_t stream_len;
+    bool is_stream;
+} pdf_xref_t;
+
+/**
+ * @brief One `objnum offset` pair of an object stream header.
+ */
+typedef struct {
+    uint64_t num;
+    uint64_t off;           /**< Offset from /First */
+} pdf_objstm_entry_t;
+
+/**
+ * @brief An opened document.
+ */
+typedef struct {
+    bparser *parser;
+    char version[8];
+    uint64_t startxref;
+    size_t sections;
+    size_t stream_sections; /**< Sections that are cross-reference streams */
+    pdf_xref_t *xref;
+    size_t count;           /**< Entries in xref */
+    pdf_obj_t *trailer;     /**< Newest trailer (or cross-reference stream dictionary) */
+    // last decoded object stream, with its header parsed once
+    uint32_t objstm_num;
+    unsigned char *objstm;
+    size_t objstm_len;
+    uint64_t objstm_first;  /**< /First: offset of the first object */
+    pdf_objstm_entry_t *objstm_index;
+    size_t objstm_count;
+} pdf_doc_t;
+
+/**
+ * @brief Read the cross-reference chain of a document.
+ *
+ * @return The document (free with pdf_close()), NULL if startxref or the
+ *         newest section cannot be parsed.
+ */
+pdf_doc_t *pdf_open(bparser *parser);
+void pdf_close(pdf_doc_t *doc);
+
+/**
+ * @brief Load (once) and return object num, NULL if it is free or broken.
+ */
+pdf_obj_t *pdf_get_object(pdf_doc_t *doc, uint32_t num);
+
+/**
+ * @brief Follow references until a direct value.
+ */
+pdf_obj_t *pdf_resolve(pdf_doc_t *doc, pdf_obj_t *obj);
+
+/**
+ * @brief Value of /key in a dictionary (key without '/'), NULL if absent.
+ */
+pdf_obj_t *pdf_dict_get(const pdf_obj_t *dict, const char *key);
+
+/**
+ * @brief Decode a stream object (no filter, or FlateDecode with predictors).
+ *
+ * @return The data (free with free()), NULL for other filters.
+ */
+unsigned char *pdf_stream_decode(pdf_doc_t *doc, uint32_t num, size_t *len);
+
+void pdf_obj_free(pdf_obj_t *obj);
+
+bool bx_pdf(bparser *parser, void *arg);
+
+#endif
@@ -0,0 +1,723 @@
+/**
+ * @file bx_pe.c
+ * @brief PE/COFF headers, imports, exports, symbols and disassembly.
+ */
+#include "bx_pe.h"
+#include <time.h>
+#include "../bx_elf_utils/bx_elf_utils.h"
+#include "../b_scan/b_scan.h"
+#include "../b_carve/b_carve.h"
+#include "../b_hash/b_hash.h"
+
+#define PE_MAX_OPT_HEADER 240   /**< PE32+ with 16 data directories */
+
+const char *pe_machine_name(uint16_t machine)
+{
+    switch (machine) {
+        case PE_MACHINE_I386: return "i386";
+        case PE_MACHINE_AMD64: return "x86-64";
+        case PE_MACHINE_ARM: return "arm";
+        case PE_MACHINE_ARMNT: return "arm (thumb-2)";
+        case PE_MACHINE_ARM64: return "arm64";
+        case 0xa641: return "arm64ec";
+        case PE_MACHINE_IA64: return "ia64";
+        case 0x5064: return "riscv64";
+        case 0x6264: return "loongarch64";
+        case 0x0ebc: return "efi byte code";
+        case 0: return "any";
+        default: return "unknown";
+    }
+}
+
+/**
+ * @brief .NET ReadyToRun images xor the machine with a per-OS value.
+ *
+ * @return The OS, NULL if the machine is not one of those.
+ */
+static const char *r2r_os(uint16_t machine, uint16_t *native)
+{
+    static const struct { uint16_t key; const char *os; } oses[] = {
+        {0x4644, "macOS"}, {0x7b79, "Linux"}, {0xadc4, "FreeBSD"}, {0x1993, "NetBSD"}, {0x1992, "SunOS"},
+    };
+    for (size_t i = 0; i < sizeof(oses) / sizeof(*oses); i++) {
+        uint16_t m = machine ^ oses[i].key;
+        if (m == PE_MACHINE_I386 || m == PE_MACHINE_AMD64 || m == PE_MACHINE_ARMNT || m == PE_MACHINE_ARM64) {
+            *native = m;
+            return oses[i].os;
+        }
+    }
+    return NULL;
+}
+
+static const char *subsystem_name(uint16_t subsystem)
+{
+    switch (subsystem) {
+        case 1: return "Native";
+        case 2: return "Windows GUI";
+        case 3: return "Windows CUI";
+        case 5: return "OS/2 CUI";
+        case 7: return "POSIX CUI";
+        case 9: return "Windows CE GUI";
+        case 10: return "EFI application";
+        case 11: return "EFI boot service driver";
+        case 12: return "EFI runtime driver";
+        case 13: return "EFI ROM";
+        case 14: return "Xbox";
+        case 16: return "Windows boot application";
+        default: return "unknown";
+    }
+}
+
+static const char *dir_names[PE_MAX_DIRS] = {
+    "Export", "Import", "Resource", "Exception", "Security", "BaseReloc", "Debug", "Architecture",
+    "GlobalPtr", "TLS", "LoadConfig", "BoundImport", "IAT", "DelayImport", "CLR", "Reserved",
+};
+
+typedef struct {
+    uint32_t bit;
+    const char *name;
+} pe_flag_t;
+
+static const pe_flag_t file_flags[] = {
+    {0x0001, "RELOCS_STRIPPED"}, {0x0002, "EXECUTABLE_IMAGE"}, {0x0020, "LARGE_ADDRESS_AWARE"},
+    {0x0100, "32BIT_MACHINE"}, {0x0200, "DEBUG_STRIPPED"}, {0x1000, "SYSTEM"}, {PE_FILE_DLL, "DLL"},
+};
+
+static const pe_flag_t dll_flags[] = {
+    {0x0020, "HIGH_ENTROPY_VA"}, {0x0040, "DYNAMIC_BASE"}, {0x0080, "FORCE_INTEGRITY"}, {0x0100, "NX_COMPAT"},
+    {0x0200, "NO_ISOLATION"}, {0x0400, "NO_SEH"}, {0x0800, "NO_BIND"}, {0x1000, "APPCONTAINER"},
+    {0x2000, "WDM_DRIVER"}, {0x4000, "GUARD_CF"}, {0x8000, "TERMINAL_SERVER_AWARE"},
+};
+
+// ========================= BEGIN PARSER ==================================
+bool pe_rva_to_offset(const pe_file_t *pe, uint32_t rva, uint64_t *off, uint64_t *avail)
+{
+    uint64_t o, a;
+    if (!b_addrmap_va_to_off(pe->map, rva, &o, &a) || o >= pe->parser->size) return false;
+    if (a > pe->parser->size - o) a = pe->parser->size - o;
+    if (off) *off = o;
+    if (avail) *avail = a;
+    return true;
+}
+
+/**
+ * @brief Read len bytes at an RVA, false unless they are all backed by the file.
+ */
+static bool pe_read(const pe_file_t *pe, uint32_t rva, void *buf, size_t len)
+{
+    uint64_t off, avail;
+    return pe_rva_to_offset(pe, rva, &off, &avail) && avail >= len && bparser_read(pe->parser, buf, off, len) == len;
+}
+
+/**
+ * @brief Read a NUL-terminated string at an RVA (truncated to cap - 1 bytes).
+ */
+static bool pe_string(const pe_file_t *pe, uint32_t rva, char *buf, size_t cap)
+{
+    uint64_t off, avail;
+    buf[0] = '\0';
+    if (!pe_rva_to_offset(pe, rva, &off, &avail)) return false;
+    size_t n = avail < cap - 1 ? (size_t)avail : cap - 1;
+    n = bparser_read(pe->parser, buf, off, n);
+    buf[n] = '\0';
+    return true;
+}
+
+/**
+ * @brief Copy up to *count elements of an array at an RVA; *count is set to
+ * the number the file actually holds.
+ *
+ * @return The elements (free with free()), NULL if none.
+ */
+static unsigned char *pe_array(const pe_file_t *pe, uint32_t rva, size_t elem, size_t *count)
+{
+    uint64_t off, avail;
+    if (!*count || !pe_rva_to_offset(pe, rva, &off, &avail) || avail < elem) {
+        *count = 0;
+        return NULL;
+    }
+    if (*count > avail / elem) *count = avail / elem;
+    unsigned char *out = malloc(*count * elem);
+    if (!out || bparser_read(pe->parser, out, off, *count * elem) != *count * elem) {
+        free(out);
+        *count = 0;
+        return NULL;
+    }
+    return out;
+}
+
+static void parse_optional(pe_file_t *pe, const unsigned char *opt, size_t len)
+{
+    pe->opt_magic = rd16le(opt);
+    if (pe->opt_magic != PE_OPT_MAGIC_PE32 && pe->opt_magic != PE_OPT_MAGIC_PE32P) return;
+    // opt is zero-filled past len, short headers read as zeros
+    pe->is64 = pe->opt_magic == PE_OPT_MAGIC_PE32P;
+    pe->linker_major = opt[2];
+    pe->linker_minor = opt[3];
+    pe->entry = rd32le(opt + 16);
+    pe->image_base = pe->is64 ? rd64le(opt + 24) : rd32le(opt + 28);
+    pe->section_align = rd32le(opt + 32);
+    pe->file_align = rd32le(opt + 36);
+    pe->os_major = rd16le(opt + 40);
+    pe->os_minor = rd16le(opt + 42);
+    pe->subsystem_major = rd16le(opt + 48);
+    pe->subsystem_minor = rd16le(opt + 50);
+    pe->size_of_image = rd32le(opt + 56);
+    pe->size_of_headers = rd32le(opt + 60);
+    pe->checksum = rd32le(opt + 64);
+    pe->subsystem = rd16le(opt + 68);
+    pe->dll_characteristics = rd16le(opt + 70);
+
+    size_t dirs = pe->is64 ? 112 : 96;
+    uint32_t ndirs = rd32le(opt + dirs - 4);
+    if (ndirs > PE_MAX_DIRS) ndirs = PE_MAX_DIRS;
+    if (len < dirs) ndirs = 0;
+    else if (ndirs > (len - dirs) / 8) ndirs = (uint32_t)((len - dirs) / 8);
+    pe->ndirs = ndirs;
+    for (uint32_t i = 0; i < ndirs; i++) {
+        pe->dirs[i].rva = rd32le(opt + dirs + i * 8);
+        pe->dirs[i].size = rd32le(opt + dirs + i * 8 + 4);
+    }
+}
+
+/**
+ * @brief Load the COFF string table (section long names, symbol names).
+ */
+static char *load_strtab(const pe_file_t *pe, uint32_t *size)
+{
+    *size = 0;
+    if (!pe->symtab_off || pe->symtab_off > pe->parser->size) return NULL;
+    uint64_t off = pe->symtab_off + (uint64_t)pe->nsymtab * PE_SYMBOL_SIZE;
+    unsigned char len[4];
+    if (off > pe->parser->size || bparser_read(pe->parser, len, off, sizeof(len)) != sizeof(len)) return NULL;
+    uint64_t n = rd32le(len);
+    if (n < 4) return NULL;
+    if (n > pe->parser->size - off) n = pe->parser->size - off;
+    // offsets count from the size field
+    char *tab = malloc(n + 1);
+    if (!tab) return NULL;
+    n = bparser_read(pe->parser, tab, off, n);
+    tab[n] = '\0';
+    *size = (uint32_t)n;
+    return tab;
+}
+
+static void parse_symbols(pe_file_t *pe, const char *strtab, uint32_t strsize)
+{
+    if (!pe->symtab_off || pe->symtab_off >= pe->parser->size) return;
+    size_t count = pe->nsymtab < PE_MAX_SYMBOLS ? pe->nsymtab : PE_MAX_SYMBOLS;
+    if (count > (pe->parser->size - pe->symtab_off) / PE_SYMBOL_SIZE)
+        count = (pe->parser->size - pe->symtab_off) / PE_SYMBOL_SIZE;
+    unsigned char *raw = malloc(count * PE_SYMBOL_SIZE + 1);
+    pe->symbols = calloc(count + 1, sizeof(*pe->symbols));
+    if (!raw || !pe->symbols || bparser_read(pe->parser, raw, pe->symtab_off, count * PE_SYMBOL_SIZE) != count * PE_SYMBOL_SIZE) {
+        free(raw);
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        const unsigned char *r = raw + i * PE_SYMBOL_SIZE;
+        pe_symbol_t *s = &pe->symbols[pe->nsymbols];
+        if (rd32le(r) == 0) {
+            uint32_t at = rd32le(r + 4);
+            s->name = strdup(strtab && at >= 4 && at < strsize ? strtab + at : "");
+        } else {
+            s->name = strndup((const char*)r, 8);
+        }
+        if (!s->name) break;
+        s->value = rd32le(r + 8);
+        s->section = (int16_t)rd16le(r + 12);
+        s->type = rd16le(r + 14);
+        s->sclass = r[16];
+        if (s->section > 0 && s->section <= pe->nsections) s->value += pe->sections[s->section - 1].vaddr;
+        pe->nsymbols++;
+        i += r[17];     // auxiliary records
+    }
+    free(raw);
+}
+
+pe_file_t *pe_open(bparser *parser)
+{
+    unsigned char dos[PE_DOS_HEADER_SIZE];
+    if (bparser_read(parser, dos, 0, sizeof(dos)) != sizeof(dos) || rd16le(dos) != PE_DOS_SIGNATURE) return NULL;
+    uint32_t pe_off = rd32le(dos + 0x3c);
+    unsigned char head[4 + PE_COFF_HEADER_SIZE];
+    if (pe_off > parser->size || bparser_read(parser, head, pe_off, sizeof(head)) != sizeof(head) ||
+        rd32le(head) != PE_SIGNATURE) {
+        fprintf(stderr, COLOR_RED "[!] No PE signature at e_lfanew " COLOR_RESET "0x%x (DOS executable?)\n", pe_off);
+        return NULL;
+    }
+
+    pe_file_t *pe = calloc(1, sizeof(*pe));
+    if (!pe) return NULL;
+    pe->parser = parser;
+    pe->pe_off = pe_off;
+    pe->machine = rd16le(head + 4);
+    pe->nsections = rd16le(head + 6);
+    pe->timestamp = rd32le(head + 8);
+    pe->symtab_off = rd32le(head + 12);
+    pe->nsymtab = rd32le(head + 16);
+    uint16_t optsize = rd16le(head + 20);
+    pe->characteristics = rd16le(head + 22);
+
+    unsigned char opt[PE_MAX_OPT_HEADER] = {0};
+    size_t optlen = optsize < sizeof(opt) ? optsize : sizeof(opt);
+    optlen = bparser_read(parser, opt, pe_off + sizeof(head), optlen);
+    parse_optional(pe, opt, optlen);
+
+    // section table
+    uint64_t table = (uint64_t)pe_off + sizeof(head) + optsize;
+    size_t fits = table < parser->size ? (parser->size - table) / PE_SECTION_SIZE : 0;
+    if (pe->nsections > fits) {
+        fprintf(stderr, COLOR_RED "[!] Section table truncated: " COLOR_RESET "%zu of %u sections\n", fits,
+                pe->nsections);
+        pe->nsections = (uint16_t)fits;
+    }
+    unsigned char *raw = malloc(pe->nsections * PE_SECTION_SIZE + 1);
+    pe->sections = calloc(pe->nsections + 1, sizeof(*pe->sections));
+    pe->map = b_addrmap_create();
+    if (!raw || !pe->sections || !pe->map ||
+        bparser_read(parser, raw, table, pe->nsections * PE_SECTION_SIZE) != pe->nsections * PE_SECTION_SIZE) {
+        free(raw);
+        pe_close(pe);
+        return NULL;
+    }
+    uint32_t strsize;
+    char *strtab = load_strtab(pe, &strsize);
+    for (uint16_t i = 0; i < pe->nsections; i++) {
+        const unsigned char *r = raw + i * PE_SECTION_SIZE;
+        pe_section_t *s = &pe->sections[i];
+        memcpy(s->name, r, 8);
+        s->name[8] = '\0';
+        if (s->name[0] == '/' && strtab) {
+            // "/n": offset into the string table (MinGW debug sections)
+            unsigned long at = strtoul(s->name + 1, NULL, 10);
+            if (at >= 4 && at < strsize) snprintf(s->name, sizeof(s->name), "%s", strtab + at);
+        }
+        s->vsize = rd32le(r + 8);
+        s->vaddr = rd32le(r + 12);
+        s->raw_size = rd32le(r + 16);
+        s->raw_off = rd32le(r + 20);
+        s->flags = rd32le(r + 36);
+    }
+    free(raw);
+    parse_symbols(pe, strtab, strsize);
+    free(strtab);
+
+    // RVA map: the headers, then every section as the loader maps it
+    uint64_t headers = pe->size_of_headers ? pe->size_of_headers : table + pe->nsections * PE_SECTION_SIZE;
+    if (headers > parser->size) headers = parser->size;
+    b_addrmap_add_segment(pe->map, 0, headers, 0, headers, -1);
+    for (uint16_t i = 0; i < pe->nsections; i++) {
+        const pe_section_t *s = &pe->sections[i];
+        uint64_t off = s->raw_off, memsz = s->vsize ? s->vsize : s->raw_size;
+        if (pe->file_align >= 0x200) off &= ~(uint64_t)0x1ff;   // the loader rounds PointerToRawData down
+        uint64_t filesz = s->raw_size < memsz ? s->raw_size : memsz;
+        if (off >= parser->size) filesz = 0;
+        else if (filesz > parser->size - off) filesz = parser->size - off;
+        b_addrmap_add_segment(pe->map, s->vaddr, memsz, off, filesz, i);
+        b_addrmap_add_section(pe->map, s->vaddr, memsz, off, filesz, i, true);
+    }
+    b_addrmap_finalize(pe->map);
+    return pe;
+}
+
+void pe_close(pe_file_t *pe)
+{
+    if (!pe) return;
+    for (size_t i = 0; i < pe->nsymbols; i++) free(pe->symbols[i].name);
+    free(pe->symbols);
+    free(pe->sections);
+    b_addrmap_free(pe->map);
+    free(pe);
+}
+
+/**
+ * @brief One exported function.
+ */
+typedef struct {
+    uint32_t ordinal;
+    uint32_t rva;
+    char *name;             /**< NULL when only exported by ordinal */
+    char *forwarder;        /**< "DLL.Function" when rva points into the export directory */
+} pe_export_t;
+
+static void free_exports(pe_export_t *exports, size_t count)
+{
+    if (!exports) return;
+    for (size_t i = 0; i < count; i++) {
+        free(exports[i].name);
+        free(exports[i].forwarder);
+    }
+    free(exports);
+}
+
+/**
+ * @brief Read the export directory.
+ *
+ * @param dll Receives the DLL name.
+ * @param count Receives the number of entries (unused ordinals included, rva 0).
+ * @return The exports indexed by ordinal - base (free with free_exports()).
+ */
+static pe_export_t *read_exports(const pe_file_t *pe, char dll[PE_MAX_NAME], size_t *count)
+{
+    *count = 0;
+    dll[0] = '\0';
+    const pe_dir_t *dir = &pe->dirs[PE_DIR_EXPORT];
+    unsigned char d[40];
+    if (pe->ndirs <= PE_DIR_EXPORT || !dir->rva || !pe_read(pe, dir->rva, d, sizeof(d))) return NULL;
+    pe_string(pe, rd32le(d + 12), dll, PE_MAX_NAME);
+    uint32_t base = rd32le(d + 16);
+    size_t nfuncs = rd32le(d + 20), nnames = rd32le(d + 24);
+    if (nfuncs > PE_MAX_ENTRIES) nfuncs = PE_MAX_ENTRIES;
+    if (nnames > PE_MAX_ENTRIES) nnames = PE_MAX_ENTRIES;
+    unsigned char *funcs = pe_array(pe, rd32le(d + 28), 4, &nfuncs);
+    size_t nords = nnames;
+    unsigned char *names = pe_array(pe, rd32le(d + 32), 4, &nnames);
+    unsigned char *ords = pe_array(pe, rd32le(d + 36), 2, &nords);
+    pe_export_t *out = funcs ? calloc(nfuncs, sizeof(*out)) : NULL;
+    if (!out) {
+        free(funcs);
+        free(names);
+        free(ords);
+        return NULL;
+    }
+
+    char buf[PE_MAX_NAME];
+    for (size_t i = 0; i < nfuncs; i++) {
+        out[i].ordinal = base + (uint32_t)i;
+        out[i].rva = rd32le(funcs + i * 4);
+        if (out[i].rva >= dir->rva && out[i].rva - dir->rva < dir->size && pe_string(pe, out[i].rva, buf, sizeof(buf)))
+            out[i].forwarder = strdup(buf);
+    }
+    for (size_t i = 0; i < nnames && i < nords; i++) {
+        uint16_t index = rd16le(ords + i * 2);
+        if (index < nfuncs && !out[index].name && pe_string(pe, rd32le(names + i * 4), buf, sizeof(buf)))
+            out[index].name = strdup(buf);
+    }
+    free(funcs);
+    free(names);
+    free(ords);
+    *count = nfuncs;
+    return out;
+}
+// ========================= END PARSER ==================================
+
+// ========================= BEGIN METADATA ==================================
+static void print_flags(uint32_t value, const pe_flag_t *flags, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        if (value & flags[i].bit) printf(" %s", flags[i].name);
+    printf("\n");
+}
+
+static const char *section_of(const pe_file_t *pe, uint32_t rva)
+{
+    int i = b_addrmap_va_to_section(pe->map, rva);
+    return i >= 0 ? pe->sections[i].name : "-";
+}
+
+/**
+ * @brief List the names (or ordinals) of an import lookup table, with the
+ * address of the IAT slot each one is bound to.
+ */
+static size_t print_thunks(const pe_file_t *pe, uint32_t lookup, uint32_t iat)
+{
+    size_t width = pe->is64 ? 8 : 4, count = PE_MAX_ENTRIES;
+    unsigned char *thunks = pe_array(pe, lookup, width, &count);
+    uint64_t ordinal_flag = pe->is64 ? 1ull << 63 : 1ull << 31;
+    char name[PE_MAX_NAME];
+    size_t k = 0;
+    for (; k < count; k++) {
+        uint64_t t = pe->is64 ? rd64le(thunks + k * width) : rd32le(thunks + k * width);
+        if (t == 0) break;
+        uint64_t slot = pe->image_base + iat + k * width;
+        if (t & ordinal_flag) {
+            printf("|----0x%08llx ordinal %u\n", (unsigned long long)slot, (unsigned)(t & 0xffff));
+            continue;
+        }
+        unsigned char hint[2] = {0, 0};
+        uint32_t at = (uint32_t)(t & 0x7fffffff);
+        pe_read(pe, at, hint, sizeof(hint));
+        if (!pe_string(pe, at + 2, name, sizeof(name))) snprintf(name, sizeof(name), "<bad rva 0x%x>", at);
+        printf("|----0x%08llx %-40s hint %u\n", (unsigned long long)slot, name, rd16le(hint));
+    }
+    free(thunks);
+    return k;
+}
+
+static void print_imports(const pe_file_t *pe)
+{
+    const pe_dir_t *dir = &pe->dirs[PE_DIR_IMPORT];
+    if (pe->ndirs <= PE_DIR_IMPORT || !dir->rva) return;
+    printf(COLOR_BLUE "\n=== Imports ===\n" COLOR_RESET);
+    char dll[PE_MAX_NAME];
+    for (uint32_t i = 0; i < PE_MAX_ENTRIES; i++) {
+        unsigned char d[20];
+        static const unsigned char zero[20];
+        if (!pe_read(pe, dir->rva + i * 20, d, sizeof(d)) || memcmp(d, zero, sizeof(d)) == 0) break;
+        uint32_t lookup = rd32le(d), iat = rd32le(d + 16);
+        pe_string(pe, rd32le(d + 12), dll, sizeof(dll));
+        printf(COLOR_GREEN "|--%s" COLOR_RESET "\n", dll);
+        // the IAT doubles as lookup table when there is no ILT (old Borland linkers)
+        print_thunks(pe, lookup ? lookup : iat, iat);
+    }
+}
+
+static void print_delay_imports(const pe_file_t *pe)
+{
+    const pe_dir_t *dir = &pe->dirs[PE_DIR_DELAY_IMPORT];
+    if (pe->ndirs <= PE_DIR_DELAY_IMPORT || !dir->rva) return;
+    printf(COLOR_BLUE "\n=== Delay Imports ===\n" COLOR_RESET);
+    char dll[PE_MAX_NAME];
+    for (uint32_t i = 0; i < PE_MAX_ENTRIES; i++) {
+        unsigned char d[32];
+        if (!pe_read(pe, dir->rva + i * 32, d, sizeof(d)) || rd32le(d + 4) == 0) break;
+        // version 1 descriptors (attributes bit 0 clear) hold VAs
+        uint32_t bias = (rd32le(d) & 1) ? 0 : (uint32_t)pe->image_base;
+        uint32_t name = rd32le(d + 4) - bias, iat = rd32le(d + 12) - bias, lookup = rd32le(d + 16) - bias;
+        pe_string(pe, name, dll, sizeof(dll));
+        printf(COLOR_GREEN "|--%s" COLOR_RESET "\n", dll);
+        print_thunks(pe, lookup, iat);
+    }
+}
+
+static void print_exports(const pe_file_t *pe)
+{
+    char dll[PE_MAX_NAME];
+    size_t count;
+    pe_export_t *exports = read_exports(pe, dll, &count);
+    if (!exports) return;
+    printf(COLOR_BLUE "\n=== Exports (%s) ===\n" COLOR_RESET, dll[0] ? dll : "-");
+    for (size_t i = 0; i < count; i++) {
+        const pe_export_t *e = &exports[i];
+        if (!e->rva) continue;      // unused ordinal
+        if (e->forwarder)
+            printf("|--[%5u] %-40s -> %s\n", e->ordinal, e->name ? e->name : "-", e->forwarder);
+        else
+            printf("|--[%5u] 0x%08x %s\n", e->ordinal, e->rva, e->name ? e->name : "-");
+    }
+    free_exports(exports, count);
+}
+
+static void pe_metadata(const pe_file_t *pe)
+{
+    printf(COLOR_BLUE "\n=== PE Header ===\n" COLOR_RESET);
+    printf(COLOR_GREEN "|--e_lfanew  :" COLOR_RESET " 0x%x\n", pe->pe_off);
+    uint16_t native;
+    const char *os = r2r_os(pe->machine, &native);
+    if (os)
+        printf(COLOR_GREEN "|--machine   :" COLOR_RESET " %s, ReadyToRun for %s (0x%04x)\n", pe_machine_name(native), os,
+               pe->machine);
+    else
+        printf(COLOR_GREEN "|--machine   :" COLOR_RESET " %s (0x%04x)\n", pe_machine_name(pe->machine), pe->machine);
+    printf(COLOR_GREEN "|--sections  :" COLOR_RESET " %u\n", pe->nsections);
+    time_t t = pe->timestamp;
+    struct tm tm;
+    char date[32] = "-";
+    if (gmtime_r(&t, &tm)) strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S UTC", &tm);
+    printf(COLOR_GREEN "|--timestamp :" COLOR_RESET " 0x%08x (%s)\n", pe->timestamp, date);
+    printf(COLOR_GREEN "|--flags     :" COLOR_RESET " 0x%04x", pe->characteristics);
+    print_flags(pe->characteristics, file_flags, sizeof(file_flags) / sizeof(*file_flags));
+    if (pe->symtab_off)
+        printf(COLOR_GREEN "|--symbols   :" COLOR_RESET " %u records at 0x%x\n", pe->nsymtab, pe->symtab_off);
+
+    printf(COLOR_BLUE "\n=== Optional Header ===\n" COLOR_RESET);
+    if (pe->opt_magic != PE_OPT_MAGIC_PE32 && pe->opt_magic != PE_OPT_MAGIC_PE32P) {
+        printf(COLOR_GREEN "|--magic     :" COLOR_RESET " 0x%x (unknown)\n", pe->opt_magic);
+    } else {
+        printf(COLOR_GREEN "|--format    :" COLOR_RESET " %s (0x%x)\n", pe->is64 ? "PE32+" : "PE32", pe->opt_magic);
+        printf(COLOR_GREEN "|--linker    :" COLOR_RESET " %u.%u\n", pe->linker_major, pe->linker_minor);
+        if (pe->entry)
+            printf(COLOR_GREEN "|--entry     :" COLOR_RESET " 0x%x (VA 0x%llx, %s)\n", pe->entry,
+                   (unsigned long long)(pe->image_base + pe->entry), section_of(pe, pe->entry));
+        printf(COLOR_GREEN "|--image base:" COLOR_RESET " 0x%llx\n", (unsigned long long)pe->image_base);
+        printf(COLOR_GREEN "|--alignment :" COLOR_RESET " section 0x%x, file 0x%x\n", pe->section_align,
+               pe->file_align);
+        printf(COLOR_GREEN "|--size      :" COLOR_RESET " image 0x%x, headers 0x%x\n", pe->size_of_image,
+               pe->size_of_headers);
+        printf(COLOR_GREEN "|--os        :" COLOR_RESET " %u.%u\n", pe->os_major, pe->os_minor);
+        printf(COLOR_GREEN "|--subsystem :" COLOR_RESET " %s (%u) %u.%u\n", subsystem_name(pe->subsystem),
+               pe->subsystem, pe->subsystem_major, pe->subsystem_minor);
+        printf(COLOR_GREEN "|--dll flags :" COLOR_RESET " 0x%04x", pe->dll_characteristics);
+        print_flags(pe->dll_characteristics, dll_flags, sizeof(dll_flags) / sizeof(*dll_flags));
+        printf(COLOR_GREEN "|--checksum  :" COLOR_RESET " 0x%08x\n", pe->checksum);
+        if (pe->ndirs > PE_DIR_CLR && pe->dirs[PE_DIR_CLR].rva)
+            printf(COLOR_GREEN "|--.NET      :" COLOR_RESET " CLR header at 0x%x (managed code, IL is not disassembled)\n",
+                   pe->dirs[PE_DIR_CLR].rva);
+    }
+
+    printf(COLOR_BLUE "\n=== Data Directories ===\n" COLOR_RESET);
+    for (uint32_t i = 0; i < pe->ndirs; i++) {
+        const pe_dir_t *d = &pe->dirs[i];
+        if (!d->rva && !d->size) continue;
+        // the certificate table is addressed by file offset
+        printf(COLOR_GREEN "|--%-12s" COLOR_RESET " %s 0x%08x %8u bytes  %s\n", dir_names[i],
+               i == PE_DIR_SECURITY ? "off" : "rva", d->rva, d->size,
+               i == PE_DIR_SECURITY ? "" : section_of(pe, d->rva));
+    }
+
+    printf(COLOR_BLUE "\n=== Sections ===\n" COLOR_RESET);
+    for (uint16_t i = 0; i < pe->nsections; i++) {
+        const pe_section_t *s = &pe->sections[i];
+        printf(COLOR_GREEN "|--[%2u] %-8s" COLOR_RESET " rva 0x%08x vsize 0x%08x  raw 0x%08x size 0x%08x  %c%c%c 0x%08x%s\n",
+               i + 1, s->name, s->vaddr, s->vsize, s->raw_off, s->raw_size,
+               (s->flags & PE_SCN_MEM_READ) ? 'r' : '-', (s->flags & PE_SCN_MEM_WRITE) ? 'w' : '-',
+               (s->flags & PE_SCN_MEM_EXECUTE) ? 'x' : '-', s->flags,
+               (s->flags & PE_SCN_CNT_CODE) ? COLOR_YELLOW " code" COLOR_RESET : "");
+    }
+
+    print_imports(pe);
+    print_delay_imports(pe);
+    print_exports(pe);
+
+    if (pe->nsymbols) {
+        printf(COLOR_BLUE "\n=== COFF Symbols (%zu) ===\n" COLOR_RESET, pe->nsymbols);
+        for (size_t i = 0; i < pe->nsymbols; i++) {
+            const pe_symbol_t *s = &pe->symbols[i];
+            printf("|--0x%08x sec %3d class %3u%s %s\n", s->value, s->section, s->sclass,
+                   (s->type >> 4) == PE_SYM_DTYPE_FUNCTION ? " func" : "     ", s->name);
+        }
+    }
+}
+// ========================= END METADATA ==================================
+
+// ========================= BEGIN DISASM ==================================
+/**
+ * @brief A named code address: the entry point, an export or a COFF function.
+ */
+typedef struct {
+    const char *name;
+    uint32_t rva;
+} pe_label_t;
+
+static int cmp_label_rva(const void *a, const void *b)
+{
+    const pe_label_t *x = a, *y = b;
+    return (x->rva > y->rva) - (x->rva < y->rva);
+}
+
+static bool is_code(const pe_section_t *s)
+{
+    return (s->flags & (PE_SCN_CNT_CODE | PE_SCN_MEM_EXECUTE)) != 0;
+}
+
+/**
+ * @brief Disassemble [rva, rva + size), in place when the file is in memory.
+ */
+static void disasm_range(const pe_file_t *pe, uint32_t rva, uint64_t size)
+{
+    bparser *parser = pe->parser;
+    uint64_t off, avail;
+    if (!pe_rva_to_offset(pe, rva, &off, &avail)) return;
+    if (size > avail) size = avail;
+    unsigned char bit_type = pe->machine == PE_MACHINE_AMD64 ? ELFCLASS64 : ELFCLASS32;
+    uint64_t va = pe->image_base + rva;
+    if (parser->block) {
+        print_disasm((unsigned char*)parser->block + off, size, va, bit_type);
+        return;
+    }
+    unsigned char *buf = malloc(size ? size : 1);
+    if (!buf) return;
+    size = bparser_read(parser, buf, off, size);
+    print_disasm(buf, size, va, bit_type);
+    free(buf);
+}
+
+/**
+ * @brief Disassemble every code section, split at the entry point, exports
+ * and COFF functions; or only the function named by `--function`.
+ */
+static bool pe_disasm(const pe_file_t *pe, inputs *input)
+{
+    if (pe->machine != PE_MACHINE_AMD64 && pe->machine != PE_MACHINE_I386) {
+        fprintf(stderr, COLOR_RED "[!] Disassembly is only supported for x86 and x86-64 images, not " COLOR_RESET
+                "%s\n", pe_machine_name(pe->machine));
+        return false;
+    }
+    char dll[PE_MAX_NAME];
+    size_t nexports;
+    pe_export_t *exports = read_exports(pe, dll, &nexports);
+    pe_label_t *labels = malloc((nexports + pe->nsymbols + 1) * sizeof(*labels));
+    if (!labels) {
+        free_exports(exports, nexports);
+        return false;
+    }
+    size_t count = 0;
+    if (pe->entry) labels[count++] = (pe_label_t){"entry", pe->entry};
+    for (size_t i = 0; i < nexports; i++)
+        if (exports[i].rva && !exports[i].forwarder && exports[i].name)
+            labels[count++] = (pe_label_t){exports[i].name, exports[i].rva};
+    for (size_t i = 0; i < pe->nsymbols; i++) {
+        const pe_symbol_t *s = &pe->symbols[i];
+        if (s->section > 0 && (s->type >> 4) == PE_SYM_DTYPE_FUNCTION) labels[count++] = (pe_label_t){s->name, s->value};
+    }
+    qsort(labels, count, sizeof(*labels), cmp_label_rva);
+
+    const char *function = baseer_get_opt(input, "--function");
+    bool found = false;
+    printf(COLOR_BLUE "=== PE Disasm (%s) ===\n" COLOR_RESET, pe_machine_name(pe->machine));
+    for (uint16_t i = 0; i < pe->nsections; i++) {
+        const pe_section_t *s = &pe->sections[i];
+        uint64_t avail;
+        if (!is_code(s) || !pe_rva_to_offset(pe, s->vaddr, NULL, &avail)) continue;
+        uint64_t end = s->vaddr + avail;
+        if (!function) printf(COLOR_YELLOW "\n=== %s ===\n" COLOR_RESET, s->name);
+
+        // first label inside the section
+        size_t k = 0;
+        while (k < count && labels[k].rva < s->vaddr) k++;
+        if (!function && (k == count || labels[k].rva > s->vaddr))
+            disasm_range(pe, s->vaddr, (k < count && labels[k].rva < end ? labels[k].rva : end) - s->vaddr);
+        for (; k < count && labels[k].rva < end; k++) {
+            const pe_label_t *l = &labels[k];
+            if (k + 1 < count && labels[k + 1].rva == l->rva) continue;   // aliases: keep the last one
+            // 32-bit C names are decorated with a leading '_'
+            if (function && strcmp(l->name, function) != 0 && !(l->name[0] == '_' && strcmp(l->name + 1, function) == 0))
+                continue;
+            uint32_t next = (k + 1 < count && labels[k + 1].rva < end) ? labels[k + 1].rva : (uint32_t)end;
+            printf("\n" COLOR_WHITE "|-- %s:" COLOR_RESET "\n", l->name);
+            disasm_range(pe, l->rva, next - l->rva);
+            found = true;
+        }
+    }
+    free(labels);
+    free_exports(exports, nexports);
+    if (function && !found) {
+        fprintf(stderr, COLOR_RED "[!] Function not found: " COLOR_RESET "%s\n", function);
+        return false;
+    }
+    return true;
+}
+// ========================= END DISASM ==================================
+
+bool bx_pe(bparser *parser, void *arg)
+{
+    int argc = *((inputs*)arg)->argc;
+    char **args = ((inputs*)arg)->args;
+
+    pe_file_t *pe = NULL;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp("--scan", args[i]) == 0 && i + 1 < argc) {
+            bparser_apply(parser, b_scan, arg);
+            i++;
+        } else if (strcmp("--hash", args[i]) == 0) {
+            bparser_apply(parser, b_hash, arg);
+        } else if (strcmp("--carve", args[i]) == 0) {
+            bparser_apply(parser, b_carve, arg);
+            break;
+        } else if (strcmp("--function", args[i]) == 0) {
+            i++;
+        } else if (strcmp("-m", args[i]) == 0 || strcmp("-a", args[i]) == 0) {
+            if (!pe && !(pe = pe_open(parser))) {
+                fprintf(stderr, COLOR_RED "[!] Not a PE image\n" COLOR_RESET);
+                return false;
+            }
+            if (args[i][1] == 'm') pe_metadata(pe);
+            else pe_disasm(pe, arg);
+        } else {
+            fprintf(stderr, "[!] Unsupported flag: %s\n", args[i]);
+        }
+    }
+    pe_close(pe);
+    return true;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file bx_pe.h
+ * @brief PE/COFF executables (Windows EXE, DLL, SYS).
+ *
+ * The MZ header points (e_lfanew) to the `PE\0\0` signature, followed by
+ * the COFF file header, the optional header (PE32 or PE32+) with its data
+ * directories, and the section table. The sections feed a b_addrmap, so
+ * every RVA -> file offset translation (imports, exports, code) is a
+ * binary search, and code is disassembled in place.
+ *
+ * The definitions below mirror <winnt.h>, which is not available here.
+ *
+ * Options (read from the command line):
+ * - `-m`                   Headers, data directories, sections, imports,
+ *                          delay imports, exports and COFF symbols.
+ * - `-a [--function <f>]`  Disassemble the code sections (x86 and x64),
+ *                          split at the entry point, exports and symbols.
+ * - `--scan`, `--carve`, `--hash` As for any file.
+ */
+#ifndef BX_PE_H
+#define BX_PE_H
+#include "../bparser/bparser.h"
+#include "../../baseer.h"
+#include "../../utils/ui.h"
+#include "../b_addrmap/b_addrmap.h"
+#include <stdint.h>
+
+#define PE_DOS_SIGNATURE     0x5a4d         /**< "MZ" */
+#define PE_SIGNATURE         0x00004550     /**< "PE\0\0" */
+#define PE_DOS_HEADER_SIZE   64
+#define PE_COFF_HEADER_SIZE  20
+#define PE_SECTION_SIZE      40
+#define PE_SYMBOL_SIZE       18
+#define PE_MAX_DIRS          16
+#define PE_MAX_ENTRIES       65536          /**< DLLs, functions per DLL, exports */
+#define PE_MAX_NAME          512            /**< Longest DLL or function name read */
+#define PE_MAX_SYMBOLS       (4u * 1024 * 1024)
+
+#define PE_OPT_MAGIC_PE32    0x10b
+#define PE_OPT_MAGIC_PE32P   0x20b
+
+// machines
+#define PE_MACHINE_I386      0x014c
+#define PE_MACHINE_AMD64     0x8664
+#define PE_MACHINE_ARM       0x01c0
+#define PE_MACHINE_ARMNT     0x01c4
+#define PE_MACHINE_ARM64     0xaa64
+#define PE_MACHINE_IA64      0x0200
+
+// data directories
+#define PE_DIR_EXPORT        0
+#define PE_DIR_IMPORT        1
+#define PE_DIR_RESOURCE      2
+#define PE_DIR_EXCEPTION     3
+#define PE_DIR_SECURITY      4
+#define PE_DIR_BASERELOC     5
+#define PE_DIR_DEBUG         6
+#define PE_DIR_TLS           9
+#define PE_DIR_LOAD_CONFIG   10
+#define PE_DIR_IAT           12
+#define PE_DIR_DELAY_IMPORT  13
+#define PE_DIR_CLR           14
+
+// section characteristics
+#define PE_SCN_CNT_CODE      0x00000020
+#define PE_SCN_MEM_EXECUTE   0x20000000
+#define PE_SCN_MEM_READ      0x40000000
+#define PE_SCN_MEM_WRITE     0x80000000
+
+// file characteristics
+#define PE_FILE_DLL          0x2000
+
+typedef struct {
+    char name[64];          /**< "/n" long names resolved through the string table */
+    uint32_t vaddr;         /**< RVA */
+    uint32_t vsize;
+    uint32_t raw_off;
+    uint32_t raw_size;
+    uint32_t flags;
+} pe_section_t;
+
+typedef struct {
+    uint32_t rva;
+    uint32_t size;
+} pe_dir_t;
+
+// COFF symbols
+#define PE_SYM_DTYPE_FUNCTION 2     /**< (type >> 4) of a function */
+#define PE_SYM_CLASS_EXTERNAL 2
+#define PE_SYM_CLASS_STATIC   3
+#define PE_SYM_CLASS_FILE     103
+
+/**
+ * @brief A COFF symbol (primary records only, auxiliary records skipped).
+ */
+typedef struct {
+    char *name;
+    uint32_t value;         /**< RVA when section > 0 */
+    int16_t section;        /**< 1-based, 0 undefined, -1 absolute, -2 debug */
+    uint16_t type;
+    uint8_t sclass;
+} pe_symbol_t;
+
+/**
+ * @brief A parsed PE image.
+ */
+typedef struct {
+    bparser *parser;
+    uint32_t pe_off;            /**< e_lfanew */
+    uint16_t machine;
+    uint16_t nsections;
+    uint32_t timestamp;
+    uint32_t symtab_off;        /**< COFF symbol table (MinGW, object files), 0 if none */
+    uint32_t nsymtab;           /**< Records in it, auxiliary ones included */
+    uint16_t characteristics;
+    uint16_t opt_magic;
+    bool is64;                  /**< PE32+ */
+    uint8_t linker_major, linker_minor;
+    uint32_t entry;             /**< RVA of the entry point, 0 if none */
+    uint64_t image_base;
+    uint32_t section_align, file_align;
+    uint16_t os_major, os_minor, subsystem_major, subsystem_minor;
+    uint32_t size_of_image, size_of_headers, checksum;
+    uint16_t subsystem, dll_characteristics;
+    uint32_t ndirs;
+    pe_dir_t dirs[PE_MAX_DIRS];
+    pe_section_t *sections;
+    pe_symbol_t *symbols;
+    size_t nsymbols;
+    b_addrmap *map;             /**< RVA <-> file offset */
+} pe_file_t;
+
+/**
+ * @brief Parse the headers and section table, and build the address map.
+ *
+ * @return The image (free with pe_close()), NULL if there is no valid PE
+ *         signature and COFF header.
+ */
+pe_file_t *pe_open(bparser *parser);
+void pe_close(pe_file_t *pe);
+
+/**
+ * @brief Translate an RVA to a file offset.
+ *
+ * @param avail Bytes of file data from off to the end of the section (may be NULL).
+ * @return false if the RVA is not backed by file data.
+ */
+bool pe_rva_to_offset(const pe_file_t *pe, uint32_t rva, uint64_t *off, uint64_t *avail);
+
+const char *pe_machine_name(uint16_t machine);
+
+bool bx_pe(bparser *parser, void *arg);
+
+#endif
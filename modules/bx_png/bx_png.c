@@ -0,0 +1,211 @@
+/**
+ * @file bx_png.c
+ * @brief PNG chunk listing and CRC verification.
+ */
+#include "bx_png.h"
+#include <ctype.h>
+#include <time.h>
+#include "../binhead/bx_binhead.h"
+#include "../b_crc32/b_crc32.h"
+#include "../b_scan/b_scan.h"
+#include "../b_carve/b_carve.h"
+#include "../b_hash/b_hash.h"
+
+// ========================= BEGIN CHUNKS ==================================
+bool png_next_chunk(bparser *parser, uint64_t *pos, png_chunk_t *chunk)
+{
+    unsigned char head[8], tail[4];
+    if (bparser_read(parser, head, *pos, sizeof(head)) != sizeof(head)) return false;
+    chunk->offset = *pos;
+    chunk->length = rd32be(head);
+    memcpy(chunk->type, head + 4, 4);
+    chunk->type[4] = '\0';
+
+    uint64_t crc_off = *pos + 8 + (uint64_t)chunk->length;
+    chunk->truncated = chunk->length > PNG_MAX_CHUNK ||
+                       bparser_read(parser, tail, crc_off, sizeof(tail)) != sizeof(tail);
+    chunk->crc = chunk->truncated ? 0 : rd32be(tail);
+    *pos = crc_off + 4;
+    return true;
+}
+
+bool png_chunk_crc(bparser *parser, const png_chunk_t *chunk, uint32_t *crc)
+{
+    uint64_t off = chunk->offset + 4, len = 4 + (uint64_t)chunk->length;
+    if (chunk->truncated || off + len > parser->size) return false;
+    if (parser->block) {
+        // in place: no copy of the chunk data
+        *crc = b_crc32(0, (const unsigned char*)parser->block + off, len);
+        return true;
+    }
+    size_t cap = len < PNG_CRC_CHUNK ? len : PNG_CRC_CHUNK;
+    unsigned char *buf = malloc(cap);
+    if (!buf) return false;
+    uint32_t c = 0;
+    for (uint64_t done = 0; done < len; ) {
+        size_t n = len - done < cap ? len - done : cap;
+        if (bparser_read(parser, buf, off + done, n) != n) {
+            free(buf);
+            return false;
+        }
+        c = b_crc32(c, buf, n);
+        done += n;
+    }
+    free(buf);
+    *crc = c;
+    return true;
+}
+// ========================= END CHUNKS ==================================
+
+// ========================= BEGIN REPORT ==================================
+static const char *color_type_name(uint8_t color)
+{
+    switch (color) {
+        case 0: return "grayscale";
+        case 2: return "RGB";
+        case 3: return "palette";
+        case 4: return "grayscale + alpha";
+        case 6: return "RGBA";
+        default: return "invalid";
+    }
+}
+
+static bool known_critical(const char *type)
+{
+    return strcmp(type, "IHDR") == 0 || strcmp(type, "PLTE") == 0 || strcmp(type, "IDAT") == 0 ||
+           strcmp(type, "IEND") == 0;
+}
+
+static void print_ihdr(bparser *parser, const png_chunk_t *chunk)
+{
+    unsigned char d[13];
+    if (chunk->length != 13 || bparser_read(parser, d, chunk->offset + 8, sizeof(d)) != sizeof(d)) {
+        fprintf(stderr, COLOR_RED "[!] Bad IHDR length: " COLOR_RESET "%u\n", chunk->length);
+        return;
+    }
+    printf(COLOR_BLUE "\n=== PNG Header ===\n" COLOR_RESET);
+    printf(COLOR_GREEN "|--size      :" COLOR_RESET " %ux%u\n", rd32be(d), rd32be(d + 4));
+    printf(COLOR_GREEN "|--depth     :" COLOR_RESET " %u\n", d[8]);
+    printf(COLOR_GREEN "|--color     :" COLOR_RESET " %u (%s)\n", d[9], color_type_name(d[9]));
+    printf(COLOR_GREEN "|--compress  :" COLOR_RESET " %u\n", d[10]);
+    printf(COLOR_GREEN "|--filter    :" COLOR_RESET " %u\n", d[11]);
+    printf(COLOR_GREEN "|--interlace :" COLOR_RESET " %s\n", d[12] ? "Adam7" : "none");
+}
+
+/**
+ * @brief Show the keyword (and the start of the text) of tEXt/zTXt/iTXt.
+ */
+static void print_text(bparser *parser, const png_chunk_t *chunk)
+{
+    char text[81];
+    size_t n = chunk->length < sizeof(text) - 1 ? chunk->length : sizeof(text) - 1;
+    n = bparser_read(parser, text, chunk->offset + 8, n);
+    bool plain = strcmp(chunk->type, "tEXt") == 0;
+    printf("  ");
+    for (size_t i = 0; i < n; i++) {
+        if (text[i] == '\0') {
+            if (!plain) break;   // compressed text: keyword only
+            printf("=");
+        } else {
+            putchar(isprint((unsigned char)text[i]) ? text[i] : '.');
+        }
+    }
+    if (plain && n < chunk->length) printf("...");
+}
+
+/**
+ * @brief Walk every chunk, verify its CRC and report (`-m`, or problems
+ * only with `--crc`).
+ */
+static bool png_walk(bparser *parser, bool verbose)
+{
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    uint64_t pos = PNG_SIGNATURE_SIZE, crc_bytes = 0, idat_bytes = 0;
+    size_t chunks = 0, bad = 0, idat = 0;
+    bool iend = false, truncated = false;
+    png_chunk_t chunk;
+
+    if (verbose) printf(COLOR_BLUE "\n=== PNG Chunks ===\n" COLOR_RESET);
+    while (!iend && png_next_chunk(parser, &pos, &chunk)) {
+        chunks++;
+        if (chunks == 1 && strcmp(chunk.type, "IHDR") != 0)
+            fprintf(stderr, COLOR_RED "[!] First chunk is not IHDR: " COLOR_RESET "%s\n", chunk.type);
+        if (chunks == 1 && verbose && strcmp(chunk.type, "IHDR") == 0) {
+            print_ihdr(parser, &chunk);
+            printf("\n");
+        }
+
+        uint32_t crc = 0;
+        bool readable = png_chunk_crc(parser, &chunk, &crc);
+        bool ok = readable && crc == chunk.crc;
+        if (readable) crc_bytes += 4 + (uint64_t)chunk.length;
+        if (!readable) truncated = true;
+        else if (!ok) bad++;
+        if (strcmp(chunk.type, "IDAT") == 0) {
+            idat++;
+            idat_bytes += chunk.length;
+        }
+        iend = strcmp(chunk.type, "IEND") == 0;
+
+        bool critical = isupper((unsigned char)chunk.type[0]);
+        if (verbose) {
+            printf(COLOR_GREEN "|--[0x%08llx] " COLOR_RESET "%-4s %10u  crc %08x ", (unsigned long long)chunk.offset,
+                   chunk.type, chunk.length, chunk.crc);
+            if (!readable) printf(COLOR_RED "truncated" COLOR_RESET);
+            else if (ok) printf(COLOR_GREEN "ok" COLOR_RESET);
+            else printf(COLOR_RED "BAD (computed %08x)" COLOR_RESET, crc);
+            if (critical && !known_critical(chunk.type)) printf(COLOR_YELLOW "  unknown critical chunk" COLOR_RESET);
+            if (readable && (strcmp(chunk.type, "tEXt") == 0 || strcmp(chunk.type, "zTXt") == 0 ||
+                             strcmp(chunk.type, "iTXt") == 0))
+                print_text(parser, &chunk);
+            printf("\n");
+        } else if (!readable) {
+            fprintf(stderr, COLOR_RED "[!] Truncated chunk at " COLOR_RESET "0x%llx (%s, %u bytes)\n",
+                    (unsigned long long)chunk.offset, chunk.type, chunk.length);
+        } else if (!ok) {
+            fprintf(stderr, COLOR_RED "[!] Bad CRC at " COLOR_RESET "0x%llx (%s: stored %08x, computed %08x)\n",
+                    (unsigned long long)chunk.offset, chunk.type, chunk.crc, crc);
+        }
+        if (!readable) break;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double seconds = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+    if (!iend && !truncated)
+        fprintf(stderr, COLOR_RED "[!] No IEND chunk\n" COLOR_RESET);
+    if (iend && pos < parser->size) {
+        // anything after IEND is ignored by decoders
+        bparser *rest = bparser_slice(parser, pos, parser->size - pos);
+        const char *format = rest ? bx_binhead_identify(rest) : NULL;
+        fprintf(stderr, COLOR_YELLOW "[!] %llu bytes after IEND at " COLOR_RESET "0x%llx (%s)\n",
+                (unsigned long long)(parser->size - pos), (unsigned long long)pos, format ? format : "unknown");
+        free(rest);
+    }
+    printf(COLOR_GREEN "Verified " COLOR_RESET "%zu chunks, %zu IDAT (%llu bytes), %zu bad CRC%s in %.3f s "
+           "(%.2f GB/s, %s)\n", chunks, idat, (unsigned long long)idat_bytes, bad, truncated ? ", truncated" : "",
+           seconds, seconds > 0 ? crc_bytes / seconds / 1e9 : 0.0, b_crc32_kernel());
+    return bad == 0 && !truncated && iend;
+}
+// ========================= END REPORT ==================================
+
+bool bx_png(bparser *parser, void *arg)
+{
+    int argc = *((inputs*)arg)->argc;
+    char **args = ((inputs*)arg)->args;
+
+    if (strcmp("-m", args[2]) == 0) {
+        png_walk(parser, true);
+    } else if (strcmp("--crc", args[2]) == 0) {
+        png_walk(parser, false);
+    } else if (strcmp("--scan", args[2]) == 0 && argc > 3) {
+        bparser_apply(parser, b_scan, arg);
+    } else if (strcmp("--carve", args[2]) == 0) {
+        bparser_apply(parser, b_carve, arg);
+    } else if (strcmp("--hash", args[2]) == 0) {
+        bparser_apply(parser, b_hash, arg);
+    } else {
+        fprintf(stderr, "[!] Unsupported flag: %s\n", args[2]);
+    }
+    return true;
+}
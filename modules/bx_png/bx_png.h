@@ -0,0 +1,53 @@
+/**
+ * @file bx_png.h
+ * @brief PNG chunk walker with CRC-32 verification.
+ *
+ * Chunks are walked in place through the bparser (no copy in memory mode)
+ * and every chunk CRC is recomputed with b_crc32(). Problems that matter
+ * in bulk scans are reported: bad CRCs, truncated chunks, a missing IEND,
+ * and data appended after IEND (a common place to hide a payload).
+ *
+ * Options (read from the command line):
+ * - `-m`      Print IHDR and every chunk with its CRC status.
+ * - `--crc`   Only report problems, with a one-line summary.
+ * - `--scan`, `--carve`, `--hash` As for any file.
+ */
+#ifndef BX_PNG_H
+#define BX_PNG_H
+#include "../bparser/bparser.h"
+#include "../../baseer.h"
+#include "../../utils/ui.h"
+#include <stdint.h>
+
+#define PNG_SIGNATURE_SIZE 8
+#define PNG_MAX_CHUNK      0x7fffffffu       /**< Largest chunk length allowed by the format */
+#define PNG_CRC_CHUNK      (1024 * 1024)     /**< Bytes per read when the file is streamed */
+
+/**
+ * @brief One chunk: `length, type, data[length], crc`.
+ */
+typedef struct {
+    uint64_t offset;            /**< Offset of the length field */
+    uint32_t length;
+    char type[5];
+    uint32_t crc;               /**< Stored CRC (valid if !truncated) */
+    bool truncated;             /**< The chunk runs past the end of the file */
+} png_chunk_t;
+
+/**
+ * @brief Read the chunk at *pos and move *pos past it.
+ *
+ * @return false when no chunk header fits before the end of the file.
+ */
+bool png_next_chunk(bparser *parser, uint64_t *pos, png_chunk_t *chunk);
+
+/**
+ * @brief Compute the CRC of a chunk (type and data).
+ *
+ * @return false if the chunk data cannot be read.
+ */
+bool png_chunk_crc(bparser *parser, const png_chunk_t *chunk, uint32_t *crc);
+
+bool bx_png(bparser *parser, void *arg);
+
+#endif
@@ -1,6 +1,11 @@
 #include "bx_tar.h"
 #include <stdio.h>
 #include <sys/stat.h>
+#include <sys/wait.h>
+#include <stddef.h>
+#include "../binhead/bx_binhead.h"
+#include "../b_tar_index/b_tar_index.h"
+#include "../b_tar_extract/b_tar_extract.h"
 
 
 typedef struct {
@@ -25,168 +30,707 @@ typedef struct {
     char pad[12];
 } posix_header;
 
-/* Values used in typeflag field.  */
-#define REGTYPE  '0'            /* regular file */
-#define AREGTYPE '\0'           /* regular file */
-#define LNKTYPE  '1'            /* link */
-#define SYMTYPE  '2'            /* reserved */
-#define CHRTYPE  '3'            /* character special */
-#define BLKTYPE  '4'            /* block special */
-#define DIRTYPE  '5'            /* directory */
-#define FIFOTYPE '6'            /* FIFO special */
-#define CONTTYPE '7'            /* reserved */
-#define BLOCK_SIZE 512
 
-static inline int oct2int(char *size_ptr)
+/**
+ * @brief Parse a numeric header field: octal, or base-256 when the high bit
+ * of the first byte is set (GNU extension for large values).
+ */
+static uint64_t tar_number(const char *field, size_t len)
 {
-    int file_size = 0;
-    for (size_t i = 0; i < (size_t)size_ptr && size_ptr[i]; i++) {
-        if (size_ptr[i] >= '0' && size_ptr[i] <= '7')
-            file_size = file_size * 8 + (size_ptr[i] - '0');
+    const unsigned char *p = (const unsigned char*)field;
+    uint64_t v = 0;
+    if (p[0] & 0x80) {
+        v = p[0] & 0x7f;
+        for (size_t i = 1; i < len; i++) v = v << 8 | p[i];
+        return v;
     }
-    return file_size;
+    size_t i = 0;
+    while (i < len && p[i] == ' ') i++;
+    for (; i < len && p[i] >= '0' && p[i] <= '7'; i++) v = v * 8 + (p[i] - '0');
+    return v;
 }
 
-bool bx_tar(bparser* parser, void *arg)
+/**
+ * @brief Check the header checksum (the chksum field counts as spaces).
+ *
+ * Both the unsigned sum of POSIX and the signed sum of old tars are accepted.
+ */
+static bool tar_checksum_ok(const posix_header *header)
 {
-    int argc = *((inputs*)arg) -> argc;
-    char** args = ((inputs*)arg) -> args;
+    const unsigned char *u = (const unsigned char*)header;
+    const signed char *s = (const signed char*)header;
+    uint64_t stored = tar_number(header->chksum, sizeof(header->chksum));
+    int64_t usum = 0, ssum = 0;
+    for (size_t i = 0; i < sizeof(*header); i++) {
+        bool field = i >= offsetof(posix_header, chksum) && i < offsetof(posix_header, typeflag);
+        usum += field ? ' ' : u[i];
+        ssum += field ? ' ' : s[i];
+    }
+    return (uint64_t)usum == stored || (uint64_t)ssum == stored;
+}
 
-    if(strcmp("-m", args[2]) == 0) {
-        unsigned long long int pos = 0;
-        while (pos < parser->size) {
-            void* block = malloc(sizeof(posix_header));
-            size_t n = bparser_read(parser, block, pos, sizeof(posix_header));
-            if(n == 0) break;
-            posix_header* header = (posix_header*)block;
-            if (header -> name[0] == '\0') break;
-            int file_size = oct2int(header->size);
-            printf("\n=== TAR Header Info ===\n");
-            printf(COLOR_GREEN "|--[  0] name      :%s %s\n", COLOR_RESET, header->name);
-            printf(COLOR_GREEN "|--[100] mode      :%s %s\n", COLOR_RESET, header->mode);
-            printf(COLOR_GREEN "|--[108] uid       :%s %s\n", COLOR_RESET, header->uid);
-            printf(COLOR_GREEN "|--[116] gid       :%s %s\n", COLOR_RESET, header->gid);
-            printf(COLOR_GREEN "|--[124] size      :%s %s\n", COLOR_RESET, header->size);
-            printf(COLOR_GREEN "|--[124] size      :%s %d\n", COLOR_RESET, file_size);
-            printf(COLOR_GREEN "|--[136] mtime     :%s %s\n", COLOR_RESET, header->mtime);
-            printf(COLOR_GREEN "|--[148] chksum    :%s %s\n", COLOR_RESET, header->chksum);
-            printf(COLOR_GREEN "|--[156] typeflag  :%s %c\n", COLOR_RESET, header->typeflag);
-            printf(COLOR_GREEN "|--[157] linkname  :%s %s\n", COLOR_RESET, header->linkname);
-            printf(COLOR_GREEN "|--[257] magic     :%s %s\n", COLOR_RESET, header->magic);
-            printf(COLOR_GREEN "|--[263] version   :%s %s\n", COLOR_RESET, header->version);
-            printf(COLOR_GREEN "|--[265] uname     :%s %s\n", COLOR_RESET, header->uname);
-            printf(COLOR_GREEN "|--[297] gname     :%s %s\n", COLOR_RESET, header->gname);
-            printf(COLOR_GREEN "|--[329] devmajor  :%s %s\n", COLOR_RESET, header->devmajor);
-            printf(COLOR_GREEN "|--[337] devminor  :%s %s\n", COLOR_RESET, header->devminor);
-            printf(COLOR_GREEN "|--[345] prefix    :%s %s\n", COLOR_RESET, header->prefix);
-
-            if(header ->typeflag == REGTYPE || header->typeflag == AREGTYPE) {
-                printf(COLOR_YELLOW "|---This is Reg File\n" COLOR_RESET);
-            }
-            else if(header ->typeflag == LNKTYPE) {
-                printf(COLOR_YELLOW "|---This is LINK File\n" COLOR_RESET);
-            }
-            else if(header ->typeflag == SYMTYPE ) {
-                printf(COLOR_YELLOW "|---This is reserved File\n" COLOR_RESET);
+/* ========================= pax / GNU Extensions ========================= */
+/**
+ * @brief Values collected from the pax and GNU headers in front of a member.
+ */
+typedef struct {
+    int path_src;               /**< 0: header, 1: GNU long name, 2: pax */
+    int link_src;
+    bool has_size, has_mtime, has_real_size;
+    uint64_t size, real_size;
+    int64_t mtime;
+    int sparse_major;           /**< pax sparse format (-1 if none) */
+    int sparse_minor;
+    bool sparse_has_offset;     /**< 0.0: GNU.sparse.offset waiting for its numbytes */
+    uint64_t sparse_offset;
+    tar_sparse_t *map;
+    size_t count, cap;
+} tar_ext_t;
+
+static bool sparse_add(tar_ext_t *x, uint64_t offset, uint64_t size)
+{
+    if (x->count == x->cap) {
+        if (x->cap >= TAR_MAX_SPARSE) return false;
+        size_t cap = x->cap ? x->cap * 2 : 16;
+        tar_sparse_t *grown = realloc(x->map, cap * sizeof(*grown));
+        if (!grown) return false;
+        x->map = grown;
+        x->cap = cap;
+    }
+    x->map[x->count++] = (tar_sparse_t){offset, size};
+    return true;
+}
+
+/**
+ * @brief Read a member's data (pax records, GNU long names) NUL-terminated.
+ */
+static char *tar_read_data(bparser *parser, uint64_t off, uint64_t size)
+{
+    if (size > TAR_MAX_PAX) return NULL;
+    char *data = malloc(size + 1);
+    if (!data) return NULL;
+    if (bparser_read(parser, data, off, size) != size) {
+        free(data);
+        return NULL;
+    }
+    data[size] = '\0';
+    return data;
+}
+
+/**
+ * @brief Apply the records of a pax extended header ("<len> <key>=<value>\n").
+ */
+static void pax_parse(const char *data, size_t size, tar_member_t *m, tar_ext_t *x)
+{
+    for (size_t at = 0; at < size; ) {
+        char *end;
+        unsigned long long len = strtoull(data + at, &end, 10);
+        if (len == 0 || *end != ' ' || len > size - at) break;
+        const char *key = end + 1, *rec_end = data + at + len;
+        const char *eq = memchr(key, '=', rec_end - key);
+        at += len;
+        if (!eq || rec_end[-1] != '\n') continue;
+        size_t key_len = eq - key;
+        const char *value = eq + 1;
+        int value_len = (int)(rec_end - 1 - value);
+
+#define PAX_KEY(name) (key_len == sizeof(name) - 1 && memcmp(key, name, key_len) == 0)
+        if (PAX_KEY("path") || PAX_KEY("GNU.sparse.name")) {
+            snprintf(m->path, sizeof(m->path), "%.*s", value_len, value);
+            x->path_src = 2;
+        } else if (PAX_KEY("linkpath")) {
+            snprintf(m->link, sizeof(m->link), "%.*s", value_len, value);
+            x->link_src = 2;
+        } else if (PAX_KEY("size")) {
+            x->size = strtoull(value, NULL, 10);
+            x->has_size = true;
+        } else if (PAX_KEY("mtime")) {
+            x->mtime = strtoll(value, NULL, 10);
+            x->has_mtime = true;
+        } else if (PAX_KEY("GNU.sparse.realsize") || PAX_KEY("GNU.sparse.size")) {
+            x->real_size = strtoull(value, NULL, 10);
+            x->has_real_size = true;
+        } else if (PAX_KEY("GNU.sparse.major")) {
+            x->sparse_major = atoi(value);
+        } else if (PAX_KEY("GNU.sparse.minor")) {
+            x->sparse_minor = atoi(value);
+        } else if (PAX_KEY("GNU.sparse.offset")) {
+            // 0.0: repeated offset/numbytes pairs
+            x->sparse_offset = strtoull(value, NULL, 10);
+            x->sparse_has_offset = true;
+            if (x->sparse_major < 0) x->sparse_major = 0;
+        } else if (PAX_KEY("GNU.sparse.numbytes")) {
+            if (x->sparse_has_offset) sparse_add(x, x->sparse_offset, strtoull(value, NULL, 10));
+            x->sparse_has_offset = false;
+        } else if (PAX_KEY("GNU.sparse.map")) {
+            // 0.1: "offset,size,offset,size,..."
+            x->sparse_major = 0;
+            x->sparse_minor = 1;
+            for (const char *p = value; p < rec_end - 1; ) {
+                uint64_t off = strtoull(p, &end, 10);
+                if (*end != ',') break;
+                uint64_t len = strtoull(end + 1, &end, 10);
+                if (!sparse_add(x, off, len)) break;
+                if (*end != ',') break;
+                p = end + 1;
             }
-            else if(header ->typeflag == CHRTYPE) {
-                printf(COLOR_YELLOW "|---This is character special File\n" COLOR_RESET);
+        }
+#undef PAX_KEY
+    }
+}
+
+/**
+ * @brief Read the 1.0 sparse map stored in front of the member data.
+ *
+ * The map is a list of decimal lines (count, then offset/size pairs),
+ * padded to a block; the packed data follows it.
+ *
+ * @return Bytes taken by the map, 0 if it is malformed.
+ */
+static uint64_t pax_sparse_map(bparser *parser, const tar_member_t *m, tar_ext_t *x)
+{
+    unsigned char buf[BLOCK_SIZE];
+    size_t have = 0, at = 0;
+    uint64_t used = 0, want = 1, count = 0, offset = 0;
+    for (uint64_t i = 0; i < want; i++) {
+        uint64_t v = 0;
+        int digits = 0;
+        for (;;) {
+            if (at == have) {
+                if (used >= m->size) return 0;
+                have = bparser_read(parser, buf, m->data_off + used, BLOCK_SIZE);
+                if (have == 0) return 0;
+                used += have;
+                at = 0;
             }
-            else if(header ->typeflag == BLKTYPE) {
-                printf(COLOR_YELLOW "|---This is block special File\n" COLOR_RESET);
+            unsigned char c = buf[at++];
+            if (c == '\n') break;
+            if (c < '0' || c > '9' || ++digits > 20) return 0;
+            v = v * 10 + (c - '0');
+        }
+        if (digits == 0) return 0;
+        if (i == 0) {
+            if (v > TAR_MAX_SPARSE) return 0;
+            count = v;
+            want = 1 + 2 * count;
+        } else if (i % 2 == 1) {
+            offset = v;
+        } else if (!sparse_add(x, offset, v)) {
+            return 0;
+        }
+    }
+    uint64_t consumed = used - (have - at);
+    return (consumed + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+}
+
+/**
+ * @brief Read the map of an old GNU sparse member (type 'S').
+ *
+ * Four entries live in the header; when the map is longer, extension
+ * blocks of 21 entries follow the header, in front of the data.
+ *
+ * @return Offset of the member data, 0 if the extension blocks are missing.
+ */
+static uint64_t gnu_sparse_map(bparser *parser, const unsigned char *block, uint64_t pos, tar_ext_t *x)
+{
+    const unsigned char *entries = block + 386;
+    int per_block = 4;
+    bool extended = block[482] != 0;
+    unsigned char ext[BLOCK_SIZE];
+    uint64_t data_off = pos + BLOCK_SIZE;
+    for (;;) {
+        for (int i = 0; i < per_block; i++) {
+            const char *e = (const char*)entries + i * 24;
+            if (e[0] == '\0') break;
+            sparse_add(x, tar_number(e, 12), tar_number(e + 12, 12));
+        }
+        if (!extended) return data_off;
+        if (bparser_read(parser, ext, data_off, BLOCK_SIZE) != BLOCK_SIZE) return 0;
+        data_off += BLOCK_SIZE;
+        entries = ext;
+        per_block = 21;
+        extended = ext[504] != 0;
+    }
+}
+
+/**
+ * @brief Check that a sparse map fits in the packed data and the real file.
+ */
+static bool sparse_valid(const tar_member_t *m)
+{
+    uint64_t stored = 0, end = 0;
+    for (size_t i = 0; i < m->sparse_count; i++) {
+        const tar_sparse_t *s = &m->sparse[i];
+        if (s->offset < end || s->offset + s->size < s->offset) return false;
+        end = s->offset + s->size;
+        stored += s->size;
+    }
+    return stored <= m->size && end <= m->real_size;
+}
+
+/* ========================= Member Walk ========================= */
+/**
+ * @brief Offset of the header that follows `size` bytes of data at data_off.
+ *
+ * @return 0 if the data does not fit in the archive (a wrapped base-256
+ *         size included), so the walk always moves forward.
+ */
+static uint64_t tar_skip_data(bparser *parser, uint64_t data_off, uint64_t size)
+{
+    if (data_off > parser->size || size > parser->size - data_off) return 0;
+    return data_off + (size + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+}
+
+bool tar_next_member(bparser *parser, uint64_t *pos, tar_member_t *m)
+{
+    posix_header header;
+    tar_ext_t x = {.sparse_major = -1};
+    m->hdr_off = *pos;
+    m->sparse = NULL;
+    m->sparse_count = 0;
+
+    // pax and GNU headers describe the member that follows them
+    for (;;) {
+        if (bparser_read(parser, &header, *pos, sizeof(header)) != sizeof(header)) goto fail;
+        if (header.name[0] == '\0') goto fail;
+        if (!tar_checksum_ok(&header)) {
+            fprintf(stderr, COLOR_RED "[!] Bad header checksum at " COLOR_RESET "0x%llx\n", (unsigned long long)*pos);
+            goto fail;
+        }
+        char type = header.typeflag;
+        if (type != XHDTYPE && type != XGLTYPE && type != GNUTYPE_LONGNAME && type != GNUTYPE_LONGLINK) break;
+
+        uint64_t size = tar_number(header.size, sizeof(header.size));
+        uint64_t data_off = *pos + BLOCK_SIZE;
+        uint64_t after = tar_skip_data(parser, data_off, size);
+        if (after == 0) {
+            fprintf(stderr, COLOR_RED "[!] Bad extended header at " COLOR_RESET "0x%llx\n", (unsigned long long)*pos);
+            goto fail;
+        }
+        *pos = after;
+        if (type == XGLTYPE) continue;   // archive-wide defaults are not applied
+        char *data = tar_read_data(parser, data_off, size);
+        if (!data) {
+            fprintf(stderr, COLOR_RED "[!] Bad extended header at " COLOR_RESET "0x%llx\n",
+                    (unsigned long long)(data_off - BLOCK_SIZE));
+            continue;
+        }
+        if (type == XHDTYPE) {
+            pax_parse(data, size, m, &x);
+        } else if (type == GNUTYPE_LONGNAME && x.path_src < 2) {
+            snprintf(m->path, sizeof(m->path), "%s", data);
+            x.path_src = 1;
+        } else if (type == GNUTYPE_LONGLINK && x.link_src < 2) {
+            snprintf(m->link, sizeof(m->link), "%s", data);
+            x.link_src = 1;
+        }
+        free(data);
+    }
+
+    // prefix only exists in POSIX headers; GNU headers keep other fields there
+    bool posix = memcmp(header.magic, "ustar", 6) == 0;
+    if (x.path_src == 0) {
+        if (posix && header.prefix[0] != '\0')
+            snprintf(m->path, sizeof(m->path), "%.*s/%.*s", (int)sizeof(header.prefix), header.prefix,
+                     (int)sizeof(header.name), header.name);
+        else
+            snprintf(m->path, sizeof(m->path), "%.*s", (int)sizeof(header.name), header.name);
+    }
+    if (x.link_src == 0)
+        snprintf(m->link, sizeof(m->link), "%.*s", (int)sizeof(header.linkname), header.linkname);
+    m->type = header.typeflag;
+    m->block_off = *pos;
+    m->data_off = *pos + BLOCK_SIZE;
+    m->size = x.has_size ? x.size : tar_number(header.size, sizeof(header.size));
+    m->mode = (uint32_t)tar_number(header.mode, sizeof(header.mode));
+    m->mtime = x.has_mtime ? x.mtime : (int64_t)tar_number(header.mtime, sizeof(header.mtime));
+    m->real_size = m->size;
+
+    // links, devices, directories and FIFOs have no data blocks
+    uint64_t data = (m->type >= LNKTYPE && m->type <= FIFOTYPE) ? 0 : m->size;
+    uint64_t next = tar_skip_data(parser, m->data_off, data);
+
+    if (m->type == GNUTYPE_SPARSE) {
+        const unsigned char *block = (const unsigned char*)&header;
+        m->type = REGTYPE;
+        m->real_size = tar_number((const char*)block + 483, 12);
+        m->data_off = gnu_sparse_map(parser, block, *pos, &x);
+        if (m->data_off == 0) goto fail;
+        next = tar_skip_data(parser, m->data_off, m->size);
+    } else if (x.sparse_major >= 0) {
+        if (x.has_real_size) m->real_size = x.real_size;
+        if (x.sparse_major == 1) {
+            uint64_t map = pax_sparse_map(parser, m, &x);
+            if (map == 0 || map > m->size) {
+                fprintf(stderr, COLOR_RED "[!] Bad sparse map: " COLOR_RESET "%s\n", m->path);
+                x.count = 0;
+            } else {
+                m->data_off += map;
+                m->size -= map;
             }
-            else if(header ->typeflag == DIRTYPE) {
-                printf(COLOR_YELLOW "|---This is directory\n" COLOR_RESET);
-                // mkdir(header->name, oct2int(header->mode));
-                pos+=BLOCK_SIZE;
-                free(block);
-                continue;
+        }
+    }
+    if (x.count > 0) {
+        m->sparse = x.map;
+        m->sparse_count = x.count;
+        x.map = NULL;
+        if (!sparse_valid(m)) {
+            fprintf(stderr, COLOR_RED "[!] Bad sparse map: " COLOR_RESET "%s\n", m->path);
+            free(m->sparse);
+            m->sparse = NULL;
+            m->sparse_count = 0;
+            m->real_size = m->size;
+        }
+    }
+    free(x.map);
+    if (next == 0) {
+        fprintf(stderr, COLOR_RED "[!] Truncated member: " COLOR_RESET "%s\n", m->path);
+        goto fail_map;
+    }
+    *pos = next;
+    return true;
+
+fail:
+    free(x.map);
+    return false;
+
+fail_map:
+    free(m->sparse);
+    m->sparse = NULL;
+    m->sparse_count = 0;
+    return false;
+}
+
+tar_entry_t *tar_list_members(bparser *parser, size_t *count)
+{
+    size_t n = 0, cap = 0;
+    tar_entry_t *entries = NULL;
+    tar_member_t *m = malloc(sizeof(*m));
+    *count = 0;
+    if (!m) return NULL;
+
+    for (uint64_t pos = 0; tar_next_member(parser, &pos, m); ) {
+        if (n == cap) {
+            cap = cap ? cap * 2 : 64;
+            tar_entry_t *grown = realloc(entries, cap * sizeof(*entries));
+            if (!grown) break;
+            entries = grown;
+        }
+        bool is_link = m->type == LNKTYPE || m->type == SYMTYPE;
+        entries[n] = (tar_entry_t){
+            .path = strdup(m->path), .link = is_link ? strdup(m->link) : NULL, .type = m->type,
+            .hdr_off = m->hdr_off, .data_off = m->data_off, .size = m->size, .real_size = m->real_size,
+            .mode = m->mode, .mtime = m->mtime, .sparse = m->sparse, .sparse_count = m->sparse_count,
+        };
+        m->sparse = NULL;
+        if (!entries[n].path) {
+            free(entries[n].sparse);
+            break;
+        }
+        n++;
+    }
+    free(m->sparse);
+    free(m);
+    *count = n;
+    return entries;
+}
+
+void tar_free_members(tar_entry_t *entries, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        free(entries[i].path);
+        free(entries[i].link);
+        free(entries[i].sparse);
+    }
+    free(entries);
+}
+
+/* ========================= Recursive Analysis ========================= */
+#define TAR_WINDOW_PER_THREAD 4   /**< Finished outputs kept waiting per worker */
+
+static void print_member_title(bparser *slice, const tar_entry_t *m)
+{
+    const char *format = bx_binhead_identify(slice);
+    printf(COLOR_BLUE "\n=== %s " COLOR_RESET "(%llu bytes at 0x%llx, %s)\n", m->path,
+           (unsigned long long)m->size, (unsigned long long)m->data_off, format ? format : "unknown");
+}
+
+/**
+ * @brief Analyze one member in a child process writing to its own buffer.
+ *
+ * The analysis tools print to stdout and are not thread-safe, so members
+ * are isolated in forked workers; the archive image is shared with them.
+ *
+ * @return pid of the worker, or -1 if it could not be started.
+ */
+static pid_t start_member(bparser *parser, const tar_entry_t *m, inputs *sub, FILE *out)
+{
+    fflush(stdout);
+    fflush(stderr);
+    pid_t pid = fork();
+    if (pid != 0) return pid;
+
+    dup2(fileno(out), STDOUT_FILENO);
+    dup2(fileno(out), STDERR_FILENO);
+    bparser *slice = bparser_slice(parser, m->data_off, m->size);
+    if (slice) {
+        sub->member = m->path;
+        print_member_title(slice, m);
+        bx_binhead_dispatch(slice, sub);
+    }
+    fflush(stdout);
+    fflush(stderr);
+    _exit(slice ? 0 : 1);
+}
+
+/**
+ * @brief Run the flags that follow `-r` on every regular member, in place.
+ *
+ * Members are sliced out of the archive image (no extraction) and analyzed
+ * by up to get_thread_count() workers; each worker writes to its own
+ * buffer and the buffers are printed in archive order.
+ */
+static bool tar_recursive(bparser *parser, inputs *input)
+{
+    // <prog> <archive> <flags after -r...>
+    int sub_argc;
+    inputs sub;
+    char **args = baseer_sub_args(input, 3, &sub_argc, &sub);
+    if (!args) return false;
+
+    // keep the regular members
+    size_t all = 0, count = 0;
+    tar_entry_t *members = tar_list_members(parser, &all);
+    for (size_t i = 0; i < all; i++) {
+        tar_entry_t *m = &members[i];
+        if (m->type != REGTYPE && m->type != AREGTYPE && m->type != CONTTYPE) continue;
+        if (m->data_off > parser->size || m->size > parser->size - m->data_off) {
+            fprintf(stderr, COLOR_RED "[!] Truncated member: " COLOR_RESET "%s\n", m->path);
+            continue;
+        }
+        if (m->sparse) {
+            // the packed data is not the file; it only exists once extracted
+            fprintf(stderr, COLOR_YELLOW "[!] Skipping sparse member: " COLOR_RESET "%s\n", m->path);
+            continue;
+        }
+        tar_entry_t keep = *m;
+        *m = members[count];
+        members[count++] = keep;
+    }
+
+    if (sub_argc < 3) {
+        // no tools requested: only identify the members
+        for (size_t i = 0; i < count; i++) {
+            bparser *slice = bparser_slice(parser, members[i].data_off, members[i].size);
+            if (!slice) continue;
+            print_member_title(slice, &members[i]);
+            free(slice);
+        }
+        tar_free_members(members, all);
+        free(args);
+        return true;
+    }
+
+    int threads = get_thread_count();
+    size_t window = (size_t)threads * TAR_WINDOW_PER_THREAD;
+    FILE **outs = calloc(count ? count : 1, sizeof(*outs));
+    pid_t *pids = calloc(count ? count : 1, sizeof(*pids));
+    int *status = calloc(count ? count : 1, sizeof(*status));
+    bool *done = calloc(count ? count : 1, sizeof(*done));
+    if (!outs || !pids || !status || !done) count = 0;
+
+    size_t next_start = 0, next_print = 0;
+    int running = 0;
+    while (next_print < count) {
+        while (running < threads && next_start < count && next_start < next_print + window) {
+            size_t i = next_start++;
+            outs[i] = tmpfile();
+            pids[i] = outs[i] ? start_member(parser, &members[i], &sub, outs[i]) : -1;
+            if (pids[i] < 0) {
+                fprintf(stderr, COLOR_RED "[!] Could not analyze: " COLOR_RESET "%s\n", members[i].path);
+                done[i] = true;
+            } else {
+                running++;
             }
-            else if(header ->typeflag == FIFOTYPE) {
-                printf(COLOR_YELLOW "|---This is FIFO File\n" COLOR_RESET);
+        }
+
+        if (done[next_print]) {
+            size_t i = next_print++;
+            if (outs[i]) {
+                char buf[1 << 16];
+                size_t n;
+                rewind(outs[i]);
+                while ((n = fread(buf, 1, sizeof(buf), outs[i])) > 0)
+                    fwrite(buf, 1, n, stdout);
+                fclose(outs[i]);
             }
-            else if(header ->typeflag == CONTTYPE) {
-                printf(COLOR_YELLOW "|---This is reserved File\n" COLOR_RESET);
+            if (pids[i] > 0 && !(WIFEXITED(status[i]) && WEXITSTATUS(status[i]) == 0))
+                fprintf(stderr, COLOR_RED "[!] Analysis failed: " COLOR_RESET "%s\n", members[i].path);
+            continue;
+        }
+
+        int st;
+        pid_t pid = wait(&st);
+        if (pid < 0) break;
+        for (size_t i = next_print; i < next_start; i++) {
+            if (pids[i] == pid) {
+                status[i] = st;
+                done[i] = true;
+                running--;
+                break;
             }
+        }
+    }
+    fflush(stdout);
 
-            unsigned int data_blocks = (file_size + BLOCK_SIZE - 1) / BLOCK_SIZE;
-            unsigned int end_of_file = pos + BLOCK_SIZE + data_blocks * BLOCK_SIZE;
+    free(done);
+    free(status);
+    free(pids);
+    free(outs);
+    tar_free_members(members, all);
+    free(args);
+    return true;
+}
 
-            pos += BLOCK_SIZE;
+/* ========================= Listing ========================= */
+/**
+ * @brief List the members (`-l`), with pax/GNU names and sparse sizes applied.
+ */
+static bool tar_list(bparser *parser)
+{
+    size_t count = 0;
+    tar_entry_t *members = tar_list_members(parser, &count);
+    for (size_t i = 0; i < count; i++) {
+        const tar_entry_t *m = &members[i];
+        printf(COLOR_GREEN "%c %06o" COLOR_RESET " %12llu %12lld  %s", m->type ? m->type : '0', m->mode & 07777,
+               (unsigned long long)m->real_size, (long long)m->mtime, m->path);
+        if (m->link) printf(" -> %s", m->link);
+        if (m->sparse)
+            printf(COLOR_YELLOW "  (sparse, %zu segments, %llu bytes stored)" COLOR_RESET, m->sparse_count,
+                   (unsigned long long)m->size);
+        printf("\n");
+    }
+    printf(COLOR_BLUE "%zu members\n" COLOR_RESET, count);
+    tar_free_members(members, count);
+    return true;
+}
 
-            if(file_size == 0) {
-                pos = end_of_file;
-                free(block);
-                continue;
-            }
+/* ========================= Metadata ========================= */
+static const char *tar_type_name(char type)
+{
+    switch (type) {
+    case REGTYPE: case AREGTYPE: return "regular file";
+    case LNKTYPE:  return "hard link";
+    case SYMTYPE:  return "symbolic link";
+    case CHRTYPE:  return "character special file";
+    case BLKTYPE:  return "block special file";
+    case DIRTYPE:  return "directory";
+    case FIFOTYPE: return "FIFO";
+    case CONTTYPE: return "contiguous file";
+    default:       return "unknown type";
+    }
+}
 
-            //             FILE* fp = fopen(header->name, "wb");
-            //             if(!fp) {
-            //                 perror("fopen");
-            //                 pos = end_of_file;
-            //                 free(block);
-            //                 continue;
-            //             }
-
-            unsigned int remaining = file_size;
-            while (pos < end_of_file) {
-                unsigned int to_read = BLOCK_SIZE;
-                if (end_of_file - pos < BLOCK_SIZE)
-                    to_read = end_of_file - pos;
-
-                void* block_content = malloc(to_read);
-                size_t block_size = bparser_read(parser, block_content, pos, to_read);
-
-                // if(block_size > 0) {
-                //     size_t write_bytes = (remaining >= block_size) ? block_size : remaining;
-                //     fwrite(block_content, 1, write_bytes, fp);
-                //     remaining -= write_bytes;
-                // }
-                // for (char* byte = (char*)block_content; byte<(char*)block_content+block_size;byte++) {
-                //     printf("%02x", *byte);
-                // }
-
-                char* ptr = (char*)block_content;
-                printf(COLOR_GREEN "|" COLOR_RESET);
-                print_hex_header((unsigned long long)pos);
-
-                unsigned long long i, j;
-                for (i = 0; ptr < (char*)block_content+block_size; i += BLOCK_LENGTH) {
-                    // Print offset
-                    printf(COLOR_GREEN "|----0x%08llx:  " COLOR_RESET,  pos + i);
-
-                    // Print hex bytes
-                    for (j = 0; j < BLOCK_LENGTH; j++) {
-                        if (i + j < (size_t)(unsigned char*)block_content+block_size) {
-                            const unsigned char c = ptr[i + j];
-                            display_byte(&c);
-                        // printf("%02x", ptr[i + j]);
-                        } else {
-                            printf("   "); // padding for alignment
-                        }
-                        if ((j + 1) % 2 == 0)
-                            printf(" "); // extra space every 2 bytes
-                    }
-
-                    // Print ASCII chars
-                    printf(" |");
-                    for (j = 0; j < BLOCK_LENGTH && i + j < (size_t)(unsigned char*)block_content+block_size; j++) {
-                        const unsigned char c = ptr[i + j];
-                        display_byte_char(&c);
-                    }
-                    printf("|");
-                    printf("\n");
-                    ptr+=16;
-                }
-
-                free(block_content);
-                pos += to_read;
+/**
+ * @brief Hex dump the data of a member, one offset header per block.
+ */
+static void tar_dump_data(bparser *parser, uint64_t off, uint64_t size)
+{
+    unsigned char block[BLOCK_SIZE];
+    for (uint64_t done = 0; done < size; done += BLOCK_SIZE) {
+        size_t n = bparser_read(parser, block, off + done, size - done < BLOCK_SIZE ? size - done : BLOCK_SIZE);
+        if (n == 0) break;
+        printf(COLOR_GREEN "|" COLOR_RESET);
+        print_hex_header((unsigned long long)(off + done));
+        for (size_t i = 0; i < n; i += BLOCK_LENGTH) {
+            printf(COLOR_GREEN "|----0x%08llx:  " COLOR_RESET, (unsigned long long)(off + done + i));
+            for (size_t j = 0; j < BLOCK_LENGTH; j++) {
+                if (i + j < n) display_byte(&block[i + j]);
+                else printf("   ");   // padding for alignment
+                if ((j + 1) % 2 == 0) printf(" ");
             }
-            // fclose(fp);
-            // printf("Length Bytes: %d\n", file_size);
-
-            free(block);
+            printf(" |");
+            for (size_t j = 0; j < BLOCK_LENGTH && i + j < n; j++) display_byte_char(&block[i + j]);
+            printf("|\n");
         }
+    }
+}
+
+/**
+ * @brief Print the header fields and dump the data of every member (`-m`).
+ *
+ * The walk is tar_next_member()'s, so pax and GNU long-name headers are
+ * applied to their member instead of being listed as members, and sizes
+ * are read in octal or base-256.
+ */
+static bool tar_metadata(bparser *parser)
+{
+    tar_member_t *m = malloc(sizeof(*m));
+    if (!m) return false;
+
+    for (uint64_t pos = 0; tar_next_member(parser, &pos, m); ) {
+        posix_header h;
+        if (bparser_read(parser, &h, m->block_off, sizeof(h)) != sizeof(h)) memset(&h, 0, sizeof(h));
+        printf("\n=== TAR Header Info ===\n");
+        printf(COLOR_GREEN "|--[  0] name      :%s %.*s\n", COLOR_RESET, (int)sizeof(h.name), h.name);
+        printf(COLOR_GREEN "|--[100] mode      :%s %.*s\n", COLOR_RESET, (int)sizeof(h.mode), h.mode);
+        printf(COLOR_GREEN "|--[108] uid       :%s %.*s\n", COLOR_RESET, (int)sizeof(h.uid), h.uid);
+        printf(COLOR_GREEN "|--[116] gid       :%s %.*s\n", COLOR_RESET, (int)sizeof(h.gid), h.gid);
+        printf(COLOR_GREEN "|--[124] size      :%s %llu\n", COLOR_RESET, (unsigned long long)m->size);
+        printf(COLOR_GREEN "|--[136] mtime     :%s %lld\n", COLOR_RESET, (long long)m->mtime);
+        printf(COLOR_GREEN "|--[148] chksum    :%s %.*s\n", COLOR_RESET, (int)sizeof(h.chksum), h.chksum);
+        printf(COLOR_GREEN "|--[156] typeflag  :%s %c\n", COLOR_RESET, h.typeflag ? h.typeflag : '0');
+        printf(COLOR_GREEN "|--[157] linkname  :%s %.*s\n", COLOR_RESET, (int)sizeof(h.linkname), h.linkname);
+        printf(COLOR_GREEN "|--[257] magic     :%s %.*s\n", COLOR_RESET, (int)sizeof(h.magic), h.magic);
+        printf(COLOR_GREEN "|--[263] version   :%s %.*s\n", COLOR_RESET, (int)sizeof(h.version), h.version);
+        printf(COLOR_GREEN "|--[265] uname     :%s %.*s\n", COLOR_RESET, (int)sizeof(h.uname), h.uname);
+        printf(COLOR_GREEN "|--[297] gname     :%s %.*s\n", COLOR_RESET, (int)sizeof(h.gname), h.gname);
+        printf(COLOR_GREEN "|--[329] devmajor  :%s %.*s\n", COLOR_RESET, (int)sizeof(h.devmajor), h.devmajor);
+        printf(COLOR_GREEN "|--[337] devminor  :%s %.*s\n", COLOR_RESET, (int)sizeof(h.devminor), h.devminor);
+        // GNU headers keep other fields where POSIX has the prefix
+        if (memcmp(h.magic, "ustar", 6) == 0)
+            printf(COLOR_GREEN "|--[345] prefix    :%s %.*s\n", COLOR_RESET, (int)sizeof(h.prefix), h.prefix);
+        printf(COLOR_GREEN "|--path            :%s %s\n", COLOR_RESET, m->path);
+        if (m->type == LNKTYPE || m->type == SYMTYPE)
+            printf(COLOR_GREEN "|--link            :%s %s\n", COLOR_RESET, m->link);
+        if (m->block_off != m->hdr_off)
+            printf(COLOR_GREEN "|--extended        :%s 0x%llx\n", COLOR_RESET, (unsigned long long)m->hdr_off);
+        if (m->sparse)
+            printf(COLOR_GREEN "|--sparse          :%s %llu bytes, %zu segments\n", COLOR_RESET,
+                   (unsigned long long)m->real_size, m->sparse_count);
+        printf(COLOR_YELLOW "|---This is %s\n" COLOR_RESET, tar_type_name(m->type));
+
+        // links, devices, directories and FIFOs have no data blocks
+        if (m->type < LNKTYPE || m->type > FIFOTYPE) tar_dump_data(parser, m->data_off, m->size);
+        free(m->sparse);
+    }
+    free(m);
+    return true;
+}
+
+bool bx_tar(bparser* parser, void *arg)
+{
+    int argc = *((inputs*)arg) -> argc;
+    char** args = ((inputs*)arg) -> args;
+
+    if(strcmp("-m", args[2]) == 0) {
+        tar_metadata(parser);
+    } else if (strcmp("--scan", args[2]) == 0 && argc > 3) {
+        bparser_apply(parser, b_scan, arg);
+    } else if (strcmp("--carve", args[2]) == 0) {
+        bparser_apply(parser, b_carve, arg);
+    } else if (strcmp("--hash", args[2]) == 0) {
+        bparser_apply(parser, b_hash, arg);
+    } else if (strcmp("-l", args[2]) == 0) {
+        tar_list(parser);
+    } else if (strcmp("-r", args[2]) == 0) {
+        tar_recursive(parser, arg);
+    } else if (strcmp("-x", args[2]) == 0 && argc > 3) {
+        bparser_apply(parser, b_tar_extract, arg);
+    } else if (strcmp("--index", args[2]) == 0) {
+        bparser_apply(parser, b_tar_index, arg);
+    } else if (strcmp("--member", args[2]) == 0 && argc > 3) {
+        bparser_apply(parser, b_tar_member, arg);
     } else {
         fprintf(stderr, "[!] Unsupported flag: %s\n", args[2]);
         // printf(COLOR_YELLOW "[!] Not implemented "COLOR_RED"%s"COLOR_RESET COLOR_YELLOW" yet\n" COLOR_RESET, args[2]);
@@ -4,6 +4,108 @@
 #include "../../baseer.h"
 #include <string.h>
 #include "../../utils/ui.h"
+#include "../b_scan/b_scan.h"
+#include "../b_carve/b_carve.h"
+#include "../b_hash/b_hash.h"
+#include <stdint.h>
+
+#define TAR_MAX_PATH 4096
+
+/* Values used in typeflag field.  */
+#define REGTYPE  '0'            /* regular file */
+#define AREGTYPE '\0'           /* regular file */
+#define LNKTYPE  '1'            /* link */
+#define SYMTYPE  '2'            /* reserved */
+#define CHRTYPE  '3'            /* character special */
+#define BLKTYPE  '4'            /* block special */
+#define DIRTYPE  '5'            /* directory */
+#define FIFOTYPE '6'            /* FIFO special */
+#define CONTTYPE '7'            /* reserved */
+#define XHDTYPE  'x'            /* pax extended header (next member) */
+#define XGLTYPE  'g'            /* pax global header */
+#define GNUTYPE_LONGNAME 'L'    /* GNU long name of the next member */
+#define GNUTYPE_LONGLINK 'K'    /* GNU long link name of the next member */
+#define GNUTYPE_SPARSE   'S'    /* GNU (old format) sparse file */
+#define BLOCK_SIZE 512
+
+#define TAR_MAX_PAX (16 * 1024 * 1024)   /**< Largest pax header accepted */
+#define TAR_MAX_SPARSE (1 << 20)         /**< Largest sparse map accepted */
+
+/**
+ * @brief One data segment of a sparse member.
+ *
+ * The segments are stored back to back in the archive; everything between
+ * them in the real file is a hole.
+ */
+typedef struct {
+    uint64_t offset;        /**< Offset in the real file */
+    uint64_t size;
+} tar_sparse_t;
+
+/**
+ * @brief One archive member, located in the archive image.
+ *
+ * pax and GNU long names are already applied. For sparse members, `size`
+ * is the stored (packed) data and `real_size` the size of the real file.
+ */
+typedef struct {
+    char path[TAR_MAX_PATH];
+    char link[TAR_MAX_PATH];  /**< Link target of hard and symbolic links */
+    char type;              /**< typeflag (GNU sparse members are reported as REGTYPE) */
+    uint64_t hdr_off;       /**< Offset of the header block (or of its first pax/GNU header) */
+    uint64_t block_off;     /**< Offset of the member's own header block, after its pax/GNU headers */
+    uint64_t data_off;      /**< Offset of the member data */
+    uint64_t size;          /**< Size of the member data */
+    uint64_t real_size;     /**< Size of the extracted file */
+    uint32_t mode;
+    int64_t mtime;
+    tar_sparse_t *sparse;   /**< Sparse map (owned by the caller), NULL if not sparse */
+    size_t sparse_count;
+} tar_member_t;
+
+/**
+ * @brief Read the member whose header is at *pos and move *pos to the next one.
+ *
+ * pax extended (`x`) headers and GNU long names (`L`, `K`) are applied to
+ * the member that follows them, and pax global (`g`) headers are skipped.
+ * Old GNU (`S`) and pax (0.0, 0.1, 1.0) sparse maps are decoded into
+ * m->sparse, which the caller frees.
+ *
+ * @param parser Parser over the archive
+ * @param pos    Offset of the header, updated to the next header
+ * @param m      Receives the member
+ * @return false at the end of the archive, and on a bad checksum or a
+ *         member whose data does not fit in the archive (the walk never
+ *         moves backwards or stays in place)
+ */
+bool tar_next_member(bparser *parser, uint64_t *pos, tar_member_t *m);
+
+/**
+ * @brief Compact copy of a member, for lists of every member of an archive.
+ */
+typedef struct {
+    char *path;
+    char *link;             /**< NULL unless the member is a link */
+    char type;
+    uint64_t hdr_off;
+    uint64_t data_off;
+    uint64_t size;
+    uint64_t real_size;
+    uint32_t mode;
+    int64_t mtime;
+    tar_sparse_t *sparse;
+    size_t sparse_count;
+} tar_entry_t;
+
+/**
+ * @brief List the members of an archive in one pass over the header chain.
+ *
+ * @param parser Parser over the archive
+ * @param count  Receives the number of members
+ * @return Array of members (free with tar_free_members()), NULL if empty
+ */
+tar_entry_t *tar_list_members(bparser *parser, size_t *count);
+void tar_free_members(tar_entry_t *entries, size_t count);
 
 bool bx_tar(bparser* parser, void *arg);
 
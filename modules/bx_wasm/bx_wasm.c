@@ -0,0 +1,743 @@
+/**
+ * @file bx_wasm.c
+ * @brief WebAssembly sections, signatures and function bodies.
+ */
+#include "bx_wasm.h"
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+#include "../b_scan/b_scan.h"
+#include "../b_carve/b_carve.h"
+#include "../b_hash/b_hash.h"
+
+#define LEB_CONT 0x8080808080808080ull  /**< Continuation bit of each byte */
+#define LEB_DATA 0x7f7f7f7f7f7f7f7full
+
+/**
+ * @brief Bounded cursor over a section; any overrun sets err and yields 0.
+ */
+typedef struct {
+    const unsigned char *p, *end;
+    bool err;
+} wasm_reader_t;
+
+// ========================= BEGIN LEB128 ==================================
+/**
+ * @brief Pack the 7-bit groups of up to 8 LEB128 bytes (already masked to
+ * the encoding) into one integer, without a loop.
+ */
+static inline uint64_t leb_pack(uint64_t w)
+{
+#ifdef __BMI2__
+    return _pext_u64(w, LEB_DATA);
+#else
+    w &= LEB_DATA;
+    w = (w & 0x007f007f007f007full) | ((w & 0x7f007f007f007f00ull) >> 1);
+    w = (w & 0x00003fff00003fffull) | ((w & 0x3fff00003fff0000ull) >> 2);
+    return (w & 0x000000000fffffffull) | ((w & 0x0fffffff00000000ull) >> 4);
+#endif
+}
+
+/**
+ * @brief Byte-at-a-time decoder, for the end of the section and 64-bit values.
+ */
+static uint64_t leb_slow(wasm_reader_t *r, unsigned max_bytes)
+{
+    uint64_t v = 0;
+    for (unsigned i = 0, shift = 0; i < max_bytes && r->p < r->end; i++, shift += 7) {
+        unsigned char b = *r->p++;
+        v |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) return v;
+    }
+    r->err = true;
+    return 0;
+}
+
+/**
+ * @brief Decode an unsigned LEB128 of at most 5 bytes.
+ *
+ * With 8 readable bytes, one load finds the terminating byte (the first
+ * without its continuation bit) and the value is packed in constant time,
+ * whatever its length.
+ */
+static inline uint32_t leb_u32(wasm_reader_t *r)
+{
+    if (r->end - r->p >= 8) {
+        uint64_t w = rd64le(r->p);
+        uint64_t stop = ~w & LEB_CONT;
+        unsigned len = stop ? (unsigned)__builtin_ctzll(stop) / 8 + 1 : 9;
+        if (len > 5) {
+            r->err = true;
+            return 0;
+        }
+        r->p += len;
+        return (uint32_t)leb_pack(w & (stop ^ (stop - 1)));   // keep the bytes up to the terminator
+    }
+    return (uint32_t)leb_slow(r, 5);
+}
+
+/**
+ * @brief Decode a vector of n unsigned LEB128 values (function type
+ * indices, supertypes). Runs of eight single-byte values, the common case,
+ * are copied out of one load.
+ */
+static bool leb_u32_batch(wasm_reader_t *r, uint32_t *out, size_t n)
+{
+    size_t i = 0;
+    while (n - i >= 8 && r->end - r->p >= 8) {
+        uint64_t w = rd64le(r->p);
+        if (!(w & LEB_CONT)) {
+            for (int k = 0; k < 8; k++) out[i + k] = (uint32_t)(w >> (8 * k)) & 0xff;
+            i += 8;
+            r->p += 8;
+            continue;
+        }
+        out[i++] = leb_u32(r);
+        if (r->err) return false;
+    }
+    while (i < n && !r->err) out[i++] = leb_u32(r);
+    return !r->err;
+}
+
+/**
+ * @brief Signed LEB128 of at most 33 bits (heap types, block types).
+ */
+static int64_t leb_s33(wasm_reader_t *r)
+{
+    int64_t v = 0;
+    unsigned shift = 0;
+    for (unsigned i = 0; i < 5 && r->p < r->end; i++) {
+        unsigned char b = *r->p++;
+        v |= (int64_t)(b & 0x7f) << shift;
+        shift += 7;
+        if (!(b & 0x80)) {
+            if (b & 0x40) v |= -((int64_t)1 << shift);
+            return v;
+        }
+    }
+    r->err = true;
+    return 0;
+}
+// ========================= END LEB128 ==================================
+
+// ========================= BEGIN SECTIONS ==================================
+static uint8_t read_byte(wasm_reader_t *r)
+{
+    if (r->p >= r->end) {
+        r->err = true;
+        return 0;
+    }
+    return *r->p++;
+}
+
+/**
+ * @brief Read a vector length, rejecting one larger than the bytes left
+ * (every element takes at least a byte), so it can size an allocation.
+ */
+static uint32_t read_count(wasm_reader_t *r)
+{
+    uint32_t n = leb_u32(r);
+    if (n > (size_t)(r->end - r->p)) {
+        r->err = true;
+        return 0;
+    }
+    return n;
+}
+
+static void read_name(wasm_reader_t *r, wasm_name_t *name)
+{
+    uint32_t len = leb_u32(r);
+    if (r->err || len > (size_t)(r->end - r->p)) {
+        r->err = true;
+        name->str = NULL, name->len = 0;
+        return;
+    }
+    name->str = r->p, name->len = len;
+    r->p += len;
+}
+
+static const char *valtype_name(unsigned char b)
+{
+    switch (b) {
+    case 0x7f: return "i32";
+    case 0x7e: return "i64";
+    case 0x7d: return "f32";
+    case 0x7c: return "f64";
+    case 0x7b: return "v128";
+    case 0x78: return "i8";             // packed, struct and array fields only
+    case 0x77: return "i16";
+    case 0x74: return "nullexnref";
+    case 0x73: return "nullfuncref";
+    case 0x72: return "nullexternref";
+    case 0x71: return "nullref";
+    case 0x70: return "funcref";
+    case 0x6f: return "externref";
+    case 0x6e: return "anyref";
+    case 0x6d: return "eqref";
+    case 0x6c: return "i31ref";
+    case 0x6b: return "structref";
+    case 0x6a: return "arrayref";
+    case 0x69: return "exnref";
+    default:   return NULL;
+    }
+}
+
+/**
+ * @brief Read a value (or storage) type and write its text form (buf may
+ * be NULL to only skip it).
+ *
+ * @return false if the type is unknown, the reader is then in error.
+ */
+static bool read_valtype(wasm_reader_t *r, char *buf, size_t size)
+{
+    unsigned char b = read_byte(r);
+    if (b == 0x63 || b == 0x64) {
+        // (ref null? heaptype): abstract heap types are negative, type indices are not
+        int64_t ht = leb_s33(r);
+        if (!buf) return !r->err;
+        const char *null = b == 0x63 ? "null " : "";
+        const char *abs = ht >= -0x17 && ht <= -0x0c ? valtype_name((unsigned char)(ht & 0x7f)) : NULL;
+        if (abs)
+            snprintf(buf, size, "(ref %s%.*s)", null, (int)(strlen(abs) - 3), abs);   // "funcref" -> "func"
+        else
+            snprintf(buf, size, "(ref %s%lld)", null, (long long)ht);
+        return !r->err;
+    }
+    const char *name = valtype_name(b);
+    if (!name) {
+        r->err = true;
+        return false;
+    }
+    if (buf) snprintf(buf, size, "%s", name);
+    return true;
+}
+
+static void skip_valtype(wasm_reader_t *r)
+{
+    read_valtype(r, NULL, 0);
+}
+
+static bool add_item(void **items, size_t *count, size_t *cap, size_t elem, const void *item)
+{
+    if (*count == *cap) {
+        size_t n = *cap ? *cap * 2 : 16;
+        void *tmp = realloc(*items, n * elem);
+        if (!tmp) return false;
+        *items = tmp, *cap = n;
+    }
+    memcpy((char *)*items + *count * elem, item, elem);
+    (*count)++;
+    return true;
+}
+
+/**
+ * @brief Read one composite type (func, struct or array) and record it.
+ */
+static void read_comptype(wasm_module_t *w, wasm_reader_t *r, size_t *cap)
+{
+    unsigned char form = read_byte(r);
+    wasm_type_t t = {.func = form == 0x60, .off = (uint64_t)(r->p - w->image)};
+    if (form == 0x60) {
+        for (int v = 0; v < 2 && !r->err; v++) {     // parameters, then results
+            uint32_t n = read_count(r);
+            for (uint32_t i = 0; i < n && !r->err; i++) skip_valtype(r);
+        }
+    } else if (form == 0x5f || form == 0x5e) {
+        uint32_t n = form == 0x5f ? read_count(r) : 1;
+        for (uint32_t i = 0; i < n && !r->err; i++) {
+            skip_valtype(r);
+            read_byte(r);                           // mutability
+        }
+    } else {
+        r->err = true;
+    }
+    if (!r->err && !add_item((void **)&w->types, &w->ntypes, cap, sizeof(t), &t)) r->err = true;
+}
+
+/**
+ * @brief Type section. With GC, entries may be recursive groups and
+ * subtypes, each member taking its own type index.
+ */
+static void read_types(wasm_module_t *w, wasm_reader_t *r)
+{
+    size_t cap = 0;
+    uint32_t count = read_count(r);
+    for (uint32_t i = 0; i < count && !r->err; i++) {
+        uint32_t group = 1;
+        if (r->p < r->end && *r->p == 0x4e) {       // rec
+            r->p++;
+            group = read_count(r);
+        }
+        for (uint32_t j = 0; j < group && !r->err; j++) {
+            if (r->p < r->end && (*r->p == 0x50 || *r->p == 0x4f)) {   // sub, sub final
+                r->p++;
+                uint32_t n = read_count(r);
+                for (uint32_t k = 0; k < n && !r->err; k++) leb_u32(r);
+            }
+            read_comptype(w, r, &cap);
+        }
+    }
+}
+
+static void read_limits(wasm_reader_t *r, wasm_import_t *imp)
+{
+    imp->flags = read_byte(r);
+    unsigned bytes = imp->flags & 4 ? 10 : 5;       // 64-bit memories and tables
+    imp->min = leb_slow(r, bytes);
+    if (imp->flags & 1) imp->max = leb_slow(r, bytes);
+}
+
+static void read_imports(wasm_module_t *w, wasm_reader_t *r)
+{
+    uint32_t count = read_count(r);
+    w->imports = calloc(count ? count : 1, sizeof(*w->imports));
+    if (!w->imports) {
+        r->err = true;
+        return;
+    }
+    for (uint32_t i = 0; i < count && !r->err; i++) {
+        wasm_import_t *imp = &w->imports[i];
+        read_name(r, &imp->module);
+        read_name(r, &imp->field);
+        imp->kind = read_byte(r);
+        imp->desc = (uint64_t)(r->p - w->image);
+        switch (imp->kind) {
+        case WASM_EXT_FUNC:
+            imp->index = leb_u32(r);
+            w->nfunc_imports++;
+            break;
+        case WASM_EXT_TABLE:
+            skip_valtype(r);
+            read_limits(r, imp);
+            break;
+        case WASM_EXT_MEMORY:
+            read_limits(r, imp);
+            break;
+        case WASM_EXT_GLOBAL:
+            skip_valtype(r);
+            read_byte(r);
+            break;
+        case WASM_EXT_TAG:
+            read_byte(r);                           // attribute, 0 is exception
+            imp->index = leb_u32(r);
+            break;
+        default:
+            r->err = true;
+        }
+        if (!r->err) w->nimports++;
+    }
+}
+
+static void read_functions(wasm_module_t *w, wasm_reader_t *r)
+{
+    uint32_t count = read_count(r);
+    w->funcs = calloc(count ? count : 1, sizeof(*w->funcs));
+    if (!w->funcs) {
+        r->err = true;
+        return;
+    }
+    uint32_t types[256];
+    for (uint32_t i = 0; i < count; i += 256) {
+        uint32_t n = count - i < 256 ? count - i : 256;
+        if (!leb_u32_batch(r, types, n)) return;
+        for (uint32_t j = 0; j < n; j++) w->funcs[i + j].type = types[j];
+    }
+    w->nfuncs = count;
+}
+
+static void read_exports(wasm_module_t *w, wasm_reader_t *r)
+{
+    uint32_t count = read_count(r);
+    w->exports = calloc(count ? count : 1, sizeof(*w->exports));
+    if (!w->exports) {
+        r->err = true;
+        return;
+    }
+    for (uint32_t i = 0; i < count && !r->err; i++) {
+        wasm_export_t *e = &w->exports[i];
+        read_name(r, &e->name);
+        e->kind = read_byte(r);
+        e->index = leb_u32(r);
+        if (!r->err) w->nexports++;
+    }
+}
+
+/**
+ * @brief Code section: the body range and local count of every function,
+ * skipping the instructions themselves.
+ */
+static void read_code(wasm_module_t *w, wasm_reader_t *r)
+{
+    uint32_t count = read_count(r);
+    if (count != w->nfuncs)
+        fprintf(stderr, COLOR_YELLOW "[!] %u bodies for %zu functions\n" COLOR_RESET, count, w->nfuncs);
+    for (uint32_t i = 0; i < count && !r->err; i++) {
+        uint32_t size = leb_u32(r);
+        if (r->err || size > (size_t)(r->end - r->p)) {
+            r->err = true;
+            break;
+        }
+        const unsigned char *body = r->p;
+        if (i < w->nfuncs) {
+            wasm_func_t *f = &w->funcs[i];
+            wasm_reader_t b = {body, body + size, false};
+            uint32_t decls = read_count(&b);
+            uint64_t locals = 0;
+            for (uint32_t j = 0; j < decls && !b.err; j++) {
+                locals += leb_u32(&b);
+                skip_valtype(&b);
+            }
+            f->body_off = (uint64_t)(body - w->image);
+            f->body_size = size;
+            f->code_start = (uint32_t)(b.p - body);
+            f->locals = locals > UINT32_MAX ? UINT32_MAX : (uint32_t)locals;
+            if (b.err)
+                fprintf(stderr, COLOR_RED "[!] Bad local declarations at " COLOR_RESET "0x%llx\n",
+                        (unsigned long long)f->body_off);
+        }
+        r->p = body + size;
+    }
+}
+
+/**
+ * @brief Function symbols of the "linking" section (relocatable objects
+ * have no "name" section).
+ */
+static void load_linking(wasm_module_t *w, const wasm_section_t *linking, size_t total)
+{
+    wasm_reader_t r = {w->image + linking->off, w->image + linking->off + linking->size, false};
+    wasm_name_t skip;
+    read_name(&r, &skip);                           // "linking"
+    leb_u32(&r);                                    // version
+    while (r.p < r.end && !r.err) {
+        uint8_t id = read_byte(&r);
+        uint32_t size = leb_u32(&r);
+        if (r.err || size > (size_t)(r.end - r.p)) break;
+        wasm_reader_t s = {r.p, r.p + size, false};
+        uint32_t count = id == 8 ? read_count(&s) : 0;  // WASM_SYMBOL_TABLE
+        for (uint32_t i = 0; i < count && !s.err; i++) {
+            uint8_t kind = read_byte(&s);
+            uint32_t flags = leb_u32(&s);
+            wasm_name_t name = {0};
+            if (kind == 1) {                        // data: name, then segment, offset, size if defined
+                read_name(&s, &name);
+                if (!(flags & 0x10)) leb_u32(&s), leb_slow(&s, 10), leb_slow(&s, 10);
+            } else if (kind == 3) {                 // section
+                leb_u32(&s);
+            } else {
+                uint32_t idx = leb_u32(&s);
+                if (!(flags & 0x10) || (flags & 0x40)) read_name(&s, &name);   // defined, or explicit name
+                if (kind == 0 && name.str && idx < total && !s.err) w->func_names[idx] = name;
+            }
+        }
+        r.p += size;
+    }
+}
+
+/**
+ * @brief Function names: defaults to the import field or the export name,
+ * then the "linking" symbols and the "name" section take precedence.
+ */
+static void load_names(wasm_module_t *w, const wasm_section_t *names, const wasm_section_t *linking)
+{
+    size_t total = w->nfunc_imports + w->nfuncs;
+    w->func_names = calloc(total ? total : 1, sizeof(*w->func_names));
+    if (!w->func_names) return;
+    for (size_t i = 0, f = 0; i < w->nimports; i++)
+        if (w->imports[i].kind == WASM_EXT_FUNC) w->func_names[f++] = w->imports[i].field;
+    for (size_t i = 0; i < w->nexports; i++) {
+        const wasm_export_t *e = &w->exports[i];
+        if (e->kind == WASM_EXT_FUNC && e->index < total && !w->func_names[e->index].str)
+            w->func_names[e->index] = e->name;
+    }
+    if (linking) load_linking(w, linking, total);
+    if (!names) return;
+
+    wasm_reader_t r = {w->image + names->off, w->image + names->off + names->size, false};
+    wasm_name_t skip;
+    read_name(&r, &skip);                           // "name"
+    while (r.p < r.end && !r.err) {
+        uint8_t id = read_byte(&r);
+        uint32_t size = leb_u32(&r);
+        if (r.err || size > (size_t)(r.end - r.p)) break;
+        if (id == 1) {
+            wasm_reader_t s = {r.p, r.p + size, false};
+            uint32_t count = read_count(&s);
+            for (uint32_t i = 0; i < count && !s.err; i++) {
+                uint32_t idx = leb_u32(&s);
+                wasm_name_t name;
+                read_name(&s, &name);
+                if (!s.err && idx < total) w->func_names[idx] = name;
+            }
+        }
+        r.p += size;
+    }
+}
+
+static const char *section_name(uint8_t id)
+{
+    static const char *names[] = {"custom", "type", "import", "function", "table", "memory", "global",
+                                  "export", "start", "element", "code", "data", "datacount", "tag"};
+    return id < sizeof(names) / sizeof(names[0]) ? names[id] : "unknown";
+}
+
+/**
+ * @brief Decode the payload of one section.
+ */
+static void read_section(wasm_module_t *w, wasm_section_t *sec, wasm_reader_t *r)
+{
+    switch (sec->id) {
+    case WASM_SEC_CUSTOM:
+        read_name(r, &sec->name);
+        break;
+    case WASM_SEC_TYPE:     read_types(w, r); break;
+    case WASM_SEC_IMPORT:   read_imports(w, r); break;
+    case WASM_SEC_FUNCTION: read_functions(w, r); break;
+    case WASM_SEC_EXPORT:   read_exports(w, r); break;
+    case WASM_SEC_CODE:     read_code(w, r); break;
+    case WASM_SEC_START:
+        w->start = leb_u32(r);
+        w->has_start = !r->err;
+        break;
+    default:
+        break;
+    }
+}
+
+wasm_module_t *wasm_open(bparser *parser)
+{
+    unsigned char h[WASM_HEADER_SIZE];
+    if (bparser_read(parser, h, 0, sizeof(h)) != sizeof(h) || memcmp(h, "\0asm", 4) != 0)
+        return NULL;
+    wasm_module_t *w = calloc(1, sizeof(*w));
+    if (!w) return NULL;
+    w->parser = parser;
+    w->size = parser->size;
+    w->version = (uint32_t)h[4] | (uint32_t)h[5] << 8 | (uint32_t)h[6] << 16 | (uint32_t)h[7] << 24;
+    if (w->version != WASM_VERSION) {
+        fprintf(stderr, COLOR_RED "[!] Unsupported WebAssembly version " COLOR_RESET "0x%x%s\n", w->version,
+                w->version >> 16 ? " (component)" : "");
+        free(w);
+        return NULL;
+    }
+
+    if (parser->block) {
+        w->image = parser->block;
+    } else {
+        if (w->size > WASM_MAX_MODULE || !(w->owned = malloc(w->size)) ||
+            bparser_read(parser, w->owned, 0, w->size) != w->size) {
+            fprintf(stderr, COLOR_RED "[!] Cannot read the module\n" COLOR_RESET);
+            free(w->owned);
+            free(w);
+            return NULL;
+        }
+        w->image = w->owned;
+    }
+
+    size_t cap = 0;
+    uint32_t seen = 0;                              // known sections appear at most once
+    const wasm_section_t *names = NULL;
+    wasm_reader_t top = {w->image + WASM_HEADER_SIZE, w->image + w->size, false};
+    while (top.p < top.end) {
+        wasm_section_t sec = {.id = read_byte(&top)};
+        sec.size = leb_u32(&top);
+        if (top.err || sec.size > (size_t)(top.end - top.p)) {
+            fprintf(stderr, COLOR_RED "[!] Truncated section at " COLOR_RESET "0x%llx\n",
+                    (unsigned long long)(top.p - w->image));
+            break;
+        }
+        sec.off = (uint64_t)(top.p - w->image);
+        wasm_reader_t r = {top.p, top.p + sec.size, false};
+        bool dup = sec.id != WASM_SEC_CUSTOM && sec.id < 32 && (seen & 1u << sec.id);
+        if (sec.id < 32) seen |= 1u << sec.id;
+        if (dup)
+            fprintf(stderr, COLOR_YELLOW "[!] Duplicate %s section at 0x%llx, ignored\n" COLOR_RESET,
+                    section_name(sec.id), (unsigned long long)sec.off);
+        else
+            read_section(w, &sec, &r);
+        if (r.err)
+            fprintf(stderr, COLOR_RED "[!] Malformed %s section at " COLOR_RESET "0x%llx\n", section_name(sec.id),
+                    (unsigned long long)sec.off);
+        if (!add_item((void **)&w->sections, &w->nsections, &cap, sizeof(sec), &sec)) break;
+        top.p += sec.size;
+    }
+
+    // the name section may come anywhere, index spaces are only complete now
+    const wasm_section_t *linking = NULL;
+    for (size_t i = 0; i < w->nsections; i++) {
+        const wasm_section_t *s = &w->sections[i];
+        if (s->id != WASM_SEC_CUSTOM || !s->name.str) continue;
+        if (s->name.len == 4 && memcmp(s->name.str, "name", 4) == 0) names = s;
+        if (s->name.len == 7 && memcmp(s->name.str, "linking", 7) == 0) linking = s;
+    }
+    load_names(w, names, linking);
+    return w;
+}
+
+void wasm_close(wasm_module_t *w)
+{
+    if (!w) return;
+    free(w->sections);
+    free(w->types);
+    free(w->imports);
+    free(w->exports);
+    free(w->funcs);
+    free(w->func_names);
+    free(w->owned);
+    free(w);
+}
+// ========================= END SECTIONS ==================================
+
+// ========================= BEGIN COMMANDS ==================================
+/**
+ * @brief Printable copy of a name (control bytes replaced, long names cut).
+ */
+static const char *name_str(const wasm_name_t *n, char buf[WASM_MAX_NAME + 1])
+{
+    size_t len = n && n->str ? (n->len < WASM_MAX_NAME ? n->len : WASM_MAX_NAME) : 0;
+    for (size_t i = 0; i < len; i++) buf[i] = n->str[i] < 0x20 || n->str[i] == 0x7f ? '.' : (char)n->str[i];
+    buf[len] = '\0';
+    return buf;
+}
+
+/**
+ * @brief "(params) -> (results)" of a type index.
+ */
+static void format_type(const wasm_module_t *w, uint32_t index, char *buf, size_t size)
+{
+    if (index >= w->ntypes || !w->types[index].func) {
+        snprintf(buf, size, index < w->ntypes ? "type %u (not a function)" : "type %u (?)", index);
+        return;
+    }
+    wasm_reader_t r = {w->image + w->types[index].off, w->image + w->size, false};
+    size_t used = 0;
+    for (int v = 0; v < 2; v++) {
+        uint32_t n = leb_u32(&r);
+        used += snprintf(buf + used, size - used, "%s(", v ? " -> " : "");
+        for (uint32_t i = 0; i < n && used < size && !r.err; i++) {
+            char t[48];
+            read_valtype(&r, t, sizeof(t));
+            used += snprintf(buf + used, size - used, "%s%s", i ? " " : "", t);
+        }
+        if (used >= size) break;
+        used += snprintf(buf + used, size - used, ")");
+        if (used >= size) break;
+    }
+}
+
+static const char *kind_name(uint8_t kind)
+{
+    static const char *names[] = {"func", "table", "memory", "global", "tag"};
+    return kind < sizeof(names) / sizeof(names[0]) ? names[kind] : "?";
+}
+
+static void print_import(const wasm_module_t *w, const wasm_import_t *imp)
+{
+    char mod[WASM_MAX_NAME + 1], field[WASM_MAX_NAME + 1], desc[512];
+    wasm_reader_t r = {w->image + imp->desc, w->image + w->size, false};
+    char t[48] = "";
+    switch (imp->kind) {
+    case WASM_EXT_FUNC:
+    case WASM_EXT_TAG:
+        format_type(w, imp->index, desc, sizeof(desc));
+        break;
+    case WASM_EXT_GLOBAL:
+        read_valtype(&r, t, sizeof(t));
+        snprintf(desc, sizeof(desc), "%s%s", read_byte(&r) ? "mut " : "", t);
+        break;
+    default:
+        if (imp->kind == WASM_EXT_TABLE) read_valtype(&r, t, sizeof(t));
+        int n = snprintf(desc, sizeof(desc), "%s%smin %llu", t, *t ? " " : "", (unsigned long long)imp->min);
+        if (imp->flags & 1) n += snprintf(desc + n, sizeof(desc) - n, " max %llu", (unsigned long long)imp->max);
+        snprintf(desc + n, sizeof(desc) - n, "%s%s", imp->flags & 2 ? " shared" : "",
+                 imp->flags & 4 ? " 64-bit" : "");
+        break;
+    }
+    printf(COLOR_GREEN "|--" COLOR_RESET "%s.%s " COLOR_CYAN "%s" COLOR_RESET " %s\n", name_str(&imp->module, mod),
+           name_str(&imp->field, field), kind_name(imp->kind), desc);
+}
+
+static void wasm_metadata(const wasm_module_t *w)
+{
+    char name[WASM_MAX_NAME + 1], sig[512];
+    printf(COLOR_BLUE "\n=== WebAssembly Module ===\n" COLOR_RESET);
+    printf(COLOR_GREEN "|--version   :" COLOR_RESET " %u\n", w->version);
+    printf(COLOR_GREEN "|--size      :" COLOR_RESET " %llu bytes\n", (unsigned long long)w->size);
+    printf(COLOR_GREEN "|--functions :" COLOR_RESET " %zu imported, %zu defined\n", w->nfunc_imports, w->nfuncs);
+    if (w->has_start) {
+        const wasm_name_t *n = w->start < w->nfunc_imports + w->nfuncs ? &w->func_names[w->start] : NULL;
+        printf(COLOR_GREEN "|--start     :" COLOR_RESET " func %u %s\n", w->start, name_str(n, name));
+    }
+
+    printf(COLOR_BLUE "\n=== Sections (%zu) ===\n" COLOR_RESET, w->nsections);
+    for (size_t i = 0; i < w->nsections; i++) {
+        const wasm_section_t *s = &w->sections[i];
+        printf(COLOR_GREEN "|--" COLOR_RESET "[%2u] %-10s 0x%08llx %10u bytes", s->id, section_name(s->id),
+               (unsigned long long)s->off, s->size);
+        if (s->id == WASM_SEC_CUSTOM) printf("  \"%s\"", name_str(&s->name, name));
+        printf("\n");
+    }
+
+    printf(COLOR_BLUE "\n=== Types (%zu) ===\n" COLOR_RESET, w->ntypes);
+    for (size_t i = 0; i < w->ntypes; i++) {
+        if (w->types[i].func) format_type(w, (uint32_t)i, sig, sizeof(sig));
+        else snprintf(sig, sizeof(sig), "%s", w->image[w->types[i].off - 1] == 0x5f ? "struct" : "array");
+        printf(COLOR_GREEN "|--" COLOR_RESET "[%4zu] %s\n", i, sig);
+    }
+
+    printf(COLOR_BLUE "\n=== Imports (%zu) ===\n" COLOR_RESET, w->nimports);
+    for (size_t i = 0; i < w->nimports; i++) print_import(w, &w->imports[i]);
+
+    printf(COLOR_BLUE "\n=== Exports (%zu) ===\n" COLOR_RESET, w->nexports);
+    for (size_t i = 0; i < w->nexports; i++) {
+        const wasm_export_t *e = &w->exports[i];
+        printf(COLOR_GREEN "|--" COLOR_RESET "%s " COLOR_CYAN "%s" COLOR_RESET " %u\n", name_str(&e->name, name),
+               kind_name(e->kind), e->index);
+    }
+}
+
+static void wasm_list(const wasm_module_t *w)
+{
+    char name[WASM_MAX_NAME + 1], sig[512];
+    printf(COLOR_BLUE "\n=== Functions (%zu) ===\n" COLOR_RESET, w->nfuncs);
+    for (size_t i = 0; i < w->nfuncs; i++) {
+        const wasm_func_t *f = &w->funcs[i];
+        size_t index = w->nfunc_imports + i;
+        format_type(w, f->type, sig, sizeof(sig));
+        printf(COLOR_GREEN "|--" COLOR_RESET "[%5zu] " COLOR_YELLOW "%s" COLOR_RESET " %s\n", index,
+               name_str(&w->func_names[index], name), sig);
+        if (f->body_size)
+            printf("|    body 0x%08llx-0x%08llx (%u bytes), code at 0x%08llx, %u locals\n",
+                   (unsigned long long)f->body_off, (unsigned long long)(f->body_off + f->body_size), f->body_size,
+                   (unsigned long long)(f->body_off + f->code_start), f->locals);
+        else
+            printf("|    no body\n");
+    }
+}
+
+bool bx_wasm(bparser *parser, void *arg)
+{
+    inputs *input = arg;
+    int argc = *input->argc;
+    char **args = input->args;
+
+    if (strcmp("--scan", args[2]) == 0 && argc > 3) return bparser_apply(parser, b_scan, arg);
+    if (strcmp("--carve", args[2]) == 0) return bparser_apply(parser, b_carve, arg);
+    if (strcmp("--hash", args[2]) == 0) return bparser_apply(parser, b_hash, arg);
+
+    wasm_module_t *w = wasm_open(parser);
+    if (!w) {
+        fprintf(stderr, COLOR_RED "[!] Not a WebAssembly module\n" COLOR_RESET);
+        return false;
+    }
+    if (strcmp("-m", args[2]) == 0) {
+        wasm_metadata(w);
+    } else if (strcmp("-l", args[2]) == 0) {
+        wasm_list(w);
+    } else {
+        fprintf(stderr, "[!] Unsupported flag: %s\n", args[2]);
+    }
+    wasm_close(w);
+    return true;
+}
+// ========================= END COMMANDS ==================================
@@ -0,0 +1,143 @@
+/**
+ * @file bx_wasm.h
+ * @brief WebAssembly binary modules (`\0asm`).
+ *
+ * The module is walked section by section in place (zero-copy in memory
+ * mode). The type, import, function, export, start and code sections are
+ * decoded, as well as the function names of the "name" custom section (or
+ * the "linking" symbols of a relocatable object), so every defined function
+ * gets its signature, name and body range.
+ *
+ * LEB128 integers are decoded eight bytes at a time: the terminating byte
+ * is found with a mask and the 7-bit groups are packed without a loop
+ * (pext with BMI2, shifts and masks otherwise), and vectors of indices go
+ * through a batched decoder. Only the last bytes of the module fall back
+ * to the byte-at-a-time loop.
+ *
+ * Options (read from the command line):
+ * - `-m`   Sections, types, imports, exports and the start function.
+ * - `-l`   Defined functions: index, name, signature, locals and body range.
+ * - `--scan`, `--carve`, `--hash` As for any file.
+ */
+#ifndef BX_WASM_H
+#define BX_WASM_H
+#include "../bparser/bparser.h"
+#include "../../baseer.h"
+#include "../../utils/ui.h"
+#include <stdint.h>
+
+#define WASM_HEADER_SIZE  8
+#define WASM_VERSION      1
+#define WASM_MAX_MODULE   (1024ull * 1024 * 1024)   /**< Largest module copied in stream mode */
+#define WASM_MAX_NAME     256                       /**< Longest name printed */
+
+// section ids
+#define WASM_SEC_CUSTOM     0
+#define WASM_SEC_TYPE       1
+#define WASM_SEC_IMPORT     2
+#define WASM_SEC_FUNCTION   3
+#define WASM_SEC_TABLE      4
+#define WASM_SEC_MEMORY     5
+#define WASM_SEC_GLOBAL     6
+#define WASM_SEC_EXPORT     7
+#define WASM_SEC_START      8
+#define WASM_SEC_ELEMENT    9
+#define WASM_SEC_CODE       10
+#define WASM_SEC_DATA       11
+#define WASM_SEC_DATACOUNT  12
+#define WASM_SEC_TAG        13
+
+// import and export kinds
+#define WASM_EXT_FUNC    0
+#define WASM_EXT_TABLE   1
+#define WASM_EXT_MEMORY  2
+#define WASM_EXT_GLOBAL  3
+#define WASM_EXT_TAG     4
+
+/**
+ * @brief A name in the module (UTF-8, not NUL-terminated).
+ */
+typedef struct {
+    const unsigned char *str;
+    uint32_t len;
+} wasm_name_t;
+
+typedef struct {
+    uint8_t id;
+    uint64_t off;               /**< Payload offset */
+    uint32_t size;
+    wasm_name_t name;           /**< Custom sections */
+} wasm_section_t;
+
+/**
+ * @brief One type, a function signature unless it is a GC struct or array.
+ */
+typedef struct {
+    bool func;
+    uint64_t off;               /**< Parameter vector of a function type */
+} wasm_type_t;
+
+typedef struct {
+    wasm_name_t module, field;
+    uint8_t kind;
+    uint32_t index;             /**< Type of a function or tag */
+    uint64_t min, max;          /**< Limits of a table or memory */
+    uint8_t flags;              /**< Limits flags: 1 max, 2 shared, 4 64-bit */
+    uint64_t desc;              /**< Offset of the description */
+} wasm_import_t;
+
+typedef struct {
+    wasm_name_t name;
+    uint8_t kind;
+    uint32_t index;
+} wasm_export_t;
+
+/**
+ * @brief A function defined in the module (imports come first in the
+ * function index space, so its index is nfunc_imports + position).
+ */
+typedef struct {
+    uint64_t body_off;          /**< Offset of the body (local declarations, then code) */
+    uint32_t body_size;
+    uint32_t code_start;        /**< First instruction, relative to body_off */
+    uint32_t type;
+    uint32_t locals;
+} wasm_func_t;
+
+/**
+ * @brief A parsed module.
+ */
+typedef struct {
+    bparser *parser;
+    const unsigned char *image; /**< The whole module, in place or copied */
+    unsigned char *owned;
+    uint64_t size;
+    uint32_t version;
+    wasm_section_t *sections;
+    size_t nsections;
+    wasm_type_t *types;
+    size_t ntypes;
+    wasm_import_t *imports;
+    size_t nimports;
+    size_t nfunc_imports;
+    wasm_export_t *exports;
+    size_t nexports;
+    wasm_func_t *funcs;
+    size_t nfuncs;
+    wasm_name_t *func_names;    /**< Per function index (imports included), from the "name" section */
+    bool has_start;
+    uint32_t start;
+} wasm_module_t;
+
+/**
+ * @brief Walk the sections and decode the ones listed above.
+ *
+ * @return The module (free with wasm_close()), NULL if the header is not
+ *         a WebAssembly module.
+ */
+wasm_module_t *wasm_open(bparser *parser);
+void wasm_close(wasm_module_t *w);
+
+bool bx_wasm(bparser *parser, void *arg);
+
+#endif
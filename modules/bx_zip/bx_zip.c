@@ -0,0 +1,545 @@
+/**
+ * @file bx_zip.c
+ * @brief ZIP central directory walker, member access and analysis.
+ */
+#include "bx_zip.h"
+#include <zlib.h>
+#include "../binhead/bx_binhead.h"
+#include "../b_scan/b_scan.h"
+#include "../b_carve/b_carve.h"
+#include "../b_hash/b_hash.h"
+
+
+// ========================= BEGIN CENTRAL DIRECTORY ==================================
+/**
+ * @brief Find the end of central directory record in the last 64KB.
+ *
+ * Candidates are tried from the end; one is accepted when its comment
+ * fits in the file and its directory ends before it.
+ */
+static bool find_eocd(zip_archive_t *zip, uint32_t *cd_size, uint32_t *cd_off, uint64_t *count)
+{
+    bparser *parser = zip->parser;
+    size_t tail_len = parser->size < ZIP_EOCD_SIZE + ZIP_MAX_COMMENT ? parser->size : ZIP_EOCD_SIZE + ZIP_MAX_COMMENT;
+    uint64_t tail_off = parser->size - tail_len;
+    unsigned char *tail = malloc(tail_len);
+    if (!tail || bparser_read(parser, tail, tail_off, tail_len) != tail_len) {
+        free(tail);
+        return false;
+    }
+
+    bool found = false;
+    for (size_t i = tail_len - ZIP_EOCD_SIZE + 1; i-- > 0 && !found; ) {
+        const unsigned char *p = tail + i;
+        if (memcmp(p, "PK\x05\x06", 4) != 0) continue;
+        uint16_t comment_len = rd16le(p + 20);
+        if (i + ZIP_EOCD_SIZE + comment_len > tail_len) continue;
+        *cd_size = rd32le(p + 12);
+        *cd_off = rd32le(p + 16);
+        zip->eocd_off = tail_off + i;
+        if (*cd_off != 0xffffffff && (uint64_t)*cd_off + *cd_size > zip->eocd_off) continue;
+        *count = rd16le(p + 10);
+        memcpy(zip->comment, p + ZIP_EOCD_SIZE, comment_len);
+        zip->comment[comment_len] = '\0';
+        found = true;
+    }
+    free(tail);
+    return found;
+}
+
+/**
+ * @brief Replace the 32-bit directory fields by the ZIP64 ones, if any.
+ *
+ * @return Offset where the central directory ends (the ZIP64 record or
+ *         the end of central directory record).
+ */
+static uint64_t read_zip64(zip_archive_t *zip, uint64_t *cd_size, uint64_t *cd_off, uint64_t *count)
+{
+    unsigned char loc[20], rec[56];
+    if (zip->eocd_off < sizeof(loc) + sizeof(rec)) return zip->eocd_off;
+    uint64_t loc_off = zip->eocd_off - sizeof(loc);
+    if (bparser_read(zip->parser, loc, loc_off, sizeof(loc)) != sizeof(loc) || memcmp(loc, "PK\x06\x07", 4) != 0)
+        return zip->eocd_off;
+
+    // the recorded offset is wrong when data was prepended to the archive
+    uint64_t candidates[2] = {rd64le(loc + 8), loc_off - sizeof(rec)};
+    for (int i = 0; i < 2; i++) {
+        uint64_t off = candidates[i];
+        if (bparser_read(zip->parser, rec, off, sizeof(rec)) != sizeof(rec) || memcmp(rec, "PK\x06\x06", 4) != 0)
+            continue;
+        *count = rd64le(rec + 32);
+        *cd_size = rd64le(rec + 40);
+        *cd_off = rd64le(rec + 48);
+        zip->zip64 = true;
+        return off;
+    }
+    return zip->eocd_off;
+}
+
+/**
+ * @brief Apply the ZIP64 extended information extra field to e.
+ *
+ * Only the fields saturated in the fixed header are present, in order.
+ */
+static void read_zip64_extra(const unsigned char *extra, size_t len, zip_entry_t *e)
+{
+    for (size_t at = 0; at + 4 <= len; ) {
+        uint16_t id = rd16le(extra + at), size = rd16le(extra + at + 2);
+        const unsigned char *p = extra + at + 4, *end = p + size;
+        at += 4 + (size_t)size;
+        if (at > len) return;
+        if (id != 0x0001) continue;
+        if (e->usize == 0xffffffff && p + 8 <= end) { e->usize = rd64le(p); p += 8; }
+        if (e->csize == 0xffffffff && p + 8 <= end) { e->csize = rd64le(p); p += 8; }
+        if (e->local_off == 0xffffffff && p + 8 <= end) { e->local_off = rd64le(p); p += 8; }
+        return;
+    }
+}
+
+static bool name_eq(const zip_entry_t *e, const char *name, size_t len)
+{
+    return e->name_len == len && memcmp(e->name, name, len) == 0;
+}
+
+static bool build_table(zip_archive_t *zip)
+{
+    zip->buckets = 16;
+    while (zip->buckets < zip->count * 2) zip->buckets <<= 1;
+    zip->table = calloc(zip->buckets, sizeof(*zip->table));
+    if (!zip->table) return false;
+    for (size_t i = 0; i < zip->count; i++) {
+        const zip_entry_t *e = &zip->entries[i];
+        size_t b = b_fnv1a(e->name, e->name_len) & (zip->buckets - 1);
+        // a later member with the same name replaces the earlier one
+        while (zip->table[b] && !name_eq(&zip->entries[zip->table[b] - 1], e->name, e->name_len))
+            b = (b + 1) & (zip->buckets - 1);
+        zip->table[b] = (uint32_t)(i + 1);
+    }
+    return true;
+}
+
+zip_archive_t *zip_open(bparser *parser)
+{
+    if (!parser || parser->size < ZIP_EOCD_SIZE) return NULL;
+    zip_archive_t *zip = calloc(1, sizeof(*zip));
+    if (!zip) return NULL;
+    zip->parser = parser;
+
+    uint32_t size32, off32;
+    uint64_t count;
+    if (!find_eocd(zip, &size32, &off32, &count)) goto fail;
+    uint64_t cd_size = size32, cd_off = off32;
+    uint64_t cd_end = read_zip64(zip, &cd_size, &cd_off, &count);
+    if (cd_off + cd_size < cd_off || cd_off + cd_size > cd_end) goto fail;
+    zip->bias = cd_end - (cd_off + cd_size);
+    zip->cd_off = cd_off + zip->bias;
+    zip->cd_size = cd_size;
+
+    // the whole directory in one read (or none, when the file is in memory)
+    if (parser->block) {
+        zip->cd = (const unsigned char*)parser->block + zip->cd_off;
+    } else {
+        zip->cd_owned = malloc(cd_size ? cd_size : 1);
+        if (!zip->cd_owned || bparser_read(parser, zip->cd_owned, zip->cd_off, cd_size) != cd_size) goto fail;
+        zip->cd = zip->cd_owned;
+    }
+
+    size_t cap = count < cd_size / ZIP_CDH_SIZE ? count : cd_size / ZIP_CDH_SIZE;
+    zip->entries = malloc((cap ? cap : 1) * sizeof(*zip->entries));
+    if (!zip->entries) goto fail;
+    const unsigned char *p = zip->cd, *end = zip->cd + cd_size;
+    while (zip->count < cap && (size_t)(end - p) >= ZIP_CDH_SIZE && memcmp(p, "PK\x01\x02", 4) == 0) {
+        uint16_t name_len = rd16le(p + 28), extra_len = rd16le(p + 30), comment_len = rd16le(p + 32);
+        if ((size_t)(end - p) < (size_t)ZIP_CDH_SIZE + name_len + extra_len + comment_len) break;
+        zip_entry_t *e = &zip->entries[zip->count++];
+        *e = (zip_entry_t){
+            .name = (const char*)p + ZIP_CDH_SIZE, .name_len = name_len,
+            .flags = rd16le(p + 8), .method = rd16le(p + 10), .dos_time = rd16le(p + 14) << 16 | rd16le(p + 12),
+            .crc = rd32le(p + 16), .csize = rd32le(p + 20), .usize = rd32le(p + 24),
+            .ext_attr = rd32le(p + 38), .local_off = rd32le(p + 42),
+        };
+        read_zip64_extra(p + ZIP_CDH_SIZE + name_len, extra_len, e);
+        e->local_off += zip->bias;
+        p += ZIP_CDH_SIZE + name_len + extra_len + comment_len;
+    }
+    if (zip->count != count)
+        fprintf(stderr, COLOR_YELLOW "[!] Central directory lists %zu of %llu members\n" COLOR_RESET, zip->count,
+                (unsigned long long)count);
+    if (!build_table(zip)) goto fail;
+    return zip;
+
+fail:
+    zip_close(zip);
+    return NULL;
+}
+
+void zip_close(zip_archive_t *zip)
+{
+    if (!zip) return;
+    free(zip->table);
+    free(zip->entries);
+    free(zip->cd_owned);
+    free(zip);
+}
+
+const zip_entry_t *zip_find(const zip_archive_t *zip, const char *name)
+{
+    size_t len = strlen(name);
+    for (size_t b = b_fnv1a(name, len) & (zip->buckets - 1); zip->table[b]; b = (b + 1) & (zip->buckets - 1)) {
+        const zip_entry_t *e = &zip->entries[zip->table[b] - 1];
+        if (name_eq(e, name, len)) return e;
+    }
+    return NULL;
+}
+// ========================= END CENTRAL DIRECTORY ==================================
+
+// ========================= BEGIN MEMBER DATA ==================================
+bool zip_data_offset(const zip_archive_t *zip, const zip_entry_t *e, uint64_t *off)
+{
+    unsigned char lfh[ZIP_LFH_SIZE];
+    if (bparser_read(zip->parser, lfh, e->local_off, sizeof(lfh)) != sizeof(lfh)) return false;
+    if (memcmp(lfh, "PK\x03\x04", 4) != 0) return false;
+    // the local name and extra field may differ from the central ones
+    *off = e->local_off + ZIP_LFH_SIZE + rd16le(lfh + 26) + rd16le(lfh + 28);
+    return *off <= zip->parser->size && e->csize <= zip->parser->size - *off;
+}
+
+bparser *zip_member_slice(const zip_archive_t *zip, const zip_entry_t *e)
+{
+    uint64_t off;
+    if (e->method != ZIP_STORED || (e->flags & 1) || !zip_data_offset(zip, e, &off)) return NULL;
+    return bparser_slice(zip->parser, off, e->csize);
+}
+
+/**
+ * @brief Pass the compressed bytes of a member to step, in ZIP_CHUNK pieces.
+ *
+ * In memory mode the pieces point into the image; otherwise they are read
+ * into buf.
+ */
+static bool for_each_chunk(const zip_archive_t *zip, uint64_t off, uint64_t len, unsigned char *buf,
+                           bool (*step)(const unsigned char*, size_t, void*), void *ctx)
+{
+    bparser *parser = zip->parser;
+    for (uint64_t done = 0; done < len; ) {
+        size_t n = len - done > ZIP_CHUNK ? ZIP_CHUNK : (size_t)(len - done);
+        const unsigned char *p;
+        if (parser->block) {
+            p = (const unsigned char*)parser->block + off + done;
+        } else {
+            if (bparser_read(parser, buf, off + done, n) != n) return false;
+            p = buf;
+        }
+        if (!step(p, n, ctx)) return false;
+        done += n;
+    }
+    return true;
+}
+
+typedef struct {
+    zip_sink_t sink;
+    void *ctx;
+    uLong crc;
+    uint64_t total;
+    z_stream zs;
+    unsigned char *out;
+    bool end;
+} zip_reader_t;
+
+static bool stored_step(const unsigned char *p, size_t n, void *arg)
+{
+    zip_reader_t *r = arg;
+    r->crc = crc32(r->crc, p, (uInt)n);
+    r->total += n;
+    return r->sink(p, n, r->ctx);
+}
+
+static bool inflate_step(const unsigned char *p, size_t n, void *arg)
+{
+    zip_reader_t *r = arg;
+    r->zs.next_in = (Bytef*)p;
+    r->zs.avail_in = (uInt)n;
+    while (!r->end && (r->zs.avail_in > 0 || r->zs.avail_out == 0)) {
+        r->zs.next_out = r->out;
+        r->zs.avail_out = ZIP_CHUNK;
+        int rc = inflate(&r->zs, Z_NO_FLUSH);
+        if (rc != Z_OK && rc != Z_STREAM_END && rc != Z_BUF_ERROR) return false;
+        size_t produced = ZIP_CHUNK - r->zs.avail_out;
+        if (produced) {
+            r->crc = crc32(r->crc, r->out, (uInt)produced);
+            r->total += produced;
+            if (!r->sink(r->out, produced, r->ctx)) return false;
+        }
+        r->end = rc == Z_STREAM_END;
+        if (rc == Z_BUF_ERROR && produced == 0) break;
+    }
+    return true;
+}
+
+bool zip_member_read(const zip_archive_t *zip, const zip_entry_t *e, zip_sink_t sink, void *ctx)
+{
+    uint64_t off;
+    if ((e->flags & 1) || (e->method != ZIP_STORED && e->method != ZIP_DEFLATED)) return false;
+    if (!zip_data_offset(zip, e, &off)) return false;
+
+    zip_reader_t r = {.sink = sink, .ctx = ctx, .crc = crc32(0, Z_NULL, 0)};
+    unsigned char *in = zip->parser->block ? NULL : malloc(ZIP_CHUNK);
+    if (!zip->parser->block && !in) return false;
+    bool ok;
+    if (e->method == ZIP_STORED) {
+        ok = for_each_chunk(zip, off, e->csize, in, stored_step, &r);
+    } else {
+        r.out = malloc(ZIP_CHUNK);
+        ok = r.out && inflateInit2(&r.zs, -MAX_WBITS) == Z_OK;
+        if (ok) {
+            ok = for_each_chunk(zip, off, e->csize, in, inflate_step, &r) && r.end;
+            inflateEnd(&r.zs);
+        }
+        free(r.out);
+    }
+    free(in);
+    return ok && r.total == e->usize && r.crc == e->crc;
+}
+// ========================= END MEMBER DATA ==================================
+
+// ========================= BEGIN COMMANDS ==================================
+static const char *method_name(uint16_t method)
+{
+    switch (method) {
+        case ZIP_STORED:   return "stored";
+        case ZIP_DEFLATED: return "deflate";
+        case 12:           return "bzip2";
+        case 14:           return "lzma";
+        case 93:           return "zstd";
+        case 95:           return "xz";
+        default:           return "other";
+    }
+}
+
+static void print_dos_time(uint32_t t)
+{
+    unsigned date = t >> 16, time = t & 0xffff;
+    printf("%04u-%02u-%02u %02u:%02u", ((date >> 9) & 0x7f) + 1980, (date >> 5) & 0xf, date & 0x1f,
+           time >> 11, (time >> 5) & 0x3f);
+}
+
+static bool is_dir(const zip_entry_t *e)
+{
+    return e->name_len > 0 && e->name[e->name_len - 1] == '/';
+}
+
+static bool hash_sink(const void *data, size_t len, void *ctx)
+{
+    b_sha256_update(ctx, data, len);
+    return true;
+}
+
+typedef struct {
+    unsigned char *buf;
+    size_t len, cap;
+} zip_buffer_t;
+
+/** Collect the data up to the capacity, and stop the read past it. */
+static bool buffer_sink(const void *data, size_t len, void *ctx)
+{
+    zip_buffer_t *b = ctx;
+    size_t take = len > b->cap - b->len ? b->cap - b->len : len;
+    memcpy(b->buf + b->len, data, take);
+    b->len += take;
+    return take == len;
+}
+
+/**
+ * @brief Run fn on a parser over a member: a slice when it is stored, its
+ * inflated data in memory otherwise (at most limit bytes).
+ */
+static bool with_member(const zip_archive_t *zip, const zip_entry_t *e, uint64_t limit,
+                        void (*fn)(bparser*, const zip_entry_t*, void*), void *ctx)
+{
+    bparser *slice = zip_member_slice(zip, e);
+    if (slice) {
+        fn(slice, e, ctx);
+        free(slice);
+        return true;
+    }
+    if (e->method != ZIP_DEFLATED || (e->flags & 1)) return false;
+    if (e->usize > ZIP_MAX_INFLATE && limit > ZIP_MAX_INFLATE) {
+        fprintf(stderr, COLOR_YELLOW "[!] Too large to inflate: " COLOR_RESET "%.*s\n", (int)e->name_len, e->name);
+        return false;
+    }
+    zip_buffer_t b = {.cap = e->usize < limit ? e->usize : limit};
+    b.buf = malloc(b.cap ? b.cap : 1);
+    if (!b.buf) return false;
+    bool ok = zip_member_read(zip, e, buffer_sink, &b) || (b.len == b.cap && b.cap < e->usize);
+    if (ok) {
+        bparser mem = {.mode = BASEER_MODE_MEMORY, .fp = NULL, .size = b.len, .block = b.buf, .base = 0};
+        fn(&mem, e, ctx);
+    } else {
+        fprintf(stderr, COLOR_RED "[!] Could not inflate: " COLOR_RESET "%.*s\n", (int)e->name_len, e->name);
+    }
+    free(b.buf);
+    return ok;
+}
+
+static void print_member_title(bparser *data, const zip_entry_t *e, void *ctx)
+{
+    (void)ctx;
+    const char *format = bx_binhead_identify(data);
+    printf(COLOR_BLUE "\n=== %.*s " COLOR_RESET "(%llu bytes, %s, %s)\n", (int)e->name_len, e->name,
+           (unsigned long long)e->usize, method_name(e->method), format ? format : "unknown");
+}
+
+static void analyze_member(bparser *data, const zip_entry_t *e, void *ctx)
+{
+    inputs *sub = ctx;
+    char name[UINT16_MAX + 1];   // names are 16-bit counted
+    snprintf(name, sizeof(name), "%.*s", (int)e->name_len, e->name);
+    sub->member = name;
+    print_member_title(data, e, NULL);
+    bx_binhead_dispatch(data, sub);
+    sub->member = NULL;
+}
+
+static void zip_metadata(const zip_archive_t *zip)
+{
+    printf(COLOR_BLUE "\n=== ZIP End of Central Directory ===\n" COLOR_RESET);
+    printf(COLOR_GREEN "|--eocd      :" COLOR_RESET " 0x%llx\n", (unsigned long long)zip->eocd_off);
+    printf(COLOR_GREEN "|--zip64     :" COLOR_RESET " %s\n", zip->zip64 ? "yes" : "no");
+    printf(COLOR_GREEN "|--members   :" COLOR_RESET " %zu\n", zip->count);
+    printf(COLOR_GREEN "|--directory :" COLOR_RESET " 0x%llx (%llu bytes)\n", (unsigned long long)zip->cd_off,
+           (unsigned long long)zip->cd_size);
+    if (zip->bias)
+        printf(COLOR_GREEN "|--prefix    :" COLOR_RESET " %llu bytes before the archive\n",
+               (unsigned long long)zip->bias);
+    if (zip->comment[0])
+        printf(COLOR_GREEN "|--comment   :" COLOR_RESET " %s\n", zip->comment);
+}
+
+/**
+ * @brief List the members (`-l`), hashing their data with `-l --hash`.
+ */
+static void zip_list(const zip_archive_t *zip, bool hash)
+{
+    uint64_t usize = 0, csize = 0;
+    for (size_t i = 0; i < zip->count; i++) {
+        const zip_entry_t *e = &zip->entries[i];
+        printf(COLOR_GREEN "%-8s" COLOR_RESET " %12llu %12llu %08x ", method_name(e->method),
+               (unsigned long long)e->usize, (unsigned long long)e->csize, e->crc);
+        print_dos_time(e->dos_time);
+        if (hash) {
+            unsigned char digest[SHA256_DIGEST_SIZE];
+            b_sha256_ctx ctx;
+            b_sha256_init(&ctx);
+            if (is_dir(e)) {
+                printf(" %-64s", "-");
+            } else if (zip_member_read(zip, e, hash_sink, &ctx)) {
+                b_sha256_final(&ctx, digest);
+                printf(" ");
+                for (int j = 0; j < SHA256_DIGEST_SIZE; j++) printf("%02x", digest[j]);
+            } else {
+                printf(COLOR_RED " %-64s" COLOR_RESET, (e->flags & 1) ? "encrypted" : "unreadable (bad data or CRC)");
+            }
+        }
+        printf("  %.*s\n", (int)e->name_len, e->name);
+        usize += e->usize;
+        csize += e->csize;
+    }
+    printf(COLOR_BLUE "%zu members, %llu bytes (%llu compressed)\n" COLOR_RESET, zip->count,
+           (unsigned long long)usize, (unsigned long long)csize);
+}
+
+/**
+ * @brief Run the flags that follow `-r` on every member.
+ *
+ * Without flags, the members are only identified, from their first bytes.
+ */
+static void zip_recursive(const zip_archive_t *zip, inputs *input)
+{
+    int sub_argc;
+    inputs sub;
+    char **args = baseer_sub_args(input, 3, &sub_argc, &sub);
+    if (!args) return;
+    for (size_t i = 0; i < zip->count; i++) {
+        const zip_entry_t *e = &zip->entries[i];
+        if (is_dir(e)) continue;
+        if (sub_argc < 3) with_member(zip, e, ZIP_IDENTIFY_SIZE, print_member_title, NULL);
+        else with_member(zip, e, UINT64_MAX, analyze_member, &sub);
+    }
+    fflush(stdout);
+    free(args);
+}
+
+/**
+ * @brief Print one member and run the flags that follow `--member <name>` on it.
+ */
+static bool zip_member(const zip_archive_t *zip, inputs *input)
+{
+    const char *name = baseer_get_opt(input, "--member");
+    const zip_entry_t *e = name ? zip_find(zip, name) : NULL;
+    if (!e) {
+        fprintf(stderr, COLOR_RED "[!] No such member: " COLOR_RESET "%s\n", name ? name : "");
+        return false;
+    }
+    uint64_t off = 0;
+    bool have_data = zip_data_offset(zip, e, &off);
+    printf(COLOR_BLUE "\n=== %.*s ===\n" COLOR_RESET, (int)e->name_len, e->name);
+    printf(COLOR_GREEN "|--method    :" COLOR_RESET " %s (%u)%s\n", method_name(e->method), e->method,
+           (e->flags & 1) ? ", encrypted" : "");
+    printf(COLOR_GREEN "|--size      :" COLOR_RESET " %llu\n", (unsigned long long)e->usize);
+    printf(COLOR_GREEN "|--compressed:" COLOR_RESET " %llu\n", (unsigned long long)e->csize);
+    printf(COLOR_GREEN "|--crc32     :" COLOR_RESET " %08x\n", e->crc);
+    printf(COLOR_GREEN "|--mtime     :" COLOR_RESET " ");
+    print_dos_time(e->dos_time);
+    printf("\n");
+    if (e->ext_attr >> 16)
+        printf(COLOR_GREEN "|--mode      :" COLOR_RESET " %o\n", e->ext_attr >> 16);
+    printf(COLOR_GREEN "|--header    :" COLOR_RESET " 0x%llx\n", (unsigned long long)e->local_off);
+    if (have_data)
+        printf(COLOR_GREEN "|--data      :" COLOR_RESET " 0x%llx\n", (unsigned long long)off);
+    else
+        fprintf(stderr, COLOR_RED "[!] Bad local header at " COLOR_RESET "0x%llx\n", (unsigned long long)e->local_off);
+
+    // <prog> <archive> <flags after --member <name>...>
+    int argc = *input->argc, at = 2;
+    while (at < argc && strcmp("--member", input->args[at]) != 0) at++;
+    if (have_data && at + 2 < argc) {
+        int sub_argc;
+        inputs sub;
+        char **args = baseer_sub_args(input, at + 2, &sub_argc, &sub);
+        if (args) with_member(zip, e, UINT64_MAX, analyze_member, &sub);
+        free(args);
+    }
+    return true;
+}
+
+bool bx_zip(bparser *parser, void *arg)
+{
+    inputs *input = arg;
+    int argc = *input->argc;
+    char **args = input->args;
+
+    // format-independent tools do not need the directory
+    if (strcmp("--scan", args[2]) == 0 && argc > 3) return bparser_apply(parser, b_scan, arg);
+    if (strcmp("--carve", args[2]) == 0) return bparser_apply(parser, b_carve, arg);
+    if (strcmp("--hash", args[2]) == 0) return bparser_apply(parser, b_hash, arg);
+
+    zip_archive_t *zip = zip_open(parser);
+    if (!zip) {
+        fprintf(stderr, COLOR_RED "[!] No end of central directory: not a complete zip archive\n" COLOR_RESET);
+        return false;
+    }
+    if (strcmp("-m", args[2]) == 0) {
+        zip_metadata(zip);
+    } else if (strcmp("-l", args[2]) == 0) {
+        zip_list(zip, argc > 3 && strcmp("--hash", args[3]) == 0);
+    } else if (strcmp("-r", args[2]) == 0) {
+        zip_recursive(zip, input);
+    } else if (strcmp("--member", args[2]) == 0 && argc > 3) {
+        zip_member(zip, input);
+    } else {
+        fprintf(stderr, "[!] Unsupported flag: %s\n", args[2]);
+    }
+    zip_close(zip);
+    return true;
+}
+// ========================= END COMMANDS ==================================
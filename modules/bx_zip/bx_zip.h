@@ -0,0 +1,122 @@
+/**
+ * @file bx_zip.h
+ * @brief ZIP (and JAR/APK) archives read through their central directory.
+ *
+ * The end of central directory record is found by scanning the last 64KB
+ * of the file backwards (ZIP64 records are followed when present), and the
+ * member table is built from the central directory alone: local headers
+ * are only read when a member's data is accessed. Opening an archive thus
+ * costs one read at its end and one read of the directory.
+ *
+ * Stored members are available as zero-copy bparser slices; deflated
+ * members are inflated as a stream (zlib), with their CRC-32 checked.
+ *
+ * Options (read from the command line):
+ * - `-m`                         Print the end of central directory.
+ * - `-l [--hash]`                List the members (and their SHA-256).
+ * - `-r <flags...>`              Run the flags on every member.
+ * - `--member <name> [flags...]` Print one member, and run the flags on it.
+ * - `--scan`, `--carve`, `--hash` As for any file.
+ */
+#ifndef BX_ZIP_H
+#define BX_ZIP_H
+#include "../bparser/bparser.h"
+#include "../../baseer.h"
+#include "../../utils/ui.h"
+#include <stdint.h>
+
+#define ZIP_EOCD_SIZE     22
+#define ZIP_MAX_COMMENT   0xffff
+#define ZIP_CDH_SIZE      46                /**< Central directory header without its names */
+#define ZIP_LFH_SIZE      30                /**< Local file header without its names */
+#define ZIP_CHUNK         (256 * 1024)      /**< Bytes per read/inflate step */
+#define ZIP_MAX_INFLATE   (1ULL << 30)      /**< Largest member inflated in memory for analysis */
+#define ZIP_IDENTIFY_SIZE 4096              /**< Bytes inflated to identify a member */
+
+#define ZIP_STORED   0
+#define ZIP_DEFLATED 8
+
+/**
+ * @brief One member, as described by the central directory.
+ */
+typedef struct {
+    const char *name;           /**< Points into the central directory (not NUL-terminated) */
+    uint32_t name_len;
+    uint16_t method;
+    uint16_t flags;             /**< Bit 0: encrypted */
+    uint32_t crc;
+    uint32_t dos_time;          /**< MS-DOS date << 16 | time */
+    uint32_t ext_attr;          /**< Unix mode in the upper 16 bits when made on Unix */
+    uint64_t csize;             /**< Compressed size */
+    uint64_t usize;             /**< Uncompressed size */
+    uint64_t local_off;         /**< Offset of the local header (in the parser) */
+} zip_entry_t;
+
+/**
+ * @brief An opened archive.
+ */
+typedef struct {
+    bparser *parser;
+    uint64_t eocd_off;          /**< Offset of the end of central directory record */
+    uint64_t cd_off;            /**< Offset of the central directory (in the parser) */
+    uint64_t cd_size;
+    uint64_t bias;              /**< Bytes in front of the archive (self-extractors) */
+    bool zip64;
+    char comment[ZIP_MAX_COMMENT + 1];
+    const unsigned char *cd;    /**< Central directory image */
+    unsigned char *cd_owned;    /**< Copy of it in stream mode */
+    zip_entry_t *entries;
+    size_t count;
+    uint32_t *table;            /**< Open-addressed name hash table: entry + 1, 0 if empty */
+    size_t buckets;
+} zip_archive_t;
+
+/**
+ * @brief Receives the data of a member, chunk by chunk.
+ *
+ * @return false to stop reading.
+ */
+typedef bool (*zip_sink_t)(const void *data, size_t len, void *ctx);
+
+/**
+ * @brief Locate the central directory and build the member table.
+ *
+ * @return The archive (free with zip_close()), NULL if no valid end of
+ *         central directory is found.
+ */
+zip_archive_t *zip_open(bparser *parser);
+void zip_close(zip_archive_t *zip);
+
+/**
+ * @brief Find a member by name (the last one wins for duplicates).
+ */
+const zip_entry_t *zip_find(const zip_archive_t *zip, const char *name);
+
+/**
+ * @brief Offset of a member's data, read from its local header.
+ *
+ * @return false if the local header is missing or out of bounds.
+ */
+bool zip_data_offset(const zip_archive_t *zip, const zip_entry_t *e, uint64_t *off);
+
+/**
+ * @brief Zero-copy window over a stored member.
+ *
+ * @return The slice (free with free()), NULL for compressed or encrypted
+ *         members.
+ */
+bparser *zip_member_slice(const zip_archive_t *zip, const zip_entry_t *e);
+
+/**
+ * @brief Stream the uncompressed data of a member into sink.
+ *
+ * Stored members are passed through, deflated members are inflated in
+ * ZIP_CHUNK steps. The CRC-32 of the data is checked at the end.
+ *
+ * @return true if the whole member was read and its CRC matches.
+ */
+bool zip_member_read(const zip_archive_t *zip, const zip_entry_t *e, zip_sink_t sink, void *ctx);
+
+bool bx_zip(bparser *parser, void *arg);
+
+#endif
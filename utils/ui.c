@@ -50,6 +50,37 @@ void print_usage(void)
     printf("Flags:\n      ");
     printf("-m Metadata\n      ");
     printf("-a Disassemble\n      ");
+    printf("   --function <name>             Only disassemble one function\n      ");
+    printf("   --section <name>              Only disassemble one section\n      ");
+    printf("   --range <vaddr>:<vaddr|+len>  Only disassemble an address range\n      ");
+    printf("   --source                      File and line above the instructions (DWARF)\n      ");
+    printf("-g ROP/JOP gadgets\n      ");
+    printf("   --depth <n>                   Instructions before the terminator (default 4)\n      ");
+    printf("--core Threads, registers, stacks and mappings of an ELF core dump\n      ");
+    printf("   --exe <path>                  Executable to symbolize against\n      ");
+    printf("--read <vaddr>:<vaddr|+len> Hex dump of the memory of an ELF core dump\n      ");
+    printf("--dump <section> Hex dump of a section (name or index), decompressed if needed\n      ");
+    printf("--stats Instruction and mnemonic statistics\n      ");
+    printf("--fingerprint Function fingerprints\n      ");
+    printf("   --fp-add <index>              Add the functions to a fingerprint index\n      ");
+    printf("   --fp-query <index>            Find similar functions in an index\n      ");
+    printf("--scan <rules> Signature scan (any file)\n      ");
+    printf("--carve Find embedded ELF/tar/zip/PNG/PDF files (any file)\n      ");
+    printf("   --carve <flags...>            Run the flags on every carved file\n      ");
+    printf("--hash Size and SHA-256\n      ");
+    printf("-l List the members of a tar, zip or ar archive\n      ");
+    printf("   -l --hash                     Also hash the zip and ar members\n      ");
+    printf("   -l (WebAssembly)              Functions and their body ranges\n      ");
+    printf("-r <flags...> Run the flags on every member of a tar, zip or ar archive\n      ");
+    printf("-x <dir> Extract a tar archive (in parallel)\n      ");
+    printf("--index Build the member index of a tar archive (saved in ~/.cache/baseer)\n      ");
+    printf("--member <path> [flags...] Look up one tar, zip or ar member (and run the flags on it)\n      ");
+    printf("--symbol <name> [flags...] Member of a static library defining a symbol\n      ");
+    printf("--crc Verify the chunk CRCs of a PNG (-m lists the chunks)\n      ");
+    printf("--object <n> Print one object of a PDF (-l lists them)\n      ");
+    printf("--embedded Embedded files of a PDF\n      ");
+    printf("--js JavaScript actions of a PDF\n      ");
+    printf("--arch <name> Only one slice of a Mach-O fat binary (x86_64, arm64...)\n      ");
     printf("-c Decompiler\n      ");
     printf("-d Debugger\n");
 }